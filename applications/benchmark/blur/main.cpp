@@ -0,0 +1,182 @@
+/**
+ * @brief Benchmark of the Blur algorithms, time versus radius.
+ *
+ * A synthetic image is blurred through the host Graph API with each algorithm
+ * of the Blur plugin and each radius (standard deviation of the gaussian, in pixels).
+ * The time of the image generation alone is measured and subtracted.
+ * Results are reported as JSON.
+ */
+#include <benchmark/common/graph.hpp>
+
+#include <tuttle/common/utils/global.hpp>
+#include <tuttle/host/Graph.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace tuttle::host;
+using namespace benchmark;
+namespace bpo = boost::program_options;
+
+namespace {
+
+struct BlurResult
+{
+	BlurResult()
+	: _radius( 0 )
+	, _seconds( 0 )
+	{}
+
+	std::string _algorithm;
+	double _radius;
+	double _seconds;
+	std::string _error;
+};
+
+BlurResult benchmarkBlur( const std::string& algorithm, const double radius,
+                          const int width, const int height, const int nbFrames )
+{
+	BlurResult result;
+	result._algorithm = algorithm;
+	result._radius = radius;
+	try
+	{
+		Graph graph;
+		Graph::Node& generator = graph.createNode( "tuttle.colorgradient" );
+		Graph::Node& blur      = graph.createNode( "tuttle.blur" );
+		setupGenerator( generator, width, height, "32f" );
+		// the blur size is the variance of the gaussian
+		blur.getParam( "size" ).setValue( radius * radius, radius * radius );
+		blur.getParam( "algorithm" ).setValue( algorithm );
+		graph.connect( generator, blur );
+		result._seconds = computeSeconds( graph, blur, nbFrames );
+	}
+	catch( ... )
+	{
+		result._error = boost::current_exception_diagnostic_information();
+	}
+	return result;
+}
+
+void writeJson( std::ostream& os, const int width, const int height, const int nbFrames,
+                const double sourceSeconds, const std::vector<BlurResult>& results )
+{
+	writeJsonHeader( os, "blur", width, height );
+	os << "  \"frames\": " << nbFrames << ",\n"
+	   << "  \"source\": { \"plugin\": \"tuttle.colorgradient\", \"seconds\": " << sourceSeconds << " },\n"
+	   << "  \"results\": [\n";
+	for( std::size_t i = 0; i < results.size(); ++i )
+	{
+		const BlurResult& result = results[i];
+		os << "    { \"algorithm\": " << jsonString( result._algorithm ) << ", \"radius\": " << result._radius;
+		if( ! result._error.empty() )
+		{
+			os << ", \"error\": " << jsonString( result._error );
+		}
+		else
+		{
+			const double seconds = std::max( result._seconds - sourceSeconds, 1e-6 );
+			os << ", \"seconds\": " << result._seconds
+			   << ", \"msPerFrame\": " << seconds * 1000.0 / nbFrames
+			   << ", \"mpixelsPerSecond\": " << double( width ) * height * nbFrames / seconds * 1e-6;
+		}
+		os << " }" << ( i + 1 < results.size() ? "," : "" ) << "\n";
+	}
+	os << "  ]\n"
+	   << "}\n";
+}
+
+}
+
+int main( int argc, char** argv )
+{
+	boost::shared_ptr<tuttle::common::Formatter> formatter( tuttle::common::Formatter::get() );
+	formatter->setLogLevel( boost::log::trivial::warning );
+
+	int width = 0;
+	int height = 0;
+	int nbFrames = 0;
+	std::string outputFilename;
+	std::string radiusList;
+	std::string algorithmList;
+
+	bpo::options_description options( "tuttle-benchmark-blur options" );
+	options.add_options()
+		( "help,h", "display help" )
+		( "width", bpo::value<int>( &width )->default_value( 3840 ), "width of the images" )
+		( "height", bpo::value<int>( &height )->default_value( 2160 ), "height of the images" )
+		( "frames,n", bpo::value<int>( &nbFrames )->default_value( 4 ), "number of frames computed for each measure" )
+		( "radius,r", bpo::value<std::string>( &radiusList )->default_value( "1,5,10,25,50,100,200,300" ), "comma separated radius (standard deviation in pixels)" )
+		( "algorithms,a", bpo::value<std::string>( &algorithmList )->default_value( "convolution,recursiveGaussian,box" ), "comma separated blur algorithms" )
+		( "output,o", bpo::value<std::string>( &outputFilename ), "JSON output file (default: standard output)" );
+
+	bpo::variables_map vm;
+	std::vector<double> radius;
+	std::vector<std::string> algorithms;
+	try
+	{
+		bpo::store( bpo::parse_command_line( argc, argv, options ), vm );
+		bpo::notify( vm );
+
+		std::vector<std::string> radiusStrings;
+		boost::algorithm::split( radiusStrings, radiusList, boost::algorithm::is_any_of( "," ) );
+		BOOST_FOREACH( const std::string& r, radiusStrings )
+		{
+			radius.push_back( boost::lexical_cast<double>( r ) );
+		}
+		boost::algorithm::split( algorithms, algorithmList, boost::algorithm::is_any_of( "," ) );
+	}
+	catch( const std::exception& e )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-blur: " << e.what() );
+		return 1;
+	}
+
+	if( vm.count( "help" ) )
+	{
+		TUTTLE_COUT( options );
+		return 0;
+	}
+	if( width <= 0 || height <= 0 || nbFrames <= 0 )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-blur: width, height and frames must be positive." );
+		return 1;
+	}
+
+	try
+	{
+		core().preload();
+
+		const double sourceSeconds = benchmarkSource( width, height, nbFrames, "32f" );
+
+		std::vector<BlurResult> results;
+		BOOST_FOREACH( const std::string& algorithm, algorithms )
+		{
+			BOOST_FOREACH( const double r, radius )
+			{
+				TUTTLE_LOG_INFO( "[benchmark blur] " << algorithm << " radius " << r );
+				results.push_back( benchmarkBlur( algorithm, r, width, height, nbFrames ) );
+				if( ! results.back()._error.empty() )
+					TUTTLE_LOG_WARNING( "[benchmark blur] " << algorithm << " radius " << r << " failed: " << results.back()._error );
+			}
+		}
+
+		Output output( outputFilename );
+		writeJson( output.stream(), width, height, nbFrames, sourceSeconds, results );
+	}
+	catch( ... )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-blur: " << boost::current_exception_diagnostic_information() );
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,84 @@
+#ifndef _BENCHMARK_COMMON_BENCHMARK_HPP_
+#define _BENCHMARK_COMMON_BENCHMARK_HPP_
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/foreach.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief Timing and JSON output shared by the benchmarks.
+ */
+namespace benchmark {
+
+inline double elapsedSeconds( const boost::posix_time::ptime& start )
+{
+	return ( boost::posix_time::microsec_clock::local_time() - start ).total_microseconds() * 1e-6;
+}
+
+/// @return @p str as a quoted JSON string
+inline std::string jsonString( const std::string& str )
+{
+	std::ostringstream oss;
+	oss << '"';
+	BOOST_FOREACH( const char c, str )
+	{
+		switch( c )
+		{
+			case '"':  oss << "\\\""; break;
+			case '\\': oss << "\\\\"; break;
+			case '\n': oss << "\\n"; break;
+			case '\r': oss << "\\r"; break;
+			case '\t': oss << "\\t"; break;
+			default:
+				if( static_cast<unsigned char>( c ) < 0x20 )
+					oss << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << static_cast<int>( c ) << std::dec;
+				else
+					oss << c;
+		}
+	}
+	oss << '"';
+	return oss.str();
+}
+
+/// Open the JSON object of the results, with the name of the benchmark, the date and the image size.
+inline void writeJsonHeader( std::ostream& os, const std::string& name, const std::size_t width, const std::size_t height )
+{
+	os << "{\n"
+	   << "  \"benchmark\": " << jsonString( name ) << ",\n"
+	   << "  \"date\": " << jsonString( boost::posix_time::to_iso_extended_string( boost::posix_time::second_clock::universal_time() ) ) << ",\n"
+	   << "  \"width\": " << width << ",\n"
+	   << "  \"height\": " << height << ",\n";
+}
+
+/**
+ * @brief Output of the results: the file @p filename, or the standard output if it is empty.
+ */
+class Output : boost::noncopyable
+{
+public:
+	explicit Output( const std::string& filename )
+	{
+		if( ! filename.empty() )
+			_file.open( filename.c_str() );
+	}
+
+	std::ostream& stream()
+	{
+		if( _file.is_open() )
+			return _file;
+		return std::cout;
+	}
+
+private:
+	std::ofstream _file;
+};
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _BENCHMARK_COMMON_GRAPH_HPP_
+#define _BENCHMARK_COMMON_GRAPH_HPP_
+
+#include "benchmark.hpp"
+
+#include <tuttle/host/Graph.hpp>
+
+/**
+ * @brief Measures of the benchmarks running plugins through the host Graph API.
+ */
+namespace benchmark {
+
+/**
+ * @brief A 2D color gradient of @p width x @p height (the gradient of the io test images).
+ * @param bitDepth explicit conversion of the output ("8i", "16i", "32f"), the host choice if empty
+ */
+inline void setupGenerator( tuttle::host::Graph::Node& generator, const int width, const int height, const std::string& bitDepth = "" )
+{
+	if( ! bitDepth.empty() )
+		generator.getParam( "explicitConversion" ).setValue( bitDepth );
+	generator.getParam( "mode" ).setValue( "size" );
+	generator.getParam( "width" ).setValue( width );
+	generator.getParam( "height" ).setValue( height );
+	generator.getParam( "type" ).setValue( "2d" );
+	generator.getParam( "nbPoints" ).setValue( 5 );
+	generator.getParam( "point0" ).setValue( 0.0, 0.0 );
+	generator.getParam( "color0" ).setValue( 0.0, 0.0, 0.0, 0.0 );
+	generator.getParam( "point1" ).setValue( 1.0, 1.0 );
+	generator.getParam( "color1" ).setValue( 1.0, 1.0, 1.0, 1.0 );
+	generator.getParam( "point2" ).setValue( 0.0, 1.0 );
+	generator.getParam( "color2" ).setValue( 0.0, 1.0, 0.0, 1.0 );
+	generator.getParam( "point3" ).setValue( 1.0, 0.1 );
+	generator.getParam( "color3" ).setValue( 0.0, 0.0, 1.0, 1.0 );
+	generator.getParam( "point4" ).setValue( 0.5, 0.5 );
+	generator.getParam( "color4" ).setValue( 1.0, 0.0, 0.0, 1.0 );
+}
+
+/// @return the time of the computation of @p node on the frames [0, nbFrames[
+inline double computeSeconds( tuttle::host::Graph& graph, tuttle::host::Graph::Node& node, const int nbFrames )
+{
+	tuttle::host::ComputeOptions options( 0, nbFrames - 1 );
+	options.setReturnBuffers( false );
+
+	const boost::posix_time::ptime start( boost::posix_time::microsec_clock::local_time() );
+	graph.compute( node, options );
+	return elapsedSeconds( start );
+}
+
+/// @return the time of the generation of the images alone, to subtract from the measures
+inline double benchmarkSource( const int width, const int height, const int nbFrames, const std::string& bitDepth = "" )
+{
+	tuttle::host::Graph graph;
+	tuttle::host::Graph::Node& generator = graph.createNode( "tuttle.colorgradient" );
+	setupGenerator( generator, width, height, bitDepth );
+	return computeSeconds( graph, generator, nbFrames );
+}
+
+}
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * @brief Micro benchmark of the terry correlation, for kernel sizes from 3 to 65.
+ *
+ * - "line" measures: correlation of a line of pixels with the generic GIL
+ *   implementation and with each SIMD implementation supported by the cpu.
+ * - "image" measures: separable correlation of an image (correlate_rows_cols)
+ *   with float, 16 bits and planar float images, accumulated in float.
+ * Results are reported as JSON, in megapixels per second.
+ */
+#include <benchmark/common/benchmark.hpp>
+
+#include <terry/globals.hpp>
+#include <terry/filter/convolve.hpp>
+#include <terry/filter/detail/correlate_simd.hpp>
+
+#include <tuttle/common/utils/global.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/foreach.hpp>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bpo = boost::program_options;
+using namespace terry;
+using namespace benchmark;
+namespace filter = terry::filter;
+
+namespace {
+
+static const std::size_t kKernelSizes[] = { 3, 5, 7, 9, 15, 21, 33, 49, 65 };
+
+std::vector<float> buildKernel( const std::size_t size )
+{
+	std::vector<float> kernel( size, 1.0f / size );
+	return kernel;
+}
+
+/// Keep the result alive, so the compiler can't remove the computation.
+template<typename Pixel>
+float checksum( const std::vector<Pixel>& pixels )
+{
+	float sum = 0;
+	for( std::size_t i = 0; i < pixels.size(); i += 97 )
+		sum += pixels[i][0];
+	return sum;
+}
+
+struct LineMeasure
+{
+	std::string _pixel;
+	std::string _implementation;
+	std::size_t _kernelSize;
+	double _mpixelsPerSecond;
+};
+
+template<typename Pixel>
+void benchmarkLine( const std::string& pixelName, const std::size_t width, const std::size_t nbRepeat,
+                    std::vector<LineMeasure>& measures, float& sink )
+{
+	const std::size_t nbChannels = num_channels<Pixel>::value;
+
+	BOOST_FOREACH( const std::size_t kernelSize, kKernelSizes )
+	{
+		const std::vector<float> kernel = buildKernel( kernelSize );
+		std::vector<Pixel> src( width + kernelSize - 1 );
+		std::vector<Pixel> dst( width );
+		for( std::size_t i = 0; i < src.size(); ++i )
+			for( std::size_t c = 0; c < nbChannels; ++c )
+				src[i][c] = ( i * ( c + 1 ) % 17 ) / 16.0f;
+
+		const Pixel* srcBegin = &src.front();
+		const Pixel* srcEnd = srcBegin + width;
+		const float* srcFloats = reinterpret_cast<const float*>( srcBegin );
+		float* dstFloats = reinterpret_cast<float*>( &dst.front() );
+
+		LineMeasure measure;
+		measure._pixel = pixelName;
+		measure._kernelSize = kernelSize;
+
+#define TERRY_BENCHMARK_LINE( NAME, CALL ) \
+		{ \
+			const boost::posix_time::ptime start( boost::posix_time::microsec_clock::local_time() ); \
+			for( std::size_t r = 0; r < nbRepeat; ++r ) \
+			{ \
+				CALL; \
+			} \
+			measure._implementation = NAME; \
+			measure._mpixelsPerSecond = width * nbRepeat / std::max( elapsedSeconds( start ), 1e-9 ) * 1e-6; \
+			measures.push_back( measure ); \
+			sink += checksum( dst ); \
+		}
+
+		TERRY_BENCHMARK_LINE( "gil",
+			filter::detail::correlate_pixels_n_imp<Pixel>( srcBegin, srcEnd, kernel.begin(), kernelSize, &dst.front(), boost::mpl::false_() ) );
+		TERRY_BENCHMARK_LINE( "floats-generic",
+			filter::detail::correlate_floats_generic( srcFloats, &kernel.front(), kernelSize, nbChannels, dstFloats, width * nbChannels ) );
+#ifdef TERRY_FILTER_SIMD_X86
+		if( __builtin_cpu_supports( "sse2" ) )
+			TERRY_BENCHMARK_LINE( "sse2",
+				filter::detail::correlate_floats_sse2( srcFloats, &kernel.front(), kernelSize, nbChannels, dstFloats, width * nbChannels ) );
+		if( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) )
+			TERRY_BENCHMARK_LINE( "avx2",
+				filter::detail::correlate_floats_avx2( srcFloats, &kernel.front(), kernelSize, nbChannels, dstFloats, width * nbChannels ) );
+#endif
+		TERRY_BENCHMARK_LINE( "dispatch",
+			filter::correlate_pixels_n<Pixel>( srcBegin, srcEnd, kernel.begin(), kernelSize, &dst.front() ) );
+
+#undef TERRY_BENCHMARK_LINE
+	}
+}
+
+struct ImageMeasure
+{
+	std::string _image;
+	std::size_t _kernelSize;
+	double _mpixelsPerSecond;
+};
+
+template<typename Image>
+void benchmarkImage( const std::string& imageName, const std::size_t width, const std::size_t height,
+                     std::vector<ImageMeasure>& measures, float& sink )
+{
+	typedef typename Image::view_t View;
+	Image srcImage( width, height );
+	Image dstImage( width, height );
+	const View src = view( srcImage );
+	const View dst = view( dstImage );
+	for( std::size_t y = 0; y < height; ++y )
+		for( std::size_t x = 0; x < width; ++x )
+			color_convert( rgba32f_pixel_t( x / float( width ), y / float( height ), 0.5f, 1.0f ), src( x, y ) );
+
+	BOOST_FOREACH( const std::size_t kernelSize, kKernelSizes )
+	{
+		const std::vector<float> values = buildKernel( kernelSize );
+		const filter::kernel_1d<float> kernel( &values.front(), kernelSize, kernelSize / 2 );
+
+		const boost::posix_time::ptime start( boost::posix_time::microsec_clock::local_time() );
+		filter::correlate_rows_cols<rgba32f_pixel_t, std::allocator>( src, kernel, kernel, dst, typename View::point_t( 0, 0 ), filter::convolve_option_extend_mirror );
+		const double seconds = elapsedSeconds( start );
+
+		ImageMeasure measure;
+		measure._image = imageName;
+		measure._kernelSize = kernelSize;
+		measure._mpixelsPerSecond = width * height / std::max( seconds, 1e-9 ) * 1e-6;
+		measures.push_back( measure );
+
+		rgba32f_pixel_t p;
+		color_convert( dst( width / 2, height / 2 ), p );
+		sink += p[0];
+	}
+}
+
+void writeJson( std::ostream& os, const std::size_t width, const std::size_t height,
+                const std::vector<LineMeasure>& lines, const std::vector<ImageMeasure>& images )
+{
+	writeJsonHeader( os, "correlate", width, height );
+	os << "  \"line\": [\n";
+	for( std::size_t i = 0; i < lines.size(); ++i )
+	{
+		os << "    { \"pixel\": \"" << lines[i]._pixel << "\""
+		   << ", \"implementation\": \"" << lines[i]._implementation << "\""
+		   << ", \"kernelSize\": " << lines[i]._kernelSize
+		   << ", \"mpixelsPerSecond\": " << lines[i]._mpixelsPerSecond
+		   << " }" << ( i + 1 < lines.size() ? "," : "" ) << "\n";
+	}
+	os << "  ],\n"
+	   << "  \"image\": [\n";
+	for( std::size_t i = 0; i < images.size(); ++i )
+	{
+		os << "    { \"image\": \"" << images[i]._image << "\""
+		   << ", \"kernelSize\": " << images[i]._kernelSize
+		   << ", \"mpixelsPerSecond\": " << images[i]._mpixelsPerSecond
+		   << " }" << ( i + 1 < images.size() ? "," : "" ) << "\n";
+	}
+	os << "  ]\n"
+	   << "}\n";
+}
+
+}
+
+int main( int argc, char** argv )
+{
+	std::size_t width = 0;
+	std::size_t height = 0;
+	std::size_t nbRepeat = 0;
+	std::string outputFilename;
+
+	bpo::options_description options( "tuttle-benchmark-correlate options" );
+	options.add_options()
+		( "help,h", "display help" )
+		( "width", bpo::value<std::size_t>( &width )->default_value( 3840 ), "width of the lines and images" )
+		( "height", bpo::value<std::size_t>( &height )->default_value( 540 ), "height of the images" )
+		( "repeat,n", bpo::value<std::size_t>( &nbRepeat )->default_value( 500 ), "number of lines computed for each line measure" )
+		( "output,o", bpo::value<std::string>( &outputFilename ), "JSON output file (default: standard output)" );
+
+	bpo::variables_map vm;
+	try
+	{
+		bpo::store( bpo::parse_command_line( argc, argv, options ), vm );
+		bpo::notify( vm );
+	}
+	catch( const bpo::error& e )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-correlate: " << e.what() );
+		return 1;
+	}
+	if( vm.count( "help" ) )
+	{
+		TUTTLE_COUT( options );
+		return 0;
+	}
+
+	float sink = 0;
+	std::vector<LineMeasure> lines;
+	benchmarkLine<gray32f_pixel_t>( "gray32f", width, nbRepeat, lines, sink );
+	benchmarkLine<rgb32f_pixel_t>( "rgb32f", width, nbRepeat, lines, sink );
+	benchmarkLine<rgba32f_pixel_t>( "rgba32f", width, nbRepeat, lines, sink );
+
+	std::vector<ImageMeasure> images;
+	benchmarkImage<rgba32f_image_t>( "rgba32f", width, height, images, sink );
+	benchmarkImage<rgba32f_planar_image_t>( "rgba32f_planar", width, height, images, sink );
+	benchmarkImage<rgba16_image_t>( "rgba16", width, height, images, sink );
+	TUTTLE_LOG_TRACE( "checksum " << sink );
+
+	Output output( outputFilename );
+	writeJson( output.stream(), width, height, lines, images );
+	return 0;
+}
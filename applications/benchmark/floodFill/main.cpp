@@ -0,0 +1,205 @@
+/**
+ * @brief Benchmark of the terry flood fill on large binary masks.
+ *
+ * Compares the serial span fill (flood_fill) with the parallel union-find
+ * labelling (flood_fill_parallel), for several densities of the mask and the
+ * two connexities. The masks are random blobs, so the components cross many
+ * rows. Results are reported as JSON, in megapixels per second.
+ */
+#include <benchmark/common/benchmark.hpp>
+
+#include <terry/globals.hpp>
+#include <terry/filter/floodFill.hpp>
+
+#include <tuttle/common/utils/global.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/foreach.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bpo = boost::program_options;
+using namespace terry;
+using namespace benchmark;
+namespace floodFill = terry::filter::floodFill;
+
+namespace {
+
+/// proportion of the pixels of the mask over the soft threshold
+static const float kDensities[] = { 0.1f, 0.3f, 0.5f, 0.7f };
+
+/**
+ * @brief Binary mask of random blobs: 0 (background), 0.5 (soft) or 1 (strong).
+ * A coarse random grid is interpolated, then thresholded to the density.
+ * The border is background, so both implementations fill the same pixels.
+ */
+void buildMask( const gray32f_view_t& mask, const float density, const unsigned int seed )
+{
+	static const std::ptrdiff_t cell = 16;
+	const std::ptrdiff_t gridWidth = mask.width() / cell + 2;
+	const std::ptrdiff_t gridHeight = mask.height() / cell + 2;
+	std::vector<float> grid( gridWidth * gridHeight );
+	std::srand( seed );
+	for( std::size_t i = 0; i < grid.size(); ++i )
+		grid[i] = std::rand() / float( RAND_MAX );
+
+	for( std::ptrdiff_t y = 0; y < mask.height(); ++y )
+	{
+		const std::ptrdiff_t gy = y / cell;
+		const float fy = ( y % cell ) / float( cell );
+		gray32f_view_t::x_iterator it = mask.row_begin( y );
+		for( std::ptrdiff_t x = 0; x < mask.width(); ++x, ++it )
+		{
+			const std::ptrdiff_t gx = x / cell;
+			const float fx = ( x % cell ) / float( cell );
+			const float* g = &grid[gy * gridWidth + gx];
+			const float v = ( g[0] * ( 1 - fx ) + g[1] * fx ) * ( 1 - fy ) +
+			                ( g[gridWidth] * ( 1 - fx ) + g[gridWidth + 1] * fx ) * fy;
+			// the interpolated values are around 0.5, the density is approximate
+			const float soft = 1.0f - density;
+			const bool border = x == 0 || y == 0 || x == mask.width() - 1 || y == mask.height() - 1;
+			(*it)[0] = ( border || v < soft ) ? 0.0f : ( v > soft + ( 1.0f - soft ) * 0.5f ? 1.0f : 0.5f );
+		}
+	}
+}
+
+/// flood_fill_parallel on all the cores
+template<class Connexity, class StrongTest, class SoftTest, class SView, class DView, template<class> class Allocator>
+void flood_fill_all_cores( const SView& srcView, const Rect<std::ssize_t>& srcRod,
+                           DView& dstView, const Rect<std::ssize_t>& dstRod,
+                           const Rect<std::ssize_t>& procWindow,
+                           const StrongTest& strongTest, const SoftTest& softTest )
+{
+	floodFill::flood_fill_parallel<Connexity, StrongTest, SoftTest, SView, DView, Allocator>(
+		algorithm::thread_launcher(), srcView, srcRod, dstView, dstRod, procWindow, strongTest, softTest );
+}
+
+struct Measure
+{
+	std::string _implementation;
+	std::string _connexity;
+	float _density;
+	double _mpixelsPerSecond;
+	std::size_t _nbFilled;
+};
+
+std::size_t nbFilled( const gray32f_view_t& view )
+{
+	std::size_t n = 0;
+	for( std::ptrdiff_t y = 0; y < view.height(); ++y )
+	{
+		gray32f_view_t::x_iterator it = view.row_begin( y );
+		for( std::ptrdiff_t x = 0; x < view.width(); ++x, ++it )
+			n += ( (*it)[0] != 0 );
+	}
+	return n;
+}
+
+template<class Connexity>
+void benchmarkFloodFill( const std::string& connexityName, const gray32f_view_t& mask, const gray32f_view_t& dst,
+                         const float density, const std::size_t nbRepeat, std::vector<Measure>& measures )
+{
+	typedef floodFill::IsUpper<float> Test;
+	const Rect<std::ssize_t> rod( 0, 0, mask.width(), mask.height() );
+	const Rect<std::ssize_t> procWindow = rectangleReduce( rod, 1 );
+	gray32f_view_t dstView = dst;
+
+	Measure measure;
+	measure._connexity = connexityName;
+	measure._density = density;
+
+#define TERRY_BENCHMARK_FLOODFILL( NAME, FUNCTION ) \
+	{ \
+		double seconds = 0; \
+		for( std::size_t r = 0; r < nbRepeat; ++r ) \
+		{ \
+			boost::gil::fill_pixels( dstView, gray32f_pixel_t( 0 ) ); \
+			const boost::posix_time::ptime start( boost::posix_time::microsec_clock::local_time() ); \
+			FUNCTION<Connexity, Test, Test, gray32f_view_t, gray32f_view_t, std::allocator>( \
+				mask, rod, dstView, rod, procWindow, Test( 0.75f ), Test( 0.25f ) ); \
+			seconds += elapsedSeconds( start ); \
+		} \
+		measure._implementation = NAME; \
+		measure._mpixelsPerSecond = mask.width() * mask.height() * nbRepeat / std::max( seconds, 1e-9 ) * 1e-6; \
+		measure._nbFilled = nbFilled( dstView ); \
+		measures.push_back( measure ); \
+	}
+
+	TERRY_BENCHMARK_FLOODFILL( "serial", floodFill::flood_fill );
+	TERRY_BENCHMARK_FLOODFILL( "parallel", flood_fill_all_cores );
+
+#undef TERRY_BENCHMARK_FLOODFILL
+}
+
+void writeJson( std::ostream& os, const std::size_t width, const std::size_t height, const std::vector<Measure>& measures )
+{
+	writeJsonHeader( os, "floodFill", width, height );
+	os << "  \"measures\": [\n";
+	for( std::size_t i = 0; i < measures.size(); ++i )
+	{
+		os << "    { \"implementation\": \"" << measures[i]._implementation << "\""
+		   << ", \"connexity\": \"" << measures[i]._connexity << "\""
+		   << ", \"density\": " << measures[i]._density
+		   << ", \"mpixelsPerSecond\": " << measures[i]._mpixelsPerSecond
+		   << ", \"nbFilled\": " << measures[i]._nbFilled
+		   << " }" << ( i + 1 < measures.size() ? "," : "" ) << "\n";
+	}
+	os << "  ]\n"
+	   << "}\n";
+}
+
+}
+
+int main( int argc, char** argv )
+{
+	std::size_t width = 0;
+	std::size_t height = 0;
+	std::size_t nbRepeat = 0;
+	std::string outputFilename;
+
+	bpo::options_description options( "tuttle-benchmark-floodFill options" );
+	options.add_options()
+		( "help,h", "display help" )
+		( "width", bpo::value<std::size_t>( &width )->default_value( 4096 ), "width of the masks" )
+		( "height", bpo::value<std::size_t>( &height )->default_value( 2160 ), "height of the masks" )
+		( "repeat,n", bpo::value<std::size_t>( &nbRepeat )->default_value( 5 ), "number of fills for each measure" )
+		( "output,o", bpo::value<std::string>( &outputFilename ), "JSON output file (default: standard output)" );
+
+	bpo::variables_map vm;
+	try
+	{
+		bpo::store( bpo::parse_command_line( argc, argv, options ), vm );
+		bpo::notify( vm );
+	}
+	catch( const bpo::error& e )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-floodFill: " << e.what() );
+		return 1;
+	}
+	if( vm.count( "help" ) )
+	{
+		TUTTLE_COUT( options );
+		return 0;
+	}
+
+	gray32f_image_t maskImage( width, height );
+	gray32f_image_t dstImage( width, height );
+	const gray32f_view_t mask = view( maskImage );
+	const gray32f_view_t dst = view( dstImage );
+
+	std::vector<Measure> measures;
+	BOOST_FOREACH( const float density, kDensities )
+	{
+		buildMask( mask, density, 42 );
+		benchmarkFloodFill<floodFill::Connexity4>( "4", mask, dst, density, nbRepeat, measures );
+		benchmarkFloodFill<floodFill::Connexity8>( "8", mask, dst, density, nbRepeat, measures );
+	}
+
+	Output output( outputFilename );
+	writeJson( output.stream(), width, height, measures );
+	return 0;
+}
@@ -0,0 +1,381 @@
+/**
+ * @brief I/O benchmark of the reader and writer plugins.
+ *
+ * For each format configuration, a synthetic sequence is written from a generator,
+ * then read back, both through the host Graph API.
+ * Frames per second, MB/s (file size on disk) and peak RSS are reported as JSON,
+ * to track the performances of the readers/writers over time.
+ */
+#include <benchmark/common/graph.hpp>
+
+#include <tuttle/common/utils/global.hpp>
+#include <tuttle/host/Graph.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/foreach.hpp>
+#include <boost/cstdint.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace tuttle::host;
+using namespace benchmark;
+namespace bfs = boost::filesystem;
+namespace bpo = boost::program_options;
+
+namespace {
+
+typedef std::vector< std::pair<std::string, std::string> > ParamList;
+
+/**
+ * @brief A format configuration to benchmark.
+ */
+struct BenchmarkCase
+{
+	BenchmarkCase( const std::string& name, const std::string& extension,
+	               const std::string& reader, const std::string& writer )
+	: _name( name )
+	, _extension( extension )
+	, _reader( reader )
+	, _writer( writer )
+	{}
+
+	BenchmarkCase& param( const std::string& name, const std::string& value )
+	{
+		_writerParams.push_back( std::make_pair( name, value ) );
+		return *this;
+	}
+
+	std::string _name;
+	std::string _extension;
+	std::string _reader;
+	std::string _writer;
+	ParamList _writerParams;
+};
+
+struct Measure
+{
+	Measure()
+	: _seconds( 0 )
+	, _peakRssKB( 0 )
+	{}
+
+	double _seconds;
+	std::size_t _peakRssKB;
+};
+
+struct BenchmarkResult
+{
+	BenchmarkResult()
+	: _fileBytes( 0 )
+	{}
+
+	Measure _write;
+	Measure _read;
+	boost::uintmax_t _fileBytes;
+	std::string _error;
+};
+
+std::vector<BenchmarkCase> getBenchmarkCases()
+{
+	std::vector<BenchmarkCase> cases;
+	cases.push_back( BenchmarkCase( "dpx-10i", "dpx", "tuttle.dpxreader", "tuttle.dpxwriter" ).param( "bitDepth", "10i" ) );
+	cases.push_back( BenchmarkCase( "dpx-16i", "dpx", "tuttle.dpxreader", "tuttle.dpxwriter" ).param( "bitDepth", "16i" ) );
+
+	const char* exrCompressions[] = { "None", "RLE", "ZIP", "PIZ", "B44" };
+	BOOST_FOREACH( const char* compression, exrCompressions )
+	{
+		cases.push_back( BenchmarkCase( std::string( "exr-16f-" ) + compression, "exr", "tuttle.exrreader", "tuttle.exrwriter" )
+			.param( "bitDepth", "16f" ).param( "fileBitDepth", "16f" ).param( "compression", compression ) );
+	}
+	BOOST_FOREACH( const char* compression, exrCompressions )
+	{
+		if( std::string( compression ) == "B44" ) // B44 only compresses half channels
+			continue;
+		cases.push_back( BenchmarkCase( std::string( "exr-32f-" ) + compression, "exr", "tuttle.exrreader", "tuttle.exrwriter" )
+			.param( "bitDepth", "32f" ).param( "fileBitDepth", "32f" ).param( "compression", compression ) );
+	}
+
+	cases.push_back( BenchmarkCase( "png-8i", "png", "tuttle.pngreader", "tuttle.pngwriter" ).param( "bitDepth", "8i" ) );
+	cases.push_back( BenchmarkCase( "png-16i", "png", "tuttle.pngreader", "tuttle.pngwriter" ).param( "bitDepth", "16i" ) );
+	cases.push_back( BenchmarkCase( "jpeg", "jpg", "tuttle.jpegreader", "tuttle.jpegwriter" ) );
+	cases.push_back( BenchmarkCase( "turbojpeg", "jpg", "tuttle.turbojpegreader", "tuttle.turbojpegwriter" ) );
+	cases.push_back( BenchmarkCase( "jpeg2000", "j2k", "tuttle.jpeg2000reader", "tuttle.jpeg2000writer" ) );
+	return cases;
+}
+
+/**
+ * @brief Reset the peak resident set size of the process (Linux only).
+ * On other systems the peak is the one of the whole process.
+ */
+void resetPeakRss()
+{
+	std::ofstream clearRefs( "/proc/self/clear_refs" );
+	if( clearRefs )
+		clearRefs << "5";
+}
+
+/// @return the peak resident set size in KB
+std::size_t getPeakRssKB()
+{
+	std::ifstream status( "/proc/self/status" );
+	std::string line;
+	while( std::getline( status, line ) )
+	{
+		if( line.compare( 0, 6, "VmHWM:" ) == 0 )
+		{
+			std::istringstream iss( line.substr( 6 ) );
+			std::size_t value = 0;
+			iss >> value;
+			return value;
+		}
+	}
+	struct rusage usage;
+	getrusage( RUSAGE_SELF, &usage );
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024; // in bytes on macos
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * @brief Time the computation of @p node on all the frames.
+ */
+Measure computeSequence( Graph& graph, Graph::Node& node, const int nbFrames )
+{
+	resetPeakRss();
+	Measure measure;
+	measure._seconds = computeSeconds( graph, node, nbFrames );
+	measure._peakRssKB = getPeakRssKB();
+	return measure;
+}
+
+boost::uintmax_t sequenceFileSize( const bfs::path& directory, const std::string& prefix )
+{
+	boost::uintmax_t size = 0;
+	for( bfs::directory_iterator it( directory ), itEnd; it != itEnd; ++it )
+	{
+		if( it->path().filename().string().compare( 0, prefix.size(), prefix ) == 0 )
+			size += bfs::file_size( it->path() );
+	}
+	return size;
+}
+
+void removeSequence( const bfs::path& directory, const std::string& prefix )
+{
+	std::vector<bfs::path> files;
+	for( bfs::directory_iterator it( directory ), itEnd; it != itEnd; ++it )
+	{
+		if( it->path().filename().string().compare( 0, prefix.size(), prefix ) == 0 )
+			files.push_back( it->path() );
+	}
+	BOOST_FOREACH( const bfs::path& file, files )
+	{
+		bfs::remove( file );
+	}
+}
+
+BenchmarkResult benchmarkCase( const BenchmarkCase& benchCase, const bfs::path& directory,
+                               const int width, const int height, const int nbFrames, const bool keepFiles )
+{
+	BenchmarkResult result;
+	const std::string prefix = "benchmark-" + benchCase._name + ".";
+	const std::string sequence = ( directory / ( prefix + "####." + benchCase._extension ) ).string();
+
+	try
+	{
+		{
+			Graph graph;
+			Graph::Node& generator = graph.createNode( "tuttle.colorgradient" );
+			Graph::Node& writer    = graph.createNode( benchCase._writer );
+			setupGenerator( generator, width, height );
+			writer.getParam( "filename" ).setValue( sequence );
+			BOOST_FOREACH( const ParamList::value_type& param, benchCase._writerParams )
+			{
+				writer.getParam( param.first ).setValue( param.second );
+			}
+			graph.connect( generator, writer );
+			result._write = computeSequence( graph, writer, nbFrames );
+		}
+		result._fileBytes = sequenceFileSize( directory, prefix );
+		{
+			Graph graph;
+			Graph::Node& reader = graph.createNode( benchCase._reader );
+			reader.getParam( "filename" ).setValue( sequence );
+			result._read = computeSequence( graph, reader, nbFrames );
+		}
+	}
+	catch( ... )
+	{
+		result._error = boost::current_exception_diagnostic_information();
+	}
+
+	if( ! keepFiles )
+		removeSequence( directory, prefix );
+	return result;
+}
+
+void writeJsonMeasure( std::ostream& os, const std::string& name, const Measure& measure,
+                       const double sourceSeconds, const int nbFrames, const boost::uintmax_t fileBytes )
+{
+	// the writer time includes the generation of the images, which is measured alone
+	const double seconds = std::max( measure._seconds - sourceSeconds, 1e-6 );
+	os << "      " << jsonString( name ) << ": {"
+	   << " \"seconds\": " << measure._seconds
+	   << ", \"fps\": " << nbFrames / seconds
+	   << ", \"mbPerSecond\": " << fileBytes / ( 1024.0 * 1024.0 ) / seconds
+	   << ", \"peakRssKB\": " << measure._peakRssKB
+	   << " }";
+}
+
+void writeJson( std::ostream& os, const int width, const int height, const int nbFrames, const double sourceSeconds,
+                const std::vector<BenchmarkCase>& cases, const std::vector<BenchmarkResult>& results )
+{
+	writeJsonHeader( os, "io", width, height );
+	os << "  \"frames\": " << nbFrames << ",\n"
+	   << "  \"source\": { \"plugin\": \"tuttle.colorgradient\", \"seconds\": " << sourceSeconds << " },\n"
+	   << "  \"results\": [\n";
+	for( std::size_t i = 0; i < cases.size(); ++i )
+	{
+		const BenchmarkCase& benchCase = cases[i];
+		const BenchmarkResult& result = results[i];
+		os << "    {\n"
+		   << "      \"name\": " << jsonString( benchCase._name ) << ",\n"
+		   << "      \"reader\": " << jsonString( benchCase._reader ) << ",\n"
+		   << "      \"writer\": " << jsonString( benchCase._writer ) << ",\n"
+		   << "      \"params\": {";
+		for( std::size_t p = 0; p < benchCase._writerParams.size(); ++p )
+		{
+			os << ( p ? ", " : " " ) << jsonString( benchCase._writerParams[p].first ) << ": " << jsonString( benchCase._writerParams[p].second );
+		}
+		os << ( benchCase._writerParams.empty() ? "},\n" : " },\n" );
+		if( ! result._error.empty() )
+		{
+			os << "      \"error\": " << jsonString( result._error ) << "\n";
+		}
+		else
+		{
+			os << "      \"fileSizeMB\": " << result._fileBytes / ( 1024.0 * 1024.0 ) << ",\n";
+			writeJsonMeasure( os, "write", result._write, sourceSeconds, nbFrames, result._fileBytes );
+			os << ",\n";
+			writeJsonMeasure( os, "read", result._read, 0, nbFrames, result._fileBytes );
+			os << "\n";
+		}
+		os << "    }" << ( i + 1 < cases.size() ? "," : "" ) << "\n";
+	}
+	os << "  ]\n"
+	   << "}\n";
+}
+
+}
+
+int main( int argc, char** argv )
+{
+	boost::shared_ptr<tuttle::common::Formatter> formatter( tuttle::common::Formatter::get() );
+	formatter->setLogLevel( boost::log::trivial::warning );
+
+	int width = 0;
+	int height = 0;
+	int nbFrames = 0;
+	std::string outputFilename;
+	std::string directoryName;
+	std::string filter;
+
+	bpo::options_description options( "tuttle-benchmark-io options" );
+	options.add_options()
+		( "help,h", "display help" )
+		( "width", bpo::value<int>( &width )->default_value( 2048 ), "width of the images" )
+		( "height", bpo::value<int>( &height )->default_value( 1556 ), "height of the images" )
+		( "frames,n", bpo::value<int>( &nbFrames )->default_value( 24 ), "number of frames of each sequence" )
+		( "directory,d", bpo::value<std::string>( &directoryName )->default_value( bfs::temp_directory_path().string() ), "directory of the generated sequences (a local disk)" )
+		( "output,o", bpo::value<std::string>( &outputFilename ), "JSON output file (default: standard output)" )
+		( "filter,f", bpo::value<std::string>( &filter ), "comma separated names of the cases to run (default: all)" )
+		( "list,l", "list the benchmark cases" )
+		( "keep,k", "keep the generated sequences" );
+
+	bpo::variables_map vm;
+	try
+	{
+		bpo::store( bpo::parse_command_line( argc, argv, options ), vm );
+		bpo::notify( vm );
+	}
+	catch( const bpo::error& e )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-io: " << e.what() );
+		return 1;
+	}
+
+	if( vm.count( "help" ) )
+	{
+		TUTTLE_COUT( options );
+		return 0;
+	}
+
+	std::vector<BenchmarkCase> cases = getBenchmarkCases();
+	if( vm.count( "list" ) )
+	{
+		BOOST_FOREACH( const BenchmarkCase& benchCase, cases )
+		{
+			TUTTLE_COUT( benchCase._name );
+		}
+		return 0;
+	}
+	if( ! filter.empty() )
+	{
+		std::vector<std::string> names;
+		boost::algorithm::split( names, filter, boost::algorithm::is_any_of( "," ) );
+		std::vector<BenchmarkCase> filteredCases;
+		BOOST_FOREACH( const BenchmarkCase& benchCase, cases )
+		{
+			if( std::find( names.begin(), names.end(), benchCase._name ) != names.end() )
+				filteredCases.push_back( benchCase );
+		}
+		cases.swap( filteredCases );
+	}
+	if( width <= 0 || height <= 0 || nbFrames <= 0 )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-io: width, height and frames must be positive." );
+		return 1;
+	}
+
+	try
+	{
+		const bfs::path directory( directoryName );
+		bfs::create_directories( directory );
+
+		core().preload();
+
+		TUTTLE_LOG_INFO( "[benchmark io] source " << width << "x" << height << ", " << nbFrames << " frames" );
+		const double sourceSeconds = benchmarkSource( width, height, nbFrames );
+
+		std::vector<BenchmarkResult> results;
+		BOOST_FOREACH( const BenchmarkCase& benchCase, cases )
+		{
+			TUTTLE_LOG_INFO( "[benchmark io] " << benchCase._name );
+			results.push_back( benchmarkCase( benchCase, directory, width, height, nbFrames, vm.count( "keep" ) ) );
+			if( ! results.back()._error.empty() )
+				TUTTLE_LOG_WARNING( "[benchmark io] " << benchCase._name << " failed: " << results.back()._error );
+		}
+
+		Output output( outputFilename );
+		writeJson( output.stream(), width, height, nbFrames, sourceSeconds, cases, results );
+	}
+	catch( ... )
+	{
+		TUTTLE_LOG_ERROR( "tuttle-benchmark-io: " << boost::current_exception_diagnostic_information() );
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,330 @@
+#ifndef _TERRY_ALGORITHM_PARALLEL_REDUCE_HPP_
+#define _TERRY_ALGORITHM_PARALLEL_REDUCE_HPP_
+
+#include <boost/gil/gil_config.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace terry {
+namespace algorithm {
+
+/// Maximum number of partial results of a reduction.
+static const std::ptrdiff_t parallel_reduce_max_nb_chunks = 64;
+
+/// Progress which never aborts, for the reductions without progress.
+struct no_progress
+{
+	bool progressForward( const int ) { return false; }
+};
+
+/**
+ * @brief Thrown by the parallel algorithms when their progress asks to abort,
+ * so a partial result is never returned.
+ */
+struct parallel_aborted : public std::exception
+{
+	const char* what() const throw() { return "terry: parallel computation aborted"; }
+};
+
+/**
+ * @brief Launcher running the workers on the calling thread only.
+ *
+ * Launcher concept, to run the parallel algorithms on the threads of the caller:
+ * @code
+ * // call worker() on each thread of the launcher, and return when they have all returned
+ * template<class Worker> void operator()( Worker& worker ) const;
+ * @endcode
+ * The workers share the rows between them, so a launcher can run any number of them.
+ * The plugins use tuttle::plugin::OfxMultiThreadLauncher, on the threads of the host.
+ */
+struct serial_launcher
+{
+	template<class Worker>
+	void operator()( Worker& worker ) const { worker(); }
+};
+
+namespace detail {
+
+template<class Worker>
+struct worker_ref
+{
+	Worker* _worker;
+	explicit worker_ref( Worker& worker ) : _worker( &worker ) {}
+	void operator()() { ( *_worker )(); }
+};
+
+}
+
+/**
+ * @brief Launcher creating its own threads, for the applications and the tests
+ * which are not run by a host.
+ */
+class thread_launcher
+{
+public:
+	/// @param nbThreads 0 for the number of cores
+	explicit thread_launcher( const unsigned int nbThreads = 0 )
+	: _nbThreads( nbThreads ? nbThreads : std::max( boost::thread::hardware_concurrency(), 1u ) )
+	{}
+
+	template<class Worker>
+	void operator()( Worker& worker ) const
+	{
+		boost::thread_group threads;
+		for( unsigned int i = 1; i < _nbThreads; ++i )
+			threads.create_thread( detail::worker_ref<Worker>( worker ) );
+		worker(); // the calling thread also works
+		threads.join_all();
+	}
+
+private:
+	unsigned int _nbThreads;
+};
+
+namespace detail {
+
+template<class Reducer, class Progress>
+class parallel_reduce_rows_imp
+{
+public:
+	parallel_reduce_rows_imp( const std::ptrdiff_t height, const std::ptrdiff_t nbChunks, const Reducer& init,
+	                          Progress& progress, const std::ptrdiff_t stepsPerRow )
+	: _height( height )
+	, _nbChunks( nbChunks )
+	, _nextChunk( 0 )
+	, _partials( nbChunks, init )
+	, _progress( progress )
+	, _stepsPerRow( stepsPerRow )
+	, _aborted( false )
+	{}
+
+	/// Reduce the next chunks until there is no more chunk, each chunk in its own partial result.
+	void operator()()
+	{
+		try
+		{
+			for(;;)
+			{
+				std::ptrdiff_t chunk;
+				{
+					boost::mutex::scoped_lock lock( _mutex );
+					if( _aborted || _nextChunk == _nbChunks )
+						return;
+					chunk = _nextChunk++;
+				}
+				const std::ptrdiff_t yBegin = chunk * _height / _nbChunks;
+				const std::ptrdiff_t yEnd = ( chunk + 1 ) * _height / _nbChunks;
+				Reducer& reducer = _partials[chunk];
+				for( std::ptrdiff_t y = yBegin; y < yEnd; ++y )
+					reducer( y );
+
+				boost::mutex::scoped_lock lock( _mutex );
+				if( _progress.progressForward( static_cast<int>( ( yEnd - yBegin ) * _stepsPerRow ) ) )
+					_aborted = true;
+			}
+		}
+		catch( ... )
+		{
+			boost::mutex::scoped_lock lock( _mutex );
+			if( ! _exception )
+				_exception = boost::current_exception();
+			_aborted = true;
+		}
+	}
+
+	/// Merge the partial results in the order of the rows.
+	Reducer result()
+	{
+		if( _exception )
+			boost::rethrow_exception( _exception );
+		if( _aborted || _nextChunk != _nbChunks )
+			throw parallel_aborted();
+		Reducer result( _partials.front() );
+		for( std::size_t i = 1; i < _partials.size(); ++i )
+			result.merge( _partials[i] );
+		return result;
+	}
+
+private:
+	const std::ptrdiff_t _height;
+	const std::ptrdiff_t _nbChunks;
+	std::ptrdiff_t _nextChunk;
+	std::vector<Reducer> _partials;
+	Progress& _progress;
+	const std::ptrdiff_t _stepsPerRow;
+	bool _aborted;
+	boost::exception_ptr _exception;
+	boost::mutex _mutex;
+};
+
+template<class View, class PixelReducer>
+struct pixels_reducer
+{
+	View _view;
+	PixelReducer _reducer;
+
+	pixels_reducer( const View& view, const PixelReducer& reducer )
+	: _view( view )
+	, _reducer( reducer )
+	{}
+
+	GIL_FORCEINLINE
+	void operator()( const std::ptrdiff_t y )
+	{
+		typename View::x_iterator it = _view.row_begin( y );
+		for( std::ptrdiff_t x = 0; x < _view.width(); ++x )
+			_reducer( it[x] );
+	}
+
+	void merge( const pixels_reducer& other ) { _reducer.merge( other._reducer ); }
+};
+
+template<class View1, class View2, class PixelReducer>
+struct pixels_pair_reducer
+{
+	View1 _view1;
+	View2 _view2;
+	PixelReducer _reducer;
+
+	pixels_pair_reducer( const View1& view1, const View2& view2, const PixelReducer& reducer )
+	: _view1( view1 )
+	, _view2( view2 )
+	, _reducer( reducer )
+	{}
+
+	GIL_FORCEINLINE
+	void operator()( const std::ptrdiff_t y )
+	{
+		typename View1::x_iterator it1 = _view1.row_begin( y );
+		typename View2::x_iterator it2 = _view2.row_begin( y );
+		for( std::ptrdiff_t x = 0; x < _view1.width(); ++x )
+			_reducer( it1[x], it2[x] );
+	}
+
+	void merge( const pixels_pair_reducer& other ) { _reducer.merge( other._reducer ); }
+};
+
+template<class RowFunctor>
+struct rows_for_each
+{
+	RowFunctor _functor;
+
+	rows_for_each( const RowFunctor& functor )
+	: _functor( functor )
+	{}
+
+	GIL_FORCEINLINE
+	void operator()( const std::ptrdiff_t y ) { _functor( y ); }
+
+	void merge( const rows_for_each& ) {}
+};
+
+}
+
+/**
+ * @brief Reduction of the rows [0, height[ on the threads of @p launcher.
+ *
+ * The rows are split in contiguous chunks, each chunk is reduced in its own
+ * copy of @p init by the first free thread, then the partial results are
+ * merged in the order of the rows. The chunks only depend on the height,
+ * so the result doesn't depend on the number of threads or on the
+ * scheduling (the floating point sums are reproducible).
+ *
+ * Reducer concept:
+ * @code
+ * Reducer( const Reducer& );                 // copy of the initial state
+ * void operator()( const std::ptrdiff_t y ); // accumulate the row y
+ * void merge( const Reducer& next );         // accumulate the result of the next rows
+ * @endcode
+ *
+ * @param launcher runs the workers (see serial_launcher)
+ * @param progress object with a progressForward( nbSteps ) method, returning true to abort
+ *        (like tuttle::plugin::IProgress). It is called by one thread at a time.
+ * @param stepsPerRow number of progress steps of each row (the width to count pixels)
+ * @param grain minimal number of rows of a chunk
+ * @throw parallel_aborted if the progress has aborted the reduction
+ */
+template<class Launcher, class Reducer, class Progress>
+Reducer parallel_reduce_rows( const Launcher& launcher, const std::ptrdiff_t height, const Reducer& init, Progress& progress,
+                              const std::ptrdiff_t stepsPerRow = 1, const std::ptrdiff_t grain = 16 )
+{
+	if( height <= 0 )
+		return init;
+	const std::ptrdiff_t nbChunks = std::min( ( height + grain - 1 ) / grain, parallel_reduce_max_nb_chunks );
+
+	typedef detail::parallel_reduce_rows_imp<Reducer, Progress> Imp;
+	Imp imp( height, nbChunks, init, progress, stepsPerRow );
+	if( nbChunks == 1 )
+		imp();
+	else
+		launcher( imp );
+	return imp.result();
+}
+
+template<class Launcher, class Reducer>
+Reducer parallel_reduce_rows( const Launcher& launcher, const std::ptrdiff_t height, const Reducer& init )
+{
+	no_progress progress;
+	return parallel_reduce_rows( launcher, height, init, progress );
+}
+
+/**
+ * @brief Call @p functor( y ) for each row y of [0, height[ on the threads of @p launcher,
+ * with the same chunks of rows as parallel_reduce_rows.
+ * Each chunk works on its own copy of @p functor.
+ * @param grain minimal number of rows of a chunk
+ */
+template<class Launcher, class RowFunctor>
+void parallel_for_rows( const Launcher& launcher, const std::ptrdiff_t height, const RowFunctor& functor, const std::ptrdiff_t grain = 16 )
+{
+	no_progress progress;
+	parallel_reduce_rows( launcher, height, detail::rows_for_each<RowFunctor>( functor ), progress, 1, grain );
+}
+
+/**
+ * @brief Parallel reduction of the pixels of a view.
+ *
+ * PixelReducer concept: void operator()( const Pixel& ) and void merge( const PixelReducer& ).
+ * @throw parallel_aborted if the progress has aborted the reduction
+ */
+template<class Launcher, class View, class PixelReducer, class Progress>
+PixelReducer parallel_reduce_pixels( const Launcher& launcher, const View& view, const PixelReducer& init, Progress& progress )
+{
+	const detail::pixels_reducer<View, PixelReducer> rows( view, init );
+	return parallel_reduce_rows( launcher, view.height(), rows, progress, view.width() )._reducer;
+}
+
+template<class Launcher, class View, class PixelReducer>
+PixelReducer parallel_reduce_pixels( const Launcher& launcher, const View& view, const PixelReducer& init )
+{
+	no_progress progress;
+	return parallel_reduce_pixels( launcher, view, init, progress );
+}
+
+/**
+ * @brief Parallel reduction of the pixels of two views of the same dimensions.
+ *
+ * PixelReducer concept: void operator()( const Pixel1&, const Pixel2& ) and void merge( const PixelReducer& ).
+ * @throw parallel_aborted if the progress has aborted the reduction
+ */
+template<class Launcher, class View1, class View2, class PixelReducer, class Progress>
+PixelReducer parallel_reduce_pixels( const Launcher& launcher, const View1& view1, const View2& view2, const PixelReducer& init, Progress& progress )
+{
+	assert( view1.dimensions() == view2.dimensions() );
+	const detail::pixels_pair_reducer<View1, View2, PixelReducer> rows( view1, view2, init );
+	return parallel_reduce_rows( launcher, view1.height(), rows, progress, view1.width() )._reducer;
+}
+
+}
+}
+
+#endif
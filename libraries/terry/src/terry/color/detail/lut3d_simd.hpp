@@ -0,0 +1,262 @@
+#ifndef _TERRY_COLOR_DETAIL_LUT3D_SIMD_HPP_
+#define _TERRY_COLOR_DETAIL_LUT3D_SIMD_HPP_
+
+/**
+ * @file
+ * @brief Tetrahedral interpolation of a 3D LUT on lines of float pixels,
+ * with a runtime dispatch on the cpu features.
+ *
+ * The nodes of the LUT are stored with 4 floats (rgb and a padding), so the
+ * SSE2 version loads each of the 4 nodes of the tetrahedron in one register
+ * and interpolates the 3 channels at once. It computes the tetrahedra and
+ * the weights of 4 pixels at once.
+ * Define TERRY_DISABLE_SIMD to always use the generic interpolation.
+ */
+
+#include <algorithm>
+#include <cstddef>
+
+#if ! defined(TERRY_DISABLE_SIMD) && ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+ #define TERRY_COLOR_SIMD_X86 1
+ #include <emmintrin.h>
+#endif
+
+namespace terry {
+namespace color {
+namespace detail {
+
+/**
+ * @brief Nodes and weights of the tetrahedron which contains the point (r, g, b).
+ * @param rgb coordinates in [0, 1] (clamped)
+ * @param size number of nodes on each axis of the LUT
+ * @param[out] offsets offsets (in floats) of the 4 nodes in the table
+ * @param[out] weights weights of the 4 nodes
+ */
+inline void lut3d_tetrahedron( const float* rgb, const std::size_t size, std::size_t* offsets, float* weights )
+{
+	const float last = float( size - 1 );
+	float f[3];
+	std::size_t i[3];
+	for( int c = 0; c < 3; ++c )
+	{
+		// written to also send the NaN values on the first node
+		const float v = rgb[c] > 0.0f ? ( rgb[c] < 1.0f ? rgb[c] * last : last ) : 0.0f;
+		i[c] = std::min( static_cast<std::size_t>( v ), size - 2 );
+		f[c] = v - i[c];
+	}
+	const std::size_t sr = size * size * 4;
+	const std::size_t sg = size * 4;
+	const std::size_t sb = 4;
+	const std::size_t base = i[0] * sr + i[1] * sg + i[2] * sb;
+	const float dr = f[0], dg = f[1], db = f[2];
+
+	offsets[0] = base;
+	offsets[3] = base + sr + sg + sb;
+	if( dr >= dg )
+	{
+		if( dg >= db )
+		{
+			offsets[1] = base + sr; offsets[2] = base + sr + sg;
+			weights[0] = 1.0f - dr; weights[1] = dr - dg; weights[2] = dg - db; weights[3] = db;
+		}
+		else if( dr >= db )
+		{
+			offsets[1] = base + sr; offsets[2] = base + sr + sb;
+			weights[0] = 1.0f - dr; weights[1] = dr - db; weights[2] = db - dg; weights[3] = dg;
+		}
+		else
+		{
+			offsets[1] = base + sb; offsets[2] = base + sr + sb;
+			weights[0] = 1.0f - db; weights[1] = db - dr; weights[2] = dr - dg; weights[3] = dg;
+		}
+	}
+	else
+	{
+		if( db >= dg )
+		{
+			offsets[1] = base + sb; offsets[2] = base + sg + sb;
+			weights[0] = 1.0f - db; weights[1] = db - dg; weights[2] = dg - dr; weights[3] = dr;
+		}
+		else if( db >= dr )
+		{
+			offsets[1] = base + sg; offsets[2] = base + sg + sb;
+			weights[0] = 1.0f - dg; weights[1] = dg - db; weights[2] = db - dr; weights[3] = dr;
+		}
+		else
+		{
+			offsets[1] = base + sg; offsets[2] = base + sr + sg;
+			weights[0] = 1.0f - dg; weights[1] = dg - dr; weights[2] = dr - db; weights[3] = db;
+		}
+	}
+}
+
+/**
+ * @brief Interpolation of n pixels.
+ * @param table nodes of the LUT, 4 floats per node, blue varies the fastest
+ * @param src grid coordinates in [0, 1] of the first pixel, srcStep floats between two pixels
+ * @param dst rgb result of the first pixel, dstStep floats between two pixels (src and dst can be the same)
+ */
+inline void lut3d_tetrahedral_floats_generic( const float* table, const std::size_t size,
+                                              const float* src, const std::size_t srcStep,
+                                              float* dst, const std::size_t dstStep, const std::size_t n )
+{
+	std::size_t offsets[4];
+	float weights[4];
+	for( std::size_t i = 0; i < n; ++i, src += srcStep, dst += dstStep )
+	{
+		lut3d_tetrahedron( src, size, offsets, weights );
+		const float* p0 = table + offsets[0];
+		const float* p1 = table + offsets[1];
+		const float* p2 = table + offsets[2];
+		const float* p3 = table + offsets[3];
+		for( int c = 0; c < 3; ++c )
+			dst[c] = weights[0] * p0[c] + weights[1] * p1[c] + weights[2] * p2[c] + weights[3] * p3[c];
+	}
+}
+
+#ifdef TERRY_COLOR_SIMD_X86
+
+/// Weighted sum of the 4 nodes of one tetrahedron, only 3 floats of dst are written.
+__attribute__((target("sse2")))
+inline void lut3d_tetrahedron_sum_sse2( const float* table, const int* offsets, const float* weights, float* dst )
+{
+	float res[4];
+	__m128 acc = _mm_mul_ps( _mm_set1_ps( weights[0] ), _mm_loadu_ps( table + offsets[0] ) );
+	acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( weights[1] ), _mm_loadu_ps( table + offsets[1] ) ) );
+	acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( weights[2] ), _mm_loadu_ps( table + offsets[2] ) ) );
+	acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( weights[3] ), _mm_loadu_ps( table + offsets[3] ) ) );
+	// the fourth float of dst may be the next pixel
+	_mm_storeu_ps( res, acc );
+	dst[0] = res[0];
+	dst[1] = res[1];
+	dst[2] = res[2];
+}
+
+/// (a & mask) | (b & ~mask)
+__attribute__((target("sse2")))
+inline __m128i lut3d_select_sse2( const __m128i mask, const __m128i a, const __m128i b )
+{
+	return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+}
+
+/**
+ * @brief Interpolation of n pixels, the tetrahedra of 4 pixels are computed at once.
+ *
+ * The fractional parts are sorted without branches: the weights are
+ * (1 - max, max - mid, mid - min, min), and the path goes from the first node
+ * along the axis of max, then along the axis of mid.
+ * When fractional parts are equal, the choice of the axis doesn't change the result
+ * (the weight of the node is 0).
+ * The LUT must have less than 2^24 nodes (size <= 256).
+ */
+__attribute__((target("sse2")))
+inline void lut3d_tetrahedral_floats_sse2( const float* table, const std::size_t size,
+                                           const float* src, const std::size_t srcStep,
+                                           float* dst, const std::size_t dstStep, const std::size_t n )
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 fsize = _mm_set1_ps( float( size ) );
+	const __m128 last = _mm_set1_ps( float( size - 1 ) );
+	const __m128 lastCell = _mm_set1_ps( float( size - 2 ) );
+	const __m128i sr = _mm_set1_epi32( int( size * size * 4 ) );
+	const __m128i sg = _mm_set1_epi32( int( size * 4 ) );
+	const __m128i sb = _mm_set1_epi32( 4 );
+	const __m128i sAll = _mm_add_epi32( sr, _mm_add_epi32( sg, sb ) );
+
+	int offsets[4][4]; // [node][pixel]
+	float weights[4][4];
+	int pixelOffsets[4];
+	float pixelWeights[4];
+
+	std::size_t i = 0;
+	for( ; i + 4 <= n; i += 4 )
+	{
+		const float* s = src + i * srcStep;
+		__m128 cell[3];
+		__m128 v[3];
+		for( int c = 0; c < 3; ++c )
+		{
+			const __m128 x = _mm_set_ps( s[3 * srcStep + c], s[2 * srcStep + c], s[srcStep + c], s[c] );
+			// max( x, 0 ) returns 0 for NaN, like the generic version
+			const __m128 clamped = _mm_min_ps( _mm_max_ps( x, zero ), one );
+			const __m128 pos = _mm_mul_ps( clamped, last );
+			cell[c] = _mm_min_ps( _mm_cvtepi32_ps( _mm_cvttps_epi32( pos ) ), lastCell );
+			v[c] = _mm_sub_ps( pos, cell[c] );
+		}
+		// index of the first node, exact in float with less than 2^24 nodes
+		const __m128 node = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( cell[0], fsize ), cell[1] ), fsize ), cell[2] );
+		const __m128i base = _mm_slli_epi32( _mm_cvttps_epi32( node ), 2 );
+
+		const __m128 dr = v[0], dg = v[1], db = v[2];
+		const __m128 vMax = _mm_max_ps( dr, _mm_max_ps( dg, db ) );
+		const __m128 vMin = _mm_min_ps( dr, _mm_min_ps( dg, db ) );
+		const __m128 vMid = _mm_max_ps( _mm_min_ps( dr, dg ), _mm_min_ps( _mm_max_ps( dr, dg ), db ) );
+
+		// axis of the max and axis of the min, always 2 different axes
+		const __m128i rIsMax = _mm_castps_si128( _mm_and_ps( _mm_cmpge_ps( dr, dg ), _mm_cmpge_ps( dr, db ) ) );
+		const __m128i gIsMax = _mm_castps_si128( _mm_cmpge_ps( dg, db ) );
+		const __m128i strideMax = lut3d_select_sse2( rIsMax, sr, lut3d_select_sse2( gIsMax, sg, sb ) );
+		const __m128i rIsMin = _mm_castps_si128( _mm_and_ps( _mm_cmplt_ps( dr, dg ), _mm_cmplt_ps( dr, db ) ) );
+		const __m128i gIsMin = _mm_castps_si128( _mm_cmplt_ps( dg, db ) );
+		const __m128i strideMin = lut3d_select_sse2( rIsMin, sr, lut3d_select_sse2( gIsMin, sg, sb ) );
+
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( offsets[0] ), base );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( offsets[1] ), _mm_add_epi32( base, strideMax ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( offsets[2] ), _mm_sub_epi32( _mm_add_epi32( base, sAll ), strideMin ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( offsets[3] ), _mm_add_epi32( base, sAll ) );
+		_mm_storeu_ps( weights[0], _mm_sub_ps( one, vMax ) );
+		_mm_storeu_ps( weights[1], _mm_sub_ps( vMax, vMid ) );
+		_mm_storeu_ps( weights[2], _mm_sub_ps( vMid, vMin ) );
+		_mm_storeu_ps( weights[3], vMin );
+
+		// all the inputs are read before the first output, so src and dst can be the same
+		for( int p = 0; p < 4; ++p )
+		{
+			for( int k = 0; k < 4; ++k )
+			{
+				pixelOffsets[k] = offsets[k][p];
+				pixelWeights[k] = weights[k][p];
+			}
+			lut3d_tetrahedron_sum_sse2( table, pixelOffsets, pixelWeights, dst + ( i + p ) * dstStep );
+		}
+	}
+	std::size_t tailOffsets[4];
+	for( ; i < n; ++i )
+	{
+		lut3d_tetrahedron( src + i * srcStep, size, tailOffsets, pixelWeights );
+		for( int k = 0; k < 4; ++k )
+			pixelOffsets[k] = int( tailOffsets[k] );
+		lut3d_tetrahedron_sum_sse2( table, pixelOffsets, pixelWeights, dst + i * dstStep );
+	}
+}
+
+#endif
+
+typedef void (*lut3d_tetrahedral_floats_function)( const float*, const std::size_t, const float*, const std::size_t, float*, const std::size_t, const std::size_t );
+
+/// @return the best implementation for the current cpu
+inline lut3d_tetrahedral_floats_function select_lut3d_tetrahedral_floats()
+{
+#ifdef TERRY_COLOR_SIMD_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "sse2" ) )
+		return &lut3d_tetrahedral_floats_sse2;
+#endif
+	return &lut3d_tetrahedral_floats_generic;
+}
+
+/// Tetrahedral interpolation of float pixels with the best implementation for the current cpu.
+inline void lut3d_tetrahedral_floats( const float* table, const std::size_t size,
+                                      const float* src, const std::size_t srcStep,
+                                      float* dst, const std::size_t dstStep, const std::size_t n )
+{
+	static const lut3d_tetrahedral_floats_function interpolate = select_lut3d_tetrahedral_floats();
+	interpolate( table, size, src, srcStep, dst, dstStep, n );
+}
+
+}
+}
+}
+
+#endif
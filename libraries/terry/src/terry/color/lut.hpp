@@ -0,0 +1,575 @@
+#ifndef _TERRY_COLOR_LUT_HPP_
+#define _TERRY_COLOR_LUT_HPP_
+
+/**
+ * @file
+ * @brief Bake of pure per pixel color transforms in LUTs.
+ *
+ * - lut1d samples a function of one value, it is applied on each channel
+ *   (gradations, gammas...). The 8 and 16 bits channels use a complete table
+ *   of the channel values, so they are exact.
+ * - lut3d samples any RGB to RGB transform on a grid, with an optional 1D
+ *   shaper LUT on the inputs, and is applied with a tetrahedral interpolation.
+ *
+ * The bakes measure the error of the LUT against the exact transform, and
+ * fail if it is above the maximum error requested: the caller then keeps the
+ * exact transform. The values out of the domain of a LUT are also computed
+ * with the exact transform.
+ */
+
+#include "detail/lut3d_simd.hpp"
+
+#include <terry/channel.hpp>
+
+#include <boost/gil/gil_config.hpp>
+#include <boost/gil/channel.hpp>
+#include <boost/gil/pixel.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <boost/gil/color_base_algorithm.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/mpl/bool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace terry {
+namespace color {
+
+using namespace boost::gil;
+
+/// Default maximum error of a baked LUT, relative to the values above 1.
+static const float lut_default_max_error = 1e-4f;
+
+namespace detail {
+
+inline bool lut_is_finite( const float v )
+{
+	return v == v && std::abs( v ) <= 3.4e38f;
+}
+
+/// Error of @p value against @p exact, relative to the values above 1.
+inline float lut_error( const float value, const float exact )
+{
+	if( ! lut_is_finite( exact ) || ! lut_is_finite( value ) )
+		return 3.4e38f;
+	return std::abs( value - exact ) / std::max( 1.0f, std::abs( exact ) );
+}
+
+/// Deterministic pseudo random values in [0, 1[ to check the LUTs.
+struct lut_random
+{
+	unsigned int _state;
+	lut_random() : _state( 12345u ) {}
+	float operator()()
+	{
+		_state = _state * 1664525u + 1013904223u;
+		return ( _state >> 8 ) * ( 1.0f / 16777216.0f );
+	}
+};
+
+}
+
+/**
+ * @brief LUT of a function of one value, with a linear interpolation.
+ */
+class lut1d
+{
+public:
+	lut1d()
+	: _min( 0.0f )
+	, _scale( 0.0f )
+	, _domainMin( 0.0f )
+	, _domainMax( -1.0f )
+	{}
+
+	bool empty() const { return _values.empty(); }
+	std::size_t size() const { return _values.size(); }
+	float domain_min() const { return _domainMin; }
+	float domain_max() const { return _domainMax; }
+
+	/// @return true if @p v is in the domain where the LUT respects the maximum error (false for NaN)
+	bool in_domain( const float v ) const { return v >= _domainMin && v <= _domainMax; }
+
+	/**
+	 * @brief Sample @p f on [min, max] with @p size values.
+	 *
+	 * The error is checked between the samples. The first intervals may be
+	 * excluded from the domain if they don't respect @p maxError (like the
+	 * dark values of a gamma, where the slope is infinite), the bake fails
+	 * if the other intervals don't respect it.
+	 *
+	 * @return false if the LUT can't respect @p maxError, the LUT is then empty
+	 */
+	template<class Function>
+	bool bake( const Function& f, const std::size_t size, const float min, const float max, const float maxError = lut_default_max_error )
+	{
+		clear();
+		if( size < 2 || ! ( max > min ) )
+			return false;
+		const double step = ( double( max ) - min ) / ( size - 1 );
+		std::vector<float> values( size );
+		for( std::size_t i = 0; i < size; ++i )
+			values[i] = f( float( min + i * step ) );
+
+		// the first interval of the domain, after the inaccurate intervals
+		std::size_t first = 0;
+		for( std::size_t i = 0; i < size - 1; ++i )
+		{
+			bool accurate = detail::lut_is_finite( values[i] ) && detail::lut_is_finite( values[i+1] );
+			for( int k = 1; accurate && k < 4; ++k )
+			{
+				const float t = k * 0.25f;
+				const float exact = f( float( min + ( i + t ) * step ) );
+				accurate = detail::lut_error( values[i] + t * ( values[i+1] - values[i] ), exact ) <= maxError;
+			}
+			if( ! accurate )
+			{
+				if( i != first )
+					return false; // not only at the beginning of the domain
+				first = i + 1;
+			}
+		}
+		if( first > ( size - 1 ) / 2 )
+			return false;
+
+		_values.swap( values );
+		_min = min;
+		_scale = float( 1.0 / step );
+		_domainMin = float( min + first * step );
+		_domainMax = max;
+		return true;
+	}
+
+	/**
+	 * @brief Complete table of a function of an integer channel (8 or 16 bits), exact.
+	 * @param f channel function: dst = f( src, dst ), like the gradation functors
+	 */
+	template<class Channel, class ChannelFunction>
+	void bake_channel( const ChannelFunction& f )
+	{
+		typedef channel_traits<Channel> Traits;
+		clear();
+		const std::size_t size = std::size_t( Traits::max_value() ) - std::size_t( Traits::min_value() ) + 1;
+		_values.resize( size );
+		for( std::size_t i = 0; i < size; ++i )
+		{
+			const Channel src = Channel( Traits::min_value() + i );
+			Channel dst;
+			f( src, dst );
+			_values[i] = channel_convert<bits32f>( dst );
+		}
+		_min = float( Traits::min_value() );
+		_scale = 1.0f;
+		_domainMin = float( Traits::min_value() );
+		_domainMax = float( Traits::max_value() );
+	}
+
+	/// Interpolated value, @p v is clamped to the samples.
+	GIL_FORCEINLINE
+	float operator()( const float v ) const
+	{
+		const float last = float( _values.size() - 1 );
+		const float p = std::min( std::max( ( v - _min ) * _scale, 0.0f ), last );
+		const std::size_t i = std::min( static_cast<std::size_t>( p ), _values.size() - 2 );
+		const float t = p - i;
+		return _values[i] + t * ( _values[i+1] - _values[i] );
+	}
+
+	/// Value of a table baked with bake_channel.
+	template<class Channel>
+	GIL_FORCEINLINE
+	float at_channel( const Channel c ) const
+	{
+		return _values[ std::size_t( c ) - std::size_t( channel_traits<Channel>::min_value() ) ];
+	}
+
+	void clear()
+	{
+		_values.clear();
+		_domainMin = 0.0f;
+		_domainMax = -1.0f;
+	}
+
+private:
+	float _min;   ///< input of the first sample
+	float _scale; ///< number of samples per unit of input
+	float _domainMin;
+	float _domainMax;
+	std::vector<float> _values;
+};
+
+/**
+ * @brief Bake a channel function in @p lut, for the channels of type @p Channel.
+ *
+ * The integer channels get a complete table (always accurate), the float
+ * channels a LUT of @p size samples on [min, max].
+ * @return false if the LUT can't respect @p maxError
+ */
+template<class Channel, class ChannelFunction>
+bool bake_channel_lut1d( const ChannelFunction& f, lut1d& lut, const std::size_t size = 4096,
+                         const float min = 0.0f, const float max = 1.0f, const float maxError = lut_default_max_error );
+
+namespace detail {
+
+template<class ChannelFunction>
+struct float_channel_function_t
+{
+	const ChannelFunction& _f;
+	float_channel_function_t( const ChannelFunction& f ) : _f( f ) {}
+	float operator()( const float v ) const
+	{
+		bits32f dst;
+		_f( bits32f( v ), dst );
+		return dst;
+	}
+};
+
+template<class Channel, class ChannelFunction>
+bool bake_channel_lut1d_imp( const ChannelFunction& f, lut1d& lut, const std::size_t, const float, const float, const float, const boost::mpl::true_ /*integral*/ )
+{
+	lut.bake_channel<Channel>( f );
+	return true;
+}
+
+template<class Channel, class ChannelFunction>
+bool bake_channel_lut1d_imp( const ChannelFunction& f, lut1d& lut, const std::size_t size, const float min, const float max, const float maxError, const boost::mpl::false_ /*integral*/ )
+{
+	return lut.bake( float_channel_function_t<ChannelFunction>( f ), size, min, max, maxError );
+}
+
+}
+
+template<class Channel, class ChannelFunction>
+bool bake_channel_lut1d( const ChannelFunction& f, lut1d& lut, const std::size_t size, const float min, const float max, const float maxError )
+{
+	typedef typename channel_base_type<Channel>::type Base;
+	typedef boost::mpl::bool_<boost::is_integral<Base>::value && sizeof(Base) <= 2> IsTable;
+	return detail::bake_channel_lut1d_imp<Channel>( f, lut, size, min, max, maxError, IsTable() );
+}
+
+/**
+ * @brief Apply a lut1d on each channel of the pixels, like a ChannelFunction.
+ *
+ * The float values out of the domain of the LUT use the exact function.
+ * @param lut baked with bake_channel_lut1d for the channel type of the pixels
+ */
+template<class ChannelFunction>
+struct channel_lut1d_t
+{
+	const lut1d& _lut;
+	const ChannelFunction& _exact;
+
+	channel_lut1d_t( const lut1d& lut, const ChannelFunction& exact )
+	: _lut( lut )
+	, _exact( exact )
+	{}
+
+	template<class ChannelSrc, class ChannelDst>
+	GIL_FORCEINLINE
+	void operator()( const ChannelSrc& src, ChannelDst& dst ) const
+	{
+		typedef typename channel_traits<ChannelSrc>::value_type Channel;
+		typedef typename channel_base_type<Channel>::type Base;
+		apply<Channel>( src, dst, boost::mpl::bool_<boost::is_integral<Base>::value && sizeof(Base) <= 2>() );
+	}
+
+private:
+	template<class Channel, class ChannelSrc, class ChannelDst>
+	GIL_FORCEINLINE
+	void apply( const ChannelSrc& src, ChannelDst& dst, const boost::mpl::true_ /*table*/ ) const
+	{
+		dst = channel_convert<Channel>( bits32f( _lut.at_channel( Channel( src ) ) ) );
+	}
+
+	template<class Channel, class ChannelSrc, class ChannelDst>
+	GIL_FORCEINLINE
+	void apply( const ChannelSrc& src, ChannelDst& dst, const boost::mpl::false_ /*table*/ ) const
+	{
+		const float v = src;
+		if( _lut.in_domain( v ) )
+		{
+			dst = Channel( _lut( v ) );
+		}
+		else
+		{
+			Channel res;
+			_exact( Channel( src ), res );
+			dst = res;
+		}
+	}
+};
+
+/**
+ * @brief Pixel functor applying a lut1d to all the channels (for transform_pixels).
+ */
+template<class ChannelFunction>
+struct transform_pixel_lut1d_t
+{
+	channel_lut1d_t<ChannelFunction> _channel;
+
+	transform_pixel_lut1d_t( const lut1d& lut, const ChannelFunction& exact )
+	: _channel( lut, exact )
+	{}
+
+	template<typename Pixel>
+	GIL_FORCEINLINE
+	Pixel operator()( const Pixel& p ) const
+	{
+		Pixel res;
+		static_for_each( p, res, _channel );
+		return res;
+	}
+};
+
+/**
+ * @brief RGB 3D LUT, with a tetrahedral interpolation.
+ *
+ * The nodes are stored with 4 floats (rgb and a padding) for the SIMD
+ * interpolation. The inputs are mapped to the [0, 1] coordinates of the grid
+ * by an optional shaper (for example a log2 for the HDR values), baked in a
+ * lut1d.
+ *
+ * Transform concept: rgb32f_pixel_t operator()( const rgb32f_pixel_t& ) const
+ */
+class lut3d
+{
+public:
+	lut3d()
+	: _size( 0 )
+	, _error( 0.0f )
+	{}
+
+	bool empty() const { return _table.empty(); }
+	std::size_t size() const { return _size; }
+	/// maximum error measured during the bake
+	float error() const { return _error; }
+	bool has_shaper() const { return ! _shaper.empty(); }
+	/// nodes of 4 floats (rgb and a padding), blue varies the fastest
+	const float* data() const { return &_table.front(); }
+
+	/// @return true if the pixel is in the domain of the LUT (false for NaN)
+	GIL_FORCEINLINE
+	bool in_domain( const float r, const float g, const float b ) const
+	{
+		if( has_shaper() )
+			return _shaper.in_domain( r ) && _shaper.in_domain( g ) && _shaper.in_domain( b );
+		return r >= 0.0f && r <= 1.0f && g >= 0.0f && g <= 1.0f && b >= 0.0f && b <= 1.0f;
+	}
+
+	/**
+	 * @brief Bake @p transform on [0, 1]^3, with @p size nodes on each axis (like 33 or 65).
+	 * @return false if the LUT can't respect @p maxError, the LUT is then empty
+	 */
+	template<class Transform>
+	bool bake( const Transform& transform, const std::size_t size, const float maxError = lut_default_max_error )
+	{
+		clear();
+		return bake_grid( transform, size, maxError, identity_shaper() );
+	}
+
+	/**
+	 * @brief Bake @p transform on [min, max]^3, with a shaper.
+	 * @param shaper maps the inputs of [min, max] to [0, 1] (monotonic), baked in a 1D LUT of @p shaperSize samples
+	 * @param shaperInverse inverse of @p shaper, only used during the bake
+	 */
+	template<class Transform, class Shaper, class ShaperInverse>
+	bool bake( const Transform& transform, const std::size_t size, const float maxError,
+	           const Shaper& shaper, const ShaperInverse& shaperInverse,
+	           const float min, const float max, const std::size_t shaperSize = 4096 )
+	{
+		clear();
+		// the error of the shaper is checked with the error of the whole LUT
+		if( ! _shaper.bake( shaper, shaperSize, min, max, 1.0f / ( 4 * ( size - 1 ) ) ) )
+			return false;
+		return bake_grid( transform, size, maxError, shaperInverse );
+	}
+
+	/// Interpolated transform of one pixel, the pixels out of the domain are clamped.
+	rgb32f_pixel_t operator()( const rgb32f_pixel_t& p ) const
+	{
+		float coords[3] = { p[0], p[1], p[2] };
+		if( has_shaper() )
+			for( int c = 0; c < 3; ++c )
+				coords[c] = _shaper( coords[c] );
+		float res[3];
+		detail::lut3d_tetrahedral_floats_generic( &_table.front(), _size, coords, 3, res, 3, 1 );
+		return rgb32f_pixel_t( res[0], res[1], res[2] );
+	}
+
+	/**
+	 * @brief Set the nodes of the LUT from rgb values (like the content of a LUT file), without a bake.
+	 * @param values size^3 rgb triplets, blue varies the fastest
+	 */
+	template<class Iterator>
+	void assign( const std::size_t size, Iterator values )
+	{
+		clear();
+		_size = size;
+		_table.resize( size * size * size * 4 );
+		for( std::vector<float>::iterator node = _table.begin(); node != _table.end(); node += 4 )
+		{
+			node[0] = float( *values++ );
+			node[1] = float( *values++ );
+			node[2] = float( *values++ );
+			node[3] = 0.0f;
+		}
+	}
+
+	/**
+	 * @brief Apply the LUT on a line of float pixels, with the SIMD interpolation.
+	 *
+	 * The first 3 channels are transformed, the other channels (alpha) are copied.
+	 * The pixels out of the domain are clamped.
+	 * @param nbChannels number of floats of each pixel (3 or 4)
+	 * @param src, dst can be the same line
+	 */
+	void apply_floats( const float* src, float* dst, const std::size_t n, const std::size_t nbChannels ) const
+	{
+		static const std::size_t blockSize = 256;
+		float coords[blockSize * 3];
+
+		for( std::size_t begin = 0; begin < n; begin += blockSize )
+		{
+			const std::size_t size = std::min( blockSize, n - begin );
+			const float* s = src + begin * nbChannels;
+			float* d = dst + begin * nbChannels;
+
+			if( has_shaper() )
+			{
+				for( std::size_t i = 0; i < size; ++i )
+					for( int c = 0; c < 3; ++c )
+						coords[i * 3 + c] = _shaper( s[i * nbChannels + c] );
+				detail::lut3d_tetrahedral_floats( &_table.front(), _size, coords, 3, d, nbChannels, size );
+			}
+			else
+			{
+				detail::lut3d_tetrahedral_floats( &_table.front(), _size, s, nbChannels, d, nbChannels, size );
+			}
+			if( s != d )
+			{
+				for( std::size_t i = 0; i < size; ++i )
+					for( std::size_t c = 3; c < nbChannels; ++c )
+						d[i * nbChannels + c] = s[i * nbChannels + c];
+			}
+		}
+	}
+
+	/**
+	 * @brief Apply the LUT on a line of float pixels, the pixels out of the domain are computed by @p exact.
+	 * @see apply_floats
+	 */
+	template<class Transform>
+	void apply_floats( const float* src, float* dst, const std::size_t n, const std::size_t nbChannels, const Transform& exact ) const
+	{
+		static const std::size_t blockSize = 256;
+		std::size_t outside[blockSize];
+		float outsideValues[blockSize * 3];
+
+		for( std::size_t begin = 0; begin < n; begin += blockSize )
+		{
+			const std::size_t size = std::min( blockSize, n - begin );
+			const float* s = src + begin * nbChannels;
+			float* d = dst + begin * nbChannels;
+
+			// recorded before the interpolation, which can be in place
+			std::size_t nbOutside = 0;
+			for( std::size_t i = 0; i < size; ++i )
+			{
+				const float* p = s + i * nbChannels;
+				if( ! in_domain( p[0], p[1], p[2] ) )
+				{
+					outside[nbOutside] = i;
+					std::copy( p, p + 3, outsideValues + nbOutside * 3 );
+					++nbOutside;
+				}
+			}
+			apply_floats( s, d, size, nbChannels );
+			for( std::size_t k = 0; k < nbOutside; ++k )
+			{
+				const float* v = outsideValues + k * 3;
+				const rgb32f_pixel_t res = exact( rgb32f_pixel_t( v[0], v[1], v[2] ) );
+				float* p = d + outside[k] * nbChannels;
+				p[0] = res[0];
+				p[1] = res[1];
+				p[2] = res[2];
+			}
+		}
+	}
+
+	void clear()
+	{
+		_size = 0;
+		_error = 0.0f;
+		_table.clear();
+		_shaper.clear();
+	}
+
+private:
+	struct identity_shaper
+	{
+		float operator()( const float v ) const { return v; }
+	};
+
+	template<class Transform, class ShaperInverse>
+	bool bake_grid( const Transform& transform, const std::size_t size, const float maxError, const ShaperInverse& shaperInverse )
+	{
+		if( size < 2 )
+			return false;
+		std::vector<float> nodeInputs( size );
+		for( std::size_t i = 0; i < size; ++i )
+			nodeInputs[i] = shaperInverse( float( i ) / ( size - 1 ) );
+
+		_size = size;
+		_table.resize( size * size * size * 4 );
+		float* node = &_table.front();
+		for( std::size_t r = 0; r < size; ++r )
+			for( std::size_t g = 0; g < size; ++g )
+				for( std::size_t b = 0; b < size; ++b, node += 4 )
+				{
+					const rgb32f_pixel_t res = transform( rgb32f_pixel_t( nodeInputs[r], nodeInputs[g], nodeInputs[b] ) );
+					node[0] = res[0];
+					node[1] = res[1];
+					node[2] = res[2];
+					node[3] = 0.0f;
+					if( ! detail::lut_is_finite( node[0] ) || ! detail::lut_is_finite( node[1] ) || ! detail::lut_is_finite( node[2] ) )
+					{
+						clear();
+						return false;
+					}
+				}
+
+		// error on random points of the domain
+		static const std::size_t nbChecks = 4096;
+		detail::lut_random random;
+		for( std::size_t i = 0; i < nbChecks; ++i )
+		{
+			const rgb32f_pixel_t p( shaperInverse( random() ), shaperInverse( random() ), shaperInverse( random() ) );
+			if( ! in_domain( p[0], p[1], p[2] ) )
+				continue; // computed by the exact transform
+			const rgb32f_pixel_t exact = transform( p );
+			const rgb32f_pixel_t value = (*this)( p );
+			for( int c = 0; c < 3; ++c )
+				_error = std::max( _error, detail::lut_error( value[c], exact[c] ) );
+			if( _error > maxError )
+			{
+				clear();
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	std::size_t _size;       ///< number of nodes on each axis
+	float _error;
+	std::vector<float> _table; ///< size^3 nodes of 4 floats, blue varies the fastest
+	lut1d _shaper;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef _TERRY_COLOR_LUT_CACHE_HPP_
+#define _TERRY_COLOR_LUT_CACHE_HPP_
+
+#include <terry/lru_cache.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <cstddef>
+
+namespace terry {
+namespace color {
+
+/**
+ * @brief Cache of the last baked LUTs, by key (the hash of the parameters).
+ *
+ * The LUTs are shared and const, so the renders of all the threads use the
+ * same LUT, and the frames of an animated sequence with the same parameters
+ * don't bake it again.
+ * A null LUT is also kept in the cache, when a bake has failed.
+ * get( key, bake ) bakes under the lock, with a functor returning a LutPtr.
+ */
+template<class Lut, class Key = std::size_t>
+class lut_cache : public lru_cache<Key, boost::shared_ptr<const Lut> >
+{
+public:
+	typedef boost::shared_ptr<const Lut> LutPtr;
+
+	explicit lut_cache( const std::size_t maxSize = 8 )
+	: lru_cache<Key, LutPtr>( maxSize )
+	{}
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef _TERRY_FILTER_BOXBLUR_HPP_
+#define _TERRY_FILTER_BOXBLUR_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace terry {
+namespace filter {
+
+/**
+ * @brief Gaussian approximation by successive box filters.
+ *
+ * Each box is a running sum, so the cost per value is constant whatever the
+ * value of sigma. The box widths are chosen so that the variance of the
+ * nbPasses boxes is the variance of the gaussian.
+ *
+ * "Fast Almost-Gaussian Filtering", P. Kovesi, DICTA 2010
+ *
+ * The instances have temporary buffers, so use one copy per thread.
+ */
+template<typename T>
+struct box_blur_filter
+{
+	std::vector<std::ptrdiff_t> _radius; ///< radius of each box
+
+	box_blur_filter( const double sigma = 0, const std::size_t nbPasses = 3 )
+	{
+		if( sigma <= 0 || nbPasses == 0 )
+			return;
+		const double n = nbPasses;
+		const double variance = sigma * sigma;
+		// ideal width of n boxes with the same variance
+		const double wIdeal = std::sqrt( 12.0 * variance / n + 1.0 );
+		std::ptrdiff_t wl = static_cast<std::ptrdiff_t>( std::floor( wIdeal ) );
+		if( wl % 2 == 0 )
+			--wl;
+		const std::ptrdiff_t wu = wl + 2;
+		// number of boxes of width wl, the others have the width wu
+		const double mIdeal = ( 12.0 * variance - n * wl * wl - 4.0 * n * wl - 3.0 * n ) / ( -4.0 * wl - 4.0 );
+		const std::ptrdiff_t m = static_cast<std::ptrdiff_t>( std::floor( mIdeal + 0.5 ) );
+
+		for( std::size_t i = 0; i < nbPasses; ++i )
+		{
+			const std::ptrdiff_t w = static_cast<std::ptrdiff_t>( i ) < m ? wl : wu;
+			if( w > 1 )
+				_radius.push_back( ( w - 1 ) / 2 );
+		}
+	}
+
+	bool valid() const { return ! _radius.empty(); }
+
+	/// Number of values needed on each side of a line: the support of all the boxes.
+	std::ptrdiff_t margin() const
+	{
+		std::ptrdiff_t m = 0;
+		for( std::size_t i = 0; i < _radius.size(); ++i )
+			m += _radius[i];
+		return m;
+	}
+
+	/**
+	 * @brief Filter in place nbSamples samples of sampleSize contiguous values.
+	 * The values before and after the line are considered equal to the first and last values.
+	 */
+	void operator()( T* data, const std::size_t nbSamples, const std::size_t sampleSize )
+	{
+		if( ! valid() || nbSamples == 0 )
+			return;
+
+		const std::ptrdiff_t s = sampleSize;
+		const std::ptrdiff_t n = nbSamples;
+		_line.resize( n * s );
+		_sum.resize( s );
+		for( std::size_t pass = 0; pass < _radius.size(); ++pass )
+		{
+			const std::ptrdiff_t r = _radius[pass];
+			const double norm = 1.0 / ( 2 * r + 1 );
+			// keep the input of the pass, the result is written in data
+			std::copy( data, data + n * s, _line.begin() );
+			const T* src = &_line.front();
+
+			// sum of the window centered on the first sample
+			for( std::ptrdiff_t k = 0; k < s; ++k )
+				_sum[k] = ( r + 1 ) * double( src[k] );
+			for( std::ptrdiff_t j = 1; j <= r; ++j )
+			{
+				const T* in = src + std::min( j, n - 1 ) * s;
+				for( std::ptrdiff_t k = 0; k < s; ++k )
+					_sum[k] += in[k];
+			}
+
+			for( std::ptrdiff_t i = 0; i < n; ++i )
+			{
+				T* out = data + i * s;
+				const T* in  = src + std::min( i + r + 1, n - 1 ) * s;
+				const T* old = src + std::max<std::ptrdiff_t>( i - r, 0 ) * s;
+				for( std::ptrdiff_t k = 0; k < s; ++k )
+				{
+					out[k] = T( _sum[k] * norm );
+					_sum[k] += double( in[k] ) - double( old[k] );
+				}
+			}
+		}
+	}
+
+private:
+	std::vector<T>      _line; ///< input of the current pass
+	std::vector<double> _sum;  ///< running sums, in double to avoid the drift on long lines
+};
+
+}
+}
+
+#endif
@@ -53,6 +53,39 @@ bool operator>=(const point2<T>& p, const T2 v) { return (p.x>=v && p.y>=v); }
 template <typename T, typename T2> GIL_FORCEINLINE
 bool operator<=(const point2<T>& p, const T2 v) { return (p.x<=v && p.y<=v); }
 
+/**
+ * @brief Position of the source value used at @p pos on a line of @p size values.
+ * @return -1 if the value is zero.
+ */
+inline std::ptrdiff_t extended_line_index( std::ptrdiff_t pos, const std::ptrdiff_t size, const convolve_boundary_option option )
+{
+	if( pos >= 0 && pos < size )
+		return pos;
+	if( size == 0 )
+		return -1;
+
+	switch( option )
+	{
+		case convolve_option_extend_mirror:
+		{
+			// same reflection than the correlate functions: -1 is 0, -2 is 1...
+			const std::ptrdiff_t period = 2 * size;
+			pos %= period;
+			if( pos < 0 )
+				pos += period;
+			return pos < size ? pos : period - 1 - pos;
+		}
+		case convolve_option_extend_constant:
+		case convolve_option_extend_padded: // the source doesn't contain the padding, use the border value
+			return pos < 0 ? 0 : size - 1;
+		case convolve_option_extend_zero:
+		case convolve_option_output_ignore:
+		case convolve_option_output_zero:
+			break;
+	}
+	return -1;
+}
+
 /// compute the correlation of 1D kernel with the rows of an image
 /// @param src source view
 /// @param dst destination view
@@ -61,10 +94,11 @@ bool operator<=(const point2<T>& p, const T2 v) { return (p.x<=v && p.y<=v); }
 ///        We can see it as a vector to move dst in src coordinates.
 /// @param option boundary option
 /// @param correlator correlator functor
-template <typename PixelAccum,typename SrcView,typename Kernel,typename DstView,typename Correlator>
+/// @param buffer line buffer, resized if needed, so the callers correlating many lines allocate it once
+template <typename PixelAccum,typename SrcView,typename Kernel,typename DstView,typename Correlator,typename Buffer>
 void correlate_rows_imp( const SrcView& src, const Kernel& ker, const DstView& dst, const typename SrcView::point_t& dst_tl,
                          const convolve_boundary_option option,
-                         Correlator correlator )
+                         Correlator correlator, Buffer& buffer )
 {
 	using namespace terry::numeric;
 
@@ -129,7 +163,7 @@ void correlate_rows_imp( const SrcView& src, const Kernel& ker, const DstView& d
         }
 		else
 		{
-			std::vector<PixelAccum> buffer(srcRoi_width);
+			buffer.resize( srcRoi_width );
             for( coord_t yy = 0; yy < dst.dimensions().y; ++yy )
 			{
 				coord_t yy_src = yy + dst_tl.y;
@@ -154,7 +188,7 @@ void correlate_rows_imp( const SrcView& src, const Kernel& ker, const DstView& d
     }
 	else
 	{
-        std::vector<PixelAccum> buffer( dst.dimensions().x + (ker.size() - 1) );
+        buffer.resize( dst.dimensions().x + (ker.size() - 1) );
         for( int yy=0; yy<dst.dimensions().y; ++yy )
 		{
 			coord_t yy_src = yy + dst_tl.y;
@@ -254,6 +288,16 @@ void correlate_rows_imp( const SrcView& src, const Kernel& ker, const DstView& d
     }
 }
 
+template <typename PixelAccum,typename SrcView,typename Kernel,typename DstView,typename Correlator>
+GIL_FORCEINLINE
+void correlate_rows_imp( const SrcView& src, const Kernel& ker, const DstView& dst, const typename SrcView::point_t& dst_tl,
+                         const convolve_boundary_option option,
+                         Correlator correlator )
+{
+	std::vector<PixelAccum> buffer;
+	correlate_rows_imp<PixelAccum>( src, ker, dst, dst_tl, option, correlator, buffer );
+}
+
 template <typename PixelAccum>
 class correlator_n
 {
@@ -492,8 +536,144 @@ void correlate_cols(const SrcView& src, const Kernel& ker, const DstView& dst, c
 	correlate_cols_imp<false,PixelAccum,SrcView,Kernel,DstView>( src, ker, dst, dst_tl, option );
 }
 
+namespace detail {
+
+/// Size in bytes of the ring buffer of the two-pass correlation, small enough to stay in the L2 cache.
+static const std::size_t correlate_ring_buffer_size = 256 * 1024;
+
+/**
+ * @brief Two-pass correlation with a ring buffer of kernelY.size() lines.
+ *
+ * The destination is processed by vertical strips, narrow enough for the ring
+ * buffer to stay in the cache. Each source line is correlated horizontally
+ * once per strip into the ring, and each output line is the vertical
+ * correlation of the lines of the ring. So the intermediate result never
+ * goes through the memory and the columns are never read with a stride.
+ *
+ * The source lines are read while the destination lines are written,
+ * so src and dst must not overlap.
+ */
+template <typename PixelAccum, template<typename> class Alloc, typename SrcView, typename KernelX, typename KernelY, typename DstView, typename Correlator>
+void correlate_rows_cols_ring_imp( const SrcView& src,
+                                   const KernelX& kernelX,
+                                   const KernelY& kernelY,
+                                   const DstView& dst,
+                                   const typename SrcView::point_t& dst_tl,
+                                   const convolve_boundary_option option,
+                                   Correlator correlator )
+{
+	using namespace terry::numeric;
+	typedef typename SrcView::point_t Point;
+	typedef typename SrcView::coord_t Coord;
+	typedef typename view_type_from_pixel<PixelAccum, false>::type ViewAccum;
+	typedef image<PixelAccum, false, Alloc<unsigned char> > ImageAccum;
+
+	const Coord width = dst.width();
+	const Coord height = dst.height();
+	if( width == 0 || height == 0 )
+		return;
+
+	const Coord ringSize = boost::numeric_cast<Coord>( kernelY.size() );
+	const Coord leftSize = boost::numeric_cast<Coord>( kernelY.left_size() );
+	const Coord rightSize = boost::numeric_cast<Coord>( kernelY.right_size() );
+	const Coord stripWidth = std::min( width,
+		std::max( Coord( 64 ), boost::numeric_cast<Coord>( correlate_ring_buffer_size / ( ( ringSize + 1 ) * sizeof(PixelAccum) ) ) ) );
+
+	// the ring of lines, and a last line to accumulate the vertical correlation
+	ImageAccum ring( stripWidth, ringSize + 1 );
+	const ViewAccum ringView = view( ring );
+	PixelAccum* accumulator = &ringView( 0, ringSize );
+	std::vector<const PixelAccum*> lines( ringSize );
+	std::vector<PixelAccum, Alloc<PixelAccum> > buffer; // extended source line of the horizontal correlation
+
+	PixelAccum acc_zero; pixel_zeros_t<PixelAccum>()(acc_zero);
+
+	// source lines needed by the vertical correlation of the first and last output lines
+	const Coord yBegin = dst_tl.y - leftSize;
+	const Coord yEnd = dst_tl.y + height + rightSize;
+
+	for( Coord x = 0; x < width; x += stripWidth )
+	{
+		const Coord stripSize = std::min( stripWidth, width - x );
+		for( Coord y = yBegin; y < yEnd; ++y )
+		{
+			// horizontal correlation of the source line in its slot of the ring
+			const ViewAccum line = subimage_view( ringView, 0, ( y - yBegin ) % ringSize, stripSize, 1 );
+			const std::ptrdiff_t ySrc = extended_line_index( y, src.height(), option );
+			if( ySrc < 0 )
+				fill_pixels( line, acc_zero );
+			else
+				correlate_rows_imp<PixelAccum>( src, kernelX, line, Point( dst_tl.x + x, ySrc ), option, correlator, buffer );
+
+			// the ring contains all the lines of the output line which ends with y
+			const Coord yDst = y - rightSize - dst_tl.y;
+			if( yDst < 0 )
+				continue;
+			for( Coord k = 0; k < ringSize; ++k )
+				lines[k] = &ringView( 0, ( yDst + k ) % ringSize );
+			correlate_lines<PixelAccum>( &lines.front(), kernelY.begin(), ringSize, accumulator, stripSize );
+			assign_pixels( accumulator, accumulator + stripSize, dst.x_at( x, yDst ) );
+		}
+	}
+}
+
+template <typename PixelAccum, typename Kernel>
+GIL_FORCEINLINE
+correlator_n<PixelAccum> kernel_correlator( const Kernel& ker, const boost::mpl::false_ /*fixed*/ )
+{
+	return correlator_n<PixelAccum>( ker.size() );
+}
+
+template <typename PixelAccum, typename Kernel>
+GIL_FORCEINLINE
+correlator_k<Kernel::static_size,PixelAccum> kernel_correlator( const Kernel&, const boost::mpl::true_ /*fixed*/ )
+{
+	return correlator_k<Kernel::static_size,PixelAccum>();
+}
+
+template <typename PixelAccum, template<typename> class Alloc, std::size_t Size, typename SrcView, typename KernelX, typename KernelY, typename DstView>
+GIL_FORCEINLINE
+void correlate_rows_cols_ring_fixed( const SrcView& src, const KernelX& kernelX, const KernelY& kernelY, const DstView& dst,
+                                     const typename SrcView::point_t& dst_tl, const convolve_boundary_option option )
+{
+	typedef kernel_1d_fixed<typename KernelX::value_type, Size> FixedKernel;
+	const FixedKernel fker( kernelX.begin(), kernelX.center() );
+	correlate_rows_cols_ring_imp<PixelAccum,Alloc>( src, fker, kernelY, dst, dst_tl, option, correlator_k<Size,PixelAccum>() );
+}
+
+/// Two-pass correlation with a ring buffer, with the fixed-size horizontal kernels of correlate_1d_auto if autoEnabled.
+template <bool autoEnabled, typename PixelAccum, template<typename> class Alloc, typename SrcView, typename KernelX, typename KernelY, typename DstView>
+void correlate_rows_cols_ring( const SrcView& src,
+                               const KernelX& kernelX,
+                               const KernelY& kernelY,
+                               const DstView& dst,
+                               const typename SrcView::point_t& dst_tl,
+                               const convolve_boundary_option option )
+{
+	if( autoEnabled && ! KernelX::is_fixed_size_t::value )
+	{
+		switch( kernelX.size() )
+		{
+			case 3:
+				correlate_rows_cols_ring_fixed<PixelAccum,Alloc,3>( src, kernelX, kernelY, dst, dst_tl, option );
+				return;
+			case 5:
+				correlate_rows_cols_ring_fixed<PixelAccum,Alloc,5>( src, kernelX, kernelY, dst, dst_tl, option );
+				return;
+			case 7:
+				correlate_rows_cols_ring_fixed<PixelAccum,Alloc,7>( src, kernelX, kernelY, dst, dst_tl, option );
+				return;
+		}
+	}
+	typedef typename KernelX::is_fixed_size_t Fixed;
+	correlate_rows_cols_ring_imp<PixelAccum,Alloc>( src, kernelX, kernelY, dst, dst_tl, option, kernel_correlator<PixelAccum>( kernelX, Fixed() ) );
+}
+
+}
+
 /// @ingroup ImageAlgorithms
 /// correlate a 2D separable variable-size kernel (kernelX and kernelY)
+/// With the extend boundary options, src and dst must not overlap.
 template <bool autoEnabled, typename PixelAccum, template<typename> class Alloc, typename SrcView, typename KernelX,typename KernelY,typename DstView >
 GIL_FORCEINLINE
 void correlate_rows_cols_imp( const SrcView& src,
@@ -510,7 +690,12 @@ void correlate_rows_cols_imp( const SrcView& src,
 
 	if( kernelX.size() > 2 && kernelY.size() > 2 )
 	{
-		if( dst.dimensions() == src.dimensions() ) // no tiles... easy !
+		if( option != convolve_option_output_ignore && option != convolve_option_output_zero )
+		{
+			// the lines are extended, so we don't need a full temporary image
+			detail::correlate_rows_cols_ring<autoEnabled,PixelAccum,Alloc>( src, kernelX, kernelY, dst, dst_tl, option );
+		}
+		else if( dst.dimensions() == src.dimensions() ) // no tiles... easy !
 		{
 			typename SrcView::point_t zero(0,0);
 			correlate_rows_imp<autoEnabled,PixelAccum>( src, kernelX, dst, zero, option );
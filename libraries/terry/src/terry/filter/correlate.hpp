@@ -2,25 +2,99 @@
 #define _TERRY_FILTER_CORRELATE_HPP_
 
 #include "detail/inner_product.hpp"
+#include "detail/correlate_simd.hpp"
 
 #include <terry/numeric/operations.hpp>
 #include <terry/numeric/assign.hpp>
 #include <terry/numeric/init.hpp>
 #include <terry/pixel_proxy.hpp>
 
+#include <boost/gil/metafunctions.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <algorithm>
+#include <iterator>
 
 namespace terry {
 namespace filter {
 
-/// @brief 1D un-guarded correlation with a variable-size kernel
+namespace detail {
+
+/**
+ * @brief The correlation can use the SIMD float implementation:
+ * the source is a contiguous buffer of float pixels (the correlate functions
+ * always read a buffer of PixelAccum) and the kernel values are floats.
+ */
+template <typename PixelAccum, typename SrcIterator, typename KernelIterator>
+struct is_float_correlation
+	: boost::mpl::bool_<
+		( boost::is_same<SrcIterator, PixelAccum*>::value || boost::is_same<SrcIterator, const PixelAccum*>::value ) &&
+		boost::is_same<typename std::iterator_traits<KernelIterator>::value_type, float>::value &&
+		boost::is_same<typename channel_type<PixelAccum>::type, bits32f>::value &&
+		sizeof(PixelAccum) == sizeof(float) * num_channels<PixelAccum>::value
+	>
+{};
+
+/// @brief store the float result directly in the destination
+template <typename PixelAccum>
+GIL_FORCEINLINE
+PixelAccum* correlate_floats_to_pixels( const float* src, const std::size_t nbPixels,
+                                        const float* ker, const std::size_t ker_size,
+                                        PixelAccum* dst_begin )
+{
+	const std::size_t nbChannels = num_channels<PixelAccum>::value;
+	correlate_floats( src, ker, ker_size, nbChannels, reinterpret_cast<float*>( dst_begin ), nbPixels * nbChannels );
+	return dst_begin + nbPixels;
+}
+
+/// @brief compute chunks of float pixels, then convert them into the destination pixels
+template <typename PixelAccum, typename DstIterator>
+GIL_FORCEINLINE
+DstIterator correlate_floats_to_pixels( const float* src, const std::size_t nbPixels,
+                                        const float* ker, const std::size_t ker_size,
+                                        DstIterator dst_begin )
+{
+	using namespace terry::numeric;
+	typedef typename pixel_proxy<typename std::iterator_traits<DstIterator>::value_type>::type PIXEL_DST_REF;
+
+	static const std::size_t chunkSize = 64;
+	const std::size_t nbChannels = num_channels<PixelAccum>::value;
+	PixelAccum chunk[chunkSize];
+	for( std::size_t begin = 0; begin < nbPixels; begin += chunkSize )
+	{
+		const std::size_t size = std::min( chunkSize, nbPixels - begin );
+		correlate_floats( src + begin * nbChannels, ker, ker_size, nbChannels, reinterpret_cast<float*>( chunk ), size * nbChannels );
+		for( std::size_t i = 0; i < size; ++i, ++dst_begin )
+			pixel_assigns_t<PixelAccum,PIXEL_DST_REF>()( chunk[i], *dst_begin );
+	}
+	return dst_begin;
+}
+
 template <typename PixelAccum, typename SrcIterator, typename KernelIterator, typename Integer, typename DstIterator>
 GIL_FORCEINLINE
-DstIterator correlate_pixels_n(
+DstIterator correlate_pixels_n_imp(
 	SrcIterator src_begin,
 	SrcIterator src_end,
 	KernelIterator ker_begin,
 	Integer ker_size,
-	DstIterator dst_begin )
+	DstIterator dst_begin,
+	const boost::mpl::true_ /*float correlation*/ )
+{
+	return correlate_floats_to_pixels<PixelAccum>(
+		reinterpret_cast<const float*>( src_begin ), src_end - src_begin,
+		&*ker_begin, ker_size, dst_begin );
+}
+
+template <typename PixelAccum, typename SrcIterator, typename KernelIterator, typename Integer, typename DstIterator>
+GIL_FORCEINLINE
+DstIterator correlate_pixels_n_imp(
+	SrcIterator src_begin,
+	SrcIterator src_end,
+	KernelIterator ker_begin,
+	Integer ker_size,
+	DstIterator dst_begin,
+	const boost::mpl::false_ /*float correlation*/ )
 {
 	using namespace terry::numeric;
 	
@@ -41,14 +115,28 @@ DstIterator correlate_pixels_n(
     return dst_begin;
 }
 
-/// @brief 1D un-guarded correlation with a fixed-size kernel
 template <std::size_t Size,typename PixelAccum,typename SrcIterator,typename KernelIterator,typename DstIterator>
 GIL_FORCEINLINE
-DstIterator correlate_pixels_k(
+DstIterator correlate_pixels_k_imp(
 	SrcIterator src_begin,
 	SrcIterator src_end,
 	KernelIterator ker_begin,
-	DstIterator dst_begin )
+	DstIterator dst_begin,
+	const boost::mpl::true_ /*float correlation*/ )
+{
+	return correlate_floats_to_pixels<PixelAccum>(
+		reinterpret_cast<const float*>( src_begin ), src_end - src_begin,
+		&*ker_begin, Size, dst_begin );
+}
+
+template <std::size_t Size,typename PixelAccum,typename SrcIterator,typename KernelIterator,typename DstIterator>
+GIL_FORCEINLINE
+DstIterator correlate_pixels_k_imp(
+	SrcIterator src_begin,
+	SrcIterator src_end,
+	KernelIterator ker_begin,
+	DstIterator dst_begin,
+	const boost::mpl::false_ /*float correlation*/ )
 {
 	using namespace terry::numeric;
 	
@@ -69,6 +157,85 @@ DstIterator correlate_pixels_k(
     return dst_begin;
 }
 
+} // namespace detail
+
+/// @brief 1D un-guarded correlation with a variable-size kernel
+/// Uses the SIMD implementation for the float pixels, the generic one otherwise.
+template <typename PixelAccum, typename SrcIterator, typename KernelIterator, typename Integer, typename DstIterator>
+GIL_FORCEINLINE
+DstIterator correlate_pixels_n(
+	SrcIterator src_begin,
+	SrcIterator src_end,
+	KernelIterator ker_begin,
+	Integer ker_size,
+	DstIterator dst_begin )
+{
+	typedef typename detail::is_float_correlation<PixelAccum, SrcIterator, KernelIterator>::type FloatCorrelation;
+	return detail::correlate_pixels_n_imp<PixelAccum>( src_begin, src_end, ker_begin, ker_size, dst_begin, FloatCorrelation() );
+}
+
+/// @brief 1D un-guarded correlation with a fixed-size kernel
+/// Uses the SIMD implementation for the float pixels, the generic one otherwise.
+template <std::size_t Size,typename PixelAccum,typename SrcIterator,typename KernelIterator,typename DstIterator>
+GIL_FORCEINLINE
+DstIterator correlate_pixels_k(
+	SrcIterator src_begin,
+	SrcIterator src_end,
+	KernelIterator ker_begin,
+	DstIterator dst_begin )
+{
+	typedef typename detail::is_float_correlation<PixelAccum, SrcIterator, KernelIterator>::type FloatCorrelation;
+	return detail::correlate_pixels_k_imp<Size,PixelAccum>( src_begin, src_end, ker_begin, dst_begin, FloatCorrelation() );
+}
+
+namespace detail {
+
+template <typename PixelAccum, typename KernelIterator>
+GIL_FORCEINLINE
+void correlate_lines_imp( const PixelAccum* const* lines, KernelIterator ker_begin, const std::size_t ker_size,
+                          PixelAccum* dst, const std::size_t size,
+                          const boost::mpl::true_ /*float correlation*/ )
+{
+	const std::size_t nbChannels = num_channels<PixelAccum>::value;
+	correlate_lines_floats( reinterpret_cast<const float* const*>( lines ), &*ker_begin, ker_size,
+	                        reinterpret_cast<float*>( dst ), size * nbChannels );
+}
+
+template <typename PixelAccum, typename KernelIterator>
+GIL_FORCEINLINE
+void correlate_lines_imp( const PixelAccum* const* lines, KernelIterator ker_begin, const std::size_t ker_size,
+                          PixelAccum* dst, const std::size_t size,
+                          const boost::mpl::false_ /*float correlation*/ )
+{
+	using namespace terry::numeric;
+    typedef typename std::iterator_traits<KernelIterator>::value_type kernel_type;
+    PixelAccum acc_zero; pixel_zeros_t<PixelAccum>()(acc_zero);
+
+	std::fill( dst, dst + size, acc_zero );
+	for( std::size_t k = 0; k < ker_size; ++k, ++ker_begin )
+	{
+		const PixelAccum* line = lines[k];
+		for( std::size_t i = 0; i < size; ++i )
+		{
+			dst[i] = pixel_plus_t<PixelAccum,PixelAccum,PixelAccum>()(
+				dst[i],
+				pixel_multiplies_scalar_t<PixelAccum,kernel_type,PixelAccum>()( line[i], *ker_begin ) );
+		}
+	}
+}
+
+}
+
+/// @brief Vertical correlation: dst[i] = sum( ker[k] * lines[k][i] ) on size pixels.
+/// Uses the SIMD implementation for the float pixels, the generic one otherwise.
+template <typename PixelAccum, typename KernelIterator>
+GIL_FORCEINLINE
+void correlate_lines( const PixelAccum* const* lines, KernelIterator ker_begin, const std::size_t ker_size,
+                      PixelAccum* dst, const std::size_t size )
+{
+	typedef typename detail::is_float_correlation<PixelAccum, const PixelAccum*, KernelIterator>::type FloatCorrelation;
+	detail::correlate_lines_imp<PixelAccum>( lines, ker_begin, ker_size, dst, size, FloatCorrelation() );
+}
 
 }
 }
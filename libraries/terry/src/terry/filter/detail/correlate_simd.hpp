@@ -0,0 +1,262 @@
+#ifndef _TERRY_FILTER_DETAIL_CORRELATE_SIMD_HPP_
+#define _TERRY_FILTER_DETAIL_CORRELATE_SIMD_HPP_
+
+/**
+ * @file
+ * @brief SIMD correlation of float lines, with a runtime dispatch on the cpu features.
+ *
+ * The correlation of interleaved float pixels with a scalar kernel is the
+ * correlation of the flat array of floats, with a step of the number of channels
+ * between the kernel taps. So one implementation handles gray, rgb, rgba...
+ *
+ * The SSE2 and AVX2 versions are compiled with function target attributes,
+ * so the library doesn't need specific compilation flags, and the AVX2 version
+ * is only used if the cpu supports it.
+ * Define TERRY_DISABLE_SIMD to always use the generic correlation.
+ *
+ * The vertical correlation of float lines (correlate_lines_floats) computes
+ * the weighted sum of kerSize lines, it is used by the two-pass correlation on
+ * its ring buffer of lines.
+ */
+
+#include <algorithm>
+#include <cstddef>
+
+#if ! defined(TERRY_DISABLE_SIMD) && ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+ #define TERRY_FILTER_SIMD_X86 1
+ #include <immintrin.h>
+#endif
+
+namespace terry {
+namespace filter {
+namespace detail {
+
+/**
+ * @brief dst[i] = sum( ker[k] * src[i + k * step] ) for i in [0, size[
+ * @param step number of floats between two kernel taps (number of channels)
+ */
+inline void correlate_floats_generic( const float* src, const float* ker, const std::size_t kerSize,
+                                      const std::size_t step, float* dst, const std::size_t size )
+{
+	for( std::size_t i = 0; i < size; ++i )
+	{
+		float acc = 0.0f;
+		const float* s = src + i;
+		for( std::size_t k = 0; k < kerSize; ++k, s += step )
+			acc += ker[k] * *s;
+		dst[i] = acc;
+	}
+}
+
+#ifdef TERRY_FILTER_SIMD_X86
+
+__attribute__((target("sse2")))
+inline void correlate_floats_sse2( const float* src, const float* ker, const std::size_t kerSize,
+                                   const std::size_t step, float* dst, const std::size_t size )
+{
+	std::size_t i = 0;
+	// 8 values per iteration, with 2 accumulators to hide the latency of the additions
+	for( ; i + 8 <= size; i += 8 )
+	{
+		__m128 acc0 = _mm_setzero_ps();
+		__m128 acc1 = _mm_setzero_ps();
+		const float* s = src + i;
+		for( std::size_t k = 0; k < kerSize; ++k, s += step )
+		{
+			const __m128 w = _mm_set1_ps( ker[k] );
+			acc0 = _mm_add_ps( acc0, _mm_mul_ps( w, _mm_loadu_ps( s ) ) );
+			acc1 = _mm_add_ps( acc1, _mm_mul_ps( w, _mm_loadu_ps( s + 4 ) ) );
+		}
+		_mm_storeu_ps( dst + i, acc0 );
+		_mm_storeu_ps( dst + i + 4, acc1 );
+	}
+	for( ; i + 4 <= size; i += 4 )
+	{
+		__m128 acc = _mm_setzero_ps();
+		const float* s = src + i;
+		for( std::size_t k = 0; k < kerSize; ++k, s += step )
+			acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( ker[k] ), _mm_loadu_ps( s ) ) );
+		_mm_storeu_ps( dst + i, acc );
+	}
+	correlate_floats_generic( src + i, ker, kerSize, step, dst + i, size - i );
+}
+
+__attribute__((target("avx2,fma")))
+inline void correlate_floats_avx2( const float* src, const float* ker, const std::size_t kerSize,
+                                   const std::size_t step, float* dst, const std::size_t size )
+{
+	std::size_t i = 0;
+	// 32 values per iteration, with 4 accumulators to hide the latency of the fma
+	for( ; i + 32 <= size; i += 32 )
+	{
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+		__m256 acc2 = _mm256_setzero_ps();
+		__m256 acc3 = _mm256_setzero_ps();
+		const float* s = src + i;
+		for( std::size_t k = 0; k < kerSize; ++k, s += step )
+		{
+			const __m256 w = _mm256_set1_ps( ker[k] );
+			acc0 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s ), acc0 );
+			acc1 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s + 8 ), acc1 );
+			acc2 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s + 16 ), acc2 );
+			acc3 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s + 24 ), acc3 );
+		}
+		_mm256_storeu_ps( dst + i, acc0 );
+		_mm256_storeu_ps( dst + i + 8, acc1 );
+		_mm256_storeu_ps( dst + i + 16, acc2 );
+		_mm256_storeu_ps( dst + i + 24, acc3 );
+	}
+	for( ; i + 8 <= size; i += 8 )
+	{
+		__m256 acc = _mm256_setzero_ps();
+		const float* s = src + i;
+		for( std::size_t k = 0; k < kerSize; ++k, s += step )
+			acc = _mm256_fmadd_ps( _mm256_set1_ps( ker[k] ), _mm256_loadu_ps( s ), acc );
+		_mm256_storeu_ps( dst + i, acc );
+	}
+	correlate_floats_generic( src + i, ker, kerSize, step, dst + i, size - i );
+}
+
+#endif
+
+/**
+ * @brief dst[i] = sum( ker[k] * lines[k][i] ) for i in [0, size[
+ */
+inline void correlate_lines_floats_generic( const float* const* lines, const float* ker, const std::size_t kerSize,
+                                            float* dst, const std::size_t size )
+{
+	std::fill( dst, dst + size, 0.0f );
+	for( std::size_t k = 0; k < kerSize; ++k )
+	{
+		const float w = ker[k];
+		const float* s = lines[k];
+		for( std::size_t i = 0; i < size; ++i )
+			dst[i] += w * s[i];
+	}
+}
+
+#ifdef TERRY_FILTER_SIMD_X86
+
+__attribute__((target("sse2")))
+inline void correlate_lines_floats_sse2( const float* const* lines, const float* ker, const std::size_t kerSize,
+                                         float* dst, const std::size_t size )
+{
+	std::size_t i = 0;
+	for( ; i + 8 <= size; i += 8 )
+	{
+		__m128 acc0 = _mm_setzero_ps();
+		__m128 acc1 = _mm_setzero_ps();
+		for( std::size_t k = 0; k < kerSize; ++k )
+		{
+			const __m128 w = _mm_set1_ps( ker[k] );
+			const float* s = lines[k] + i;
+			acc0 = _mm_add_ps( acc0, _mm_mul_ps( w, _mm_loadu_ps( s ) ) );
+			acc1 = _mm_add_ps( acc1, _mm_mul_ps( w, _mm_loadu_ps( s + 4 ) ) );
+		}
+		_mm_storeu_ps( dst + i, acc0 );
+		_mm_storeu_ps( dst + i + 4, acc1 );
+	}
+	for( ; i < size; ++i )
+	{
+		float acc = 0.0f;
+		for( std::size_t k = 0; k < kerSize; ++k )
+			acc += ker[k] * lines[k][i];
+		dst[i] = acc;
+	}
+}
+
+__attribute__((target("avx2,fma")))
+inline void correlate_lines_floats_avx2( const float* const* lines, const float* ker, const std::size_t kerSize,
+                                         float* dst, const std::size_t size )
+{
+	std::size_t i = 0;
+	for( ; i + 32 <= size; i += 32 )
+	{
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+		__m256 acc2 = _mm256_setzero_ps();
+		__m256 acc3 = _mm256_setzero_ps();
+		for( std::size_t k = 0; k < kerSize; ++k )
+		{
+			const __m256 w = _mm256_set1_ps( ker[k] );
+			const float* s = lines[k] + i;
+			acc0 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s ), acc0 );
+			acc1 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s + 8 ), acc1 );
+			acc2 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s + 16 ), acc2 );
+			acc3 = _mm256_fmadd_ps( w, _mm256_loadu_ps( s + 24 ), acc3 );
+		}
+		_mm256_storeu_ps( dst + i, acc0 );
+		_mm256_storeu_ps( dst + i + 8, acc1 );
+		_mm256_storeu_ps( dst + i + 16, acc2 );
+		_mm256_storeu_ps( dst + i + 24, acc3 );
+	}
+	for( ; i + 8 <= size; i += 8 )
+	{
+		__m256 acc = _mm256_setzero_ps();
+		for( std::size_t k = 0; k < kerSize; ++k )
+			acc = _mm256_fmadd_ps( _mm256_set1_ps( ker[k] ), _mm256_loadu_ps( lines[k] + i ), acc );
+		_mm256_storeu_ps( dst + i, acc );
+	}
+	for( ; i < size; ++i )
+	{
+		float acc = 0.0f;
+		for( std::size_t k = 0; k < kerSize; ++k )
+			acc += ker[k] * lines[k][i];
+		dst[i] = acc;
+	}
+}
+
+#endif
+
+typedef void (*correlate_floats_function)( const float*, const float*, const std::size_t, const std::size_t, float*, const std::size_t );
+
+/// @return the best implementation for the current cpu
+inline correlate_floats_function select_correlate_floats()
+{
+#ifdef TERRY_FILTER_SIMD_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) )
+		return &correlate_floats_avx2;
+	if( __builtin_cpu_supports( "sse2" ) )
+		return &correlate_floats_sse2;
+#endif
+	return &correlate_floats_generic;
+}
+
+/// Correlation of float lines with the best implementation for the current cpu.
+inline void correlate_floats( const float* src, const float* ker, const std::size_t kerSize,
+                              const std::size_t step, float* dst, const std::size_t size )
+{
+	static const correlate_floats_function correlate = select_correlate_floats();
+	correlate( src, ker, kerSize, step, dst, size );
+}
+
+typedef void (*correlate_lines_floats_function)( const float* const*, const float*, const std::size_t, float*, const std::size_t );
+
+/// @return the best implementation for the current cpu
+inline correlate_lines_floats_function select_correlate_lines_floats()
+{
+#ifdef TERRY_FILTER_SIMD_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) )
+		return &correlate_lines_floats_avx2;
+	if( __builtin_cpu_supports( "sse2" ) )
+		return &correlate_lines_floats_sse2;
+#endif
+	return &correlate_lines_floats_generic;
+}
+
+/// Vertical correlation of float lines with the best implementation for the current cpu.
+inline void correlate_lines_floats( const float* const* lines, const float* ker, const std::size_t kerSize,
+                                    float* dst, const std::size_t size )
+{
+	static const correlate_lines_floats_function correlate = select_correlate_lines_floats();
+	correlate( lines, ker, kerSize, dst, size );
+}
+
+}
+}
+}
+
+#endif
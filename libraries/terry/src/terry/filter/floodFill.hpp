@@ -8,9 +8,12 @@
 #include <terry/math/Rect.hpp>
 #include <terry/numeric/minmax.hpp>
 #include <terry/algorithm/transform_pixels.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
 
+#include <algorithm>
 #include <queue>
 #include <list>
+#include <vector>
 
 
 namespace terry {
@@ -577,11 +580,400 @@ void flood_fill_bruteForce( const SView& srcView, const Rect<std::ssize_t>& srcR
 //	}
 }
 
+/**
+ * @brief Connected components of the pixels respecting the soft condition inside a window,
+ * and which of them contain a pixel respecting the strong condition.
+ *
+ * The components are computed by a union-find labelling: the ranges of soft
+ * pixels of the rows are labelled by chunks of rows on the threads of a launcher
+ * (compute()), or by the ranges of rows of the caller threads (labelRows()), then
+ * the chunks are connected in the order of the rows. Only the strong pixels
+ * of the seed window start a fill, the pixels outside of the window are
+ * never filled.
+ * After compute() or connectRows(), the labels are only read, so fill() can be called by
+ * several threads on different regions.
+ */
+template<template<class> class Allocator>
+class FloodFillLabels
+{
+public:
+	typedef int Label; ///< index of a pixel in the window
+	static const Label noLabel = -1;
+
+	FloodFillLabels()
+	: _width( 0 )
+	, _height( 0 )
+	{}
+
+	/**
+	 * @brief Prepare the labels of @p window, computed by labelRows() on ranges of rows then connectRows().
+	 * @param[in] window region to label
+	 * @param[in] seedWindow region where the strong pixels are searched (inside @p window)
+	 */
+	void init( const Rect<std::ssize_t>& window, const Rect<std::ssize_t>& seedWindow )
+	{
+		_window = window;
+		_width = std::max<std::ssize_t>( window.x2 - window.x1, 0 );
+		_height = std::max<std::ssize_t>( window.y2 - window.y1, 0 );
+		_parents.resize( _width * _height );
+		_strong.resize( _width * _height );
+		_firstRows.assign( _height, 0 );
+		_seeds = translateRegion( rectanglesIntersection( seedWindow, window ), window );
+	}
+
+	/**
+	 * @param[in] launcher runs the labelling of the chunks (see terry::algorithm::serial_launcher)
+	 * @param[in] srcView input image
+	 * @param[in] srcRod input image ROD
+	 * @param[in] window region to label
+	 * @param[in] seedWindow region where the strong pixels are searched (inside @p window)
+	 */
+	template<class Connexity, class StrongTest, class SoftTest, class SView, class Launcher>
+	void compute( const Launcher& launcher, const SView& srcView, const Rect<std::ssize_t>& srcRod,
+	              const Rect<std::ssize_t>& window, const Rect<std::ssize_t>& seedWindow,
+	              const StrongTest& strongTest, const SoftTest& softTest )
+	{
+		init( window, seedWindow );
+		if( _width == 0 || _height == 0 )
+			return;
+
+		const SView src = subimage_view( srcView, window.x1 - srcRod.x1, window.y1 - srcRod.y1, _width, _height );
+		terry::algorithm::parallel_reduce_rows( launcher, _height,
+			RowsLabelling<Connexity, StrongTest, SoftTest, SView>( *this, src, strongTest, softTest ) );
+	}
+
+	/**
+	 * @brief Label the rows [y1, y2[ of the window (image coordinates), after init().
+	 * The first row is not connected to the row above: several threads can label
+	 * different ranges of rows, then connectRows() connects the ranges.
+	 */
+	template<class Connexity, class StrongTest, class SoftTest, class SView>
+	void labelRows( const SView& srcView, const Rect<std::ssize_t>& srcRod,
+	                const std::ssize_t y1, const std::ssize_t y2,
+	                const StrongTest& strongTest, const SoftTest& softTest )
+	{
+		const std::ssize_t yBegin = std::max( y1, _window.y1 ) - _window.y1;
+		const std::ssize_t yEnd = std::min( y2, _window.y2 ) - _window.y1;
+		if( _width == 0 || yBegin >= yEnd )
+			return;
+
+		const SView src = subimage_view( srcView, _window.x1 - srcRod.x1, _window.y1 - srcRod.y1, _width, _height );
+		_firstRows[yBegin] = 1;
+		for( std::ssize_t y = yBegin; y < yEnd; ++y )
+			labelRow<Connexity>( src, y, y > yBegin, strongTest, softTest );
+	}
+
+	/// @brief Connect the ranges of rows of labelRows(), once all the rows of the window are labelled.
+	template<class Connexity>
+	void connectRows()
+	{
+		for( std::ssize_t y = 1; y < _height; ++y )
+		{
+			if( _firstRows[y] )
+				connectRow<Connexity>( y );
+		}
+	}
+
+	/// @brief Is the pixel (x, y) inside the window and connected to a strong pixel.
+	bool isFilled( const std::ssize_t x, const std::ssize_t y ) const
+	{
+		if( x < _window.x1 || x >= _window.x2 || y < _window.y1 || y >= _window.y2 )
+			return false;
+		const Label label = _parents[ ( y - _window.y1 ) * _width + ( x - _window.x1 ) ];
+		return label != noLabel && _strong[ root( label ) ];
+	}
+
+	/**
+	 * @brief Set to white the filled pixels of @p region, the other pixels are unchanged.
+	 * @param[out] dstView output image
+	 * @param[in] dstRod output image ROD
+	 */
+	template<class DView>
+	void fill( const DView& dstView, const Rect<std::ssize_t>& dstRod, const Rect<std::ssize_t>& region ) const
+	{
+		typedef typename DView::value_type DPixel;
+		static const DPixel white = get_white<DPixel>();
+
+		const Rect<std::ssize_t> r = rectanglesIntersection( region, _window );
+		for( std::ssize_t y = r.y1; y < r.y2; ++y )
+		{
+			typename DView::x_iterator dst_it = dstView.row_begin( y - dstRod.y1 ) + ( r.x1 - dstRod.x1 );
+			const Label* labels = &_parents[ ( y - _window.y1 ) * _width ];
+			// the pixels of a range have the same parent
+			Label lastLabel = noLabel;
+			bool lastFilled = false;
+			for( std::ssize_t x = r.x1; x < r.x2; ++x, ++dst_it )
+			{
+				const Label label = labels[ x - _window.x1 ];
+				if( label == noLabel )
+					continue;
+				if( label != lastLabel )
+				{
+					lastLabel = label;
+					lastFilled = _strong[ root( label ) ];
+				}
+				if( lastFilled )
+					*dst_it = white;
+			}
+		}
+	}
+
+private:
+	/**
+	 * @brief Labelling of the rows of a chunk, reducer of parallel_reduce_rows.
+	 * Each chunk only writes the labels of its rows, the merge connects the
+	 * first row of the next chunk to the last row of this chunk.
+	 */
+	template<class Connexity, class StrongTest, class SoftTest, class SView>
+	struct RowsLabelling
+	{
+		FloodFillLabels* _labels;
+		SView _src;
+		StrongTest _strongTest;
+		SoftTest _softTest;
+		std::ptrdiff_t _yBegin; ///< first row of the chunk
+
+		RowsLabelling( FloodFillLabels& labels, const SView& src, const StrongTest& strongTest, const SoftTest& softTest )
+		: _labels( &labels )
+		, _src( src )
+		, _strongTest( strongTest )
+		, _softTest( softTest )
+		, _yBegin( -1 )
+		{}
+
+		void operator()( const std::ptrdiff_t y )
+		{
+			if( _yBegin < 0 )
+				_yBegin = y;
+			_labels->template labelRow<Connexity>( _src, y, y > _yBegin, _strongTest, _softTest );
+		}
+
+		void merge( const RowsLabelling& next )
+		{
+			if( next._yBegin > 0 )
+				_labels->template connectRow<Connexity>( next._yBegin );
+		}
+	};
+
+	/**
+	 * @brief Label the ranges of soft pixels of the row @p y of @p src (the window),
+	 * connected to the row above if @p connect.
+	 */
+	template<class Connexity, class StrongTest, class SoftTest, class SView>
+	void labelRow( const SView& src, const std::ssize_t y, const bool connect,
+	               const StrongTest& strongTest, const SoftTest& softTest )
+	{
+		const Label row = y * _width;
+		const bool seedRow = y >= _seeds.y1 && y < _seeds.y2;
+		typename SView::x_iterator src_it = src.row_begin( y );
+		std::ssize_t x = 0;
+		while( x < _width )
+		{
+			if( ! softTest( (*src_it)[0] ) )
+			{
+				_parents[row + x] = noLabel;
+				++x;
+				++src_it;
+				continue;
+			}
+			// all the pixels of a range are attached to its first pixel
+			const std::ssize_t xBegin = x;
+			const Label first = row + xBegin;
+			bool strong = false;
+			do
+			{
+				_parents[row + x] = first;
+				if( ! strong && seedRow && x >= _seeds.x1 && x < _seeds.x2 )
+					strong = strongTest( (*src_it)[0] );
+				++x;
+				++src_it;
+			}
+			while( x < _width && softTest( (*src_it)[0] ) );
+			_strong[first] = strong;
+			if( connect )
+				connectAbove<Connexity>( first, xBegin, x );
+		}
+	}
+
+	/// @brief Connect the ranges of the row @p y, already labelled, to the row above.
+	template<class Connexity>
+	void connectRow( const std::ssize_t y )
+	{
+		const Label row = y * _width;
+		std::ssize_t x = 0;
+		while( x < _width )
+		{
+			if( _parents[row + x] == noLabel )
+			{
+				++x;
+				continue;
+			}
+			const std::ssize_t xBegin = x;
+			while( x < _width && _parents[row + x] != noLabel )
+				++x;
+			connectAbove<Connexity>( row + xBegin, xBegin, x );
+		}
+	}
+
+	/**
+	 * @brief Connect the range [xBegin, xEnd[ of a row, starting at the pixel @p first,
+	 * to the ranges of the previous row. Only one union is done for each range of the previous row.
+	 */
+	template<class Connexity>
+	void connectAbove( const Label first, const std::ssize_t xBegin, const std::ssize_t xEnd )
+	{
+		const std::ssize_t aboveBegin = std::max<std::ssize_t>( xBegin - Connexity::x, 0 );
+		const std::ssize_t aboveEnd = std::min<std::ssize_t>( xEnd + Connexity::x, _width );
+		const Label above = first - xBegin - _width;
+		for( std::ssize_t x = aboveBegin; x < aboveEnd; ++x )
+		{
+			if( _parents[above + x] != noLabel &&
+			    ( x == aboveBegin || _parents[above + x - 1] == noLabel ) )
+				unite( first, above + x );
+		}
+	}
+
+	/// @brief Root of a label, with path halving (only on the labels written by the current thread).
+	Label find( Label i )
+	{
+		while( _parents[i] != i )
+		{
+			_parents[i] = _parents[_parents[i]];
+			i = _parents[i];
+		}
+		return i;
+	}
+
+	/// @brief Root of a label, without modification.
+	Label root( Label i ) const
+	{
+		while( _parents[i] != i )
+			i = _parents[i];
+		return i;
+	}
+
+	/// @brief Union of the components of @p a and @p b, the root is the first pixel.
+	void unite( const Label a, const Label b )
+	{
+		Label ra = find( a );
+		Label rb = find( b );
+		if( ra == rb )
+			return;
+		if( rb < ra )
+			std::swap( ra, rb );
+		_parents[rb] = ra;
+		_strong[ra] = _strong[ra] || _strong[rb];
+	}
+
+private:
+	Rect<std::ssize_t> _window;
+	Rect<std::ssize_t> _seeds; ///< in the coordinates of the window
+	std::ssize_t _width;
+	std::ssize_t _height;
+	std::vector<Label, Allocator<Label> > _parents; ///< parent of each pixel of the window, noLabel outside of the soft pixels
+	std::vector<char, Allocator<char> > _strong; ///< for the roots: the component contains a strong pixel
+	std::vector<char, Allocator<char> > _firstRows; ///< first rows of the ranges of labelRows(), to connect
+};
+
+namespace detail {
+
+/**
+ * @brief Writes the filled pixels of the rows, reducer of parallel_reduce_rows.
+ */
+template<class Labels, class DView>
+struct flood_fill_rows_writer
+{
+	const Labels* _labels;
+	DView _dstView;
+	Rect<std::ssize_t> _dstRod;
+	Rect<std::ssize_t> _procWindow;
+
+	flood_fill_rows_writer( const Labels& labels, const DView& dstView, const Rect<std::ssize_t>& dstRod, const Rect<std::ssize_t>& procWindow )
+	: _labels( &labels )
+	, _dstView( dstView )
+	, _dstRod( dstRod )
+	, _procWindow( procWindow )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		Rect<std::ssize_t> row = _procWindow;
+		row.y1 = _procWindow.y1 + y;
+		row.y2 = row.y1 + 1;
+		_labels->fill( _dstView, _dstRod, row );
+	}
+
+	void merge( const flood_fill_rows_writer& ) {}
+};
+
+}
+
+/**
+ * @brief Is there a pixel respecting the soft condition in the border of 1 pixel around @p procWindow (inside @p rod).
+ * Without them, the fill of flood_fill stays inside @p procWindow,
+ * and the fill of FloodFillLabels on @p procWindow is the same.
+ */
+template<class SoftTest, class SView>
+bool soft_pixels_around( const SView& srcView, const Rect<std::ssize_t>& srcRod,
+                         const Rect<std::ssize_t>& rod, const Rect<std::ssize_t>& procWindow,
+                         const SoftTest& softTest )
+{
+	const Rect<std::ssize_t> around = rectanglesIntersection( rectangleGrow( procWindow, 1 ), rod );
+	for( std::ssize_t y = around.y1; y < around.y2; ++y )
+	{
+		const bool insideRow = y >= procWindow.y1 && y < procWindow.y2;
+		typename SView::x_iterator src_it = srcView.row_begin( y - srcRod.y1 ) + ( around.x1 - srcRod.x1 );
+		for( std::ssize_t x = around.x1; x < around.x2; ++x, ++src_it )
+		{
+			if( insideRow && x == procWindow.x1 && procWindow.x1 < procWindow.x2 )
+			{
+				// skip the pixels of procWindow
+				src_it += procWindow.x2 - 1 - x;
+				x = procWindow.x2 - 1;
+				continue;
+			}
+			if( softTest( (*src_it)[0] ) )
+				return true;
+		}
+	}
+	return false;
 }
 
+/**
+ * @brief Parallel flood fill of an image, with 2 conditions.
+ * Same parameters and same result as flood_fill, on the threads of @p launcher.
+ * flood_fill can follow paths through the pixels around @p procWindow, so
+ * when one of them respects the soft condition, flood_fill is used.
+ * Otherwise the connected components of @p procWindow are labelled in parallel.
+ * @see FloodFillLabels
+ */
+template<class Connexity, class StrongTest, class SoftTest, class SView, class DView, template<class> class Allocator, class Launcher>
+void flood_fill_parallel( const Launcher& launcher, const SView& srcView, const Rect<std::ssize_t>& srcRod,
+                          DView& dstView, const Rect<std::ssize_t>& dstRod,
+                          const Rect<std::ssize_t>& procWindow,
+                          const StrongTest& strongTest, const SoftTest& softTest )
+{
+	typedef FloodFillLabels<Allocator> Labels;
+	const Rect<std::ssize_t> rod = rectanglesIntersection( srcRod, dstRod );
+	if( soft_pixels_around( srcView, srcRod, rod, procWindow, softTest ) )
+	{
+		flood_fill<Connexity, StrongTest, SoftTest, SView, DView, Allocator>(
+			srcView, srcRod, dstView, dstRod, procWindow, strongTest, softTest );
+		return;
+	}
+	const Rect<std::ssize_t> window = rectanglesIntersection( procWindow, rod );
+	Labels labels;
+	labels.template compute<Connexity>( launcher, srcView, srcRod, window, procWindow, strongTest, softTest );
+	terry::algorithm::parallel_reduce_rows( launcher, std::max<std::ssize_t>( window.y2 - window.y1, 0 ),
+		detail::flood_fill_rows_writer<Labels, DView>( labels, dstView, dstRod, window ) );
+}
 
-template<template<class> class Allocator, class SView, class DView>
+}
+
+
+template<template<class> class Allocator, class SView, class DView, class Launcher>
 void applyFloodFill(
+	const Launcher& launcher,
 	const SView& srcView,
 	      DView& dstView,
 	const double lowerThres, const double upperThres )
@@ -610,8 +1002,8 @@ void applyFloodFill(
 	if( isConstantImage )
 		return;
 	
-	floodFill::flood_fill<floodFill::Connexity4, floodFill::IsUpper<Scalar>, floodFill::IsUpper<Scalar>, SView, DView, Allocator>(
-				srcView, getBounds<std::ptrdiff_t>(srcView),
+	floodFill::flood_fill_parallel<floodFill::Connexity4, floodFill::IsUpper<Scalar>, floodFill::IsUpper<Scalar>, SView, DView, Allocator>(
+				launcher, srcView, getBounds<std::ptrdiff_t>(srcView),
 				dstView, getBounds<std::ptrdiff_t>(dstView),
 				rectangleReduce( getBounds<std::ptrdiff_t>(dstView), 1 ),
 				floodFill::IsUpper<Scalar>(upperThresR),
@@ -619,6 +1011,15 @@ void applyFloodFill(
 				);
 }
 
+template<template<class> class Allocator, class SView, class DView>
+void applyFloodFill(
+	const SView& srcView,
+	      DView& dstView,
+	const double lowerThres, const double upperThres )
+{
+	applyFloodFill<Allocator>( terry::algorithm::serial_launcher(), srcView, dstView, lowerThres, upperThres );
+}
+
 
 }
 }
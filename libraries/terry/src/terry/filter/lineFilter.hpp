@@ -0,0 +1,185 @@
+#ifndef _TERRY_FILTER_LINEFILTER_HPP_
+#define _TERRY_FILTER_LINEFILTER_HPP_
+
+#include "convolve.hpp"
+
+#include <boost/gil/image.hpp>
+#include <boost/gil/color_convert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace terry {
+using namespace boost::gil;
+
+namespace filter {
+
+/**
+ * @brief Horizontal pass of a separable line filter, as a row functor
+ * (for terry::algorithm::parallel_for_rows).
+ *
+ * Row y of the buffer is the row dst_tl.y - margin.y + y of src, extended by
+ * margin.x on each side with the boundary option, filtered by filterX and cropped
+ * to the width of the buffer. Each copy has its own line buffer and filter.
+ */
+template<typename PixelAccum, template<typename> class Alloc, typename SrcView, typename LineFilterX>
+struct line_filter_rows
+{
+	typedef typename channel_type<PixelAccum>::type Channel;
+
+	SrcView _src;
+	PixelAccum* _tmp; ///< rows of width pixels
+	std::ptrdiff_t _width;
+	typename SrcView::point_t _dst_tl;
+	point2<std::ptrdiff_t> _margin;
+	convolve_boundary_option _option;
+	LineFilterX _filter;
+	std::vector<PixelAccum, Alloc<PixelAccum> > _line;
+
+	line_filter_rows( const SrcView& src, PixelAccum* tmp, const std::ptrdiff_t width, const typename SrcView::point_t& dst_tl,
+	                  const point2<std::ptrdiff_t>& margin, const convolve_boundary_option option, const LineFilterX& filter )
+	: _src( src )
+	, _tmp( tmp )
+	, _width( width )
+	, _dst_tl( dst_tl )
+	, _margin( margin )
+	, _option( option )
+	, _filter( filter )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		const std::size_t nbChannels = num_channels<PixelAccum>::value;
+		PixelAccum zero;
+		for( std::size_t c = 0; c < nbChannels; ++c )
+			zero[c] = Channel( 0 );
+
+		PixelAccum* tmpRow = _tmp + y * _width;
+		const std::ptrdiff_t srcY = detail::extended_line_index( _dst_tl.y - _margin.y + y, _src.height(), _option );
+		if( srcY < 0 )
+		{
+			std::fill( tmpRow, tmpRow + _width, zero );
+			return;
+		}
+		const std::ptrdiff_t lineSize = _width + 2 * _margin.x;
+		_line.resize( lineSize );
+		const typename SrcView::x_iterator srcRow = _src.row_begin( srcY );
+		const std::ptrdiff_t x0 = _dst_tl.x - _margin.x;
+		for( std::ptrdiff_t x = 0; x < lineSize; ++x )
+		{
+			const std::ptrdiff_t srcX = detail::extended_line_index( x0 + x, _src.width(), _option );
+			if( srcX < 0 )
+				_line[x] = zero;
+			else
+				color_convert( srcRow[srcX], _line[x] );
+		}
+		_filter( reinterpret_cast<Channel*>( &_line.front() ), lineSize, nbChannels );
+		std::copy( _line.begin() + _margin.x, _line.begin() + _margin.x + _width, tmpRow );
+	}
+};
+
+/**
+ * @brief Vertical pass of a separable line filter, in place, as a row functor
+ * on the strips of columns of the buffer (for terry::algorithm::parallel_for_rows).
+ *
+ * Each sample given to filterY is a row of the strip, so the filter reads the memory
+ * linearly. A strip narrower than the buffer is filtered in a contiguous copy.
+ */
+template<typename PixelAccum, template<typename> class Alloc, typename LineFilterY>
+struct line_filter_cols
+{
+	typedef typename channel_type<PixelAccum>::type Channel;
+
+	PixelAccum* _tmp; ///< nbRows rows of width pixels
+	std::ptrdiff_t _width;
+	std::ptrdiff_t _nbRows;
+	std::ptrdiff_t _stripWidth;
+	LineFilterY _filter;
+	std::vector<PixelAccum, Alloc<PixelAccum> > _strip;
+
+	line_filter_cols( PixelAccum* tmp, const std::ptrdiff_t width, const std::ptrdiff_t nbRows,
+	                  const std::ptrdiff_t stripWidth, const LineFilterY& filter )
+	: _tmp( tmp )
+	, _width( width )
+	, _nbRows( nbRows )
+	, _stripWidth( stripWidth )
+	, _filter( filter )
+	{}
+
+	/// number of strips of the buffer
+	std::ptrdiff_t nbStrips() const { return ( _width + _stripWidth - 1 ) / _stripWidth; }
+
+	void operator()( const std::ptrdiff_t strip )
+	{
+		const std::size_t nbChannels = num_channels<PixelAccum>::value;
+		const std::ptrdiff_t x0 = strip * _stripWidth;
+		const std::ptrdiff_t w = std::min( _stripWidth, _width - x0 );
+		if( w == _width )
+		{
+			_filter( reinterpret_cast<Channel*>( _tmp ), _nbRows, _width * nbChannels );
+			return;
+		}
+		_strip.resize( _nbRows * w );
+		for( std::ptrdiff_t y = 0; y < _nbRows; ++y )
+			std::copy( _tmp + y * _width + x0, _tmp + y * _width + x0 + w, _strip.begin() + y * w );
+		_filter( reinterpret_cast<Channel*>( &_strip.front() ), _nbRows, w * nbChannels );
+		for( std::ptrdiff_t y = 0; y < _nbRows; ++y )
+			std::copy( _strip.begin() + y * w, _strip.begin() + ( y + 1 ) * w, _tmp + y * _width + x0 );
+	}
+};
+
+/**
+ * @brief Apply a separable filter with a 1D line functor on rows then on columns.
+ *
+ * Unlike correlate_rows_cols, the filter is not described by a kernel but by
+ * a functor which filters in place an array of samples:
+ * @code
+ * void operator()( Channel* data, const std::size_t nbSamples, const std::size_t sampleSize );
+ * @endcode
+ * where each sample is made of sampleSize contiguous channel values.
+ * On rows a sample is a pixel, on columns a sample is a whole row of the
+ * processing window, so the vertical pass also reads the memory linearly.
+ *
+ * The lines are extended by @p margin on each side with the boundary option,
+ * so the filters with an infinite support (recursive filters) only see the
+ * extended borders through their initialization.
+ *
+ * To share the passes between threads, use line_filter_rows and line_filter_cols.
+ *
+ * @param dst_tl topleft point of dst in src coordinates (can be outside of src)
+ * @param margin number of extended values needed on each side by the filters
+ */
+template<typename PixelAccum, template<typename> class Alloc, typename SrcView, typename DstView, typename LineFilterX, typename LineFilterY>
+void line_filter_rows_cols( const SrcView& src, const DstView& dst, const typename SrcView::point_t& dst_tl,
+                            const point2<std::ptrdiff_t>& margin, const convolve_boundary_option option,
+                            LineFilterX filterX, LineFilterY filterY )
+{
+	const std::ptrdiff_t width   = dst.width();
+	const std::ptrdiff_t height  = dst.height();
+	if( width == 0 || height == 0 )
+		return;
+
+	// horizontal pass on all the rows needed by the vertical pass
+	const std::ptrdiff_t nbTmpRows = height + 2 * margin.y;
+	std::vector<PixelAccum, Alloc<PixelAccum> > tmp( nbTmpRows * width );
+	line_filter_rows<PixelAccum, Alloc, SrcView, LineFilterX> rows( src, &tmp.front(), width, dst_tl, margin, option, filterX );
+	for( std::ptrdiff_t y = 0; y < nbTmpRows; ++y )
+		rows( y );
+
+	// vertical pass: each sample is a row
+	line_filter_cols<PixelAccum, Alloc, LineFilterY>( &tmp.front(), width, nbTmpRows, width, filterY )( 0 );
+
+	for( std::ptrdiff_t y = 0; y < height; ++y )
+	{
+		const PixelAccum* tmpRow = &tmp[( y + margin.y ) * width];
+		typename DstView::x_iterator dstIt = dst.row_begin( y );
+		for( std::ptrdiff_t x = 0; x < width; ++x, ++dstIt )
+			color_convert( tmpRow[x], *dstIt );
+	}
+}
+
+}
+}
+
+#endif
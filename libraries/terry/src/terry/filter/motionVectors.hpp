@@ -13,6 +13,7 @@
 #include <boost/mpl/if.hpp>
 #include <boost/type_traits/is_same.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace terry {
@@ -119,8 +120,32 @@ bool correlateMotionVectors( GView& xGradientView, GView& yGradientView, View& i
 	return false;
 }
 
+/// Width of the tiles of the rows of motionvectors_resample_pixels, the tiles without motion are copied.
+static const std::ptrdiff_t motionvectors_tile_width = 32;
+
+namespace detail {
+
+/// @return true if the n vectors from xit_xVec and xit_yVec are null.
+template<typename VecIterator>
+bool null_motion_vectors( VecIterator xit_xVec, VecIterator xit_yVec, const std::ptrdiff_t n )
+{
+	for( std::ptrdiff_t i = 0; i < n; ++i, ++xit_xVec, ++xit_yVec )
+	{
+		if( boost::gil::get_color( *xit_xVec, boost::gil::gray_color_t() ) != 0 ||
+		    boost::gil::get_color( *xit_yVec, boost::gil::gray_color_t() ) != 0 )
+			return false;
+	}
+	return true;
+}
+
+}
+
 /**
  * @brief Moves the pixels based on the variation of the mask (the derivative: [-1 0 1] kernel)
+ *
+ * The rows are processed by tiles of motionvectors_tile_width pixels.
+ * The tiles without motion (null vectors or out of the vectors RoD) which are
+ * in the source image are copied, the samplers would only return the source pixels.
  */
 template<
 	typename Sampler, // Models SamplerConcept
@@ -149,7 +174,6 @@ bool motionvectors_resample_pixels( const SrcView& srcView, const Rect<std::ssiz
 	BOOST_ASSERT( dstView.width() == dstRod.x2 - dstRod.x1 );
 	BOOST_ASSERT( dstView.height() == dstRod.y2 - dstRod.y1 );
 
-	typedef typename DstView::point_t Point2Integer;
 	typedef typename boost::gil::channel_type<VecView>::type::base_channel_t VecChannel;
 	typedef typename boost::gil::point2<VecChannel> VecPoint2;
 	typedef typename DstView::coord_t Coord;
@@ -160,62 +184,63 @@ bool motionvectors_resample_pixels( const SrcView& srcView, const Rect<std::ssiz
 	DstPixel black;
 	color_convert( boost::gil::rgba32f_pixel_t( 0.0, 0.0, 0.0, 0.0 ), black );
 
-	// shift between the procWindow and the output clip RoD
-	// __________________________
-	// |\        dst RoD         |
-	// | \_________________      |
-	// |  |   procWindow   |     |
-	// |  |                |     |
-	// |  |                |     |
-	// |  |________________|     |
-	// |                    \    |
-	// |                      \  |
-	// |________________________\|
-	// procWindow is necessarily contained in dst RoD
-	//
-	Rect<std::ssize_t> shiftProcWinDstRod; // only positive values
-	shiftProcWinDstRod.x1 = procWindowRoW.x1 - dstRod.x1;
-	shiftProcWinDstRod.y1 = procWindowRoW.y1 - dstRod.y1;
-	shiftProcWinDstRod.x2 = dstRod.x2 - procWindowRoW.x2;
-	shiftProcWinDstRod.y2 = dstRod.y2 - procWindowRoW.y2;
-	Rect<std::ssize_t> shiftProcWinVecRod;
-	shiftProcWinVecRod.x1 = procWindowRoW.x1 - vecRod.x1;
-	shiftProcWinVecRod.y1 = procWindowRoW.y1 - vecRod.y1;
-	shiftProcWinVecRod.x2 = vecRod.x2 - procWindowRoW.x2;
-	shiftProcWinVecRod.y2 = vecRod.y2 - procWindowRoW.y2;
+	// the vectors of the procWindow columns, out of this range there is no motion
+	const Coord xVecBegin = std::max( procWindowRoW.x1, vecRod.x1 );
+	const Coord xVecEnd = std::min( procWindowRoW.x2, vecRod.x2 );
 
 	for( Coord y = procWindowRoW.y1; y < procWindowRoW.y2; ++y )
 	{
 		const Coord yDst = y - dstRod.y1;
 		const Coord ySrc = y - srcRod.y1;
-		const Coord yVec = y - vecRod.y1;
-		typename DstView::x_iterator xit_dst  = dstView.x_at( shiftProcWinDstRod.x1, yDst );
-		typename VecView::x_iterator xit_xVec = xVecView.x_at( shiftProcWinVecRod.x1, yVec );
-		typename VecView::x_iterator xit_yVec = yVecView.x_at( shiftProcWinVecRod.x1, yVec );
-		for( Coord x = procWindowRoW.x1;
-		     x < procWindowRoW.x2;
-		     ++x, ++xit_dst, ++xit_xVec, ++xit_yVec )
+		const bool rowWithVectors = y >= vecRod.y1 && y < vecRod.y2 && xVecBegin < xVecEnd;
+		const bool rowInSrc = y >= srcRod.y1 && y < srcRod.y2;
+		typename VecView::x_iterator xit_xVec;
+		typename VecView::x_iterator xit_yVec;
+		if( rowWithVectors )
 		{
-			const Coord xSrc = x - srcRod.x1;
-			const VecPoint2 pos( xSrc, ySrc );
+			xit_xVec = xVecView.x_at( xVecBegin - vecRod.x1, y - vecRod.y1 );
+			xit_yVec = yVecView.x_at( xVecBegin - vecRod.x1, y - vecRod.y1 );
+		}
 
-			VecPoint2 motion;
-			if( x < vecRod.x1 || x > vecRod.x2 ||
-			    y < vecRod.y1 || y > vecRod.y2 )
-			{
-				motion.x = 0;
-				motion.y = 0;
-			}
-			else
+		for( Coord xTile = procWindowRoW.x1; xTile < procWindowRoW.x2; xTile += motionvectors_tile_width )
+		{
+			const Coord xTileEnd = std::min( Coord( xTile + motionvectors_tile_width ), Coord( procWindowRoW.x2 ) );
+			// the columns of the tile with vectors
+			const Coord xTileVecBegin = rowWithVectors ? std::max( xTile, xVecBegin ) : xTile;
+			const Coord xTileVecEnd = rowWithVectors ? std::min( xTileEnd, xVecEnd ) : xTile;
+
+			if( rowInSrc && xTile >= srcRod.x1 && xTileEnd <= srcRod.x2 &&
+			    ( xTileVecBegin >= xTileVecEnd ||
+			      detail::null_motion_vectors( xit_xVec + ( xTileVecBegin - xVecBegin ), xit_yVec + ( xTileVecBegin - xVecBegin ), xTileVecEnd - xTileVecBegin ) ) )
 			{
-				motion.x = boost::gil::get_color( *xit_xVec, boost::gil::gray_color_t() );
-				motion.y = boost::gil::get_color( *xit_yVec, boost::gil::gray_color_t() );
+				copy_and_convert_pixels( subimage_view( srcView, xTile - srcRod.x1, ySrc, xTileEnd - xTile, 1 ),
+				                         subimage_view( dstView, xTile - dstRod.x1, yDst, xTileEnd - xTile, 1 ) );
+				continue;
 			}
 
-			// compute the pixel value according to the resample method
-			if( !terry::sampler::sample( sampler, srcView, pos + motion, *xit_dst, outOfImageProcess ) )
+			typename DstView::x_iterator xit_dst = dstView.x_at( xTile - dstRod.x1, yDst );
+			for( Coord x = xTile; x < xTileEnd; ++x, ++xit_dst )
 			{
-				*xit_dst = black; // if it is outside of the source image
+				const Coord xSrc = x - srcRod.x1;
+				const VecPoint2 pos( xSrc, ySrc );
+
+				VecPoint2 motion;
+				if( x < xTileVecBegin || x >= xTileVecEnd )
+				{
+					motion.x = 0;
+					motion.y = 0;
+				}
+				else
+				{
+					motion.x = boost::gil::get_color( xit_xVec[x - xVecBegin], boost::gil::gray_color_t() );
+					motion.y = boost::gil::get_color( xit_yVec[x - xVecBegin], boost::gil::gray_color_t() );
+				}
+
+				// compute the pixel value according to the resample method
+				if( !terry::sampler::sample( sampler, srcView, pos + motion, *xit_dst, outOfImageProcess ) )
+				{
+					*xit_dst = black; // if it is outside of the source image
+				}
 			}
 		}
 
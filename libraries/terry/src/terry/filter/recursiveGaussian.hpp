@@ -0,0 +1,131 @@
+#ifndef _TERRY_FILTER_RECURSIVEGAUSSIAN_HPP_
+#define _TERRY_FILTER_RECURSIVEGAUSSIAN_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace terry {
+namespace filter {
+
+/**
+ * @brief Recursive gaussian filter of Young and van Vliet.
+ *
+ * A causal and an anti-causal third order IIR filters approximate
+ * a gaussian of standard deviation sigma, with a constant cost per value
+ * whatever the value of sigma.
+ *
+ * The instances have temporary buffers, so use one copy per thread.
+ *
+ * "Recursive implementation of the Gaussian filter",
+ * I.T. Young, L.J. van Vliet, Signal Processing 44 (1995)
+ */
+struct recursive_gaussian_filter
+{
+	double _sigma;
+	double _B;   ///< gain
+	double _b1;  ///< feedback coefficients normalized by b0
+	double _b2;
+	double _b3;
+
+	/// The approximation is only valid for sigma >= 0.5, a smaller sigma does nothing.
+	explicit recursive_gaussian_filter( const double sigma = 0 )
+	: _sigma( sigma )
+	, _B( 1 )
+	, _b1( 0 )
+	, _b2( 0 )
+	, _b3( 0 )
+	, _w1( NULL )
+	, _w2( NULL )
+	, _w3( NULL )
+	{
+		if( ! valid() )
+			return;
+		const double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330
+		                              : 3.97156 - 4.14554 * std::sqrt( 1.0 - 0.26891 * sigma );
+		// the coefficients are computed from the poles instead of the rounded polynomials
+		// of the article, which don't sum to 1 for large values of sigma
+		const double m0 = 1.16680;
+		const double m1 = 1.10783;
+		const double m2 = 1.40586;
+		const double m12 = m1 * m1 + m2 * m2;
+		const double q2 = q * q;
+		const double q3 = q2 * q;
+		const double scale = ( m0 + q ) * ( m12 + 2.0 * m1 * q + q2 );
+		_b1 = q * ( 2.0 * m0 * m1 + m12 + ( 2.0 * m0 + 4.0 * m1 ) * q + 3.0 * q2 ) / scale;
+		_b2 = - q2 * ( m0 + 2.0 * m1 + 3.0 * q ) / scale;
+		_b3 = q3 / scale;
+		_B  = m0 * m12 / scale; // 1 - ( b1 + b2 + b3 ) without the cancellation
+	}
+
+	bool valid() const { return _sigma >= 0.5; }
+
+	/// Number of values needed on each side of a line to initialize the filter
+	/// (4 sigma give a truncation error lower than 1e-3).
+	std::ptrdiff_t margin() const { return valid() ? static_cast<std::ptrdiff_t>( std::ceil( 4.0 * _sigma ) ) : 0; }
+
+	/**
+	 * @brief Filter in place nbSamples samples of sampleSize contiguous values.
+	 * The values before and after the line are considered equal to the first and last values.
+	 */
+	template<typename T>
+	void operator()( T* data, const std::size_t nbSamples, const std::size_t sampleSize )
+	{
+		if( ! valid() || nbSamples == 0 )
+			return;
+
+		const std::ptrdiff_t s = sampleSize;
+		const std::ptrdiff_t n = nbSamples;
+
+		// causal pass, the steady state of a constant input is the input
+		initState( data, s );
+		for( std::ptrdiff_t i = 0; i < n; ++i )
+			filterSample( data + i * s, s );
+
+		// anti-causal pass
+		initState( data + ( n - 1 ) * s, s );
+		for( std::ptrdiff_t i = n - 1; i >= 0; --i )
+			filterSample( data + i * s, s );
+	}
+
+private:
+	template<typename T>
+	void initState( const T* sample, const std::ptrdiff_t s )
+	{
+		_state.resize( 3 * s );
+		_w1 = &_state[0];
+		_w2 = _w1 + s;
+		_w3 = _w2 + s;
+		for( std::ptrdiff_t k = 0; k < s; ++k )
+			_w1[k] = _w2[k] = _w3[k] = sample[k];
+	}
+
+	template<typename T>
+	void filterSample( T* x, const std::ptrdiff_t s )
+	{
+		// the new value replaces the oldest one
+		double* w = _w3;
+		for( std::ptrdiff_t k = 0; k < s; ++k )
+		{
+			w[k] = _B * x[k] + _b1 * _w1[k] + _b2 * _w2[k] + _b3 * _w3[k];
+			x[k] = T( w[k] );
+		}
+		_w3 = _w2;
+		_w2 = _w1;
+		_w1 = w;
+	}
+
+private:
+	// The poles are close to 1 for large values of sigma, so the previous
+	// outputs are kept in double, a float feedback is not stable.
+	std::vector<double> _state;
+	double* _w1;
+	double* _w2;
+	double* _w3;
+};
+
+}
+}
+
+#endif
@@ -7,6 +7,12 @@
 #include <terry/numeric/operations.hpp>
 #include <terry/numeric/assign_minmax.hpp>
 #include <terry/numeric/init.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <vector>
 
 namespace terry {
 namespace filter {
@@ -88,46 +94,315 @@ struct pixel_locator_thinning_t
 	}
 };
 
+typedef boost::uint64_t bits_word_t;
+static const std::ptrdiff_t bits_per_word = 64;
+
+/**
+ * @brief Binary image, with one bit per pixel and 64 pixels per word.
+ * The bit of the pixel x is the bit x+1 of its row, so the first and the
+ * last bits of each row are always 0 (the neighbours of the borders).
+ */
+class BitImage
+{
+public:
+	BitImage()
+	: _width( 0 )
+	, _height( 0 )
+	, _nbWords( 0 )
+	{}
+
+	BitImage( const std::ptrdiff_t width, const std::ptrdiff_t height )
+	{
+		resize( width, height );
+	}
+
+	/// @brief Resize the image, with all the pixels at 0.
+	void resize( const std::ptrdiff_t width, const std::ptrdiff_t height )
+	{
+		_width = width;
+		_height = height;
+		_nbWords = ( width + 2 + bits_per_word - 1 ) / bits_per_word;
+		_words.assign( _nbWords * height, 0 );
+	}
+
+	std::ptrdiff_t width() const { return _width; }
+	std::ptrdiff_t height() const { return _height; }
+	std::ptrdiff_t nbWords() const { return _nbWords; }
+
+	bits_word_t* row( const std::ptrdiff_t y ) { return &_words[ y * _nbWords ]; }
+	const bits_word_t* row( const std::ptrdiff_t y ) const { return &_words[ y * _nbWords ]; }
 
+	bool get( const std::ptrdiff_t x, const std::ptrdiff_t y ) const
+	{
+		const std::ptrdiff_t b = x + 1;
+		return ( row( y )[ b / bits_per_word ] >> ( b % bits_per_word ) ) & 1;
+	}
+
+private:
+	std::ptrdiff_t _width;
+	std::ptrdiff_t _height;
+	std::ptrdiff_t _nbWords; ///< words per row
+	std::vector<bits_word_t> _words;
+};
 
+/**
+ * @brief The 3 bits of a row from the bit @p b (the pixels b-1, b and b+1).
+ */
+GIL_FORCEINLINE
+unsigned int row_triplet( const bits_word_t* row, const std::ptrdiff_t b )
+{
+	const std::ptrdiff_t k = b / bits_per_word;
+	const std::ptrdiff_t s = b % bits_per_word;
+	bits_word_t v = row[k] >> s;
+	if( s > bits_per_word - 3 )
+		v |= row[k + 1] << ( bits_per_word - s );
+	return static_cast<unsigned int>( v & 7 );
 }
 
+GIL_FORCEINLINE
+std::ptrdiff_t count_trailing_zeros( const bits_word_t w )
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll( w );
+#else
+	std::ptrdiff_t n = 0;
+	while( ! ( ( w >> n ) & 1 ) )
+		++n;
+	return n;
+#endif
+}
 
-template<class SView, class DView>
-void applyThinning( const SView& srcView, DView& tmpView, DView& dstView )
+/**
+ * @brief Thinning lookup table indexed by the rows of the neighbourhood:
+ * bits 0-2 for the top row (left to right), 3-5 for the current row and
+ * 6-8 for the bottom row. The pixels which are not white stay black.
+ */
+class ThinningLut
 {
-	using namespace terry::numeric;
-	
-	typedef typename DView::value_type DPixel;
-	DPixel pixelZero; pixel_zeros_t<DPixel>()( pixelZero );
-	
-	// todo: only fill borders !!
-	fill_pixels( tmpView, pixelZero );
+public:
+	/// @param lut lutthin1 or lutthin2, indexed by the columns of the neighbourhood (see pixel_locator_thinning_t)
+	explicit ThinningLut( const bool* lut )
+	{
+		for( unsigned int r = 0; r < 512; ++r )
+		{
+			unsigned int id = 0;
+			for( unsigned int row = 0; row < 3; ++row )
+				for( unsigned int col = 0; col < 3; ++col )
+					id |= ( ( r >> ( row * 3 + col ) ) & 1 ) << ( col * 3 + row );
+			_values[r] = ( r & 16 ) && lut[id];
+		}
+	}
+
+	bool operator[]( const unsigned int r ) const { return _values[r]; }
+
+private:
+	bool _values[512];
+};
+
+inline const ThinningLut& thinningLut1()
+{
+	static const ThinningLut lut( lutthin1 );
+	return lut;
+}
+
+inline const ThinningLut& thinningLut2()
+{
+	static const ThinningLut lut( lutthin2 );
+	return lut;
+}
+
+/**
+ * @brief Set the bits of the white pixels of the row @p y of @p view.
+ * @p view and @p bits have the same dimensions.
+ */
+template<class View>
+void pack_white_row( const View& view, BitImage& bits, const std::ptrdiff_t y )
+{
+	typedef typename View::value_type Pixel;
+	Pixel white;
+	terry::numeric::pixel_assigns_max( white );
+
+	bits_word_t* dst = bits.row( y );
+	std::fill( dst, dst + bits.nbWords(), bits_word_t( 0 ) );
+	typename View::x_iterator src_it = view.row_begin( y );
+	for( std::ptrdiff_t x = 0; x < view.width(); ++x, ++src_it )
+	{
+		if( *src_it == white )
+		{
+			const std::ptrdiff_t b = x + 1;
+			dst[ b / bits_per_word ] |= bits_word_t( 1 ) << ( b % bits_per_word );
+		}
+	}
+}
+
+/**
+ * @brief Thinning of the pixels [x1, x2[ of the row @p y of @p src into @p dst.
+ * The other pixels of @p dst are not modified, the rows y-1 and y+1 and the
+ * columns x1-1 and x2 are read.
+ * Only the white pixels are evaluated, by words of 64 pixels.
+ */
+inline void thinning_row( const BitImage& src, BitImage& dst, const ThinningLut& lut,
+                          const std::ptrdiff_t x1, const std::ptrdiff_t x2, const std::ptrdiff_t y )
+{
+	if( x1 >= x2 )
+		return;
+	const bits_word_t* top = src.row( y - 1 );
+	const bits_word_t* current = src.row( y );
+	const bits_word_t* bottom = src.row( y + 1 );
+	bits_word_t* out = dst.row( y );
+
+	const std::ptrdiff_t bBegin = x1 + 1;
+	const std::ptrdiff_t bEnd = x2 + 1;
+	for( std::ptrdiff_t k = bBegin / bits_per_word; k * bits_per_word < bEnd; ++k )
+	{
+		bits_word_t w = current[k];
+		// only the bits of [bBegin, bEnd[
+		if( k == bBegin / bits_per_word )
+			w &= ~bits_word_t( 0 ) << ( bBegin % bits_per_word );
+		if( ( k + 1 ) * bits_per_word > bEnd )
+			w &= ~( ~bits_word_t( 0 ) << ( bEnd % bits_per_word ) );
+
+		bits_word_t result = out[k];
+		while( w )
+		{
+			const std::ptrdiff_t s = count_trailing_zeros( w );
+			w &= w - 1;
+			const std::ptrdiff_t b = k * bits_per_word + s - 1; // first bit of the neighbourhood
+			const unsigned int r = row_triplet( top, b ) |
+			                       ( row_triplet( current, b ) << 3 ) |
+			                       ( row_triplet( bottom, b ) << 6 );
+			if( lut[r] )
+				result |= bits_word_t( 1 ) << s;
+			else
+				result &= ~( bits_word_t( 1 ) << s );
+		}
+		out[k] = result;
+	}
+}
+
+/**
+ * @brief Write the pixels [x1, x2[ of the row @p y of @p bits in the row @p dstY of @p view,
+ * white for the bits at 1, black for the others.
+ */
+template<class View>
+void unpack_row( const BitImage& bits, const std::ptrdiff_t x1, const std::ptrdiff_t x2, const std::ptrdiff_t y,
+                 const View& view, const std::ptrdiff_t dstX, const std::ptrdiff_t dstY )
+{
+	typedef typename View::value_type Pixel;
+	Pixel white;
+	Pixel black;
+	terry::numeric::pixel_assigns_max( white );
+	terry::numeric::pixel_assigns_min( black );
+
+	const bits_word_t* src = bits.row( y );
+	typename View::x_iterator dst_it = view.row_begin( dstY ) + dstX;
+	for( std::ptrdiff_t x = x1; x < x2; ++x, ++dst_it )
+	{
+		const std::ptrdiff_t b = x + 1;
+		*dst_it = ( ( src[ b / bits_per_word ] >> ( b % bits_per_word ) ) & 1 ) ? white : black;
+	}
+}
+
+namespace detail {
+
+template<class View>
+struct pack_white_rows_t
+{
+	View _view;
+	BitImage* _bits;
+
+	pack_white_rows_t( const View& view, BitImage& bits ) : _view( view ), _bits( &bits ) {}
+
+	void operator()( const std::ptrdiff_t y ) { pack_white_row( _view, *_bits, y ); }
+};
+
+struct thinning_rows_t
+{
+	const BitImage* _src;
+	BitImage* _dst;
+	const ThinningLut* _lut;
+	Rect<std::ptrdiff_t> _region;
+
+	thinning_rows_t( const BitImage& src, BitImage& dst, const ThinningLut& lut, const Rect<std::ptrdiff_t>& region )
+	: _src( &src ), _dst( &dst ), _lut( &lut ), _region( region ) {}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		thinning_row( *_src, *_dst, *_lut, _region.x1, _region.x2, _region.y1 + y );
+	}
+};
+
+template<class View>
+struct unpack_rows_t
+{
+	const BitImage* _bits;
+	View _view;
+
+	unpack_rows_t( const BitImage& bits, const View& view ) : _bits( &bits ), _view( view ) {}
+
+	void operator()( const std::ptrdiff_t y ) { unpack_row( *_bits, 0, _bits->width(), y, _view, 0, y ); }
+};
+
+}
+
+/**
+ * @brief Thinning of the rows of @p region of @p src into @p dst, on the threads of @p launcher.
+ * The rows and the columns around @p region are read.
+ */
+template<class Launcher>
+void thinning_bits( const Launcher& launcher, const BitImage& src, BitImage& dst, const ThinningLut& lut, const Rect<std::ptrdiff_t>& region )
+{
+	terry::algorithm::parallel_for_rows( launcher, std::max<std::ptrdiff_t>( region.y2 - region.y1, 0 ),
+		detail::thinning_rows_t( src, dst, lut, region ) );
+}
+
+inline void thinning_bits( const BitImage& src, BitImage& dst, const ThinningLut& lut, const Rect<std::ptrdiff_t>& region )
+{
+	thinning_bits( terry::algorithm::serial_launcher(), src, dst, lut, region );
+}
+
+}
+
+/**
+ * @brief Two passes of thinning of the white pixels of @p srcView, on the threads of @p launcher.
+ * The image is converted to bits (the white pixels are the pixels with all
+ * the channels at the maximum) and the passes work on 64 pixels per word.
+ * The 2 pixels border of @p dstView is black.
+ * @p srcView and @p dstView can be the same view.
+ * @param tmpView not used anymore, the intermediate pass is kept in bits
+ */
+template<class Launcher, class SView, class DView>
+void applyThinning( const Launcher& launcher, const SView& srcView, DView& tmpView, DView& dstView )
+{
+	using namespace terry::filter::thinning;
+
+	const std::ptrdiff_t width = srcView.width();
+	const std::ptrdiff_t height = srcView.height();
+	BitImage src( width, height );
+	BitImage tmp( width, height );
+	BitImage dst( width, height );
 
 	const Rect<std::ptrdiff_t> srcRod = getBounds<std::ptrdiff_t>(srcView);
 	const Rect<std::ptrdiff_t> proc1 = rectangleReduce( srcRod, 1 );
 	const Rect<std::ptrdiff_t> proc2 = rectangleReduce( proc1, 1 );
 
-	algorithm::transform_pixels_locator(
-		srcView, srcRod,
-		tmpView, getBounds<std::ptrdiff_t>(tmpView),
-		proc1,
-		terry::filter::thinning::pixel_locator_thinning_t<SView,DView>(srcView, terry::filter::thinning::lutthin1)
-		);
-
-	// todo: only fill borders !!
-	fill_pixels( dstView, pixelZero );
-	
-	algorithm::transform_pixels_locator(
-		tmpView, getBounds<std::ptrdiff_t>(tmpView),
-		dstView, getBounds<std::ptrdiff_t>(dstView),
-		proc2,
-		terry::filter::thinning::pixel_locator_thinning_t<DView,DView>(tmpView, terry::filter::thinning::lutthin2)
-		);
+	algorithm::parallel_for_rows( launcher, height, detail::pack_white_rows_t<SView>( srcView, src ) );
+	thinning_bits( launcher, src, tmp, thinningLut1(), proc1 );
+	thinning_bits( launcher, tmp, dst, thinningLut2(), proc2 );
+	algorithm::parallel_for_rows( launcher, height, detail::unpack_rows_t<DView>( dst, dstView ) );
+}
+
+/**
+ * @brief Thinning on the calling thread.
+ * @see applyThinning( launcher, srcView, tmpView, dstView )
+ */
+template<class SView, class DView>
+void applyThinning( const SView& srcView, DView& tmpView, DView& dstView )
+{
+	applyThinning( algorithm::serial_launcher(), srcView, tmpView, dstView );
 }
 
 }
 }
 
 #endif
-
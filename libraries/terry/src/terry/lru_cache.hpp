@@ -0,0 +1,113 @@
+#ifndef _TERRY_LRU_CACHE_HPP_
+#define _TERRY_LRU_CACHE_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <cstddef>
+#include <list>
+#include <utility>
+
+namespace terry {
+
+/**
+ * @brief Thread safe cache of the last used values, by key.
+ *
+ * The least recently used value is removed when there are more than
+ * @p maxSize values. Value is copied in and out of the cache, so large
+ * values are kept by shared pointer (the users of a removed value keep it alive).
+ * Key only needs operator==.
+ */
+template<class Key, class Value>
+class lru_cache : boost::noncopyable
+{
+public:
+	explicit lru_cache( const std::size_t maxSize = 8 )
+	: _maxSize( maxSize )
+	{}
+
+	/**
+	 * @brief Get the value of @p key, made by @p make if it is not in the cache.
+	 *
+	 * @p make is called under the lock, so the other threads wait for its result
+	 * instead of making the same value.
+	 * @param make functor returning a Value
+	 */
+	template<class Make>
+	Value get( const Key& key, const Make& make )
+	{
+		boost::mutex::scoped_lock lock( _mutex );
+		typename List::iterator it = findEntry( key );
+		if( it != _entries.end() )
+			return it->second;
+		const Value value = make();
+		pushFront( key, value );
+		return value;
+	}
+
+	/// @brief Copy in @p value the value of @p key, returns false if it is not in the cache.
+	bool find( const Key& key, Value& value )
+	{
+		boost::mutex::scoped_lock lock( _mutex );
+		typename List::iterator it = findEntry( key );
+		if( it == _entries.end() )
+			return false;
+		value = it->second;
+		return true;
+	}
+
+	/// @brief Add or replace the value of @p key, as the most recently used.
+	void insert( const Key& key, const Value& value )
+	{
+		boost::mutex::scoped_lock lock( _mutex );
+		typename List::iterator it = findEntry( key );
+		if( it != _entries.end() )
+			_entries.erase( it );
+		pushFront( key, value );
+	}
+
+	void clear()
+	{
+		boost::mutex::scoped_lock lock( _mutex );
+		_entries.clear();
+	}
+
+	std::size_t size()
+	{
+		boost::mutex::scoped_lock lock( _mutex );
+		return _entries.size();
+	}
+
+private:
+	typedef std::list<std::pair<Key, Value> > List;
+
+	/// @return the entry of @p key, moved to the front, or end()
+	typename List::iterator findEntry( const Key& key )
+	{
+		for( typename List::iterator it = _entries.begin(); it != _entries.end(); ++it )
+		{
+			if( it->first == key )
+			{
+				_entries.splice( _entries.begin(), _entries, it ); // most recently used
+				return _entries.begin();
+			}
+		}
+		return _entries.end();
+	}
+
+	void pushFront( const Key& key, const Value& value )
+	{
+		_entries.push_front( std::make_pair( key, value ) );
+		if( _entries.size() > _maxSize )
+			_entries.pop_back();
+	}
+
+	const std::size_t _maxSize;
+	List _entries; ///< most recently used first
+	boost::mutex _mutex;
+};
+
+}
+
+#endif
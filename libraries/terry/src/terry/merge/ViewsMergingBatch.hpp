@@ -0,0 +1,99 @@
+#ifndef _TERRY_VIEWS_MERGING_BATCH_HPP_
+#define _TERRY_VIEWS_MERGING_BATCH_HPP_
+
+#include "ViewsMerging.hpp"
+#include "MergeFunctors.hpp"
+#include "detail/merge_simd.hpp"
+
+#include <boost/gil/typedefs.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_void.hpp>
+
+namespace terry {
+
+/**
+ * @brief Line operator (see detail/merge_simd.hpp) of a merging functor, void if there is none.
+ */
+template<class Functor>
+struct batch_merge_operator { typedef void type; };
+
+template<class Pixel>
+struct batch_merge_operator< FunctorOver<Pixel> > { typedef detail::merge_op_over type; };
+template<class Pixel>
+struct batch_merge_operator< FunctorPlus<Pixel> > { typedef detail::merge_op_plus type; };
+template<class Pixel>
+struct batch_merge_operator< FunctorMultiply<Pixel> > { typedef detail::merge_op_multiply type; };
+template<class Pixel>
+struct batch_merge_operator< FunctorScreen<Pixel> > { typedef detail::merge_op_screen type; };
+template<class Pixel>
+struct batch_merge_operator< FunctorDarken<Pixel> > { typedef detail::merge_op_min type; };
+template<class Pixel>
+struct batch_merge_operator< FunctorLighten<Pixel> > { typedef detail::merge_op_max type; };
+template<class Pixel>
+struct batch_merge_operator< FunctorDifference<Pixel> > { typedef detail::merge_op_difference type; };
+
+/**
+ * @brief Channel type of the views with contiguous RGBA pixels supported by the line operators, void for the others.
+ */
+template<class View>
+struct batch_merge_channel { typedef void type; };
+
+template<>
+struct batch_merge_channel<boost::gil::rgba32f_view_t> { typedef float type; };
+template<>
+struct batch_merge_channel<boost::gil::rgba16_view_t> { typedef boost::uint16_t type; };
+
+template<class View, class Functor>
+struct has_batch_merge
+	: boost::mpl::bool_< ! boost::is_void<typename batch_merge_operator<Functor>::type>::value &&
+	                     ! boost::is_void<typename batch_merge_channel<View>::type>::value >
+{};
+
+namespace detail {
+
+template<class View, class Functor>
+void merge_views_batch( const View& srcA, const View& srcB, View& dst, Functor&, const boost::mpl::true_ )
+{
+	typedef typename batch_merge_operator<Functor>::type Op;
+	typedef typename batch_merge_channel<View>::type Channel;
+
+	for( std::ptrdiff_t y = 0; y < dst.height(); ++y )
+	{
+		merge_rgba_line<Op>(
+			reinterpret_cast<const Channel*>( &srcA.row_begin( y )[0] ),
+			reinterpret_cast<const Channel*>( &srcB.row_begin( y )[0] ),
+			reinterpret_cast<Channel*>( &dst.row_begin( y )[0] ),
+			dst.width() );
+	}
+}
+
+template<class View, class Functor>
+void merge_views_batch( const View& srcA, const View& srcB, View& dst, Functor& fun, const boost::mpl::false_ )
+{
+	merge_views( srcA, srcB, dst, fun );
+}
+
+}
+
+/**
+ * @defgroup ViewsMerging
+ * @brief Merge two views, line by line with the vectorized operators when
+ * they exist for the functor and the view (over, plus, multiply, screen,
+ * darken, lighten and difference on float and 16 bits RGBA views).
+ * The other functors and views use merge_views, which is the reference.
+ *
+ * The lines where a source is fully transparent or opaque are copied or
+ * filled when the operator allows it.
+ * The views are processed on the calling thread, the parallelism is on the
+ * windows of the caller (the render threads of a plugin).
+ */
+template<class F, class View>
+void merge_views_batch( const View& srcA, const View& srcB, View& dst, F fun )
+{
+	detail::merge_views_batch( srcA, srcB, dst, fun, has_batch_merge<View, F>() );
+}
+
+}
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef _TERRY_MERGE_DETAIL_MERGE_SIMD_HPP_
+#define _TERRY_MERGE_DETAIL_MERGE_SIMD_HPP_
+
+/**
+ * @file
+ * @brief Merge operators on lines of RGBA pixels, with float or 16 bits channels.
+ *
+ * Each operator has a scalar version and an SSE2 version, which processes
+ * one float pixel or two 16 bits pixels per register. The float results are
+ * the same as the per channel functors of MergeFunctors.hpp. The 16 bits
+ * operators use normalized values (a * b / 65535, rounded) and saturate.
+ * The SSE2 version is chosen at runtime, if the cpu supports it.
+ * Define TERRY_DISABLE_SIMD to always use the scalar versions.
+ */
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if ! defined(TERRY_DISABLE_SIMD) && ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+ #define TERRY_MERGE_SIMD_X86 1
+ #include <emmintrin.h>
+#endif
+
+namespace terry {
+namespace detail {
+
+/// @brief a * b / 65535, rounded to the nearest.
+inline boost::uint16_t merge_mul16( const boost::uint16_t a, const boost::uint16_t b )
+{
+	const boost::uint32_t t = boost::uint32_t( a ) * b + 32768u;
+	return boost::uint16_t( ( t + ( t >> 16 ) ) >> 16 );
+}
+
+inline boost::uint16_t merge_adds16( const boost::uint16_t a, const boost::uint16_t b )
+{
+	return boost::uint16_t( std::min( boost::uint32_t( a ) + b, boost::uint32_t( 65535u ) ) );
+}
+
+#ifdef TERRY_MERGE_SIMD_X86
+
+/// @brief merge_mul16 on 8 values.
+__attribute__((target("sse2")))
+inline __m128i merge_mul16_sse2( const __m128i a, const __m128i b )
+{
+	const __m128i lo = _mm_mullo_epi16( a, b );
+	const __m128i hi = _mm_mulhi_epu16( a, b );
+	const __m128i half = _mm_set1_epi32( 32768 );
+	__m128i t0 = _mm_add_epi32( _mm_unpacklo_epi16( lo, hi ), half );
+	__m128i t1 = _mm_add_epi32( _mm_unpackhi_epi16( lo, hi ), half );
+	t0 = _mm_srli_epi32( _mm_add_epi32( t0, _mm_srli_epi32( t0, 16 ) ), 16 );
+	t1 = _mm_srli_epi32( _mm_add_epi32( t1, _mm_srli_epi32( t1, 16 ) ), 16 );
+	// unsigned pack of values in [0, 65535] with the signed pack of SSE2
+	const __m128i bias32 = _mm_set1_epi32( 32768 );
+	const __m128i bias16 = _mm_set1_epi16( -32768 );
+	return _mm_xor_si128( _mm_packs_epi32( _mm_sub_epi32( t0, bias32 ), _mm_sub_epi32( t1, bias32 ) ), bias16 );
+}
+
+/// @brief Alpha of each pixel on all its channels (1 float pixel).
+__attribute__((target("sse2")))
+inline __m128 merge_alpha_sse2( const __m128 p )
+{
+	return _mm_shuffle_ps( p, p, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+}
+
+/// @brief Alpha of each pixel on all its channels (2 pixels of 16 bits).
+__attribute__((target("sse2")))
+inline __m128i merge_alpha_sse2( const __m128i p )
+{
+	return _mm_shufflehi_epi16( _mm_shufflelo_epi16( p, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+}
+
+#endif
+
+/**
+ * @brief Shortcuts of an operator for the lines where a source is fully transparent or opaque.
+ */
+enum EMergeShortcut
+{
+	eMergeShortcutNone = 0,
+	eMergeShortcutCopyA,
+	eMergeShortcutCopyB,
+	eMergeShortcutZero
+};
+
+/**
+ * @brief Content of a line of a source.
+ */
+struct merge_line_content
+{
+	bool _transparent; ///< all the channels are null
+	bool _opaque;      ///< all the alpha values are at the max
+};
+
+/// A over B: A + B * ( 1 - alpha A )
+struct merge_op_over
+{
+	static EMergeShortcut shortcut( const merge_line_content& a, const merge_line_content& b )
+	{
+		if( a._transparent )
+			return eMergeShortcutCopyB;
+		if( a._opaque || b._transparent )
+			return eMergeShortcutCopyA;
+		return eMergeShortcutNone;
+	}
+	static float apply( const float a, const float b, const float alphaA ) { return a + b * ( 1.0f - alphaA ); }
+	static boost::uint16_t apply( const boost::uint16_t a, const boost::uint16_t b, const boost::uint16_t alphaA ) { return merge_adds16( a, merge_mul16( b, 65535 - alphaA ) ); }
+#ifdef TERRY_MERGE_SIMD_X86
+	__attribute__((target("sse2")))
+	static __m128 apply( const __m128 a, const __m128 b )
+	{
+		return _mm_add_ps( a, _mm_mul_ps( b, _mm_sub_ps( _mm_set1_ps( 1.0f ), merge_alpha_sse2( a ) ) ) );
+	}
+	__attribute__((target("sse2")))
+	static __m128i apply( const __m128i a, const __m128i b )
+	{
+		const __m128i invAlpha = _mm_sub_epi16( _mm_set1_epi16( -1 ), merge_alpha_sse2( a ) );
+		return _mm_adds_epu16( a, merge_mul16_sse2( b, invAlpha ) );
+	}
+#endif
+};
+
+/// A + B
+struct merge_op_plus
+{
+	static EMergeShortcut shortcut( const merge_line_content& a, const merge_line_content& b )
+	{
+		if( a._transparent )
+			return eMergeShortcutCopyB;
+		if( b._transparent )
+			return eMergeShortcutCopyA;
+		return eMergeShortcutNone;
+	}
+	static float apply( const float a, const float b, const float ) { return a + b; }
+	static boost::uint16_t apply( const boost::uint16_t a, const boost::uint16_t b, const boost::uint16_t ) { return merge_adds16( a, b ); }
+#ifdef TERRY_MERGE_SIMD_X86
+	__attribute__((target("sse2")))
+	static __m128 apply( const __m128 a, const __m128 b ) { return _mm_add_ps( a, b ); }
+	__attribute__((target("sse2")))
+	static __m128i apply( const __m128i a, const __m128i b ) { return _mm_adds_epu16( a, b ); }
+#endif
+};
+
+/**
+ * A * B
+ * FunctorMultiply returns 0 when both values are negative, but is_negative
+ * is always false on the float channels (scoped_channel_value isn't a signed
+ * type), so the product is kept like it.
+ */
+struct merge_op_multiply
+{
+	static EMergeShortcut shortcut( const merge_line_content& a, const merge_line_content& b )
+	{
+		if( a._transparent || b._transparent )
+			return eMergeShortcutZero;
+		return eMergeShortcutNone;
+	}
+	static float apply( const float a, const float b, const float ) { return a * b; }
+	static boost::uint16_t apply( const boost::uint16_t a, const boost::uint16_t b, const boost::uint16_t ) { return merge_mul16( a, b ); }
+#ifdef TERRY_MERGE_SIMD_X86
+	__attribute__((target("sse2")))
+	static __m128 apply( const __m128 a, const __m128 b ) { return _mm_mul_ps( a, b ); }
+	__attribute__((target("sse2")))
+	static __m128i apply( const __m128i a, const __m128i b ) { return merge_mul16_sse2( a, b ); }
+#endif
+};
+
+/// A + B - A * B
+struct merge_op_screen
+{
+	static EMergeShortcut shortcut( const merge_line_content& a, const merge_line_content& b )
+	{
+		return merge_op_plus::shortcut( a, b );
+	}
+	static float apply( const float a, const float b, const float ) { return a + b - a * b; }
+	// a * b / 65535 <= b, so there is no overflow
+	static boost::uint16_t apply( const boost::uint16_t a, const boost::uint16_t b, const boost::uint16_t ) { return boost::uint16_t( a + ( b - merge_mul16( a, b ) ) ); }
+#ifdef TERRY_MERGE_SIMD_X86
+	__attribute__((target("sse2")))
+	static __m128 apply( const __m128 a, const __m128 b ) { return _mm_sub_ps( _mm_add_ps( a, b ), _mm_mul_ps( a, b ) ); }
+	__attribute__((target("sse2")))
+	static __m128i apply( const __m128i a, const __m128i b ) { return _mm_add_epi16( a, _mm_sub_epi16( b, merge_mul16_sse2( a, b ) ) ); }
+#endif
+};
+
+/// min( A, B ) (darken)
+struct merge_op_min
+{
+	static EMergeShortcut shortcut( const merge_line_content&, const merge_line_content& ) { return eMergeShortcutNone; }
+	static float apply( const float a, const float b, const float ) { return std::min( a, b ); }
+	static boost::uint16_t apply( const boost::uint16_t a, const boost::uint16_t b, const boost::uint16_t ) { return std::min( a, b ); }
+#ifdef TERRY_MERGE_SIMD_X86
+	// same result as std::min with NaN values
+	__attribute__((target("sse2")))
+	static __m128 apply( const __m128 a, const __m128 b ) { return _mm_min_ps( b, a ); }
+	__attribute__((target("sse2")))
+	static __m128i apply( const __m128i a, const __m128i b ) { return _mm_sub_epi16( a, _mm_subs_epu16( a, b ) ); }
+#endif
+};
+
+/// max( A, B ) (lighten)
+struct merge_op_max
+{
+	static EMergeShortcut shortcut( const merge_line_content&, const merge_line_content& ) { return eMergeShortcutNone; }
+	static float apply( const float a, const float b, const float ) { return std::max( a, b ); }
+	static boost::uint16_t apply( const boost::uint16_t a, const boost::uint16_t b, const boost::uint16_t ) { return std::max( a, b ); }
+#ifdef TERRY_MERGE_SIMD_X86
+	// same result as std::max with NaN values
+	__attribute__((target("sse2")))
+	static __m128 apply( const __m128 a, const __m128 b ) { return _mm_max_ps( b, a ); }
+	__attribute__((target("sse2")))
+	static __m128i apply( const __m128i a, const __m128i b ) { return _mm_add_epi16( b, _mm_subs_epu16( a, b ) ); }
+#endif
+};
+
+/// | A - B |
+struct merge_op_difference
+{
+	static EMergeShortcut shortcut( const merge_line_content&, const merge_line_content& ) { return eMergeShortcutNone; }
+	static float apply( const float a, const float b, const float ) { return std::abs( a - b ); }
+	static boost::uint16_t apply( const boost::uint16_t a, const boost::uint16_t b, const boost::uint16_t ) { return boost::uint16_t( a > b ? a - b : b - a ); }
+#ifdef TERRY_MERGE_SIMD_X86
+	__attribute__((target("sse2")))
+	static __m128 apply( const __m128 a, const __m128 b ) { return _mm_andnot_ps( _mm_set1_ps( -0.0f ), _mm_sub_ps( a, b ) ); }
+	__attribute__((target("sse2")))
+	static __m128i apply( const __m128i a, const __m128i b ) { return _mm_or_si128( _mm_subs_epu16( a, b ), _mm_subs_epu16( b, a ) ); }
+#endif
+};
+
+template<typename T>
+struct merge_channel_max;
+template<>
+struct merge_channel_max<float> { static float value() { return 1.0f; } };
+template<>
+struct merge_channel_max<boost::uint16_t> { static boost::uint16_t value() { return 65535; } };
+
+/**
+ * @brief Content of a line of @p n RGBA pixels.
+ */
+template<typename T>
+merge_line_content merge_line_content_rgba( const T* p, const std::size_t n )
+{
+	merge_line_content content = { true, true };
+	const T max = merge_channel_max<T>::value();
+	for( std::size_t i = 0; i < n && ( content._transparent || content._opaque ); ++i, p += 4 )
+	{
+		content._transparent = content._transparent && p[0] == 0 && p[1] == 0 && p[2] == 0 && p[3] == 0;
+		content._opaque = content._opaque && p[3] == max;
+	}
+	return content;
+}
+
+/**
+ * @brief Merge lines of @p n RGBA pixels with the scalar operator.
+ */
+template<class Op, typename T>
+void merge_rgba_generic( const T* a, const T* b, T* d, const std::size_t n )
+{
+	for( std::size_t i = 0; i < n; ++i, a += 4, b += 4, d += 4 )
+	{
+		const T alphaA = a[3];
+		for( int c = 0; c < 4; ++c )
+			d[c] = Op::apply( a[c], b[c], alphaA );
+	}
+}
+
+#ifdef TERRY_MERGE_SIMD_X86
+
+template<class Op>
+__attribute__((target("sse2")))
+void merge_rgba_sse2( const float* a, const float* b, float* d, const std::size_t n )
+{
+	for( std::size_t i = 0; i < n; ++i, a += 4, b += 4, d += 4 )
+		_mm_storeu_ps( d, Op::apply( _mm_loadu_ps( a ), _mm_loadu_ps( b ) ) );
+}
+
+template<class Op>
+__attribute__((target("sse2")))
+void merge_rgba_sse2( const boost::uint16_t* a, const boost::uint16_t* b, boost::uint16_t* d, const std::size_t n )
+{
+	std::size_t i = 0;
+	for( ; i + 2 <= n; i += 2, a += 8, b += 8, d += 8 )
+	{
+		const __m128i va = _mm_loadu_si128( reinterpret_cast<const __m128i*>( a ) );
+		const __m128i vb = _mm_loadu_si128( reinterpret_cast<const __m128i*>( b ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( d ), Op::apply( va, vb ) );
+	}
+	merge_rgba_generic<Op>( a, b, d, n - i );
+}
+
+#endif
+
+template<typename T>
+struct merge_rgba_function
+{
+	typedef void (*type)( const T*, const T*, T*, const std::size_t );
+};
+
+/// @return the best implementation of the operator for the current cpu
+template<class Op, typename T>
+typename merge_rgba_function<T>::type select_merge_rgba()
+{
+#ifdef TERRY_MERGE_SIMD_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "sse2" ) )
+		return &merge_rgba_sse2<Op>;
+#endif
+	return &merge_rgba_generic<Op, T>;
+}
+
+/// Merge lines of @p n RGBA pixels with the best implementation for the current cpu.
+template<class Op, typename T>
+void merge_rgba_simd( const T* a, const T* b, T* d, const std::size_t n )
+{
+	static const typename merge_rgba_function<T>::type merge = select_merge_rgba<Op, T>();
+	merge( a, b, d, n );
+}
+
+/**
+ * @brief Merge lines of @p n RGBA pixels, with the shortcuts of the operator
+ * when a line of a source is fully transparent or opaque.
+ * @param d can be the same line as a or b
+ */
+template<class Op, typename T>
+void merge_rgba_line( const T* a, const T* b, T* d, const std::size_t n )
+{
+	const merge_line_content contentA = merge_line_content_rgba( a, n );
+	const merge_line_content contentB = merge_line_content_rgba( b, n );
+	switch( Op::shortcut( contentA, contentB ) )
+	{
+		case eMergeShortcutCopyA:
+			if( d != a )
+				std::copy( a, a + n * 4, d );
+			return;
+		case eMergeShortcutCopyB:
+			if( d != b )
+				std::copy( b, b + n * 4, d );
+			return;
+		case eMergeShortcutZero:
+			std::fill( d, d + n * 4, T( 0 ) );
+			return;
+		case eMergeShortcutNone:
+			break;
+	}
+	merge_rgba_simd<Op>( a, b, d, n );
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef _TERRY_NUMERIC_DETAIL_HISTOGRAM_SIMD_HPP_
+#define _TERRY_NUMERIC_DETAIL_HISTOGRAM_SIMD_HPP_
+
+/**
+ * @file
+ * @brief Histograms of the RGBA and HSL channels of lines of float pixels,
+ * with a runtime dispatch on the cpu features.
+ *
+ * The HSL values are the same as color_convert from rgba32f to hsl32f
+ * (premultiplied by the alpha, then the GIL rgb to hsl formula), and the bins
+ * are the same as pixel_histogram_t (indices computed in double).
+ * The SSE2 version converts 4 pixels at once and computes the bin indices
+ * of each channel with 2 double registers.
+ * Define TERRY_DISABLE_SIMD to always use the generic version.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if ! defined(TERRY_DISABLE_SIMD) && ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+ #define TERRY_NUMERIC_SIMD_X86 1
+ #include <emmintrin.h>
+#endif
+
+namespace terry {
+namespace numeric {
+namespace detail {
+
+/// Number of histograms: red, green, blue, alpha, hue, saturation, lightness.
+static const std::size_t kNbRgbaHslChannels = 7;
+
+/**
+ * @brief HSL of an rgba float pixel, like color_convert from rgba32f to hsl32f.
+ * @warning keep the same operations as the GIL converter, the histograms must not change
+ */
+inline void rgba_to_hsl( const float* rgba, float* hsl )
+{
+	// the rgba to rgb conversion multiplies by the alpha
+	const float r = rgba[0] * rgba[3];
+	const float g = rgba[1] * rgba[3];
+	const float b = rgba[2] * rgba[3];
+
+	const float minColor = std::min( r, std::min( g, b ) );
+	const float maxColor = std::max( r, std::max( g, b ) );
+
+	if( std::abs( maxColor - minColor ) < 0.001 )
+	{
+		// gray
+		hsl[0] = 0.f;
+		hsl[1] = 0.f;
+		hsl[2] = r;
+		return;
+	}
+	const float diff = maxColor - minColor;
+	const float lightness = ( minColor + maxColor ) / 2.f;
+	const float saturation = lightness < 0.5f ? diff / ( minColor + maxColor ) : diff / ( 2.f - diff );
+
+	float hue;
+	if( std::abs( maxColor - r ) < 0.0001f )
+		hue = ( g - b ) / diff;
+	else if( std::abs( maxColor - g ) < 0.0001f )
+		hue = 2.f + ( b - r ) / diff;
+	else
+		hue = 4.f + ( r - b ) / diff;
+	hue /= 6.f;
+	if( hue < 0.f )
+		hue += 1.f;
+
+	hsl[0] = hue;
+	hsl[1] = saturation;
+	hsl[2] = lightness;
+}
+
+/// Count a value in [0, 1] in the nearest bin, like pixel_histogram_t.
+inline void histogram_count( std::size_t* bins, const float value, const double last )
+{
+	const double v = value;
+	if( v >= 0.0 && v <= 1.0 )
+		++bins[ static_cast<std::size_t>( v * last + 0.5 ) ];
+}
+
+/// Count the 7 channels of an rgba float pixel.
+inline void histogram_rgba_hsl_pixel( const float* rgba, const double last, std::size_t* const* bins )
+{
+	float hsl[3];
+	rgba_to_hsl( rgba, hsl );
+	for( int c = 0; c < 4; ++c )
+		histogram_count( bins[c], rgba[c], last );
+	for( int c = 0; c < 3; ++c )
+		histogram_count( bins[4 + c], hsl[c], last );
+}
+
+/**
+ * @brief Count the RGBA and HSL channels of n rgba float pixels.
+ * @param src first pixel
+ * @param srcStep distance between two pixels, in floats
+ * @param mask selection of the pixels (one byte per pixel, not null to count), can be NULL
+ * @param maskStep distance between two bytes of the mask
+ * @param nbBins number of bins of each histogram
+ * @param bins the 7 histograms
+ */
+inline void histogram_rgba_hsl_floats_generic( const float* src, const std::size_t srcStep,
+                                               const unsigned char* mask, const std::size_t maskStep,
+                                               const std::size_t n, const std::size_t nbBins, std::size_t* const* bins )
+{
+	const double last = double( nbBins - 1 );
+	for( std::size_t i = 0; i < n; ++i )
+	{
+		if( mask && ! mask[i * maskStep] )
+			continue;
+		histogram_rgba_hsl_pixel( src + i * srcStep, last, bins );
+	}
+}
+
+#ifdef TERRY_NUMERIC_SIMD_X86
+
+/// Count the enabled lanes of 4 values, the indices are computed in double.
+__attribute__((target("sse2")))
+inline void histogram_count_sse2( std::size_t* bins, const __m128 values, const int enabled, const __m128d last )
+{
+	const __m128 valid = _mm_and_ps( _mm_cmpge_ps( values, _mm_setzero_ps() ), _mm_cmple_ps( values, _mm_set1_ps( 1.0f ) ) );
+	const int counted = _mm_movemask_ps( valid ) & enabled;
+	if( ! counted )
+		return;
+	const __m128d half = _mm_set1_pd( 0.5 );
+	const __m128i low  = _mm_cvttpd_epi32( _mm_add_pd( _mm_mul_pd( _mm_cvtps_pd( values ), last ), half ) );
+	const __m128i high = _mm_cvttpd_epi32( _mm_add_pd( _mm_mul_pd( _mm_cvtps_pd( _mm_movehl_ps( values, values ) ), last ), half ) );
+	int indices[4];
+	_mm_storel_epi64( reinterpret_cast<__m128i*>( indices ), low );
+	_mm_storel_epi64( reinterpret_cast<__m128i*>( indices + 2 ), high );
+	for( int p = 0; p < 4; ++p )
+	{
+		if( counted & ( 1 << p ) )
+			++bins[indices[p]];
+	}
+}
+
+__attribute__((target("sse2")))
+inline __m128 histogram_select_sse2( const __m128 condition, const __m128 a, const __m128 b )
+{
+	return _mm_or_ps( _mm_and_ps( condition, a ), _mm_andnot_ps( condition, b ) );
+}
+
+__attribute__((target("sse2")))
+inline __m128 histogram_abs_sse2( const __m128 v )
+{
+	return _mm_andnot_ps( _mm_set1_ps( -0.0f ), v );
+}
+
+__attribute__((target("sse2")))
+inline void histogram_rgba_hsl_floats_sse2( const float* src, const std::size_t srcStep,
+                                            const unsigned char* mask, const std::size_t maskStep,
+                                            const std::size_t n, const std::size_t nbBins, std::size_t* const* bins )
+{
+	const double lastValue = double( nbBins - 1 );
+	const __m128d last = _mm_set1_pd( lastValue );
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 two = _mm_set1_ps( 2.0f );
+	const __m128 four = _mm_set1_ps( 4.0f );
+	const __m128 six = _mm_set1_ps( 6.0f );
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 grayThreshold = _mm_set1_ps( 0.001f ); // same result as the comparison of the float difference with the double 0.001
+	const __m128 hueThreshold = _mm_set1_ps( 0.0001f );
+
+	std::size_t i = 0;
+	for( ; i + 4 <= n; i += 4 )
+	{
+		int enabled = 0xF;
+		if( mask )
+		{
+			enabled = ( mask[i * maskStep] != 0 ) |
+			          ( mask[( i + 1 ) * maskStep] != 0 ) << 1 |
+			          ( mask[( i + 2 ) * maskStep] != 0 ) << 2 |
+			          ( mask[( i + 3 ) * maskStep] != 0 ) << 3;
+			if( ! enabled )
+				continue;
+		}
+		const float* p = src + i * srcStep;
+		__m128 r = _mm_loadu_ps( p );
+		__m128 g = _mm_loadu_ps( p + srcStep );
+		__m128 b = _mm_loadu_ps( p + 2 * srcStep );
+		__m128 a = _mm_loadu_ps( p + 3 * srcStep );
+		_MM_TRANSPOSE4_PS( r, g, b, a );
+
+		const __m128 pr = _mm_mul_ps( r, a );
+		const __m128 pg = _mm_mul_ps( g, a );
+		const __m128 pb = _mm_mul_ps( b, a );
+		if( _mm_movemask_ps( _mm_or_ps( _mm_cmpunord_ps( pr, pg ), _mm_cmpunord_ps( pb, pb ) ) ) )
+		{
+			// std::min and std::max don't order the NaN values like the SSE instructions
+			for( int k = 0; k < 4; ++k )
+			{
+				if( enabled & ( 1 << k ) )
+					histogram_rgba_hsl_pixel( p + k * srcStep, lastValue, bins );
+			}
+			continue;
+		}
+
+		const __m128 minColor = _mm_min_ps( pr, _mm_min_ps( pg, pb ) );
+		const __m128 maxColor = _mm_max_ps( pr, _mm_max_ps( pg, pb ) );
+		const __m128 diff = _mm_sub_ps( maxColor, minColor );
+		const __m128 sum = _mm_add_ps( minColor, maxColor );
+		const __m128 gray = _mm_cmplt_ps( histogram_abs_sse2( diff ), grayThreshold );
+
+		const __m128 lightness = _mm_div_ps( sum, two );
+		const __m128 saturation = histogram_select_sse2( _mm_cmplt_ps( lightness, half ),
+		                                                 _mm_div_ps( diff, sum ),
+		                                                 _mm_div_ps( diff, _mm_sub_ps( two, diff ) ) );
+
+		const __m128 isRed = _mm_cmplt_ps( histogram_abs_sse2( _mm_sub_ps( maxColor, pr ) ), hueThreshold );
+		const __m128 isGreen = _mm_cmplt_ps( histogram_abs_sse2( _mm_sub_ps( maxColor, pg ) ), hueThreshold );
+		const __m128 hueRed = _mm_div_ps( _mm_sub_ps( pg, pb ), diff );
+		const __m128 hueGreen = _mm_add_ps( two, _mm_div_ps( _mm_sub_ps( pb, pr ), diff ) );
+		const __m128 hueBlue = _mm_add_ps( four, _mm_div_ps( _mm_sub_ps( pr, pb ), diff ) );
+		__m128 hue = _mm_div_ps( histogram_select_sse2( isRed, hueRed, histogram_select_sse2( isGreen, hueGreen, hueBlue ) ), six );
+		hue = _mm_add_ps( hue, _mm_and_ps( _mm_cmplt_ps( hue, zero ), one ) );
+
+		histogram_count_sse2( bins[0], r, enabled, last );
+		histogram_count_sse2( bins[1], g, enabled, last );
+		histogram_count_sse2( bins[2], b, enabled, last );
+		histogram_count_sse2( bins[3], a, enabled, last );
+		histogram_count_sse2( bins[4], _mm_andnot_ps( gray, hue ), enabled, last );
+		histogram_count_sse2( bins[5], _mm_andnot_ps( gray, saturation ), enabled, last );
+		histogram_count_sse2( bins[6], histogram_select_sse2( gray, pr, lightness ), enabled, last );
+	}
+	if( i < n )
+		histogram_rgba_hsl_floats_generic( src + i * srcStep, srcStep, mask ? mask + i * maskStep : NULL, maskStep, n - i, nbBins, bins );
+}
+
+#endif
+
+typedef void (*histogram_rgba_hsl_floats_function)( const float*, const std::size_t, const unsigned char*, const std::size_t,
+                                                    const std::size_t, const std::size_t, std::size_t* const* );
+
+/// @return the best implementation for the current cpu
+inline histogram_rgba_hsl_floats_function select_histogram_rgba_hsl_floats()
+{
+#ifdef TERRY_NUMERIC_SIMD_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "sse2" ) )
+		return &histogram_rgba_hsl_floats_sse2;
+#endif
+	return &histogram_rgba_hsl_floats_generic;
+}
+
+/// Histograms of float rgba pixels with the best implementation for the current cpu.
+inline void histogram_rgba_hsl_floats( const float* src, const std::size_t srcStep,
+                                       const unsigned char* mask, const std::size_t maskStep,
+                                       const std::size_t n, const std::size_t nbBins, std::size_t* const* bins )
+{
+	static const histogram_rgba_hsl_floats_function count = select_histogram_rgba_hsl_floats();
+	count( src, srcStep, mask, maskStep, n, nbBins, bins );
+}
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef _TERRY_NUMERIC_HASH_HPP_
+#define _TERRY_NUMERIC_HASH_HPP_
+
+#include <boost/functional/hash.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+namespace terry {
+namespace numeric {
+
+/**
+ * @brief Hash of the pixel values of an interleaved view.
+ *
+ * The hosts don't give any identifier of the content of the images, so the
+ * caches of the plugins identify the pixels with this hash. It is much cheaper
+ * than most of the per-pixel computations.
+ * It is a row reducer of terry::algorithm::parallel_reduce_rows: the chunks
+ * only depend on the height, so the hash is the same for the same pixels.
+ */
+template<class View>
+struct view_content_hash_t
+{
+	View _view;
+	std::size_t _hash;
+
+	view_content_hash_t( const View& view )
+	: _view( view )
+	, _hash( 0 )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		const unsigned char* row = reinterpret_cast<const unsigned char*>( &( *_view.row_begin( y ) ) );
+		const std::size_t nbBytes = _view.width() * sizeof( typename View::value_type );
+		const std::size_t nbWords = nbBytes / sizeof( std::size_t );
+
+		std::size_t rowHash = static_cast<std::size_t>( y );
+		for( std::size_t i = 0; i < nbWords; ++i )
+		{
+			std::size_t word;
+			std::memcpy( &word, row + i * sizeof( std::size_t ), sizeof( std::size_t ) );
+			boost::hash_combine( rowHash, word );
+		}
+		for( std::size_t i = nbWords * sizeof( std::size_t ); i < nbBytes; ++i )
+			boost::hash_combine( rowHash, row[i] );
+		boost::hash_combine( _hash, rowHash );
+	}
+
+	void merge( const view_content_hash_t& other )
+	{
+		boost::hash_combine( _hash, other._hash );
+	}
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef _TERRY_NUMERIC_HISTOGRAM_HPP_
+#define _TERRY_NUMERIC_HISTOGRAM_HPP_
+
+#include "detail/histogram_simd.hpp"
+
+#include <boost/gil/pixel.hpp>
+#include <boost/gil/metafunctions.hpp>
+#include <boost/gil/color_convert.hpp>
+#include <boost/gil/typedefs.hpp>
+#include <boost/array.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace terry {
+namespace numeric {
+
+using namespace boost::gil;
+
+/**
+ * @brief Histogram of each channel of normalized values.
+ *
+ * The values in [0, 1] are counted in the nearest of nbBins bins
+ * (the first bin is 0, the last is 1), the other values are ignored.
+ * It can be used as a reducer of terry::algorithm::parallel_reduce_pixels.
+ */
+template<typename Pixel>
+struct pixel_histogram_t
+{
+	typedef std::vector<std::size_t> Bins;
+	boost::array<Bins, num_channels<Pixel>::value> bins;
+
+	explicit pixel_histogram_t( const std::size_t nbBins = 256 )
+	{
+		for( std::size_t c = 0; c < bins.size(); ++c )
+			bins[c].assign( nbBins, 0 );
+	}
+
+	std::size_t nbBins() const { return bins[0].size(); }
+
+	template<typename P>
+	GIL_FORCEINLINE
+	void operator()( const P& p )
+	{
+		const double last = double( nbBins() - 1 );
+		for( std::size_t c = 0; c < bins.size(); ++c )
+		{
+			const double v = p[c];
+			if( v >= 0.0 && v <= 1.0 )
+				++bins[c][ static_cast<std::size_t>( v * last + 0.5 ) ];
+		}
+	}
+
+	void merge( const pixel_histogram_t& other )
+	{
+		for( std::size_t c = 0; c < bins.size(); ++c )
+			for( std::size_t i = 0; i < bins[c].size(); ++i )
+				bins[c][i] += other.bins[c][i];
+	}
+};
+
+/**
+ * @brief Histograms of the red, green, blue, alpha, hue, saturation and
+ * lightness of float rgba pixels, with the bins of pixel_histogram_t.
+ *
+ * It gives the same bins as a pixel_histogram_t<rgba32f_pixel_t> and a
+ * pixel_histogram_t<hsl32f_pixel_t> of the color_convert of the pixels,
+ * in one pass with a SIMD conversion to HSL.
+ * The rows can be sampled (one pixel every step) for interactive displays.
+ * In the row reducers of terry::algorithm::parallel_reduce_rows, each chunk
+ * of rows counts in its own bins, which are summed by merge.
+ */
+struct rgba_hsl_histogram_t
+{
+	enum EChannel { red = 0, green, blue, alpha, hue, saturation, lightness };
+
+	typedef std::vector<std::size_t> Bins;
+	boost::array<Bins, detail::kNbRgbaHslChannels> bins;
+
+	explicit rgba_hsl_histogram_t( const std::size_t nbBins = 256 )
+	{
+		for( std::size_t c = 0; c < bins.size(); ++c )
+			bins[c].assign( nbBins, 0 );
+	}
+
+	std::size_t nbBins() const { return bins[0].size(); }
+
+	/**
+	 * @brief Count a row of rgba32f pixels.
+	 * @param rgba first pixel of the row
+	 * @param width number of pixels of the row
+	 * @param step only count one pixel every step pixels
+	 * @param mask one byte per pixel of the row, only count the pixels with a non-null byte (NULL counts all the pixels)
+	 */
+	void add_row( const float* rgba, const std::size_t width, const std::size_t step = 1, const unsigned char* mask = NULL )
+	{
+		if( width == 0 || nbBins() == 0 )
+			return;
+		std::size_t* channelBins[detail::kNbRgbaHslChannels];
+		for( std::size_t c = 0; c < bins.size(); ++c )
+			channelBins[c] = &bins[c][0];
+		detail::histogram_rgba_hsl_floats( rgba, 4 * step, mask, step, ( width + step - 1 ) / step, nbBins(), channelBins );
+	}
+
+	template<typename P>
+	GIL_FORCEINLINE
+	void operator()( const P& p )
+	{
+		rgba32f_pixel_t rgba;
+		color_convert( p, rgba );
+		add_row( reinterpret_cast<const float*>( &rgba ), 1 );
+	}
+
+	void merge( const rgba_hsl_histogram_t& other )
+	{
+		for( std::size_t c = 0; c < bins.size(); ++c )
+			for( std::size_t i = 0; i < bins[c].size(); ++i )
+				bins[c][i] += other.bins[c][i];
+	}
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef _TERRY_NUMERIC_STATISTICS_HPP_
+#define _TERRY_NUMERIC_STATISTICS_HPP_
+
+#include <terry/numeric/init.hpp>
+
+#include <boost/gil/pixel.hpp>
+#include <boost/gil/metafunctions.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+namespace terry {
+namespace numeric {
+
+using namespace boost::gil;
+
+/**
+ * @brief Mean and variance of each channel, in one pass.
+ *
+ * The pixels are accumulated with the Welford update, and the partial results
+ * are merged with the formula of Chan et al., so it can be used as a reducer
+ * of terry::algorithm::parallel_reduce_pixels without the cancellation of
+ * the sum of squares.
+ *
+ * @tparam CPixel pixel type of the results, with floating point channels (like bits64f)
+ */
+template<typename CPixel>
+struct pixel_mean_variance_t
+{
+	std::size_t count;
+	CPixel mean;
+	CPixel m2; ///< sum of the squared differences to the mean
+
+	pixel_mean_variance_t()
+	: count( 0 )
+	{
+		pixel_zeros_t<CPixel>()( mean );
+		pixel_zeros_t<CPixel>()( m2 );
+	}
+
+	template<typename Pixel>
+	GIL_FORCEINLINE
+	void operator()( const Pixel& p )
+	{
+		++count;
+		for( int c = 0; c < num_channels<CPixel>::value; ++c )
+		{
+			const double v = p[c];
+			const double delta = v - mean[c];
+			mean[c] += delta / count;
+			m2[c] += delta * ( v - mean[c] );
+		}
+	}
+
+	void merge( const pixel_mean_variance_t& other )
+	{
+		if( other.count == 0 )
+			return;
+		if( count == 0 )
+		{
+			*this = other;
+			return;
+		}
+		const double n = count + other.count;
+		for( int c = 0; c < num_channels<CPixel>::value; ++c )
+		{
+			const double delta = other.mean[c] - mean[c];
+			mean[c] += delta * other.count / n;
+			m2[c] += other.m2[c] + delta * delta * ( double( count ) * other.count / n );
+		}
+		count += other.count;
+	}
+
+	/// population variance
+	CPixel variance() const
+	{
+		CPixel res;
+		for( int c = 0; c < num_channels<CPixel>::value; ++c )
+			res[c] = count ? m2[c] / count : 0.0;
+		return res;
+	}
+
+	/// population standard deviation
+	CPixel standard_deviation() const
+	{
+		CPixel res = variance();
+		for( int c = 0; c < num_channels<CPixel>::value; ++c )
+			res[c] = std::sqrt( double( res[c] ) );
+		return res;
+	}
+};
+
+/**
+ * @brief Sum of the squared differences between the channels of two images.
+ * @tparam CPixel pixel type of the results, with floating point channels (like bits64f)
+ */
+template<typename CPixel>
+struct pixel_squared_difference_sum_t
+{
+	std::size_t count;
+	CPixel sum;
+
+	pixel_squared_difference_sum_t()
+	: count( 0 )
+	{
+		pixel_zeros_t<CPixel>()( sum );
+	}
+
+	template<typename Pixel1, typename Pixel2>
+	GIL_FORCEINLINE
+	void operator()( const Pixel1& p1, const Pixel2& p2 )
+	{
+		++count;
+		for( int c = 0; c < num_channels<CPixel>::value; ++c )
+		{
+			const double diff = double( p1[c] ) - double( p2[c] );
+			sum[c] += diff * diff;
+		}
+	}
+
+	void merge( const pixel_squared_difference_sum_t& other )
+	{
+		count += other.count;
+		for( int c = 0; c < num_channels<CPixel>::value; ++c )
+			sum[c] += other.sum[c];
+	}
+
+	/// mean squared error
+	CPixel mean() const
+	{
+		CPixel res;
+		for( int c = 0; c < num_channels<CPixel>::value; ++c )
+			res[c] = count ? sum[c] / count : 0.0;
+		return res;
+	}
+};
+
+}
+}
+
+#endif
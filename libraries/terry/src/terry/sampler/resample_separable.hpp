@@ -0,0 +1,225 @@
+#ifndef _TERRY_SAMPLER_RESAMPLE_SEPARABLE_HPP_
+#define _TERRY_SAMPLER_RESAMPLE_SEPARABLE_HPP_
+
+#include "details.hpp"
+
+#include <terry/math/Rect.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace terry {
+using namespace boost::gil;
+namespace sampler {
+
+/**
+ * @brief Precomputed filter weights of one axis, for a separable resampling.
+ *
+ * The source position of each destination position is given by an axis aligned mapping:
+ * src = dst * scale + offset
+ * For each destination position, the sampler gives _windowSize weights on the
+ * neighbour source positions (same window and weights than the 2D sample function).
+ * The source positions outside of the image are resolved with the out of image mode:
+ * clamped (copy), mirrored, or replaced by a constant pixel (black, transparency),
+ * which is marked with an index of -1.
+ */
+struct separable_weights
+{
+	typedef RESAMPLING_CORE_TYPE Weight;
+
+	std::size_t                 _windowSize;
+	std::vector<std::ptrdiff_t> _indices; ///< source index of each tap, -1 for the out of image constant
+	std::vector<Weight>         _weights; ///< weight of each tap
+
+	separable_weights()
+	: _windowSize( 0 )
+	{}
+
+	std::size_t size() const { return _windowSize ? _indices.size() / _windowSize : 0; }
+
+	const std::ptrdiff_t* indices( const std::ptrdiff_t dst ) const { return &_indices[dst * _windowSize]; }
+	const Weight* weights( const std::ptrdiff_t dst ) const { return &_weights[dst * _windowSize]; }
+
+	/**
+	 * @brief Range of source positions used by the destination positions [dstBegin, dstEnd[
+	 * @return an empty range (first >= second) if only constant pixels are used.
+	 */
+	std::pair<std::ptrdiff_t, std::ptrdiff_t> source_range( const std::ptrdiff_t dstBegin, const std::ptrdiff_t dstEnd ) const
+	{
+		std::ptrdiff_t first = std::numeric_limits<std::ptrdiff_t>::max();
+		std::ptrdiff_t last  = -1;
+		for( std::ptrdiff_t i = dstBegin * _windowSize; i < dstEnd * (std::ptrdiff_t)_windowSize; ++i )
+		{
+			if( _indices[i] < 0 )
+				continue;
+			first = std::min( first, _indices[i] );
+			last  = std::max( last, _indices[i] );
+		}
+		return std::make_pair( first, last + 1 );
+	}
+};
+
+namespace details {
+
+inline std::ptrdiff_t resolve_out_of_image_index( std::ptrdiff_t index, const std::ptrdiff_t size, const EParamFilterOutOfImage outOfImageProcess )
+{
+	if( index >= 0 && index < size )
+		return index;
+
+	switch( outOfImageProcess )
+	{
+		case eParamFilterOutCopy:
+			return index < 0 ? 0 : size - 1;
+		case eParamFilterOutMirror:
+		{
+			const std::ptrdiff_t period = 2 * size;
+			index %= period;
+			if( index < 0 )
+				index += period;
+			return index < size ? index : period - 1 - index;
+		}
+		case eParamFilterOutBlack:
+		case eParamFilterOutTransparency:
+			break;
+	}
+	return -1;
+}
+
+}
+
+/**
+ * @brief Compute the weights of one axis.
+ * @param[in] dstSize number of destination positions
+ * @param[in] scale, offset mapping from destination to source positions (src = dst * scale + offset)
+ * @param[in] srcSize number of source positions
+ */
+template<typename Sampler>
+void compute_separable_weights( Sampler sampler, const std::ptrdiff_t dstSize,
+                                const double scale, const double offset, const std::ptrdiff_t srcSize,
+                                const EParamFilterOutOfImage outOfImageProcess, separable_weights& weights )
+{
+	const std::size_t windowSize = sampler._windowSize;
+	// same window position than the 2D sample function
+	const std::ptrdiff_t middlePosition = static_cast<std::ptrdiff_t>( std::floor( ( windowSize - 1.0 ) * 0.5 ) );
+
+	weights._windowSize = windowSize;
+	weights._indices.resize( dstSize * windowSize );
+	weights._weights.resize( dstSize * windowSize );
+
+	for( std::ptrdiff_t dst = 0; dst < dstSize; ++dst )
+	{
+		const double p = dst * scale + offset;
+		const std::ptrdiff_t pTL = static_cast<std::ptrdiff_t>( std::floor( p ) );
+		const RESAMPLING_CORE_TYPE frac = p - pTL;
+
+		std::ptrdiff_t* indices = &weights._indices[dst * windowSize];
+		separable_weights::Weight* w = &weights._weights[dst * windowSize];
+		for( std::size_t i = 0; i < windowSize; ++i )
+		{
+			const RESAMPLING_CORE_TYPE distance = - frac - middlePosition + i;
+			sampler( distance, w[i] );
+			indices[i] = details::resolve_out_of_image_index( pTL - middlePosition + i, srcSize, outOfImageProcess );
+		}
+	}
+}
+
+/**
+ * @brief Axis aligned resampling in two 1D passes, with precomputed weights.
+ *
+ * Gives the same result than resample_pixels_progress with a scale/translate mapping,
+ * but the weights are computed once per axis instead of per pixel, and the source
+ * is read by scanlines: a horizontal pass computes the source rows needed by the
+ * processing window into a floating point buffer, then a vertical pass combines them.
+ *
+ * Each call only writes inside procWindow, so windows can be processed concurrently.
+ */
+template<typename SrcView, typename DstView, typename Progress>
+void resample_separable_progress(
+	const SrcView& src_view, const DstView& dst_view,
+	const separable_weights& xWeights, const separable_weights& yWeights,
+	const terry::Rect<std::ssize_t>& procWindow,
+	const EParamFilterOutOfImage& outOfImageProcess,
+	Progress& p )
+{
+	typedef typename SrcView::value_type                     SrcP;
+	typedef typename floating_pixel_from_view<SrcView>::type SrcC;
+	typedef separable_weights::Weight                        Weight;
+
+	const std::ptrdiff_t procWidth = procWindow.x2 - procWindow.x1;
+	if( procWidth <= 0 || procWindow.y2 <= procWindow.y1 )
+		return;
+
+	// value of the source pixels outside of the image (only used for black and transparency)
+	SrcC outOfImagePixel( 0 );
+	if( outOfImageProcess == eParamFilterOutBlack )
+		outOfImagePixel = get_black<SrcC>();
+
+	// horizontal pass on the source rows used by the processing window
+	const std::pair<std::ptrdiff_t, std::ptrdiff_t> srcRows = yWeights.source_range( procWindow.y1, procWindow.y2 );
+	const std::ptrdiff_t nbSrcRows = std::max<std::ptrdiff_t>( srcRows.second - srcRows.first, 0 );
+
+	std::vector<SrcC> horizontal( nbSrcRows * procWidth, SrcC( 0 ) );
+	for( std::ptrdiff_t y = 0; y < nbSrcRows; ++y )
+	{
+		const typename SrcView::x_iterator srcRow = src_view.row_begin( srcRows.first + y );
+		SrcC* hRow = &horizontal[y * procWidth];
+		for( std::ptrdiff_t x = 0; x < procWidth; ++x )
+		{
+			const std::ptrdiff_t* indices = xWeights.indices( procWindow.x1 + x );
+			const Weight* weights = xWeights.weights( procWindow.x1 + x );
+			SrcC mp( 0 );
+			for( std::size_t i = 0; i < xWeights._windowSize; ++i )
+			{
+				if( weights[i] == 0 )
+					continue;
+				if( indices[i] >= 0 )
+					details::add_dst_mul_src<SrcP, Weight, SrcC>()( srcRow[indices[i]], weights[i], mp );
+				else
+					details::add_dst_mul_src<SrcC, Weight, SrcC>()( outOfImagePixel, weights[i], mp );
+			}
+			hRow[x] = mp;
+		}
+	}
+
+	// vertical pass, row by row on the horizontal buffer
+	std::vector<SrcC> accumulator( procWidth );
+	for( std::ptrdiff_t y = procWindow.y1; y < procWindow.y2; ++y )
+	{
+		std::fill( accumulator.begin(), accumulator.end(), SrcC( 0 ) );
+
+		const std::ptrdiff_t* indices = yWeights.indices( y );
+		const Weight* weights = yWeights.weights( y );
+		for( std::size_t i = 0; i < yWeights._windowSize; ++i )
+		{
+			if( weights[i] == 0 )
+				continue;
+			if( indices[i] >= 0 )
+			{
+				const SrcC* hRow = &horizontal[( indices[i] - srcRows.first ) * procWidth];
+				for( std::ptrdiff_t x = 0; x < procWidth; ++x )
+					details::add_dst_mul_src<SrcC, Weight, SrcC>()( hRow[x], weights[i], accumulator[x] );
+			}
+			else
+			{
+				for( std::ptrdiff_t x = 0; x < procWidth; ++x )
+					details::add_dst_mul_src<SrcC, Weight, SrcC>()( outOfImagePixel, weights[i], accumulator[x] );
+			}
+		}
+
+		typename DstView::x_iterator dstIt = dst_view.row_begin( y ) + procWindow.x1;
+		for( std::ptrdiff_t x = 0; x < procWidth; ++x, ++dstIt )
+		{
+			// Convert from floating point average value to the destination type
+			color_convert( accumulator[x], *dstIt );
+		}
+		if( p.progressForward( procWidth ) )
+			return;
+	}
+}
+
+}
+}
+
+#endif
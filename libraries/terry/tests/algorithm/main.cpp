@@ -0,0 +1,321 @@
+#include <terry/globals.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
+#include <terry/numeric/minmax.hpp>
+#include <terry/numeric/statistics.hpp>
+#include <terry/numeric/histogram.hpp>
+
+#include <boost/gil/extension/color/hsl.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#define BOOST_TEST_MODULE terry_algorithm_tests
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+using namespace terry;
+
+namespace {
+
+/// 97x301 image with values in [0, 1], not aligned on the chunks of the reduction
+struct Fixture
+{
+	rgb32f_image_t _image;
+	rgb32f_view_t _view;
+
+	Fixture()
+	: _image( 97, 301 )
+	, _view( view( _image ) )
+	{
+		for( std::ptrdiff_t y = 0; y < _view.height(); ++y )
+			for( std::ptrdiff_t x = 0; x < _view.width(); ++x )
+				_view( x, y ) = rgb32f_pixel_t( ( x * 7 + y * 13 ) % 101 / 100.0f, y / 300.0f, x / 96.0f );
+	}
+};
+
+/// Row reducer counting the rows, to check the split in chunks.
+struct RowsCounter
+{
+	std::vector<int> _rows;
+
+	explicit RowsCounter( const std::size_t height ) : _rows( height, 0 ) {}
+	void operator()( const std::ptrdiff_t y ) { ++_rows[y]; }
+	void merge( const RowsCounter& other )
+	{
+		for( std::size_t y = 0; y < _rows.size(); ++y )
+			_rows[y] += other._rows[y];
+	}
+};
+
+struct AbortProgress
+{
+	int _nbSteps;
+	AbortProgress() : _nbSteps( 0 ) {}
+	bool progressForward( const int nbSteps ) { _nbSteps += nbSteps; return true; }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE( terry_algorithm_tests_suite01 )
+
+BOOST_AUTO_TEST_CASE( parallel_reduce_rows_each_row_once )
+{
+	for( std::ptrdiff_t height = 0; height < 2000; height += 37 )
+	{
+		const RowsCounter counter = algorithm::parallel_reduce_rows( algorithm::thread_launcher( 4 ), height, RowsCounter( height ) );
+		for( std::ptrdiff_t y = 0; y < height; ++y )
+			BOOST_CHECK_EQUAL( counter._rows[y], 1 );
+		const RowsCounter serialCounter = algorithm::parallel_reduce_rows( algorithm::serial_launcher(), height, RowsCounter( height ) );
+		for( std::ptrdiff_t y = 0; y < height; ++y )
+			BOOST_CHECK_EQUAL( serialCounter._rows[y], 1 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( parallel_reduce_rows_abort )
+{
+	const std::ptrdiff_t height = 1000;
+	// the partial result is never returned
+	AbortProgress progress;
+	BOOST_CHECK_THROW( algorithm::parallel_reduce_rows( algorithm::thread_launcher( 4 ), height, RowsCounter( height ), progress ),
+	                   algorithm::parallel_aborted );
+	BOOST_CHECK( progress._nbSteps < height );
+
+	AbortProgress serialProgress;
+	BOOST_CHECK_THROW( algorithm::parallel_reduce_rows( algorithm::serial_launcher(), height, RowsCounter( height ), serialProgress ),
+	                   algorithm::parallel_aborted );
+}
+
+BOOST_FIXTURE_TEST_CASE( parallel_reduce_minmax, Fixture )
+{
+	typedef numeric::pixel_minmax_by_channel_t<rgb32f_pixel_t> MinMax;
+	const MinMax minmax = algorithm::parallel_reduce_pixels( algorithm::thread_launcher(), _view, MinMax( _view( 0, 0 ) ) );
+	BOOST_CHECK_EQUAL( float( minmax.min[0] ), 0.0f );
+	BOOST_CHECK_CLOSE( float( minmax.max[0] ), 1.0f, 1e-4 );
+	BOOST_CHECK_CLOSE( float( minmax.max[1] ), 1.0f, 1e-4 );
+	BOOST_CHECK_CLOSE( float( minmax.max[2] ), 1.0f, 1e-4 );
+	BOOST_CHECK_EQUAL( float( minmax.min[1] ), 0.0f );
+	BOOST_CHECK_EQUAL( float( minmax.min[2] ), 0.0f );
+}
+
+BOOST_FIXTURE_TEST_CASE( parallel_reduce_mean_variance, Fixture )
+{
+	typedef pixel<bits64f, rgb_layout_t> CPixel;
+	const numeric::pixel_mean_variance_t<CPixel> stats = algorithm::parallel_reduce_pixels( algorithm::thread_launcher(), _view, numeric::pixel_mean_variance_t<CPixel>() );
+
+	// reference with the two pass formula
+	const double nbPixels = double( _view.width() ) * _view.height();
+	for( int c = 0; c < 3; ++c )
+	{
+		double sum = 0;
+		for( std::ptrdiff_t y = 0; y < _view.height(); ++y )
+			for( std::ptrdiff_t x = 0; x < _view.width(); ++x )
+				sum += _view( x, y )[c];
+		const double mean = sum / nbPixels;
+		double sum2 = 0;
+		for( std::ptrdiff_t y = 0; y < _view.height(); ++y )
+			for( std::ptrdiff_t x = 0; x < _view.width(); ++x )
+				sum2 += ( _view( x, y )[c] - mean ) * ( _view( x, y )[c] - mean );
+
+		BOOST_CHECK_EQUAL( stats.count, std::size_t( nbPixels ) );
+		BOOST_CHECK_CLOSE( double( stats.mean[c] ), mean, 1e-9 );
+		BOOST_CHECK_CLOSE( double( stats.variance()[c] ), sum2 / nbPixels, 1e-9 );
+	}
+
+	// deterministic merge: same result bit for bit
+	const numeric::pixel_mean_variance_t<CPixel> stats2 = algorithm::parallel_reduce_pixels( algorithm::thread_launcher(), _view, numeric::pixel_mean_variance_t<CPixel>() );
+	for( int c = 0; c < 3; ++c )
+	{
+		BOOST_CHECK_EQUAL( double( stats.mean[c] ), double( stats2.mean[c] ) );
+		BOOST_CHECK_EQUAL( double( stats.m2[c] ), double( stats2.m2[c] ) );
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE( parallel_reduce_histogram, Fixture )
+{
+	const numeric::pixel_histogram_t<rgb32f_pixel_t> histogram =
+		algorithm::parallel_reduce_pixels( algorithm::thread_launcher(), _view, numeric::pixel_histogram_t<rgb32f_pixel_t>( 64 ) );
+
+	numeric::pixel_histogram_t<rgb32f_pixel_t> reference( 64 );
+	for( std::ptrdiff_t y = 0; y < _view.height(); ++y )
+		for( std::ptrdiff_t x = 0; x < _view.width(); ++x )
+			reference( _view( x, y ) );
+
+	for( int c = 0; c < 3; ++c )
+	{
+		std::size_t total = 0;
+		for( std::size_t i = 0; i < 64; ++i )
+		{
+			BOOST_CHECK_EQUAL( histogram.bins[c][i], reference.bins[c][i] );
+			total += histogram.bins[c][i];
+		}
+		BOOST_CHECK_EQUAL( total, std::size_t( _view.width() * _view.height() ) );
+	}
+}
+
+namespace {
+
+const float* rgbaFloats( const rgba32f_view_t& view, const std::ptrdiff_t y )
+{
+	return reinterpret_cast<const float*>( &( *view.row_begin( y ) ) );
+}
+
+/// Random rgba pixels, with grays, values out of [0, 1] and NaN.
+void fillRandomRgba( const rgba32f_view_t& view, const unsigned int seed )
+{
+	std::srand( seed );
+	for( std::ptrdiff_t y = 0; y < view.height(); ++y )
+	{
+		for( std::ptrdiff_t x = 0; x < view.width(); ++x )
+		{
+			rgba32f_pixel_t& p = view( x, y );
+			for( int c = 0; c < 4; ++c )
+				p[c] = ( std::rand() % 1200 - 100 ) / 1000.0f;
+			switch( std::rand() % 8 )
+			{
+				case 0: p[1] = p[2] = p[0]; break; // gray
+				case 1: p[3] = 1.0f; break;
+				case 2: p[std::rand() % 4] = std::numeric_limits<float>::quiet_NaN(); break;
+				case 3: p[1] = p[0] + 0.00005f; break; // two maximums for the hue
+				default: break;
+			}
+		}
+	}
+}
+
+/// The histograms of the pixels of a row (one pixel every step, in the mask) with pixel_histogram_t.
+void referenceRgbaHslHistogram( const rgba32f_view_t::x_iterator& row, const std::ptrdiff_t width, const std::size_t step,
+                                const unsigned char* mask, numeric::pixel_histogram_t<rgba32f_pixel_t>& rgba,
+                                numeric::pixel_histogram_t<hsl32f_pixel_t>& hsl )
+{
+	for( std::ptrdiff_t x = 0; x < width; x += step )
+	{
+		if( mask && ! mask[x] )
+			continue;
+		hsl32f_pixel_t hslPixel;
+		color_convert( row[x], hslPixel );
+		rgba( row[x] );
+		hsl( hslPixel );
+	}
+}
+
+void checkSameBins( const numeric::rgba_hsl_histogram_t& histogram,
+                    const numeric::pixel_histogram_t<rgba32f_pixel_t>& rgba,
+                    const numeric::pixel_histogram_t<hsl32f_pixel_t>& hsl )
+{
+	for( int c = 0; c < 4; ++c )
+		BOOST_CHECK( histogram.bins[c] == rgba.bins[c] );
+	for( int c = 0; c < 3; ++c )
+		BOOST_CHECK( histogram.bins[numeric::rgba_hsl_histogram_t::hue + c] == hsl.bins[c] );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( rgba_hsl_histogram_same_as_color_convert )
+{
+	rgba32f_image_t image( 203, 37 );
+	const rgba32f_view_t v = view( image );
+	fillRandomRgba( v, 7 );
+	std::vector<unsigned char> mask( v.width() );
+	for( std::size_t x = 0; x < mask.size(); ++x )
+		mask[x] = ( x % 7 < 3 ) ? 255 : 0;
+
+	const std::size_t steps[] = { 1, 2, 5 };
+	for( std::size_t s = 0; s < 3; ++s )
+	{
+		for( int useMask = 0; useMask < 2; ++useMask )
+		{
+			const unsigned char* rowMask = useMask ? &mask[0] : NULL;
+			numeric::rgba_hsl_histogram_t histogram( 100 );
+			numeric::pixel_histogram_t<rgba32f_pixel_t> rgba( 100 );
+			numeric::pixel_histogram_t<hsl32f_pixel_t> hsl( 100 );
+			for( std::ptrdiff_t y = 0; y < v.height(); ++y )
+			{
+				histogram.add_row( rgbaFloats( v, y ), v.width(), steps[s], rowMask );
+				referenceRgbaHslHistogram( v.row_begin( y ), v.width(), steps[s], rowMask, rgba, hsl );
+			}
+			checkSameBins( histogram, rgba, hsl );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( rgba_hsl_histogram_generic_same_as_simd )
+{
+	rgba32f_image_t image( 131, 11 );
+	const rgba32f_view_t v = view( image );
+	fillRandomRgba( v, 3 );
+	const float* pixels = rgbaFloats( v, 0 );
+	const std::size_t n = v.width() * v.height();
+
+	numeric::rgba_hsl_histogram_t simd( 256 );
+	numeric::rgba_hsl_histogram_t generic( 256 );
+	std::size_t* genericBins[numeric::detail::kNbRgbaHslChannels];
+	for( std::size_t c = 0; c < generic.bins.size(); ++c )
+		genericBins[c] = &generic.bins[c][0];
+
+	simd.add_row( pixels, n );
+	numeric::detail::histogram_rgba_hsl_floats_generic( pixels, 4, NULL, 1, n, 256, genericBins );
+	for( std::size_t c = 0; c < simd.bins.size(); ++c )
+		BOOST_CHECK( simd.bins[c] == generic.bins[c] );
+}
+
+namespace {
+
+/// Row reducer of the histograms of the rows of a view.
+struct RowsRgbaHslHistogram
+{
+	rgba32f_view_t _view;
+	numeric::rgba_hsl_histogram_t _histogram;
+
+	RowsRgbaHslHistogram( const rgba32f_view_t& view, const std::size_t nbBins )
+	: _view( view )
+	, _histogram( nbBins )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		_histogram.add_row( rgbaFloats( _view, y ), _view.width() );
+	}
+
+	void merge( const RowsRgbaHslHistogram& other )
+	{
+		_histogram.merge( other._histogram );
+	}
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( parallel_reduce_rgba_hsl_histogram )
+{
+	rgba32f_image_t image( 64, 301 );
+	const rgba32f_view_t v = view( image );
+	fillRandomRgba( v, 11 );
+
+	const RowsRgbaHslHistogram reducer = algorithm::parallel_reduce_rows( algorithm::thread_launcher(), v.height(), RowsRgbaHslHistogram( v, 32 ) );
+
+	numeric::pixel_histogram_t<rgba32f_pixel_t> rgba( 32 );
+	numeric::pixel_histogram_t<hsl32f_pixel_t> hsl( 32 );
+	for( std::ptrdiff_t y = 0; y < v.height(); ++y )
+		referenceRgbaHslHistogram( v.row_begin( y ), v.width(), 1, NULL, rgba, hsl );
+	checkSameBins( reducer._histogram, rgba, hsl );
+}
+
+BOOST_FIXTURE_TEST_CASE( parallel_reduce_squared_difference, Fixture )
+{
+	typedef pixel<bits64f, rgb_layout_t> CPixel;
+	rgb32f_image_t other( _view.dimensions() );
+	const rgb32f_view_t otherView = view( other );
+	for( std::ptrdiff_t y = 0; y < _view.height(); ++y )
+		for( std::ptrdiff_t x = 0; x < _view.width(); ++x )
+			otherView( x, y ) = rgb32f_pixel_t( _view( x, y )[0] + 0.5f, _view( x, y )[1], _view( x, y )[2] - 0.25f );
+
+	algorithm::no_progress progress;
+	const numeric::pixel_squared_difference_sum_t<CPixel> ssd =
+		algorithm::parallel_reduce_pixels( algorithm::thread_launcher(), _view, otherView, numeric::pixel_squared_difference_sum_t<CPixel>(), progress );
+	const CPixel mse = ssd.mean();
+	BOOST_CHECK_CLOSE( double( mse[0] ), 0.25, 1e-4 );
+	BOOST_CHECK_SMALL( double( mse[1] ), 1e-12 );
+	BOOST_CHECK_CLOSE( double( mse[2] ), 0.0625, 1e-4 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,285 @@
+#include <terry/globals.hpp>
+#include <terry/color/lut.hpp>
+#include <terry/color/lut_cache.hpp>
+#include <terry/colorspace/gradation.hpp>
+
+#include <boost/make_shared.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#define BOOST_TEST_MODULE terry_color_tests
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+using namespace terry;
+
+namespace {
+
+struct Power
+{
+	double _exponent;
+	Power( const double exponent ) : _exponent( exponent ) {}
+	float operator()( const float v ) const { return v > 0 ? float( std::pow( double( v ), _exponent ) ) : v; }
+};
+
+/// Transform mixing the channels, with transcendental functions.
+struct Transform
+{
+	rgb32f_pixel_t operator()( const rgb32f_pixel_t& p ) const
+	{
+		const float r = p[0], g = p[1], b = p[2];
+		return rgb32f_pixel_t( std::sqrt( std::abs( 0.7f * r + 0.2f * g + 0.1f * b ) + 0.01f ),
+		                       std::exp( 0.5f * g - 0.25f * r ),
+		                       std::log( 1.0f + b + 0.5f * r * g ) );
+	}
+};
+
+/// Tone mapping of HDR values, mixing the channels.
+struct ToneMapping
+{
+	rgb32f_pixel_t operator()( const rgb32f_pixel_t& p ) const
+	{
+		rgb32f_pixel_t res;
+		for( int c = 0; c < 3; ++c )
+		{
+			const float v = 0.8f * p[c] + 0.1f * p[( c + 1 ) % 3] + 0.1f * p[( c + 2 ) % 3];
+			res[c] = std::pow( v / ( 1.0f + v ), 1.0f / 2.2f );
+		}
+		return res;
+	}
+};
+
+struct Log2Shaper
+{
+	float operator()( const float v ) const { return ( std::log( v ) / std::log( 2.0f ) + 8.0f ) / 12.0f; }
+};
+
+struct Log2ShaperInverse
+{
+	float operator()( const float u ) const { return std::pow( 2.0f, u * 12.0f - 8.0f ); }
+};
+
+struct CountBakes
+{
+	int& _nbBakes;
+	CountBakes( int& nbBakes ) : _nbBakes( nbBakes ) {}
+	boost::shared_ptr<const color::lut1d> operator()() const
+	{
+		++_nbBakes;
+		return boost::make_shared<color::lut1d>();
+	}
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE( terry_color_lut_tests_suite01 )
+
+BOOST_AUTO_TEST_CASE( lut1d_accuracy )
+{
+	color::lut1d lut;
+	BOOST_REQUIRE( lut.bake( Power( 2.2 ), 4096, 0.0f, 1.0f ) );
+	BOOST_CHECK_EQUAL( lut.domain_min(), 0.0f );
+	for( float v = 0.0f; v <= 1.0f; v += 0.001f )
+		BOOST_CHECK_SMALL( lut( v ) - Power( 2.2 )( v ), 1e-4f );
+
+	// infinite slope at 0: the dark values are out of the domain
+	BOOST_REQUIRE( lut.bake( Power( 1.0 / 2.2 ), 4096, 0.0f, 1.0f ) );
+	BOOST_CHECK( lut.domain_min() > 0.0f );
+	BOOST_CHECK( lut.domain_min() < 0.01f );
+	BOOST_CHECK( ! lut.in_domain( 0.0f ) );
+	BOOST_CHECK( ! lut.in_domain( 2.0f ) );
+	BOOST_CHECK( ! lut.in_domain( std::numeric_limits<float>::quiet_NaN() ) );
+	for( float v = lut.domain_min(); v <= 1.0f; v += 0.001f )
+		BOOST_CHECK_SMALL( lut( v ) - Power( 1.0 / 2.2 )( v ), 1e-4f );
+
+	// not accurate enough
+	BOOST_CHECK( ! lut.bake( Power( 2.2 ), 8, 0.0f, 1.0f ) );
+	BOOST_CHECK( lut.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( lut1d_channel_table )
+{
+	typedef color::channel_color_gradation_t<bits8, color::gradation::sRGB, color::gradation::Linear> Gradation8;
+	typedef color::channel_color_gradation_t<bits16, color::gradation::sRGB, color::gradation::Linear> Gradation16;
+	const color::gradation::sRGB sRGB;
+	const color::gradation::Linear linear;
+
+	color::lut1d lut;
+	BOOST_REQUIRE( color::bake_channel_lut1d<bits8>( Gradation8( sRGB, linear ), lut ) );
+	BOOST_CHECK_EQUAL( lut.size(), 256u );
+	const color::channel_lut1d_t<Gradation8> apply8( lut, Gradation8( sRGB, linear ) );
+	for( int i = 0; i < 256; ++i )
+	{
+		bits8 exact, value;
+		Gradation8( sRGB, linear )( bits8( i ), exact );
+		apply8( bits8( i ), value );
+		BOOST_CHECK_EQUAL( int( value ), int( exact ) );
+	}
+
+	BOOST_REQUIRE( color::bake_channel_lut1d<bits16>( Gradation16( sRGB, linear ), lut ) );
+	BOOST_CHECK_EQUAL( lut.size(), 65536u );
+	const color::channel_lut1d_t<Gradation16> apply16( lut, Gradation16( sRGB, linear ) );
+	for( int i = 0; i < 65536; i += 7 )
+	{
+		bits16 exact, value;
+		Gradation16( sRGB, linear )( bits16( i ), exact );
+		apply16( bits16( i ), value );
+		BOOST_CHECK_EQUAL( int( value ), int( exact ) );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( lut1d_float_channels )
+{
+	typedef color::channel_color_gradation_t<bits32f, color::gradation::Linear, color::gradation::sRGB> Gradation;
+	const color::gradation::sRGB sRGB;
+	const color::gradation::Linear linear;
+	const Gradation gradation( linear, sRGB );
+
+	color::lut1d lut;
+	BOOST_REQUIRE( color::bake_channel_lut1d<bits32f>( gradation, lut ) );
+	const color::transform_pixel_lut1d_t<Gradation> apply( lut, gradation );
+	for( float v = -0.5f; v < 4.0f; v += 0.01f )
+	{
+		const rgb32f_pixel_t p( v, v * 0.5f, v * 0.25f );
+		const rgb32f_pixel_t res = apply( p );
+		for( int c = 0; c < 3; ++c )
+		{
+			bits32f exact;
+			gradation( p[c], exact );
+			// exact out of the domain
+			BOOST_CHECK_SMALL( float( res[c] ) - float( exact ), 1e-4f * std::max( 1.0f, std::abs( float( exact ) ) ) );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( lut3d_tetrahedral )
+{
+	color::lut3d lut;
+	BOOST_REQUIRE( lut.bake( Transform(), 65, 1e-3f ) );
+	BOOST_CHECK( lut.error() <= 1e-3f );
+	BOOST_CHECK( ! lut.bake( Transform(), 3, 1e-3f ) );
+
+	BOOST_REQUIRE( lut.bake( Transform(), 65, 1e-3f ) );
+	// rgba line, with values out of the domain
+	const std::size_t n = 1000;
+	std::vector<float> src( n * 4 );
+	for( std::size_t i = 0; i < n; ++i )
+	{
+		src[i * 4 + 0] = ( i % 37 ) / 30.0f - 0.1f;
+		src[i * 4 + 1] = ( i % 11 ) / 10.0f;
+		src[i * 4 + 2] = ( i % 101 ) / 100.0f;
+		src[i * 4 + 3] = i * 0.5f;
+	}
+	std::vector<float> dst( n * 4, 0.0f );
+	lut.apply_floats( &src.front(), &dst.front(), n, 4, Transform() );
+	std::vector<float> inPlace( src );
+	lut.apply_floats( &inPlace.front(), &inPlace.front(), n, 4, Transform() );
+
+	for( std::size_t i = 0; i < n; ++i )
+	{
+		const float* s = &src[i * 4];
+		const rgb32f_pixel_t exact = Transform()( rgb32f_pixel_t( s[0], s[1], s[2] ) );
+		const rgb32f_pixel_t value = lut( rgb32f_pixel_t( s[0], s[1], s[2] ) );
+		for( int c = 0; c < 3; ++c )
+		{
+			BOOST_CHECK_SMALL( dst[i * 4 + c] - float( exact[c] ), 1e-3f * std::max( 1.0f, std::abs( float( exact[c] ) ) ) );
+			BOOST_CHECK_EQUAL( dst[i * 4 + c], inPlace[i * 4 + c] );
+			if( lut.in_domain( s[0], s[1], s[2] ) )
+				BOOST_CHECK_SMALL( dst[i * 4 + c] - float( value[c] ), 1e-5f );
+		}
+		BOOST_CHECK_EQUAL( dst[i * 4 + 3], s[3] );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( lut3d_shaper )
+{
+	color::lut3d lut;
+	BOOST_REQUIRE( lut.bake( ToneMapping(), 65, 1e-3f, Log2Shaper(), Log2ShaperInverse(), 1.0f / 256.0f, 16.0f ) );
+	BOOST_CHECK( lut.has_shaper() );
+	BOOST_CHECK( lut.in_domain( 0.5f, 4.0f, 15.0f ) );
+	BOOST_CHECK( ! lut.in_domain( 0.5f, 4.0f, 17.0f ) );
+
+	const float src[] = { 0.01f, 0.2f, 3.0f,  8.0f, 0.5f, 1.0f,  0.0f, 1.0f, 2.0f };
+	float dst[9];
+	lut.apply_floats( src, dst, 3, 3, ToneMapping() );
+	for( int i = 0; i < 3; ++i )
+	{
+		const rgb32f_pixel_t exact = ToneMapping()( rgb32f_pixel_t( src[i * 3], src[i * 3 + 1], src[i * 3 + 2] ) );
+		for( int c = 0; c < 3; ++c )
+			BOOST_CHECK_SMALL( dst[i * 3 + c] - float( exact[c] ), 1e-3f * std::max( 1.0f, std::abs( float( exact[c] ) ) ) );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( lut3d_simd_interpolation )
+{
+	// random nodes, like the content of a LUT file
+	const std::size_t size = 17;
+	std::vector<float> values( size * size * size * 3 );
+	color::detail::lut_random random;
+	for( std::size_t i = 0; i < values.size(); ++i )
+		values[i] = random();
+	color::lut3d lut;
+	lut.assign( size, values.begin() );
+	BOOST_CHECK_EQUAL( lut.size(), size );
+	const rgb32f_pixel_t node = lut( rgb32f_pixel_t( 1.0f, 0.5f, 0.0f ) );
+	const std::size_t nodeIndex = ( ( size - 1 ) * size + size / 2 ) * size;
+	BOOST_CHECK_CLOSE( float( node[1] ), values[nodeIndex * 3 + 1], 1e-4f );
+
+	// nodes, ties between the fractional parts, values out of the domain and NaN
+	const std::size_t n = 4099;
+	std::vector<float> src( n * 3 );
+	for( std::size_t i = 0; i < n; ++i )
+	{
+		for( int c = 0; c < 3; ++c )
+			src[i * 3 + c] = random() * 1.2f - 0.1f;
+		if( i % 5 == 0 )
+			src[i * 3 + 1] = src[i * 3];
+		if( i % 7 == 0 )
+			src[i * 3 + 2] = float( i % size ) / ( size - 1 );
+	}
+	src[3] = std::numeric_limits<float>::quiet_NaN();
+	src[7] = 1.0f;
+
+	std::vector<float> generic( n * 3 );
+	color::detail::lut3d_tetrahedral_floats_generic( lut.data(), size, &src.front(), 3, &generic.front(), 3, n );
+	std::vector<float> simd( src );
+	lut.apply_floats( &simd.front(), &simd.front(), n, 3 );
+	for( std::size_t i = 0; i < n * 3; ++i )
+		BOOST_CHECK_SMALL( simd[i] - generic[i], 1e-5f );
+}
+
+BOOST_AUTO_TEST_CASE( lut_cache_reuse )
+{
+	color::lut_cache<color::lut1d> cache( 2 );
+	int nbBakes = 0;
+	const color::lut_cache<color::lut1d>::LutPtr a = cache.get( 1, CountBakes( nbBakes ) );
+	BOOST_CHECK_EQUAL( cache.get( 1, CountBakes( nbBakes ) ), a );
+	BOOST_CHECK_EQUAL( nbBakes, 1 );
+	cache.get( 2, CountBakes( nbBakes ) );
+	cache.get( 1, CountBakes( nbBakes ) ); // 1 is the most recently used
+	cache.get( 3, CountBakes( nbBakes ) ); // removes 2
+	BOOST_CHECK_EQUAL( nbBakes, 3 );
+	BOOST_CHECK_EQUAL( cache.get( 1, CountBakes( nbBakes ) ), a );
+	cache.get( 2, CountBakes( nbBakes ) );
+	BOOST_CHECK_EQUAL( nbBakes, 4 );
+}
+
+BOOST_AUTO_TEST_CASE( lru_cache_find_insert )
+{
+	lru_cache<int, double> cache( 2 );
+	double value = 0;
+	BOOST_CHECK( ! cache.find( 1, value ) );
+	cache.insert( 1, 1.5 );
+	cache.insert( 2, 2.5 );
+	cache.insert( 1, 3.5 ); // replaced, most recently used
+	cache.insert( 3, 4.5 ); // removes 2
+	BOOST_CHECK_EQUAL( cache.size(), 2u );
+	BOOST_CHECK( ! cache.find( 2, value ) );
+	BOOST_CHECK( cache.find( 1, value ) );
+	BOOST_CHECK_EQUAL( value, 3.5 );
+	cache.clear();
+	BOOST_CHECK( ! cache.find( 3, value ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
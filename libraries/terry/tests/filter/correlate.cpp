@@ -0,0 +1,133 @@
+#include <terry/globals.hpp>
+#include <terry/filter/correlate.hpp>
+#include <terry/filter/convolve.hpp>
+#include <terry/filter/detail/correlate_simd.hpp>
+
+#include <boost/mpl/bool.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+
+BOOST_AUTO_TEST_SUITE( terry_filter_correlate )
+
+BOOST_AUTO_TEST_CASE( correlate_floats_implementations )
+{
+	using namespace terry::filter::detail;
+
+	// odd sizes to check the ends of the lines
+	const std::size_t kernelSizes[] = { 1, 3, 7, 33, 65 };
+	const std::size_t lineSizes[] = { 1, 5, 31, 33, 257 };
+	for( std::size_t step = 1; step <= 4; ++step )
+	{
+		for( std::size_t k = 0; k < 5; ++k )
+		{
+			for( std::size_t l = 0; l < 5; ++l )
+			{
+				const std::size_t kernelSize = kernelSizes[k];
+				const std::size_t size = lineSizes[l];
+				std::vector<float> src( size + kernelSize * step );
+				std::vector<float> kernel( kernelSize );
+				for( std::size_t i = 0; i < src.size(); ++i )
+					src[i] = ( i * 7 % 13 ) / 13.0f;
+				for( std::size_t i = 0; i < kernel.size(); ++i )
+					kernel[i] = ( i % 5 + 1 ) / 15.0f;
+
+				std::vector<float> expected( size );
+				std::vector<float> result( size );
+				correlate_floats_generic( &src.front(), &kernel.front(), kernelSize, step, &expected.front(), size );
+				correlate_floats( &src.front(), &kernel.front(), kernelSize, step, &result.front(), size );
+				for( std::size_t i = 0; i < size; ++i )
+					BOOST_CHECK_CLOSE( result[i], expected[i], 1e-3 );
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( correlate_pixels_dispatch )
+{
+	using namespace terry;
+	using namespace terry::filter;
+
+	BOOST_CHECK( ( detail::is_float_correlation<rgba32f_pixel_t, rgba32f_pixel_t*, const float*>::value ) );
+	BOOST_CHECK( ( detail::is_float_correlation<gray32f_pixel_t, const gray32f_pixel_t*, const float*>::value ) );
+	BOOST_CHECK( ( ! detail::is_float_correlation<rgba16_pixel_t, rgba16_pixel_t*, const float*>::value ) );
+	BOOST_CHECK( ( ! detail::is_float_correlation<rgba32f_pixel_t, rgba32f_pixel_t*, const double*>::value ) );
+
+	std::vector<rgba32f_pixel_t> src( 100 );
+	for( std::size_t i = 0; i < src.size(); ++i )
+		src[i] = rgba32f_pixel_t( i, 2.0f * i, i % 3, 1.0f );
+	const float kernel[] = { 0.25f, 0.5f, 0.25f };
+
+	// SIMD to float pixels, SIMD to 16 bits pixels, and the generic implementation
+	std::vector<rgba32f_pixel_t> simd( 98 );
+	std::vector<rgba16_pixel_t> simd16( 98 );
+	std::vector<rgba32f_pixel_t> generic( 98 );
+	correlate_pixels_n<rgba32f_pixel_t>( &src.front(), &src.front() + 98, kernel, 3, &simd.front() );
+	correlate_pixels_k<3, rgba32f_pixel_t>( &src.front(), &src.front() + 98, kernel, &simd16.front() );
+	detail::correlate_pixels_n_imp<rgba32f_pixel_t>( &src.front(), &src.front() + 98, kernel, 3, &generic.front(), boost::mpl::false_() );
+
+	for( std::size_t i = 0; i < 98; ++i )
+	{
+		for( int c = 0; c < 4; ++c )
+		{
+			BOOST_CHECK_CLOSE( float( simd[i][c] ), float( generic[i][c] ), 1e-4 );
+			BOOST_CHECK_EQUAL( int( simd16[i][c] ), int( float( generic[i][c] ) ) );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( correlate_rows_cols_ring_buffer )
+{
+	using namespace terry;
+	using namespace terry::filter;
+
+	// 3x2 image, the kernels read 2 pixels on the left and 1 line above and below,
+	// so the ring of 3 lines is reused and each boundary option gives other values
+	gray32f_image_t src( 3, 2 );
+	const float values[] = { 1, 2, 3,
+	                         4, 5, 6 };
+	for( std::ptrdiff_t y = 0; y < 2; ++y )
+		for( std::ptrdiff_t x = 0; x < 3; ++x )
+			view( src )( x, y )[0] = values[y * 3 + x];
+
+	const float valuesX[] = { 1, 10, 100 };
+	const float valuesY[] = { 1, 2, 4 };
+	const kernel_1d<float> kernelX( valuesX, 3, 2 ); // src(x-2) + 10 src(x-1) + 100 src(x)
+	const kernel_1d<float> kernelY( valuesY, 3, 1 ); // h(y-1) + 2 h(y) + 4 h(y+1)
+
+	// computed by hand, line by line:
+	// zero:     h = { 100 210 321, 400 540 654 }
+	// constant: h = { 111 211 321, 444 544 654 }, h(-1) = h(0) and h(2) = h(1)
+	// mirror:   h = { 112 211 321, 445 544 654 }, src(-2) = src(1), h(-1) = h(0) and h(2) = h(1)
+	const convolve_boundary_option options[] = { convolve_option_extend_zero, convolve_option_extend_constant, convolve_option_extend_mirror };
+	const float expected[][6] = {
+		{ 1800, 2580, 3258,  900, 1290, 1629 },
+		{ 2109, 2809, 3579, 2775, 3475, 4245 },
+		{ 2116, 2809, 3579, 2782, 3475, 4245 } };
+
+	for( std::size_t o = 0; o < 3; ++o )
+	{
+		gray32f_image_t dst( 3, 2 );
+		gray32f_image_t dstAuto( 3, 2 ); // fixed-size horizontal kernel
+		correlate_rows_cols<gray32f_pixel_t, std::allocator>( const_view( src ), kernelX, kernelY, view( dst ), gray32f_view_t::point_t( 0, 0 ), options[o] );
+		correlate_rows_cols_auto<gray32f_pixel_t, std::allocator>( const_view( src ), kernelX, kernelY, view( dstAuto ), gray32f_view_t::point_t( 0, 0 ), options[o] );
+		for( std::ptrdiff_t y = 0; y < 2; ++y )
+		{
+			for( std::ptrdiff_t x = 0; x < 3; ++x )
+			{
+				BOOST_CHECK_EQUAL( float( view( dst )( x, y )[0] ), expected[o][y * 3 + x] );
+				BOOST_CHECK_EQUAL( float( view( dstAuto )( x, y )[0] ), expected[o][y * 3 + x] );
+			}
+		}
+
+		// a tile: the last column and line
+		gray32f_image_t tile( 1, 1 );
+		correlate_rows_cols<gray32f_pixel_t, std::allocator>( const_view( src ), kernelX, kernelY, view( tile ), gray32f_view_t::point_t( 2, 1 ), options[o] );
+		BOOST_CHECK_EQUAL( float( view( tile )( 0, 0 )[0] ), expected[o][5] );
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,187 @@
+#include <terry/globals.hpp>
+#include <terry/filter/floodFill.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+
+namespace {
+
+/// Random values, smoothed to get structures larger than one pixel.
+void fillRandom( const terry::gray32f_view_t& view, const unsigned int seed, const std::size_t nbSmooth, const bool blackBorder )
+{
+	using namespace terry;
+	const std::ptrdiff_t w = view.width();
+	const std::ptrdiff_t h = view.height();
+	std::srand( seed );
+	for( std::ptrdiff_t y = 0; y < h; ++y )
+		for( std::ptrdiff_t x = 0; x < w; ++x )
+			view( x, y )[0] = std::rand() / float( RAND_MAX );
+
+	gray32f_image_t tmp( w, h );
+	for( std::size_t s = 0; s < nbSmooth; ++s )
+	{
+		for( std::ptrdiff_t y = 0; y < h; ++y )
+		{
+			for( std::ptrdiff_t x = 0; x < w; ++x )
+			{
+				float sum = 0;
+				int n = 0;
+				for( std::ptrdiff_t yy = std::max<std::ptrdiff_t>( y - 1, 0 ); yy < std::min( y + 2, h ); ++yy )
+					for( std::ptrdiff_t xx = std::max<std::ptrdiff_t>( x - 1, 0 ); xx < std::min( x + 2, w ); ++xx, ++n )
+						sum += view( xx, yy )[0];
+				boost::gil::view( tmp )( x, y )[0] = sum / n;
+			}
+		}
+		boost::gil::copy_pixels( boost::gil::const_view( tmp ), view );
+	}
+
+	if( blackBorder )
+	{
+		for( std::ptrdiff_t y = 0; y < h; ++y )
+			for( std::ptrdiff_t x = 0; x < w; ++x )
+				if( x == 0 || y == 0 || x == w - 1 || y == h - 1 )
+					view( x, y )[0] = 0;
+	}
+}
+
+/// Breadth-first fill from the strong pixels of the window, through the soft pixels of the whole image.
+template<class Connexity>
+void floodFillReference( const terry::gray32f_view_t& src, const terry::gray32f_view_t& dst,
+                         const terry::Rect<std::ssize_t>& procWindow, const float lower, const float upper )
+{
+	const std::ptrdiff_t w = src.width();
+	const std::ptrdiff_t h = src.height();
+	std::vector<char> visited( w * h, 0 );
+	std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t> > stack;
+	for( std::ptrdiff_t y = procWindow.y1; y < procWindow.y2; ++y )
+	{
+		for( std::ptrdiff_t x = procWindow.x1; x < procWindow.x2; ++x )
+		{
+			if( src( x, y )[0] >= lower && src( x, y )[0] >= upper )
+			{
+				visited[y * w + x] = 1;
+				stack.push_back( std::make_pair( x, y ) );
+			}
+		}
+	}
+	while( ! stack.empty() )
+	{
+		const std::pair<std::ptrdiff_t, std::ptrdiff_t> p = stack.back();
+		stack.pop_back();
+		dst( p.first, p.second )[0] = 1;
+		for( std::ptrdiff_t dy = -1; dy <= 1; ++dy )
+		{
+			for( std::ptrdiff_t dx = -1; dx <= 1; ++dx )
+			{
+				if( ! Connexity::x && dx && dy )
+					continue;
+				const std::ptrdiff_t x = p.first + dx;
+				const std::ptrdiff_t y = p.second + dy;
+				if( x < 0 || y < 0 || x >= w || y >= h || visited[y * w + x] || src( x, y )[0] < lower )
+					continue;
+				visited[y * w + x] = 1;
+				stack.push_back( std::make_pair( x, y ) );
+			}
+		}
+	}
+}
+
+std::size_t nbDifferences( const terry::gray32f_view_t& a, const terry::gray32f_view_t& b )
+{
+	std::size_t n = 0;
+	for( std::ptrdiff_t y = 0; y < a.height(); ++y )
+		for( std::ptrdiff_t x = 0; x < a.width(); ++x )
+			n += ( a( x, y )[0] != b( x, y )[0] );
+	return n;
+}
+
+template<class Connexity>
+void checkFloodFill( const std::ptrdiff_t w, const std::ptrdiff_t h, const unsigned int seed,
+                     const std::size_t nbSmooth, const float lower, const float upper )
+{
+	using namespace terry;
+	using namespace terry::filter::floodFill;
+
+	gray32f_image_t srcImage( w, h );
+	gray32f_image_t serialImage( w, h );
+	gray32f_image_t parallelImage( w, h );
+	gray32f_image_t bandsImage( w, h );
+	gray32f_image_t referenceImage( w, h );
+	gray32f_view_t src = view( srcImage );
+	gray32f_view_t serial = view( serialImage );
+	gray32f_view_t parallel = view( parallelImage );
+	gray32f_view_t bands = view( bandsImage );
+	gray32f_view_t reference = view( referenceImage );
+
+	const Rect<std::ssize_t> rod( 0, 0, w, h );
+	const Rect<std::ssize_t> procWindow = rectangleReduce( rod, 1 );
+
+	for( int blackBorder = 0; blackBorder < 2; ++blackBorder )
+	{
+		fillRandom( src, seed, nbSmooth, blackBorder );
+		boost::gil::fill_pixels( serial, gray32f_pixel_t( 0 ) );
+		boost::gil::fill_pixels( parallel, gray32f_pixel_t( 0 ) );
+		boost::gil::fill_pixels( bands, gray32f_pixel_t( 0 ) );
+		boost::gil::fill_pixels( reference, gray32f_pixel_t( 0 ) );
+
+		flood_fill<Connexity, IsUpper<float>, IsUpper<float>, gray32f_view_t, gray32f_view_t, std::allocator>(
+			src, rod, serial, rod, procWindow, IsUpper<float>( upper ), IsUpper<float>( lower ) );
+		flood_fill_parallel<Connexity, IsUpper<float>, IsUpper<float>, gray32f_view_t, gray32f_view_t, std::allocator>(
+			terry::algorithm::thread_launcher( 4 ), src, rod, parallel, rod, procWindow, IsUpper<float>( upper ), IsUpper<float>( lower ) );
+		BOOST_CHECK_EQUAL( nbDifferences( parallel, serial ), 0u );
+
+		if( blackBorder )
+		{
+			// without soft pixels in the border, the fill is the connected components of the window
+			BOOST_CHECK( ! soft_pixels_around( src, rod, rod, procWindow, IsUpper<float>( lower ) ) );
+			floodFillReference<Connexity>( src, reference, procWindow, lower, upper );
+			BOOST_CHECK_EQUAL( nbDifferences( parallel, reference ), 0u );
+
+			// bands of rows labelled in any order, like the threads of a plugin
+			FloodFillLabels<std::allocator> labels;
+			labels.init( procWindow, procWindow );
+			const std::ptrdiff_t bandHeight = h / 3 + 1;
+			for( std::ptrdiff_t y = ( h - 1 ) / bandHeight * bandHeight; y >= 0; y -= bandHeight )
+				labels.template labelRows<Connexity>( src, rod, y, y + bandHeight, IsUpper<float>( upper ), IsUpper<float>( lower ) );
+			labels.template connectRows<Connexity>();
+			labels.fill( bands, rod, procWindow );
+			BOOST_CHECK_EQUAL( nbDifferences( bands, reference ), 0u );
+		}
+	}
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( terry_filter_floodFill )
+
+BOOST_AUTO_TEST_CASE( flood_fill_parallel_same_as_serial )
+{
+	using namespace terry::filter::floodFill;
+
+	for( unsigned int seed = 0; seed < 60; ++seed )
+	{
+		// odd sizes, from a single chunk to several chunks of rows
+		const std::ptrdiff_t w = 3 + seed * 7 % 61;
+		const std::ptrdiff_t h = 3 + seed * 13 % 150;
+		const float lower = 0.3f + ( seed % 5 ) * 0.05f;
+		const float upper = lower + 0.1f + ( seed % 3 ) * 0.1f;
+		checkFloodFill<Connexity4>( w, h, seed, seed % 4, lower, upper );
+		checkFloodFill<Connexity8>( w, h, seed, seed % 4, lower, upper );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( flood_fill_parallel_large )
+{
+	using namespace terry::filter::floodFill;
+
+	// components crossing all the chunks of rows
+	checkFloodFill<Connexity4>( 517, 1031, 1, 2, 0.45f, 0.55f );
+	checkFloodFill<Connexity8>( 517, 1031, 2, 2, 0.45f, 0.55f );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+#include <terry/globals.hpp>
+#include <terry/filter/lineFilter.hpp>
+#include <terry/filter/recursiveGaussian.hpp>
+#include <terry/filter/boxBlur.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+
+BOOST_AUTO_TEST_SUITE( terry_filter_gaussianBlur )
+
+BOOST_AUTO_TEST_CASE( recursiveGaussian_impulse )
+{
+	using namespace terry::filter;
+	const double sigmas[] = { 1.0, 5.0, 50.0, 300.0 };
+	for( std::size_t s = 0; s < 4; ++s )
+	{
+		const double sigma = sigmas[s];
+		const std::ptrdiff_t center = static_cast<std::ptrdiff_t>( 20 * sigma );
+		std::vector<float> line( 2 * center + 1, 0.0f );
+		line[center] = 1.0f;
+
+		recursive_gaussian_filter filter( sigma );
+		filter( &line.front(), line.size(), 1 );
+
+		double sum = 0.0;
+		for( std::size_t i = 0; i < line.size(); ++i )
+			sum += line[i];
+		// the filter keeps the energy, even with large values of sigma
+		BOOST_CHECK_CLOSE( sum, 1.0, 0.01 );
+		// close to the gaussian peak
+		BOOST_CHECK_CLOSE( double( line[center] ), 1.0 / ( std::sqrt( 2.0 * 3.14159265358979 ) * sigma ), 10.0 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( boxBlur_variance )
+{
+	using namespace terry::filter;
+	const double sigma = 20.0;
+	const std::ptrdiff_t center = 400;
+	std::vector<float> line( 2 * center + 1, 0.0f );
+	line[center] = 1.0f;
+
+	box_blur_filter<float> filter( sigma, 3 );
+	filter( &line.front(), line.size(), 1 );
+
+	double sum = 0.0;
+	double variance = 0.0;
+	for( std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>( line.size() ); ++i )
+	{
+		sum += line[i];
+		variance += line[i] * double( i - center ) * double( i - center );
+	}
+	BOOST_CHECK_CLOSE( sum, 1.0, 0.01 );
+	BOOST_CHECK_CLOSE( std::sqrt( variance ), sigma, 2.0 );
+}
+
+BOOST_AUTO_TEST_CASE( lineFilter_tiles )
+{
+	using namespace terry;
+	using namespace terry::filter;
+
+	rgba32f_image_t src( 64, 48 );
+	rgba32f_image_t full( 64, 48 );
+	rgba32f_image_t tiled( 64, 48 );
+	for( std::ptrdiff_t y = 0; y < 48; ++y )
+		for( std::ptrdiff_t x = 0; x < 64; ++x )
+			view( src )( x, y ) = rgba32f_pixel_t( x / 64.0f, y / 48.0f, ( ( x * 7 + y * 3 ) % 5 ) / 4.0f, 1.0f );
+
+	const recursive_gaussian_filter filter( 3.0 );
+	const point2<std::ptrdiff_t> margin( filter.margin(), filter.margin() );
+
+	line_filter_rows_cols<rgba32f_pixel_t, std::allocator>(
+		const_view( src ), view( full ), point2<std::ptrdiff_t>( 0, 0 ), margin,
+		convolve_option_extend_mirror, filter, filter );
+
+	// the processing by tiles gives the same result (up to the truncation of the recursive filter)
+	for( std::ptrdiff_t t = 0; t < 4; ++t )
+	{
+		line_filter_rows_cols<rgba32f_pixel_t, std::allocator>(
+			const_view( src ), subimage_view( view( tiled ), 0, t * 12, 64, 12 ), point2<std::ptrdiff_t>( 0, t * 12 ), margin,
+			convolve_option_extend_mirror, filter, filter );
+	}
+
+	for( std::ptrdiff_t y = 0; y < 48; ++y )
+		for( std::ptrdiff_t x = 0; x < 64; ++x )
+			for( int c = 0; c < 4; ++c )
+				BOOST_CHECK_SMALL( view( full )( x, y )[c] - view( tiled )( x, y )[c], 1e-3f );
+
+	// alpha is constant
+	BOOST_CHECK_CLOSE( float( view( full )( 0, 0 )[3] ), 1.0f, 0.01f );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -40,4 +40,35 @@ BOOST_AUTO_TEST_CASE( motionVector )
 }
 
 
+BOOST_AUTO_TEST_CASE( motionVectorNullTiles )
+{
+	using namespace terry;
+	
+	// null vectors except one pixel: the tiles without motion are copied,
+	// the moved pixel is sampled
+	terry::rgb32f_image_t inImg( 100, 10 );
+	terry::gray32f_image_t xVecImg( 100, 10 ), yVecImg( 100, 10 );
+	terry::rgb32f_image_t outImg( 100, 10 );
+	terry::rgb32f_view_t inView = view( inImg );
+	for( int y = 0; y < inView.height(); ++y )
+		for( int x = 0; x < inView.width(); ++x )
+			inView( x, y ) = terry::rgb32f_pixel_t( x, y, x * y );
+	fill_pixels( view( xVecImg ), terry::gray32f_pixel_t( 0 ) );
+	fill_pixels( view( yVecImg ), terry::gray32f_pixel_t( 0 ) );
+	view( xVecImg )( 40, 5 ) = terry::gray32f_pixel_t( 2 );
+	NoProgress progress;
+
+	filter::motionvectors_resample_pixels<sampler::bilinear_sampler>(
+			inView, getBounds<std::ssize_t>( inView ),
+			view( xVecImg ), view( yVecImg ), getBounds<std::ssize_t>( view( xVecImg ) ),
+			view( outImg ), getBounds<std::ssize_t>( view( outImg ) ),
+			getBounds<std::ssize_t>( view( outImg ) ),
+			sampler::eParamFilterOutBlack,
+			progress );
+
+	BOOST_CHECK( view( outImg )( 40, 5 ) == inView( 42, 5 ) );
+	view( outImg )( 40, 5 ) = inView( 40, 5 );
+	BOOST_CHECK( equal_pixels( view( outImg ), inView ) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,11 +1,99 @@
 #include <terry/globals.hpp>
 #include <terry/filter/thinning.hpp>
 
+#include <cstdlib>
 #include <iostream>
 
 #include <boost/test/unit_test.hpp>
 using namespace boost::unit_test;
 
+namespace {
+
+/// Random white blobs on a black background.
+template<class View>
+void fillRandomBinary( const View& view, const unsigned int seed, const int density )
+{
+	typedef typename View::value_type Pixel;
+	Pixel white;
+	Pixel black;
+	terry::numeric::pixel_assigns_max( white );
+	terry::numeric::pixel_assigns_min( black );
+
+	std::srand( seed );
+	for( std::ptrdiff_t y = 0; y < view.height(); ++y )
+		for( std::ptrdiff_t x = 0; x < view.width(); ++x )
+			view( x, y ) = ( std::rand() % 100 < density ) ? white : black;
+	// grow the pixels, to get lines and blobs to thin
+	for( std::ptrdiff_t y = view.height() - 1; y > 0; --y )
+		for( std::ptrdiff_t x = view.width() - 1; x > 0; --x )
+			if( view( x - 1, y - 1 ) == white || ( ( x + y ) % 3 && view( x - 1, y ) == white ) )
+				view( x, y ) = white;
+}
+
+/// The two passes of pixel_locator_thinning_t, pixel by pixel.
+template<class View>
+void thinningReference( const View& src, const View& dst )
+{
+	using namespace terry::filter::thinning;
+	typedef typename View::value_type Pixel;
+	Pixel black;
+	terry::numeric::pixel_assigns_min( black );
+
+	typename terry::image_from_view<View>::type tmpImage( src.width(), src.height() );
+	View tmp = boost::gil::view( tmpImage );
+	boost::gil::fill_pixels( tmp, black );
+	boost::gil::fill_pixels( dst, black );
+
+	pixel_locator_thinning_t<View, View> pass1( src, lutthin1 );
+	for( std::ptrdiff_t y = 1; y < src.height() - 1; ++y )
+		for( std::ptrdiff_t x = 1; x < src.width() - 1; ++x )
+			tmp( x, y ) = pass1( src.xy_at( x, y ) );
+
+	pixel_locator_thinning_t<View, View> pass2( tmp, lutthin2 );
+	for( std::ptrdiff_t y = 2; y < src.height() - 2; ++y )
+		for( std::ptrdiff_t x = 2; x < src.width() - 2; ++x )
+			dst( x, y ) = pass2( tmp.xy_at( x, y ) );
+}
+
+template<class View>
+std::size_t nbDifferences( const View& a, const View& b )
+{
+	std::size_t n = 0;
+	for( std::ptrdiff_t y = 0; y < a.height(); ++y )
+		for( std::ptrdiff_t x = 0; x < a.width(); ++x )
+			n += ( a( x, y ) != b( x, y ) );
+	return n;
+}
+
+template<class Image>
+void checkThinning( const std::ptrdiff_t w, const std::ptrdiff_t h, const unsigned int seed, const int density )
+{
+	typedef typename Image::view_t View;
+	Image srcImage( w, h );
+	Image tmpImage( w, h );
+	Image dstImage( w, h );
+	Image referenceImage( w, h );
+	View src = view( srcImage );
+	View tmp = view( tmpImage );
+	View dst = view( dstImage );
+	View reference = view( referenceImage );
+
+	fillRandomBinary( src, seed, density );
+	thinningReference( src, reference );
+
+	terry::filter::applyThinning( src, tmp, dst );
+	BOOST_CHECK_EQUAL( nbDifferences( dst, reference ), 0u );
+
+	terry::filter::applyThinning( terry::algorithm::thread_launcher( 4 ), src, tmp, dst );
+	BOOST_CHECK_EQUAL( nbDifferences( dst, reference ), 0u );
+
+	// in place, like canny
+	terry::filter::applyThinning( src, tmp, src );
+	BOOST_CHECK_EQUAL( nbDifferences( src, reference ), 0u );
+}
+
+}
+
 BOOST_AUTO_TEST_SUITE( terry_filter_thinning_tests_suite01 )
 
 BOOST_AUTO_TEST_CASE( thinning )
@@ -18,5 +106,17 @@ BOOST_AUTO_TEST_CASE( thinning )
 	terry::filter::applyThinning( inView, tmpView, outView );
 }
 
+BOOST_AUTO_TEST_CASE( thinning_bits_same_as_locator )
+{
+	for( unsigned int seed = 0; seed < 40; ++seed )
+	{
+		// widths around the words of 64 pixels, from a single chunk to several chunks of rows
+		const std::ptrdiff_t w = 1 + seed * 11 % 200;
+		const std::ptrdiff_t h = 1 + seed * 17 % 150;
+		checkThinning<terry::gray8_image_t>( w, h, seed, 5 + seed % 4 * 10 );
+		checkThinning<terry::gray32f_image_t>( w, h, seed, 5 + seed % 4 * 10 );
+	}
+	checkThinning<terry::rgba32f_image_t>( 131, 67, 1, 20 );
+}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+#include <terry/globals.hpp>
+#include <terry/merge/ViewsMerging.hpp>
+#include <terry/merge/ViewsMergingBatch.hpp>
+#include <terry/merge/MergeFunctors.hpp>
+
+#include <cmath>
+#include <cstdlib>
+
+#define BOOST_TEST_MODULE terry_merge_tests
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+using namespace terry;
+
+namespace {
+
+/// 37x23 images (odd width for the tails of the 16 bits lines), with a transparent and an opaque line in each source
+template<class Image>
+struct Sources
+{
+	typedef typename Image::view_t View;
+	typedef typename channel_type<View>::type Channel;
+
+	Image _imageA;
+	Image _imageB;
+	View _viewA;
+	View _viewB;
+
+	Sources( const float min, const float max )
+	: _imageA( 37, 23 )
+	, _imageB( 37, 23 )
+	, _viewA( view( _imageA ) )
+	, _viewB( view( _imageB ) )
+	{
+		std::srand( 7 );
+		fill( _viewA, min, max );
+		fill( _viewB, min, max );
+		// transparent lines
+		fill_pixels( subimage_view( _viewA, 0, 3, 37, 1 ), typename View::value_type( 0, 0, 0, 0 ) );
+		fill_pixels( subimage_view( _viewB, 0, 5, 37, 1 ), typename View::value_type( 0, 0, 0, 0 ) );
+		// opaque lines
+		for( std::ptrdiff_t x = 0; x < 37; ++x )
+		{
+			get_color( _viewA( x, 7 ), alpha_t() ) = channel_traits<Channel>::max_value();
+			get_color( _viewB( x, 9 ), alpha_t() ) = channel_traits<Channel>::max_value();
+		}
+	}
+
+	static void fill( const View& v, const float min, const float max )
+	{
+		for( std::ptrdiff_t y = 0; y < v.height(); ++y )
+			for( std::ptrdiff_t x = 0; x < v.width(); ++x )
+				for( int c = 0; c < 4; ++c )
+					v( x, y )[c] = Channel( min + ( max - min ) * ( std::rand() / float( RAND_MAX ) ) );
+	}
+};
+
+typedef Sources<rgba32f_image_t> FloatSources;
+typedef Sources<rgba16_image_t> ShortSources;
+
+/// The batched merge gives exactly the result of the functor (float views).
+template<class Functor>
+void checkSameAsReference( const FloatSources& s )
+{
+	rgba32f_image_t reference( s._viewA.dimensions() );
+	rgba32f_image_t batch( s._viewA.dimensions() );
+	rgba32f_view_t referenceView = view( reference );
+	rgba32f_view_t batchView = view( batch );
+
+	merge_views( s._viewA, s._viewB, referenceView, Functor() );
+	merge_views_batch( s._viewA, s._viewB, batchView, Functor() );
+
+	for( std::ptrdiff_t y = 0; y < batchView.height(); ++y )
+		for( std::ptrdiff_t x = 0; x < batchView.width(); ++x )
+			for( int c = 0; c < 4; ++c )
+				BOOST_CHECK_EQUAL( float( batchView( x, y )[c] ), float( referenceView( x, y )[c] ) );
+}
+
+/// The batched merge of 16 bits views gives @p op on the normalized values, within one step.
+template<class Functor, class Op>
+void checkNormalized( const ShortSources& s, const Op& op )
+{
+	rgba16_image_t batch( s._viewA.dimensions() );
+	rgba16_view_t batchView = view( batch );
+	merge_views_batch( s._viewA, s._viewB, batchView, Functor() );
+
+	for( std::ptrdiff_t y = 0; y < batchView.height(); ++y )
+	{
+		for( std::ptrdiff_t x = 0; x < batchView.width(); ++x )
+		{
+			const double alphaA = s._viewA( x, y )[3] / 65535.0;
+			for( int c = 0; c < 4; ++c )
+			{
+				const double a = s._viewA( x, y )[c] / 65535.0;
+				const double b = s._viewB( x, y )[c] / 65535.0;
+				const double expected = std::min( std::max( op( a, b, alphaA ), 0.0 ), 1.0 ) * 65535.0;
+				BOOST_CHECK_SMALL( batchView( x, y )[c] - expected, 1.0 );
+			}
+		}
+	}
+}
+
+double over( const double a, const double b, const double alphaA ) { return a + b * ( 1.0 - alphaA ); }
+double plus( const double a, const double b, const double ) { return a + b; }
+double multiply( const double a, const double b, const double ) { return a * b; }
+double screen( const double a, const double b, const double ) { return a + b - a * b; }
+double darken( const double a, const double b, const double ) { return std::min( a, b ); }
+double lighten( const double a, const double b, const double ) { return std::max( a, b ); }
+double difference( const double a, const double b, const double ) { return std::abs( a - b ); }
+
+}
+
+BOOST_AUTO_TEST_SUITE( terry_merge_tests_suite )
+
+BOOST_AUTO_TEST_CASE( merge_batch_float )
+{
+	// with negative and over range values
+	const FloatSources s( -0.5f, 1.5f );
+	checkSameAsReference< FunctorOver<rgba32f_pixel_t> >( s );
+	checkSameAsReference< FunctorPlus<rgba32f_pixel_t> >( s );
+	checkSameAsReference< FunctorMultiply<rgba32f_pixel_t> >( s );
+	checkSameAsReference< FunctorScreen<rgba32f_pixel_t> >( s );
+	checkSameAsReference< FunctorDarken<rgba32f_pixel_t> >( s );
+	checkSameAsReference< FunctorLighten<rgba32f_pixel_t> >( s );
+	checkSameAsReference< FunctorDifference<rgba32f_pixel_t> >( s );
+	// not batched, uses the reference
+	checkSameAsReference< FunctorAverage<rgba32f_pixel_t> >( s );
+}
+
+BOOST_AUTO_TEST_CASE( merge_batch_short )
+{
+	const ShortSources s( 0.0f, 65535.0f );
+	checkNormalized< FunctorOver<rgba16_pixel_t> >( s, over );
+	checkNormalized< FunctorPlus<rgba16_pixel_t> >( s, plus );
+	checkNormalized< FunctorMultiply<rgba16_pixel_t> >( s, multiply );
+	checkNormalized< FunctorScreen<rgba16_pixel_t> >( s, screen );
+	checkNormalized< FunctorDarken<rgba16_pixel_t> >( s, darken );
+	checkNormalized< FunctorLighten<rgba16_pixel_t> >( s, lighten );
+	checkNormalized< FunctorDifference<rgba16_pixel_t> >( s, difference );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
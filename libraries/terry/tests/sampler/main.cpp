@@ -0,0 +1,104 @@
+#include <terry/globals.hpp>
+#include <terry/sampler/all.hpp>
+#include <terry/sampler/resample_progress.hpp>
+#include <terry/sampler/resample_separable.hpp>
+#include <terry/geometry/affine.hpp>
+
+#include <iostream>
+
+#define BOOST_TEST_MODULE terry_sampler_tests
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+
+BOOST_AUTO_TEST_SUITE( terry_sampler_separable )
+
+struct NoProgress
+{
+	void progressBegin( const int numSteps, const std::string& msg = "" ){}
+	void progressEnd(){}
+	bool progressForward( const int nSteps ){ return false; }
+};
+
+template<class View>
+void fillTestImage( const View& view )
+{
+	for( std::ptrdiff_t y = 0; y < view.height(); ++y )
+	{
+		for( std::ptrdiff_t x = 0; x < view.width(); ++x )
+		{
+			view( x, y ) = terry::rgb32f_pixel_t( x / float( view.width() ), y / float( view.height() ), ( ( x * 7 + y * 3 ) % 5 ) / 4.0f );
+		}
+	}
+}
+
+/**
+ * @brief The separable resampling must give the same result than the 2D sampling.
+ */
+template<class Sampler>
+void checkSeparableResample( const Sampler& sampler, const std::ptrdiff_t dstWidth, const std::ptrdiff_t dstHeight,
+                             const terry::sampler::EParamFilterOutOfImage outOfImageProcess )
+{
+	using namespace terry;
+	using namespace terry::sampler;
+
+	rgb32f_image_t srcImage( 16, 12 );
+	rgb32f_image_t dstImage2D( dstWidth, dstHeight );
+	rgb32f_image_t dstImageSeparable( dstWidth, dstHeight );
+	fillTestImage( view( srcImage ) );
+
+	// same mapping than the Resize plugin
+	const double src_width  = srcImage.width() - 1;
+	const double src_height = srcImage.height() - 1;
+	const double dst_width  = dstWidth - 1;
+	const double dst_height = dstHeight - 1;
+	const matrix3x2<double> mat =
+		matrix3x2<double>::get_translate( - dst_width * 0.5, - dst_height * 0.5 ) *
+		matrix3x2<double>::get_scale    ( (src_width + 1) / (dst_width + 1 ), (src_height + 1) / (dst_height + 1) ) *
+		matrix3x2<double>::get_translate( src_width * 0.5 , src_height * 0.5 );
+
+	NoProgress progress;
+	resample_pixels_progress( const_view( srcImage ), view( dstImage2D ), mat, getBounds<std::ssize_t>( view( dstImage2D ) ), outOfImageProcess, progress, sampler );
+
+	const point2<double> origin = transform( mat, point2<double>( 0, 0 ) );
+	const point2<double> scale  = transform( mat, point2<double>( 1, 1 ) ) - origin;
+	separable_weights xWeights, yWeights;
+	compute_separable_weights( sampler, dstWidth,  scale.x, origin.x, srcImage.width(),  outOfImageProcess, xWeights );
+	compute_separable_weights( sampler, dstHeight, scale.y, origin.y, srcImage.height(), outOfImageProcess, yWeights );
+
+	// process in two windows, like two render threads
+	const Rect<std::ssize_t> top( 0, 0, dstWidth, dstHeight / 2 );
+	const Rect<std::ssize_t> bottom( 0, dstHeight / 2, dstWidth, dstHeight );
+	resample_separable_progress( const_view( srcImage ), view( dstImageSeparable ), xWeights, yWeights, top, outOfImageProcess, progress );
+	resample_separable_progress( const_view( srcImage ), view( dstImageSeparable ), xWeights, yWeights, bottom, outOfImageProcess, progress );
+
+	for( std::ptrdiff_t y = 0; y < dstHeight; ++y )
+	{
+		for( std::ptrdiff_t x = 0; x < dstWidth; ++x )
+		{
+			for( int c = 0; c < 3; ++c )
+			{
+				BOOST_CHECK_SMALL( view( dstImage2D )( x, y )[c] - view( dstImageSeparable )( x, y )[c], 1e-4f );
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( separable_downscale )
+{
+	using namespace terry::sampler;
+	checkSeparableResample( bilinear_sampler(), 7, 5, eParamFilterOutCopy );
+	checkSeparableResample( catrom_sampler(), 7, 5, eParamFilterOutCopy );
+	checkSeparableResample( lanczos3_sampler(), 7, 5, eParamFilterOutCopy );
+	checkSeparableResample( lanczos3_sampler(), 7, 5, eParamFilterOutBlack );
+}
+
+BOOST_AUTO_TEST_CASE( separable_upscale )
+{
+	using namespace terry::sampler;
+	checkSeparableResample( nearest_neighbor_sampler(), 23, 17, eParamFilterOutCopy );
+	checkSeparableResample( mitchell_sampler(), 23, 17, eParamFilterOutCopy );
+	checkSeparableResample( lanczos4_sampler(), 23, 17, eParamFilterOutBlack );
+	checkSeparableResample( lanczos4_sampler(), 23, 17, eParamFilterOutTransparency );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 
 #include "exceptions.hpp"
 #include "OfxProgress.hpp"
+#include "OfxMultiThreadLauncher.hpp"
 
 #include <tuttle/plugin/image.hpp>
 #include <tuttle/plugin/exceptions.hpp>
@@ -68,6 +69,9 @@ public:
 	void setNbThreads( const unsigned int nbThreads ) { _nbThreads = nbThreads; }
 	void setNbThreadsAuto()                           { _nbThreads = 0; }
 
+	/// @brief Launcher of the terry parallel algorithms, on the same number of threads as the process.
+	OfxMultiThreadLauncher getLauncher() const        { return OfxMultiThreadLauncher( _nbThreads ); }
+
 	/** @brief called before any MP is done */
 	virtual void preProcess() { progressBegin( _renderWindowSize.y * _renderWindowSize.x ); }
 
@@ -0,0 +1,54 @@
+#ifndef _TUTTLE_PLUGIN_OFXMULTITHREADLAUNCHER_HPP_
+#define _TUTTLE_PLUGIN_OFXMULTITHREADLAUNCHER_HPP_
+
+#include <ofxsMultiThread.h>
+
+namespace tuttle {
+namespace plugin {
+
+/**
+ * @brief Launcher of the terry parallel algorithms (terry::algorithm::parallel_reduce_rows...)
+ * on the threads of the host, through the OFX multithread suite.
+ *
+ * From a thread already spawned by the host (multiThreadProcessImages),
+ * the workers run on the calling thread.
+ */
+class OfxMultiThreadLauncher
+{
+public:
+	/// @param nbThreads 0 for the number of CPUs given by the host (like ImageProcessor::setNbThreads)
+	explicit OfxMultiThreadLauncher( const unsigned int nbThreads = 0 )
+	: _nbThreads( nbThreads )
+	{}
+
+	template<class Worker>
+	void operator()( Worker& worker ) const
+	{
+		if( _nbThreads == 1 || OFX::MultiThread::isSpawnedThread() )
+		{
+			worker();
+			return;
+		}
+		WorkerProcessor<Worker> processor( worker );
+		processor.multiThread( _nbThreads );
+	}
+
+private:
+	template<class Worker>
+	class WorkerProcessor : public OFX::MultiThread::Processor
+	{
+	public:
+		explicit WorkerProcessor( Worker& worker ) : _worker( worker ) {}
+		void multiThreadFunction( const unsigned int, const unsigned int ) { _worker(); }
+
+	private:
+		Worker& _worker;
+	};
+
+	unsigned int _nbThreads;
+};
+
+}
+}
+
+#endif
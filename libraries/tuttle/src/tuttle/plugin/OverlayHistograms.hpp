@@ -0,0 +1,259 @@
+#ifndef _TUTTLE_PLUGIN_OVERLAYHISTOGRAMS_HPP_
+#define _TUTTLE_PLUGIN_OVERLAYHISTOGRAMS_HPP_
+
+#include <tuttle/plugin/OfxMultiThreadLauncher.hpp>
+#include <tuttle/plugin/memory/OfxAllocator.hpp>
+
+#include <terry/algorithm/parallel_reduce.hpp>
+#include <terry/numeric/histogram.hpp>
+
+#include <ofxCore.h>
+
+#include <boost/gil/typedefs.hpp>
+#include <boost/multi_array.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+
+typedef std::vector<long, OfxAllocator<long> > HistogramVector;
+
+/// selected pixels of an image (not null bytes), displayed as an alpha texture
+typedef boost::multi_array<unsigned char, 2, OfxAllocator<unsigned char> > HistogramSelection;
+
+/*
+ * structure of 7 buffers (contains histogram data)
+ */
+struct HistogramBufferData
+{
+	//step
+	int _step;								//nbStep (for computing and display)
+	//RGB
+	HistogramVector _bufferRed;			//R
+	HistogramVector _bufferGreen;		//G
+	HistogramVector _bufferBlue;		//B
+	///HLS
+	HistogramVector _bufferHue;			//H
+	HistogramVector _bufferLightness;	//S
+	HistogramVector _bufferSaturation;	//L
+	//Alpha
+	HistogramVector _bufferAlpha;		//alpha
+};
+
+/*
+ * copy histograms into the buffers of data
+ */
+inline void assignHistograms( const terry::numeric::rgba_hsl_histogram_t& histograms, HistogramBufferData& data )
+{
+	typedef terry::numeric::rgba_hsl_histogram_t Histograms;
+	data._step = histograms.nbBins();
+	data._bufferRed.assign( histograms.bins[Histograms::red].begin(), histograms.bins[Histograms::red].end() );
+	data._bufferGreen.assign( histograms.bins[Histograms::green].begin(), histograms.bins[Histograms::green].end() );
+	data._bufferBlue.assign( histograms.bins[Histograms::blue].begin(), histograms.bins[Histograms::blue].end() );
+	data._bufferAlpha.assign( histograms.bins[Histograms::alpha].begin(), histograms.bins[Histograms::alpha].end() );
+	data._bufferHue.assign( histograms.bins[Histograms::hue].begin(), histograms.bins[Histograms::hue].end() );
+	data._bufferSaturation.assign( histograms.bins[Histograms::saturation].begin(), histograms.bins[Histograms::saturation].end() );
+	data._bufferLightness.assign( histograms.bins[Histograms::lightness].begin(), histograms.bins[Histograms::lightness].end() );
+}
+
+/*
+ * row reducer to compute (selection) histograms of a rgba32f view, with terry::algorithm::parallel_reduce_rows
+ * (each chunk of rows counts in its own bins)
+ */
+template<class View>
+struct Rows_compute_histograms
+{
+	BOOST_STATIC_ASSERT(( boost::is_same<typename View::value_type, boost::gil::rgba32f_pixel_t>::value ));
+
+	View _view;							//src view
+	const HistogramSelection* _imgBool;	//bool selection img (pixels)
+	bool _isSelectionMode;				//do we work on all of the pixels (normal histograms) or only on selection
+	std::size_t _samplingStep;			//only one pixel every samplingStep pixels on each axis
+	terry::numeric::rgba_hsl_histogram_t _histograms;	//RGBA and HSL histograms
+
+	Rows_compute_histograms( const View& view, const HistogramSelection& selection, const bool isSelectionMode, const std::size_t nbStep, const std::size_t samplingStep = 1 )
+	: _view( view )
+	, _imgBool( &selection )
+	, _isSelectionMode( isSelectionMode )
+	, _samplingStep( std::max( samplingStep, std::size_t(1) ) )
+	, _histograms( nbStep )
+	{
+		BOOST_ASSERT( std::ptrdiff_t(_imgBool->shape()[0]) == _view.height() );
+		BOOST_ASSERT( std::ptrdiff_t(_imgBool->shape()[1]) == _view.width() );
+	}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		if( _view.width() == 0 || y % _samplingStep )
+			return;
+		const float* row = reinterpret_cast<const float*>( &( *_view.row_begin( y ) ) );
+		const unsigned char* selection = _isSelectionMode ? &(*_imgBool)[y][0] : NULL;
+		_histograms.add_row( row, _view.width(), _samplingStep, selection );	//RGBA and HSL (conversion like color_convert)
+	}
+
+	void merge( const Rows_compute_histograms& other )
+	{
+		_histograms.merge( other._histograms );
+	}
+};
+
+/*
+ * row reducer counting the pixels added to and removed from a selection
+ * (only the rows with a modified selection are read)
+ */
+template<class View>
+struct Rows_compute_selection_changes
+{
+	View _view;							//src view
+	const HistogramSelection* _imgBool;	//current selection
+	const HistogramSelection* _previous;	//selection of the last histograms
+	std::size_t _samplingStep;			//only one pixel every samplingStep pixels on each axis
+	terry::numeric::rgba_hsl_histogram_t _added;		//histograms of the newly selected pixels
+	terry::numeric::rgba_hsl_histogram_t _removed;		//histograms of the unselected pixels
+	std::vector<unsigned char> _addedMask;
+	std::vector<unsigned char> _removedMask;
+
+	Rows_compute_selection_changes( const View& view, const HistogramSelection& selection, const HistogramSelection& previous, const std::size_t nbStep, const std::size_t samplingStep )
+	: _view( view )
+	, _imgBool( &selection )
+	, _previous( &previous )
+	, _samplingStep( std::max( samplingStep, std::size_t(1) ) )
+	, _added( nbStep )
+	, _removed( nbStep )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		const std::size_t width = _view.width();
+		if( width == 0 || y % _samplingStep )
+			return;
+		const unsigned char* selection = &(*_imgBool)[y][0];
+		const unsigned char* previous = &(*_previous)[y][0];
+		if( std::equal( selection, selection + width, previous ) )
+			return;
+		_addedMask.resize( width );
+		_removedMask.resize( width );
+		for( std::size_t x = 0; x < width; ++x )
+		{
+			_addedMask[x] = selection[x] && ! previous[x];
+			_removedMask[x] = previous[x] && ! selection[x];
+		}
+		const float* row = reinterpret_cast<const float*>( &( *_view.row_begin( y ) ) );
+		_added.add_row( row, width, _samplingStep, &_addedMask[0] );
+		_removed.add_row( row, width, _samplingStep, &_removedMask[0] );
+	}
+
+	void merge( const Rows_compute_selection_changes& other )
+	{
+		_added.merge( other._added );
+		_removed.merge( other._removed );
+	}
+};
+
+/**
+ * @brief RGBA and HSL histograms of the source image of a histogram overlay, and of its selected pixels.
+ *
+ * The full histograms are only computed again for another time, RoD, number of bins
+ * or sampling step, or after invalidate() (the plugin calls it when the source has
+ * been rendered again or the clip has changed).
+ * The selection histograms are updated with the pixels selected or unselected since the last update.
+ */
+class OverlayHistograms
+{
+public:
+	typedef boost::gil::rgba32f_view_t View;
+	typedef terry::numeric::rgba_hsl_histogram_t Histograms;
+
+	OverlayHistograms()
+	: _isValid( false )
+	{}
+
+	/// the pixels of the source may have changed
+	void invalidate() { _isValid = false; }
+
+	/**
+	 * @brief Update the histograms of the source view and of its selection.
+	 * @param view source view
+	 * @param selection selected pixels of view
+	 * @param rod pixel RoD of view
+	 */
+	void update( const OfxMultiThreadLauncher& launcher, const View& view, const HistogramSelection& selection,
+	             const OfxRectI& rod, const OfxTime time, const std::size_t nbStep, const std::size_t samplingStep )
+	{
+		Key key;
+		key._time = time;
+		key._rod = rod;
+		key._nbStep = nbStep;
+		key._samplingStep = std::max( samplingStep, std::size_t(1) );
+
+		const bool sameImage = _isValid && key == _key;
+		_isValid = false;
+		if( ! sameImage )
+		{
+			_full = terry::algorithm::parallel_reduce_rows( launcher, view.height(),
+				Rows_compute_histograms<View>( view, selection, false, nbStep, key._samplingStep ) )._histograms;
+		}
+		if( ! sameImage ||
+		    _previousSelection.shape()[0] != selection.shape()[0] ||
+		    _previousSelection.shape()[1] != selection.shape()[1] )
+		{
+			_selection = terry::algorithm::parallel_reduce_rows( launcher, view.height(),
+				Rows_compute_histograms<View>( view, selection, true, nbStep, key._samplingStep ) )._histograms;
+		}
+		else
+		{
+			const Rows_compute_selection_changes<View> changes = terry::algorithm::parallel_reduce_rows( launcher, view.height(),
+				Rows_compute_selection_changes<View>( view, selection, _previousSelection, nbStep, key._samplingStep ) );
+			for( std::size_t c = 0; c < _selection.bins.size(); ++c )
+			{
+				for( std::size_t i = 0; i < _selection.bins[c].size(); ++i )
+				{
+					_selection.bins[c][i] += changes._added.bins[c][i];
+					_selection.bins[c][i] -= changes._removed.bins[c][i];
+				}
+			}
+		}
+		HistogramSelection::extent_gen extents;
+		_previousSelection.resize( extents[selection.shape()[0]][selection.shape()[1]] );
+		_previousSelection = selection;
+		_key = key;
+		_isValid = true;
+	}
+
+	const Histograms& full() const { return _full; }
+	const Histograms& selection() const { return _selection; }
+
+private:
+	struct Key
+	{
+		OfxTime _time;
+		OfxRectI _rod;
+		std::size_t _nbStep;			//number of bins
+		std::size_t _samplingStep;		//one pixel analysed every samplingStep pixels
+
+		bool operator==( const Key& other ) const
+		{
+			return _time == other._time &&
+			       _rod.x1 == other._rod.x1 && _rod.y1 == other._rod.y1 &&
+			       _rod.x2 == other._rod.x2 && _rod.y2 == other._rod.y2 &&
+			       _nbStep == other._nbStep &&
+			       _samplingStep == other._samplingStep;
+		}
+	};
+
+	bool _isValid;
+	Key _key;
+	Histograms _full;
+	Histograms _selection;
+	HistogramSelection _previousSelection;	//selection counted in _selection
+};
+
+}
+}
+
+#endif
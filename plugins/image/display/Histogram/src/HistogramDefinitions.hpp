@@ -63,6 +63,10 @@ const static std::string kButtonRefreshOverlayLabel = "Refresh overlay";
 const static std::string knbStepRange = "numberOfStep";
 const static std::string knbStepRangeLabel = "Number of steps ";
 
+//sampling step
+const static std::string kSamplingStep = "samplingStep";
+const static std::string kSamplingStepLabel = "Sampling step ";
+
 //selection multiplier
 const static std::string kselectionMultiplier = "SelectionMultiplier";
 const static std::string kselectionMultiplierLabel = "Selection multiplier ";
@@ -40,6 +40,7 @@ HistogramPlugin::HistogramPlugin( OfxImageEffectHandle handle )
 	_paramSelectionMultiplierSelection = fetchDoubleParam( kselectionMultiplier ); //selection multiplier (Advanced group)
 	_paramRefreshOverlaySelection = fetchPushButtonParam( kButtonRefreshOverlay ); //refresh overlay (Advanced group)
 	_paramNbStepSelection = fetchIntParam( knbStepRange ); //nb step range (Advanced group)
+	_paramSamplingStep = fetchIntParam( kSamplingStep ); //sampling step (Advanced group)
 
 	//Reset param booleans
 	_isCleaned = false;
@@ -95,6 +96,15 @@ void HistogramPlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 			getOverlayData()._isDataInvalid = true;
 		}
 	}
+	// sampling step changed
+	else if( paramName == kSamplingStep )
+	{
+		if( this->hasOverlayData( ) ) //if there is overlay value
+		{
+			getOverlayData().setSamplingStep( _paramSamplingStep->getValue( ) ); //change sampling step value
+			getOverlayData()._isDataInvalid = true;
+		}
+	}
 	// Clear user selection
 	else if( paramName == kButtonResetSelection )
 	{
@@ -114,6 +124,7 @@ void HistogramPlugin::changedClip( const OFX::InstanceChangedArgs& args, const s
 	{
 		if( this->hasOverlayData( ) )
 		{
+			this->getOverlayData().invalidateSource();
 			this->getOverlayData()._isDataInvalid = true;
 			this->redrawOverlays();
 		}
@@ -191,6 +202,7 @@ void HistogramPlugin::render( const OFX::RenderArguments &args )
 
 	if( this->hasOverlayData( ) )
 	{
+		this->getOverlayData().invalidateSource();
 		this->getOverlayData()._isDataInvalid = true;
 		this->redrawOverlays();
 	}
@@ -214,6 +226,7 @@ void HistogramPlugin::addRefOverlayData( )
 	{
 		const OfxPointI imgSize = this->_clipSrc->getPixelRodSize( 0 ); ///@todo set the correct time !
 		_overlayData.reset( new OverlayData( imgSize, this->_paramNbStepSelection->getValue() ) );
+		_overlayData->setSamplingStep( this->_paramSamplingStep->getValue() );
 	}
 	++_overlayDataCount;
 }
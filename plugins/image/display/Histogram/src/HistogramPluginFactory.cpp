@@ -213,6 +213,16 @@ void HistogramPluginFactory::describeInContext( OFX::ImageEffectDescriptor& desc
 		nbStepRange->setEvaluateOnChange(false); // don't need to recompute on change
 		nbStepRange->setParent(groupHistogramOverlay);
 
+		//sampling step (advanced group)
+		OFX::IntParamDescriptor* samplingStep = desc.defineIntParam(kSamplingStep);
+		samplingStep->setLabel(kSamplingStepLabel);
+		samplingStep->setHint("Analyse only one pixel every n pixels on each axis: faster histograms on large images, for interactive use.");
+		samplingStep->setRange(1, 64);
+		samplingStep->setDisplayRange(1, 16);
+		samplingStep->setDefault(1);
+		samplingStep->setEvaluateOnChange(false); // don't need to recompute on change
+		samplingStep->setParent(groupHistogramOverlay);
+
 		//selection multiplier (advanced group)
 		OFX::DoubleParamDescriptor* selectionMultiplier = desc.defineDoubleParam(kselectionMultiplier);
 		selectionMultiplier->setLabel(kselectionMultiplierLabel);
@@ -3,8 +3,6 @@
 #include <tuttle/plugin/global.hpp>
 #include <tuttle/plugin/ImageGilProcessor.hpp>
 
-#include <terry/algorithm/transform_pixels.hpp>
-
 namespace tuttle {
 namespace plugin {
 namespace histogram {
@@ -16,6 +14,7 @@ namespace histogram {
 OverlayData::OverlayData( const OfxPointI& size, const int nbSteps )
 : _currentTime( 0 )
 , _vNbStep( nbSteps )
+, _samplingStep( 1 )
 , _isComputing( false )
 , _isDataInvalid( true )
 , _size( size )
@@ -23,27 +22,6 @@ OverlayData::OverlayData( const OfxPointI& size, const int nbSteps )
 	clearAll( size );
 }
 
-/**
- * Update selection areas buffer to selection histograms overlay
- * @param args needed to have current time
- */
-void OverlayData::computeHistogramBufferData( HistogramBufferData& data, SView& srcView, const OfxTime time, const bool isSelection)
-{
-	data._step = _vNbStep;					//prepare HistogramBuffer structure
-	
-	BOOST_ASSERT( _imgBool.shape()[0] == std::size_t(_size.y) );
-	BOOST_ASSERT( _imgBool.shape()[1] == std::size_t(_size.x) );
-	BOOST_ASSERT( srcView.width()  == std::size_t(_size.x) );
-	BOOST_ASSERT( srcView.height() == std::size_t(_size.y) );
-	
-	Pixel_compute_histograms funct( _imgBool, data, isSelection );			//functor declaration
-	
-	terry::algorithm::transform_pixels( srcView, funct );		//(USED functor reference)
-	//boost::gil::for_each_pixel(srcView, funct);		(NOT USED)
-	
-	this->correctHistogramBufferData(data);				//correct Histogram data to make up for discretization (average)
-}
-
 /**
  * @brief Set each values of the vector to null
  * @param v vector to reset
@@ -206,12 +184,12 @@ void OverlayData::computeFullData( OFX::Clip* clipSrc, const OfxTime time, const
 	}
 	
 	//TUTTLE_LOG_INFOS;
-	//Compute histogram buffer
-	this->computeHistogramBufferData( _data, srcView, time);
-	
-	//TUTTLE_LOG_INFOS;
-	//Compute selection histogram buffer
-	this->computeHistogramBufferData( _selectionData, srcView, time, true );
+	//Compute histogram and selection histogram buffers (only the modified selection if it is the same image)
+	_histograms.update( OfxMultiThreadLauncher(), srcView, _imgBool, srcPixelRod, time, _vNbStep, _samplingStep );
+	assignHistograms( _histograms.full(), _data );
+	this->correctHistogramBufferData( _data );				//correct Histogram data to make up for discretization (average)
+	assignHistograms( _histograms.selection(), _selectionData );
+	this->correctHistogramBufferData( _selectionData );
 	
 	//TUTTLE_LOG_INFOS;
 	//Compute averages
@@ -3,38 +3,16 @@
 
 #include "HistogramDefinitions.hpp"
 
-#include <tuttle/plugin/memory/OfxAllocator.hpp>
+#include <tuttle/plugin/OverlayHistograms.hpp>
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 
-#include <boost/gil/extension/color/hsl.hpp>
-#include <boost/multi_array.hpp>
 #include <boost/array.hpp>
 
 namespace tuttle {
 namespace plugin {
 namespace histogram {
 
-typedef long Number;
-typedef std::vector<Number, OfxAllocator<Number> > HistogramVector;
-
-/*
- * structure of 7 buffers (contains histogram data)
- */
-struct HistogramBufferData
-{
-	//step
-	int _step;								//nbStep (for computing and display)
-	//RGB
-	HistogramVector _bufferRed;			//R
-	HistogramVector _bufferGreen;		//G
-	HistogramVector _bufferBlue;		//B
-	///HLS
-	HistogramVector _bufferHue;			//H
-	HistogramVector _bufferLightness;	//S
-	HistogramVector _bufferSaturation;	//L
-	//Alpha
-	HistogramVector _bufferAlpha;		//alpha
-};
+typedef HistogramVector::value_type Number;
 
 /*
  * structure which contains selection average for each channel to display average bar
@@ -51,110 +29,7 @@ struct AverageBarData
 	int _averageLightness;			//L
 };
 
-/*
- *functor to compute selection histograms
- */
-typedef boost::multi_array<unsigned char,2, OfxAllocator<unsigned char> > bool_2d;
-
-
-struct Pixel_compute_histograms
-{
-    HistogramBufferData& _data;		//HistogramBufferData to fill up
-	bool_2d& _imgBool;				//bool selection img (pixels)
-	std::ssize_t _height;			//height of src clip
-	std::ssize_t _width;			//width of src clip
-	std::ssize_t _y, _x;			//position of the current pixel (functor needs to know which pixel is it)
-	bool _isSelectionMode;			//do we work on all of the pixels (normal histograms) or only on selection
-	
-	Pixel_compute_histograms( bool_2d& selection, HistogramBufferData& data, const bool isSelectionMode )
-	: _data( data )
-	, _imgBool( selection )
-	, _height( _imgBool.shape()[0] )
-	, _width( _imgBool.shape()[1] )
-	, _y(0)
-	, _x(0)
-	, _isSelectionMode(isSelectionMode)
-	{
-
-	}
-	
-	//basic round function
-    double round( const double x ) const
-	{
-		if( x >= 0.5 ) { return ceil(x); } else { return floor(x); }
-	}
-	
-	template< typename Pixel>
-    Pixel operator()( const Pixel& p )
-    {
-        using namespace boost::gil;
-		bool ok = false;
-		
-		BOOST_ASSERT( _y >= 0 );
-		BOOST_ASSERT( _x >= 0 );
-		BOOST_ASSERT( std::ssize_t(_imgBool.shape()[0]) > _y );
-		BOOST_ASSERT( std::ssize_t(_imgBool.shape()[1]) > _x );
-		
-		//int revert_y = (_height-1)-_y;
-		
-		if(_isSelectionMode == false)
-			ok = true;
-		else if(_imgBool[_y][_x] && _isSelectionMode)
-			ok = true;
-
-		if(ok) //if current pixel is selected
-		{
-			int indice;
-			double val;
-			hsl32f_pixel_t hsl_pix;			//needed to work in HSL (entry is RGBA)
-			rgba32f_pixel_t pix;
-			
-			color_convert( p, pix );		//convert input to RGBA
-			color_convert( pix, hsl_pix );	//convert RGBA tp HSL
-		
-			//RGBA
-			for( int v = 0; v < boost::gil::num_channels<Pixel>::type::value; ++v )
-			{
-				val = p[v];          
-				if(val >= 0 && val <= 1)
-				{
-					double inter = round(val*(_data._step-1));
-					indice = inter;
-					if( v == 0 )
-						_data._bufferRed.at(indice) += 1;			//increments red buffer 
-					else if(v == 1)
-						_data._bufferGreen.at(indice) += 1;			//increments green buffer 
-					else if(v == 2)
-						_data._bufferBlue.at(indice) += 1;			//increments blue buffer 
-					else if(v == 3)
-						_data._bufferAlpha.at(indice) += 1;			//increments alpha buffer 
-				}
-			}
-			
-			//HLS
-			for(int v = 0; v < boost::gil::num_channels<hsl32f_pixel_t>::type::value; ++v )
-			{
-				val = hsl_pix[v];          
-				if(val >= 0 && val <= 1)
-				{    
-					double inter = round(val*(_data._step-1));
-					indice = inter;
-					if(v == 0)
-						_data._bufferHue.at(indice) += 1;			//increments hue buffer
-					else if(v == 2)
-						_data._bufferLightness.at(indice) += 1;		//increments saturation buffer
-					else if(v == 1)
-						_data._bufferSaturation.at(indice) += 1;	//increments lightness buffer
-				}
-			}
-		}
-		
-		//Check pixel position
-		++_x;
-		if(_x == _width){++_y;_x=0;}
-        return p;
-    }
-};
+typedef HistogramSelection bool_2d;
 
 class OverlayData 
 {
@@ -193,15 +68,20 @@ public:
 	 */
 	void computeFullData( OFX::Clip* clipSrc,const OfxTime time, const OfxPointD& renderScale, const bool selectionOnly = false);			//compute full data (average/selection/histograms)
 	void setNbStep( const std::size_t nbStep ) { _vNbStep = nbStep; }
+	void setSamplingStep( const std::size_t samplingStep ) { _samplingStep = samplingStep; }
 	
 	/**
 	 * Current time checker
      */
 	bool isCurrentTimeModified(const OfxTime time) const;
 	
+	/**
+	 * The pixels of the source may have changed (render, clip change): the next computeFullData analyses the image again
+	 */
+	void invalidateSource() { _histograms.invalidate(); }
+	
 private:
 	/*Histogram management*/
-	void computeHistogramBufferData( HistogramBufferData& data, SView& srcView, const OfxTime time, const bool isSelection=false);	//compute a HisogramBufferData
 	void correctHistogramBufferData( HistogramBufferData& toCorrect ) const;		//correct a complete HistogramBufferData
 	void resetHistogramBufferData( HistogramBufferData& toReset ) const;		//reset a complete HistogramBufferData
 	
@@ -228,6 +108,7 @@ public:
 	bool_2d _imgBool;						//unsigned char 2D (use for display texture on screen)
 	OfxTime _currentTime;					//time of the current frame
 	std::size_t _vNbStep;					//nbStep for buffers
+	std::size_t _samplingStep;				//only analyse one pixel every samplingStep pixels on each axis
 	bool _isComputing;
 	
 	bool _isDataInvalid;
@@ -235,6 +116,8 @@ public:
 private:
 	OfxPointI _size;						//source clip size
 	
+	OverlayHistograms _histograms;			//histograms of the last analysed image and of its selection
+	
 };
 
 }
@@ -1,6 +1,14 @@
 #ifndef _TUTTLE_PLUGIN_SEEXPR_ALGORITHM_HPP_
 #define _TUTTLE_PLUGIN_SEEXPR_ALGORITHM_HPP_
 
+#include <SeExpression.h>
+
+#include <boost/gil/typedefs.hpp>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
 namespace tuttle {
 namespace plugin {
 namespace seExpr {
@@ -11,7 +19,16 @@ public:
 	//! Constructor that takes the expression to parse
 	ImageSynthExpr( const std::string& expr )
 		:SeExpression( expr )
-	{}
+		, _valid( false )
+		, _rowInvariant( false )
+	{
+		// the variables of the generator, resolved by the parsing
+		vars["u"];
+		vars["v"];
+		vars["w"];
+		vars["h"];
+		vars["frame"];
+	}
 
 	//! Simple variable that just returns its internal value
 	struct Var:public SeExprScalarVarRef
@@ -20,7 +37,9 @@ public:
 			:val(val)
 		{}
 
-		Var(){}
+		Var()
+			:val(0)
+		{}
 
 		double val; // independent variable
 		void eval( const SeExprVarNode* /*node*/,SeVec3d& result )
@@ -40,6 +59,44 @@ public:
 
 		return 0;
 	}
+
+	/**
+	 * @brief Parse the expression, returns its validity.
+	 * The variables are resolved once, only their values change between the evaluations.
+	 */
+	bool prepare()
+	{
+		_valid = isValid();
+		_rowInvariant = _valid && ! usesVar( "u" );
+		return _valid;
+	}
+
+	/**
+	 * @brief Evaluate a line of @p n pixels, u goes from @p u0 by steps of @p du and v is constant.
+	 * The expressions which don't use u are evaluated once for the whole line.
+	 */
+	void evaluateRow( const double u0, const double du, const double v, const std::size_t n, boost::gil::rgba32f_pixel_t* dst )
+	{
+		double& varU = vars["u"].val;
+		vars["v"].val = v;
+		if( _rowInvariant )
+		{
+			varU = u0;
+			const SeVec3d result = evaluate();
+			std::fill( dst, dst + n, boost::gil::rgba32f_pixel_t( (float)result[0], (float)result[1], (float)result[2], 1.0 ) );
+			return;
+		}
+		for( std::size_t x = 0; x < n; ++x )
+		{
+			varU = u0 + du * x;
+			const SeVec3d result = evaluate();
+			dst[x] = boost::gil::rgba32f_pixel_t( (float)result[0], (float)result[1], (float)result[2], 1.0 );
+		}
+	}
+
+private:
+	bool _valid;
+	bool _rowInvariant; ///< the result doesn't change along a line
 };
 
 }
@@ -0,0 +1,58 @@
+#include "SeExprCache.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace tuttle {
+namespace plugin {
+namespace seExpr {
+
+namespace {
+/// more than the render threads, the others are released
+static const std::size_t kMaxNbExpressions = 64;
+}
+
+ImageSynthExprPool::ImageSynthExprPool()
+	: _codeKey( boost::hash<std::string>()( std::string() ) )
+{}
+
+bool ImageSynthExprPool::isCurrentCode( const std::size_t codeKey, const std::string& code ) const
+{
+	return codeKey == _codeKey && code == _code;
+}
+
+ImageSynthExprPtr ImageSynthExprPool::acquire( const std::string& code )
+{
+	const std::size_t codeKey = boost::hash<std::string>()( code );
+	{
+		boost::lock_guard<boost::mutex> lock( _mutex );
+		if( ! isCurrentCode( codeKey, code ) )
+		{
+			_codeKey = codeKey;
+			_code = code;
+			_exprs.clear();
+		}
+		else if( ! _exprs.empty() )
+		{
+			ImageSynthExprPtr expr = _exprs.back();
+			_exprs.pop_back();
+			return expr;
+		}
+	}
+	// parsed outside of the lock, the other threads can take the free expressions
+	ImageSynthExprPtr expr( new ImageSynthExpr( code ) );
+	expr->prepare();
+	return expr;
+}
+
+void ImageSynthExprPool::release( const std::string& code, const ImageSynthExprPtr& expr )
+{
+	const std::size_t codeKey = boost::hash<std::string>()( code );
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	if( isCurrentCode( codeKey, code ) && _exprs.size() < kMaxNbExpressions )
+		_exprs.push_back( expr );
+}
+
+}
+}
+}
@@ -0,0 +1,76 @@
+#ifndef _TUTTLE_PLUGIN_SEEXPR_CACHE_HPP_
+#define _TUTTLE_PLUGIN_SEEXPR_CACHE_HPP_
+
+#include "SeExprAlgorithm.hpp"
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <string>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace seExpr {
+
+typedef boost::shared_ptr<ImageSynthExpr> ImageSynthExprPtr;
+
+/**
+ * @brief The parsed expressions of the current code, kept between the renders.
+ *
+ * An expression holds the values of its variables, so it is used by only one
+ * render thread at a time: each thread takes one from the pool (parsed on the
+ * first use) and gives it back at the end of its window.
+ * The pool is emptied when the code changes (compared by hash first).
+ */
+class ImageSynthExprPool : boost::noncopyable
+{
+public:
+	ImageSynthExprPool();
+
+	/// @brief A prepared expression of @p code, to give back with release().
+	ImageSynthExprPtr acquire( const std::string& code );
+	void release( const std::string& code, const ImageSynthExprPtr& expr );
+
+private:
+	bool isCurrentCode( const std::size_t codeKey, const std::string& code ) const;
+
+private:
+	boost::mutex _mutex;
+	std::size_t _codeKey; ///< hash of _code
+	std::string _code;
+	std::vector<ImageSynthExprPtr> _exprs; ///< the free expressions of _code
+};
+
+/**
+ * @brief An expression taken from the pool for the current scope.
+ */
+class ScopedImageSynthExpr : boost::noncopyable
+{
+public:
+	ScopedImageSynthExpr( ImageSynthExprPool& pool, const std::string& code )
+		: _pool( pool )
+		, _code( code )
+		, _expr( pool.acquire( code ) )
+	{}
+
+	~ScopedImageSynthExpr()
+	{
+		_pool.release( _code, _expr );
+	}
+
+	ImageSynthExpr& operator*() const { return *_expr; }
+	ImageSynthExpr* operator->() const { return _expr.get(); }
+
+private:
+	ImageSynthExprPool& _pool;
+	const std::string _code;
+	ImageSynthExprPtr _expr;
+};
+
+}
+}
+}
+
+#endif
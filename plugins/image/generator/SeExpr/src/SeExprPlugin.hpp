@@ -2,6 +2,7 @@
 #define _TUTTLE_PLUGIN_SEEXPR_PLUGIN_HPP_
 
 #include "SeExprDefinitions.hpp"
+#include "SeExprCache.hpp"
 
 #include <tuttle/plugin/context/GeneratorPlugin.hpp>
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
@@ -42,6 +43,8 @@ public:
 	OFX::StringParam*   _paramCode;
 	OFX::StringParam*   _paramFile;
 	OFX::Double2DParam* _paramTextureOffset;
+
+	ImageSynthExprPool  _exprPool; ///< parsed expressions, shared by the render threads and the frames
 private:
 	OFX::InstanceChangedArgs _instanceChangedArgs;
 };
@@ -1,3 +1,8 @@
+#include <boost/gil/algorithm.hpp>
+#include <boost/gil/image_view_factory.hpp>
+
+#include <vector>
+
 namespace tuttle {
 namespace plugin {
 namespace seExpr {
@@ -7,7 +12,6 @@ SeExprProcess<View>::SeExprProcess( SeExprPlugin &effect )
 	: ImageGilProcessor<View>( effect, eImageOrientationIndependant )
 	, _plugin( effect )
 {
-	this->setNoMultiThreading();
 }
 
 template<class View>
@@ -22,18 +26,13 @@ void SeExprProcess<View>::setup( const OFX::RenderArguments& args )
 	
 	TUTTLE_TLOG( TUTTLE_INFO, _params._code );
 
-	ImageSynthExpr expr( _params._code );
-	expr.vars["u"] = ImageSynthExpr::Var( _params._paramTextureOffset.x );
-	expr.vars["v"] = ImageSynthExpr::Var( _params._paramTextureOffset.y );
-	expr.vars["w"] = ImageSynthExpr::Var( rod.x2 - rod.x1 );
-	expr.vars["h"] = ImageSynthExpr::Var( rod.y2 - rod.y1 );
-	expr.vars["frame"] = ImageSynthExpr::Var( _time );
-
-	bool valid = expr.isValid();
+	// parsed once for all the frames, then used by one of the render threads
+	ScopedImageSynthExpr expr( _plugin._exprPool, _params._code );
+	bool valid = expr->isValid();
 	if( !valid )
 	{
 		TUTTLE_LOG( TUTTLE_ERROR, "Invalid expression" );
-		TUTTLE_LOG( TUTTLE_ERROR, expr.parseError() );
+		TUTTLE_LOG( TUTTLE_ERROR, expr->parseError() );
 	}
 }
 
@@ -52,33 +51,30 @@ void SeExprProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRo
 		procWindowRoW.y2 - procWindowRoW.y1
 	};
 
-	ImageSynthExpr expr( _params._code );
-	expr.vars["u"] = ImageSynthExpr::Var( _params._paramTextureOffset.x );
-	expr.vars["v"] = ImageSynthExpr::Var( _params._paramTextureOffset.y );
-	expr.vars["w"] = ImageSynthExpr::Var( rod.x2 - rod.x1 );
-	expr.vars["h"] = ImageSynthExpr::Var( rod.y2 - rod.y1 );
-	expr.vars["frame"] = ImageSynthExpr::Var( _time );
+	ScopedImageSynthExpr expr( _plugin._exprPool, _params._code );
+	expr->vars["w"].val = rod.x2 - rod.x1;
+	expr->vars["h"].val = rod.y2 - rod.y1;
+	expr->vars["frame"].val = _time;
 
-	double one_over_width  = 1.0 / procWindowSize.x;
-	double one_over_height = 1.0 / procWindowSize.y;
-	double& u = expr.vars["u"].val;
-	double& v = expr.vars["v"].val;
+	// u and v are normalized by the size of the render window, not by the window of the thread
+	double one_over_width  = 1.0 / this->_renderWindowSize.x;
+	double one_over_height = 1.0 / this->_renderWindowSize.y;
+
+	std::vector<rgba32f_pixel_t> row( procWindowSize.x );
+	const rgba32f_view_t rowView = interleaved_view( procWindowSize.x, 1, &row.front(), procWindowSize.x * sizeof( rgba32f_pixel_t ) );
 
 	for( int y = procWindowOutput.y1;
 			 y < procWindowOutput.y2;
 			 ++y )
 	{
-		typename View::x_iterator dst_it = this->_dstView.x_at( procWindowOutput.x1, y );
-		for( int x = procWindowOutput.x1;
-			 x < procWindowOutput.x2;
-			 ++x, ++dst_it )
-		{
-			u = one_over_width  * ( x + .5 - _params._paramTextureOffset.x );
-			v = one_over_height * ( y + .5 - _params._paramTextureOffset.y );
-			SeVec3d result = expr.evaluate();
-
-			color_convert( rgba32f_pixel_t( (float)result[0], (float)result[1], (float)result[2], 1.0 ), *dst_it );
-		}
+		expr->evaluateRow(
+			one_over_width  * ( procWindowOutput.x1 + .5 - _params._paramTextureOffset.x ),
+			one_over_width,
+			one_over_height * ( y + .5 - _params._paramTextureOffset.y ),
+			procWindowSize.x, &row.front() );
+
+		copy_and_convert_pixels( rowView, subimage_view( this->_dstView, procWindowOutput.x1, y, procWindowSize.x, 1 ) );
+
 		if( this->progressForward( procWindowSize.x ) )
 			return;
 	}
@@ -0,0 +1,224 @@
+#include "TextFontCache.hpp"
+
+#include <tuttle/plugin/exceptions.hpp>
+
+#include <terry/lru_cache.hpp>
+
+#include <boost/thread/locks.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+
+#ifndef __WINDOWS__
+#include <fontconfig/fontconfig.h>
+#endif
+
+namespace tuttle {
+namespace plugin {
+namespace text {
+
+namespace {
+
+static const std::size_t kMaxNbFaces = 16;
+
+/**
+ * @brief The FreeType library and the last used faces, shared by all the renders.
+ */
+struct FreeTypeCache
+{
+	typedef boost::tuple<std::string, int, int> FaceKey;
+
+	FT_Library _library;
+	boost::mutex _libraryMutex; ///< for the creation and the destruction of the faces
+	terry::lru_cache<FaceKey, FontFacePtr> _faces;
+
+	FreeTypeCache()
+	: _library( NULL )
+	, _faces( kMaxNbFaces )
+	{
+		if( FT_Init_FreeType( &_library ) )
+		{
+			BOOST_THROW_EXCEPTION( exception::Failed()
+				<< exception::user( "Text: Unable to initialize FreeType." ) );
+		}
+	}
+
+	~FreeTypeCache()
+	{
+		_faces.clear();
+		FT_Done_FreeType( _library );
+	}
+};
+
+FreeTypeCache& freeTypeCache()
+{
+	static FreeTypeCache cache;
+	return cache;
+}
+
+struct FontFaceLoader
+{
+	const std::string& _filename;
+	int _sizeX;
+	int _sizeY;
+	FontFaceLoader( const std::string& filename, const int sizeX, const int sizeY ) : _filename( filename ), _sizeX( sizeX ), _sizeY( sizeY ) {}
+	FontFacePtr operator()() const { return FontFacePtr( new FontFace( _filename, _sizeX, _sizeY ) ); }
+};
+
+}
+
+FontFace::FontFace( const std::string& filename, const int sizeX, const int sizeY )
+: _face( NULL )
+{
+	FreeTypeCache& cache = freeTypeCache();
+	boost::lock_guard<boost::mutex> lock( cache._libraryMutex );
+	if( FT_New_Face( cache._library, filename.c_str(), 0, &_face ) )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Text: Unable to load the font." )
+			<< exception::filename( filename ) );
+	}
+	FT_Set_Pixel_Sizes( _face, sizeX, sizeY );
+}
+
+FontFace::~FontFace()
+{
+	FreeTypeCache& cache = freeTypeCache();
+	boost::lock_guard<boost::mutex> lock( cache._libraryMutex );
+	FT_Done_Face( _face );
+}
+
+const TextGlyph& FontFace::glyph( const char ch )
+{
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	std::map<char, TextGlyph>::const_iterator it = _glyphs.find( ch );
+	if( it != _glyphs.end() )
+		return it->second;
+
+	TextGlyph& glyph = _glyphs[ch];
+	const int index = FT_Get_Char_Index( _face, static_cast<unsigned char>( ch ) );
+	FT_Load_Glyph( _face, index, FT_LOAD_DEFAULT );
+	FT_Render_Glyph( _face->glyph, FT_RENDER_MODE_NORMAL );
+
+	const FT_GlyphSlot slot = _face->glyph;
+	glyph._metrics = slot->metrics;
+	glyph._advance = slot->advance.x >> 6;
+	glyph._width = slot->bitmap.width;
+	glyph._height = slot->bitmap.rows;
+	glyph._bitmap.resize( glyph._width * glyph._height );
+	for( int y = 0; y < glyph._height; ++y )
+	{
+		const unsigned char* row = slot->bitmap.buffer + y * slot->bitmap.pitch;
+		std::copy( row, row + glyph._width, glyph._bitmap.begin() + y * glyph._width );
+	}
+	return glyph;
+}
+
+FontFacePtr getFontFace( const std::string& filename, const int sizeX, const int sizeY )
+{
+	// the renders using a face removed from the cache keep it alive
+	return freeTypeCache()._faces.get( FreeTypeCache::FaceKey( filename, sizeX, sizeY ), FontFaceLoader( filename, sizeX, sizeY ) );
+}
+
+#ifndef __WINDOWS__
+
+namespace {
+
+/**
+ * @brief The fontconfig configuration, the list of the font families
+ * (the same list as the choices of the font parameter) and the files already found.
+ */
+struct FontConfigCache
+{
+	typedef boost::tuple<int, bool, bool> FileKey;
+
+	boost::mutex _mutex;
+	FcConfig* _config;
+	FcFontSet* _families;
+	std::map<FileKey, std::string> _files;
+
+	FontConfigCache()
+	: _config( NULL )
+	, _families( NULL )
+	{}
+};
+
+FontConfigCache& fontConfigCache()
+{
+	static FontConfigCache cache;
+	return cache;
+}
+
+}
+
+std::string findFontFile( const int font, const bool bold, const bool italic )
+{
+	FontConfigCache& cache = fontConfigCache();
+	const FontConfigCache::FileKey key( font, bold, italic );
+
+	boost::lock_guard<boost::mutex> lock( cache._mutex );
+	std::map<FontConfigCache::FileKey, std::string>::const_iterator it = cache._files.find( key );
+	if( it != cache._files.end() )
+		return it->second;
+
+	if( ! cache._config )
+	{
+		FcInit();
+		cache._config = FcInitLoadConfigAndFonts();
+		FcPattern* p = FcPatternBuild(
+			NULL,
+			FC_WEIGHT, FcTypeInteger, FC_WEIGHT_BOLD,
+			FC_SLANT, FcTypeInteger, FC_SLANT_ITALIC,
+			NULL );
+		FcObjectSet* os = FcObjectSetBuild( FC_FAMILY, NULL );
+		cache._families = FcFontList( cache._config, p, os );
+		FcObjectSetDestroy( os );
+		FcPatternDestroy( p );
+	}
+
+	if( ! cache._families || cache._families->nfont == 0 )
+	{
+		BOOST_THROW_EXCEPTION( exception::FileNotExist()
+			<< exception::user( "The plugin does not find any font on your system. Please inform 'fontFile' parameter manually." ) );
+	}
+	if( font < 0 || font >= cache._families->nfont )
+	{
+		BOOST_THROW_EXCEPTION( exception::Value()
+			<< exception::user( "Text: The selected font doesn't exist anymore on your system." ) );
+	}
+
+	FcChar8* familyName = FcNameUnparse( cache._families->fonts[font] );
+	const std::string family = reinterpret_cast<char*>( familyName );
+	free( familyName );
+
+	const int weight = bold ? FC_WEIGHT_BOLD : FC_WEIGHT_MEDIUM;
+	const int slant = italic ? FC_SLANT_ITALIC : FC_SLANT_ROMAN;
+	FcPattern* p = FcPatternBuild( NULL,
+		FC_FAMILY, FcTypeString, family.c_str(),
+		FC_WEIGHT, FcTypeInteger, weight,
+		FC_SLANT, FcTypeInteger, slant,
+		NULL );
+
+	FcResult result;
+	FcPattern* match = FcFontMatch( 0, p, &result );
+	FcChar8* file = NULL;
+	std::string filename;
+	if( match && FcPatternGetString( match, FC_FILE, 0, &file ) == FcResultMatch )
+		filename = reinterpret_cast<char*>( file );
+	if( match )
+		FcPatternDestroy( match );
+	FcPatternDestroy( p );
+
+	if( filename.empty() )
+	{
+		BOOST_THROW_EXCEPTION( exception::FileNotExist()
+			<< exception::user() + "Text: No font file found for the font " + family + "." );
+	}
+	cache._files[key] = filename;
+	return filename;
+}
+
+#endif
+
+}
+}
+}
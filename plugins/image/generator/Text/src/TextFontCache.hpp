@@ -0,0 +1,77 @@
+#ifndef _TUTTLE_PLUGIN_TEXT_FONTCACHE_HPP_
+#define _TUTTLE_PLUGIN_TEXT_FONTCACHE_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+
+namespace tuttle {
+namespace plugin {
+namespace text {
+
+/**
+ * @brief A rasterized glyph (8 bits coverage), with its metrics.
+ */
+struct TextGlyph
+{
+	FT_Glyph_Metrics _metrics;
+	int _advance; ///< horizontal advance in pixels
+	int _width;
+	int _height;
+	std::vector<unsigned char> _bitmap; ///< _width * _height coverage values, from top to bottom
+};
+
+/**
+ * @brief A FreeType face at a pixel size, with the glyphs already rasterized.
+ *
+ * The faces are shared by the renders of all the frames and all the
+ * instances, the glyphs are rasterized only once.
+ * A FT_Face can't be used by several threads at the same time, so all the
+ * direct uses of face() need to lock mutex().
+ */
+class FontFace : boost::noncopyable
+{
+public:
+	FontFace( const std::string& filename, const int sizeX, const int sizeY );
+	~FontFace();
+
+	/// @brief The glyph of @p ch, rasterized on the first call.
+	const TextGlyph& glyph( const char ch );
+
+	FT_Face face() const { return _face; }
+	boost::mutex& mutex() { return _mutex; }
+
+private:
+	FT_Face _face;
+	boost::mutex _mutex;
+	std::map<char, TextGlyph> _glyphs; ///< glyph atlas, by character
+};
+
+typedef boost::shared_ptr<FontFace> FontFacePtr;
+
+/**
+ * @brief The face of @p filename at the pixel size (sizeX, sizeY),
+ * shared with the other renders.
+ */
+FontFacePtr getFontFace( const std::string& filename, const int sizeX, const int sizeY );
+
+#ifndef __WINDOWS__
+/**
+ * @brief The file of the font family @p font (index in the fontconfig list of the families), with the style.
+ */
+std::string findFontFile( const int font, const bool bold, const bool italic );
+#endif
+
+}
+}
+}
+
+#endif
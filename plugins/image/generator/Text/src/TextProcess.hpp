@@ -1,6 +1,8 @@
 #ifndef _TUTTLE_PLUGIN_TEXT_PROCESS_HPP_
 #define _TUTTLE_PLUGIN_TEXT_PROCESS_HPP_
 
+#include "TextFontCache.hpp"
+
 #include <tuttle/plugin/ImageGilProcessor.hpp>
 
 #include <terry/freetype/freegil.hpp>
@@ -57,6 +59,8 @@ protected:
 	View                          _srcView;       ///< @brief source clip (filters have only one input)
 	
 	TextPlugin&                   _plugin;        ///< Rendering plugin
+	FontFacePtr                   _face;          ///< shared face, keeps the glyphs alive
+	std::vector<const TextGlyph*> _textGlyphs;    ///< rasterized glyphs of the text
 	std::vector<FT_Glyph_Metrics> _metrics;
 	std::vector<int>              _kerning;
 	boost::ptr_vector<glyph_t>    _glyphs;
@@ -14,16 +14,13 @@
 #include <boost/gil/gil_all.hpp>
 
 #include <boost/filesystem.hpp>
+#include <boost/thread/locks.hpp>
 #include <boost/ptr_container/ptr_inserter.hpp>
 
 #include <sstream>
 #include <string>
 #include <iostream>
 
-#ifndef __WINDOWS__
-#include <fontconfig/fontconfig.h>
-#endif
-
 namespace tuttle {
 namespace plugin {
 namespace text {
@@ -35,7 +32,6 @@ TextProcess<View, Functor>::TextProcess( TextPlugin& instance )
 {
 //	Py_Initialize();
 	_clipSrc = instance.fetchClip( kOfxImageEffectSimpleSourceClipName );
-	this->setNoMultiThreading();
 }
 
 template<class View, class Functor>
@@ -73,7 +69,7 @@ void TextProcess<View, Functor>::setup( const OFX::RenderArguments& args )
 	_text = _params._text;
 	
 	//Step 1. Create terry image
-	//Step 2. Initialize freetype
+	//Step 2. Find the font
 	//Step 3. Make Glyphs Array
 	//Step 4. Make Metrics Array
 	//Step 5. Make Kerning Array
@@ -83,12 +79,7 @@ void TextProcess<View, Functor>::setup( const OFX::RenderArguments& args )
 
 	//Step 1. Create terry image -----------
 
-	//Step 2. Initialize freetype ---------------
-	FT_Library library;
-	FT_Init_FreeType( &library );
-
-	FT_Face face;
-
+	//Step 2. Find the font ---------------
 	std::string selectedFont = "";
 
 	if( !boost::filesystem::exists( _params._fontPath ) || boost::filesystem::is_directory( _params._fontPath ) )
@@ -98,49 +89,15 @@ void TextProcess<View, Functor>::setup( const OFX::RenderArguments& args )
 			<< exception::user( "Text: Error in Font Path." )
 			<< exception::filename( _params._fontPath ) );
 #else
-		FcInit();
-
-		FcChar8 *file;
-		FcResult result;
-		FcConfig *config = FcInitLoadConfigAndFonts();
-		FcPattern *p = FcPatternBuild(
-			NULL,
-			FC_WEIGHT, FcTypeInteger, FC_WEIGHT_BOLD,
-			FC_SLANT, FcTypeInteger, FC_SLANT_ITALIC,
-			NULL );
-
-		FcObjectSet *os = FcObjectSetBuild( FC_FAMILY, NULL );
-		FcFontSet   *fs = FcFontList( config, p, os );
-
-		if( fs->nfont == 0 )
-		{
-			BOOST_THROW_EXCEPTION( exception::FileNotExist( _params._fontPath )
-				<< exception::user( "The plugin does not find any font on your system. Please inform 'fontFile' parameter manually." ) );
-		}
-
-		selectedFont = (char*) FcNameUnparse( fs->fonts[_params._font] );
-
-		int weight = ( _params._bold   == 1) ? FC_WEIGHT_BOLD  : FC_WEIGHT_MEDIUM;
-		int slant  = ( _params._italic == 1) ? FC_SLANT_ITALIC : FC_SLANT_ROMAN;
-
-		p  = FcPatternBuild( NULL,
-			FC_FAMILY, FcTypeString, selectedFont.c_str(),
-			FC_WEIGHT, FcTypeInteger, weight,
-			FC_SLANT, FcTypeInteger, slant,
-			NULL );
-
-		FcPatternGetString( FcFontMatch( 0, p, &result ), FC_FAMILY, 0, &file );
-		FcPatternGetString( FcFontMatch( 0, p, &result ), FC_FILE, 0, &file );
-		selectedFont = (char*) file;
+		selectedFont = findFontFile( _params._font, _params._bold, _params._italic );
 #endif
 	}
 	else
 	{
 		selectedFont = _params._fontPath;
 	}
-	FT_New_Face( library, selectedFont.c_str(), 0, &face );
-	
-	FT_Set_Pixel_Sizes( face, _params._fontX, _params._fontY );	
+	// the face and its glyphs are shared by all the frames
+	_face = getFontFace( selectedFont, _params._fontX, _params._fontY );
 
 	//Step 3. Make Glyphs Array ------------------
 	rgba32f_pixel_t rgba32f_foregroundColor( _params._fontColor.r,
@@ -148,13 +105,23 @@ void TextProcess<View, Functor>::setup( const OFX::RenderArguments& args )
 		_params._fontColor.b,
 		_params._fontColor.a );
 	color_convert( rgba32f_foregroundColor, _foregroundColor );
-	std::transform( _text.begin(), _text.end(), boost::ptr_container::ptr_back_inserter( _glyphs ), make_glyph( face ) );
+	std::transform( _text.begin(), _text.end(), boost::ptr_container::ptr_back_inserter( _glyphs ), make_glyph( _face->face() ) );
 
 	//Step 4. Make Metrics Array --------------------
-	std::transform( _glyphs.begin(), _glyphs.end(), std::back_inserter( _metrics ), terry::make_metric() );
+	_textGlyphs.reserve( _text.size() );
+	_metrics.reserve( _text.size() );
+	for( std::string::const_iterator it = _text.begin(); it != _text.end(); ++it )
+	{
+		const TextGlyph& glyph = _face->glyph( *it );
+		_textGlyphs.push_back( &glyph );
+		_metrics.push_back( glyph._metrics );
+	}
 
 	//Step 5. Make Kerning Array ----------------
-	std::transform( _glyphs.begin(), _glyphs.end(), std::back_inserter( _kerning ), terry::make_kerning() );
+	{
+		boost::lock_guard<boost::mutex> lock( _face->mutex() );
+		std::transform( _glyphs.begin(), _glyphs.end(), std::back_inserter( _kerning ), terry::make_kerning() );
+	}
 
 	//Step 6. Get Coordinates (x,y) ----------------
 	_textSize.x   = std::for_each( _metrics.begin(), _metrics.end(), _kerning.begin(), terry::make_width() );
@@ -214,6 +181,72 @@ void TextProcess<View, Functor>::setup( const OFX::RenderArguments& args )
 	_textCorner.x += _params._position.x;
 }
 
+/**
+ * @brief Draw rasterized glyphs one after the other (like terry::render_glyph, from the glyphs of a FontFace).
+ */
+template<typename View>
+class render_text_glyph
+{
+public:
+	typedef typename View::value_type Pixel;
+	typedef terry::Rect<std::ptrdiff_t> rect_t;
+	typedef boost::gil::point2<std::ptrdiff_t> point_t;
+
+private:
+	const View& _outView;
+	const Pixel _color;
+	const double _letterSpacing;
+	const rect_t _roi;
+	int _x;
+
+public:
+	render_text_glyph( const View& outView, const Pixel& color, const double letterSpacing, const rect_t& roi )
+		: _outView( outView )
+		, _color( color )
+		, _letterSpacing( letterSpacing )
+		, _roi( roi )
+		, _x( 0 )
+		{}
+
+	void operator()( const TextGlyph* glyph, int kerning = 0 )
+	{
+		using namespace terry;
+		_x += kerning;
+
+		const int y = _outView.height() - ( glyph->_metrics.horiBearingY >> 6 );
+		const rect_t glyphRod( _x, y, _x + glyph->_width, y + glyph->_height );
+		const rect_t glyphRoi = rectanglesIntersection( glyphRod, _roi );
+		const point_t glyphRegionSize = glyphRoi.size();
+
+		if( glyphRegionSize.x > 0 &&
+		    glyphRegionSize.y > 0 )
+		{
+			const rect_t glyphLocalRoi = translateRegion( glyphRoi, - glyphRod.x1, - glyphRod.y1 );
+			gray8c_view_t glyphView = interleaved_view( glyph->_width, glyph->_height,
+			                                            reinterpret_cast<const gray8_pixel_t*>( &glyph->_bitmap.front() ),
+			                                            sizeof(unsigned char) * glyph->_width );
+			gray8c_view_t glyphViewRoi = subimage_view( glyphView, glyphLocalRoi );
+			View outViewRoi = subimage_view( _outView, glyphRoi );
+
+			copy_and_convert_alpha_blended_pixels( color_converted_view<gray32f_pixel_t>( glyphViewRoi ), _color, outViewRoi );
+		}
+
+		_x += glyph->_advance;
+		_x += _letterSpacing;
+	}
+};
+
+/**
+ * @brief Rows of the window @p windowRoW in a view of the region @p rod oriented from top to bottom.
+ */
+inline OfxRectI topToBottomRegion( const OfxRectI& windowRoW, const OfxRectI& rod )
+{
+	const OfxRectI local = translateRegion( windowRoW, rod );
+	const int height = rod.y2 - rod.y1;
+	const OfxRectI region = { local.x1, height - local.y2, local.x2, height - local.y1 };
+	return region;
+}
+
 /**
  * @brief Function called by rendering thread each time a process must be done.
  * @param[in] procWindowRoW  Processing window in RoW
@@ -222,42 +255,43 @@ template<class View, class Functor>
 void TextProcess<View, Functor>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
 {
 	using namespace terry;
-	
+
+	// the views are from top to bottom, the windows of the threads from bottom to top
+	const OfxRectI procWindowOutput = topToBottomRegion( procWindowRoW, this->_dstPixelRod );
+	View dstWindow = subimage_view( this->_dstView, procWindowOutput.x1, procWindowOutput.y1,
+	                                procWindowOutput.x2 - procWindowOutput.x1, procWindowOutput.y2 - procWindowOutput.y1 );
+
 	rgba32f_pixel_t backgroundColor( _params._backgroundColor.r,
 		_params._backgroundColor.g,
 		_params._backgroundColor.b,
 		_params._backgroundColor.a );
-	fill_pixels( this->_dstView, backgroundColor );
-	
-	OfxRectI procWindowOutput = translateRegion( procWindowRoW, this->_dstPixelRod );
+	fill_pixels( dstWindow, backgroundColor );
 
 	if( _clipSrc->isConnected() )
 	{
-		//merge_views( this->_dstView, _srcView, this->_dstView, FunctorMatte<Pixel>() );
-		merge_views( this->_dstView, _srcView, this->_dstView, Functor() );
+		const OfxRectI mergeRoW = rectanglesIntersection( procWindowRoW, _srcPixelRod );
+		if( mergeRoW.x2 > mergeRoW.x1 && mergeRoW.y2 > mergeRoW.y1 )
+		{
+			const OfxRectI mergeDst = topToBottomRegion( mergeRoW, this->_dstPixelRod );
+			const OfxRectI mergeSrc = topToBottomRegion( mergeRoW, _srcPixelRod );
+			View dstMerge = subimage_view( this->_dstView, mergeDst.x1, mergeDst.y1, mergeDst.x2 - mergeDst.x1, mergeDst.y2 - mergeDst.y1 );
+			View srcMerge = subimage_view( _srcView, mergeSrc.x1, mergeSrc.y1, mergeSrc.x2 - mergeSrc.x1, mergeSrc.y2 - mergeSrc.y1 );
+			//merge_views( dstMerge, srcMerge, dstMerge, FunctorMatte<Pixel>() );
+			merge_views( dstMerge, srcMerge, dstMerge, Functor() );
+		}
 	}
 	
 	//Step 7. Render Glyphs ------------------------
-	// if outside dstRod
-	// ...
-	// else
+	// only inside the window of this thread, in the coordinates of the view of the glyphs
+	const OfxRectI glyphsWindow = _params._verticalFlip ? translateRegion( procWindowRoW, this->_dstPixelRod ) : procWindowOutput;
 	const OfxRectI textRod = { _textCorner.x, _textCorner.y, _textCorner.x + _textSize.x, _textCorner.y + _textSize.y + _textSize.y / 3};
-	const OfxRectI textRoi = rectanglesIntersection( textRod, procWindowOutput );
+	const OfxRectI textRoi = rectanglesIntersection( textRod, glyphsWindow );
 	const OfxRectI textLocalRoi = translateRegion( textRoi, - _textCorner );
 	
-	//TUTTLE_LOG_VAR( TUTTLE_INFO, _textSize );
-	//TUTTLE_LOG_VAR( TUTTLE_INFO, _textCorner );
-	
-	//TUTTLE_LOG_VAR( TUTTLE_INFO, textRod );
-	//TUTTLE_LOG_VAR( TUTTLE_INFO, procWindowRoW );
-	//TUTTLE_LOG_VAR( TUTTLE_INFO, textRoi );
-	//TUTTLE_LOG_VAR( TUTTLE_INFO, textLocalRoi );
-	//TUTTLE_LOG_VAR2( TUTTLE_INFO, _dstViewForGlyphs.width(), _dstViewForGlyphs.height() );
-	
 	View tmpDstViewForGlyphs = subimage_view( _dstViewForGlyphs, _textCorner.x, _textCorner.y, _textSize.x, _textSize.y);
 	
-	std::for_each( _glyphs.begin(), _glyphs.end(), _kerning.begin(),
-	               render_glyph<View>( tmpDstViewForGlyphs, _foregroundColor, _params._letterSpacing, Rect<std::ptrdiff_t>(textLocalRoi) )
+	std::for_each( _textGlyphs.begin(), _textGlyphs.end(), _kerning.begin(),
+	               render_text_glyph<View>( tmpDstViewForGlyphs, _foregroundColor, _params._letterSpacing, Rect<std::ptrdiff_t>(textLocalRoi) )
 	               );
 }
 
@@ -0,0 +1,171 @@
+#include "AVReaderDecodeAhead.hpp"
+
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <algorithm>
+
+namespace tuttle {
+namespace plugin {
+namespace av {
+namespace reader {
+
+AVReaderDecodeAhead::AVReaderDecodeAhead( avtranscoder::InputFile& inputFile,
+                                          avtranscoder::VideoDecoder& decoder,
+                                          const avtranscoder::VideoFrameDesc& frameDesc,
+                                          const AVReaderFrameIndex& index,
+                                          const size_t nbFramesAhead )
+	: _inputFile( inputFile )
+	, _decoder( decoder )
+	, _frameDesc( frameDesc )
+	, _index( index )
+	, _nbFramesAhead( std::max<int>( nbFramesAhead, 1 ) )
+	, _requestedFrame( -1 )
+	, _nextFrame( -1 ) // unknown position of the decoder
+	, _seekRequested( false )
+	, _endOfStream( false )
+	, _stop( false )
+	, _thread( boost::bind( &AVReaderDecodeAhead::run, this ) )
+{}
+
+AVReaderDecodeAhead::~AVReaderDecodeAhead()
+{
+	{
+		boost::lock_guard<boost::mutex> lock( _mutex );
+		_stop = true;
+	}
+	_condition.notify_all();
+	_thread.join();
+}
+
+AVReaderDecodeAhead::FramePtr AVReaderDecodeAhead::getFrame( const int frame )
+{
+	boost::unique_lock<boost::mutex> lock( _mutex );
+
+	_requestedFrame = frame;
+	releaseFramesBefore( frame );
+
+	if( _frames.find( frame ) == _frames.end() && ! _seekRequested )
+	{
+		// The frame will come from the current decoding position if it's just after,
+		// or if there is no key frame between the decoding position and the frame.
+		const bool isAhead = _nextFrame >= 0 && frame >= _nextFrame;
+		const bool decodeFromPosition = isAhead &&
+			( frame < _nextFrame + _nbFramesAhead || _index.getKeyFrame( frame ) <= _nextFrame );
+
+		if( isAhead && _endOfStream )
+			return FramePtr();
+		if( ! decodeFromPosition )
+			_seekRequested = true;
+	}
+	_condition.notify_all();
+
+	std::map<int, FramePtr>::const_iterator it;
+	while( ( it = _frames.find( frame ) ) == _frames.end() )
+	{
+		if( _stop )
+			return FramePtr();
+		if( ! _seekRequested && _endOfStream && _nextFrame <= frame )
+			return FramePtr();
+		_condition.wait( lock );
+	}
+	return it->second;
+}
+
+void AVReaderDecodeAhead::run()
+{
+	boost::unique_lock<boost::mutex> lock( _mutex );
+	while( ! _stop )
+	{
+		if( _seekRequested )
+		{
+			_seekRequested = false;
+			releaseAllFrames();
+			const int keyFrame = std::max( _index.getKeyFrame( _requestedFrame ), 0 );
+
+			lock.unlock();
+			_inputFile.seekAtFrame( keyFrame );
+			_decoder.flushDecoder();
+			lock.lock();
+
+			_nextFrame = keyFrame;
+			_endOfStream = false;
+			continue;
+		}
+
+		if( _requestedFrame < 0 || _endOfStream || _nextFrame >= _requestedFrame + _nbFramesAhead )
+		{
+			_condition.wait( lock );
+			continue;
+		}
+
+		FramePtr decodedFrame = allocateFrame();
+		const int frame = _nextFrame;
+
+		lock.unlock();
+		bool decoded = false;
+		try
+		{
+			decoded = _decoder.decodeNextFrame( *decodedFrame );
+		}
+		catch( ... )
+		{}
+		lock.lock();
+
+		if( _seekRequested || ! decoded || frame < _requestedFrame )
+		{
+			// out of date, or a frame before the requested one (from the key frame)
+			_freeFrames.push_back( decodedFrame );
+		}
+		else
+		{
+			_frames[frame] = decodedFrame;
+		}
+
+		if( ! _seekRequested )
+		{
+			if( decoded )
+				++_nextFrame;
+			else
+				_endOfStream = true;
+		}
+		_condition.notify_all();
+	}
+}
+
+AVReaderDecodeAhead::FramePtr AVReaderDecodeAhead::allocateFrame()
+{
+	if( _freeFrames.empty() )
+		return FramePtr( new avtranscoder::VideoFrame( _frameDesc ) );
+
+	FramePtr frame = _freeFrames.back();
+	_freeFrames.pop_back();
+	return frame;
+}
+
+void AVReaderDecodeAhead::releaseFramesBefore( const int frame )
+{
+	std::map<int, FramePtr>::iterator it = _frames.begin();
+	while( it != _frames.end() && it->first < frame )
+	{
+		// a frame still used by a render is not reused
+		if( it->second.unique() )
+			_freeFrames.push_back( it->second );
+		_frames.erase( it++ );
+	}
+}
+
+void AVReaderDecodeAhead::releaseAllFrames()
+{
+	for( std::map<int, FramePtr>::iterator it = _frames.begin(); it != _frames.end(); ++it )
+	{
+		if( it->second.unique() )
+			_freeFrames.push_back( it->second );
+	}
+	_frames.clear();
+}
+
+}
+}
+}
+}
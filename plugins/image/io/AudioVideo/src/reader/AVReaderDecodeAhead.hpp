@@ -0,0 +1,90 @@
+#ifndef _TUTTLE_PLUGIN_AV_READER_DECODE_AHEAD_HPP_
+#define _TUTTLE_PLUGIN_AV_READER_DECODE_AHEAD_HPP_
+
+#include "AVReaderFrameIndex.hpp"
+
+#include <AvTranscoder/file/InputFile.hpp>
+#include <AvTranscoder/decoder/VideoDecoder.hpp>
+#include <AvTranscoder/frame/VideoFrame.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <map>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace av {
+namespace reader {
+
+/**
+ * @brief Decode the video stream on a background thread.
+ *
+ * The thread decodes up to nbFramesAhead frames after the last requested frame,
+ * so the decoding of the next frames overlaps the rendering of the current one.
+ * On a non sequential access, it seeks at the key frame given by the index
+ * and decodes until the requested frame (frame accurate).
+ *
+ * Once started, the input file and the decoder are only used by the background thread.
+ */
+class AVReaderDecodeAhead
+{
+public:
+	typedef boost::shared_ptr<avtranscoder::VideoFrame> FramePtr;
+
+public:
+	AVReaderDecodeAhead( avtranscoder::InputFile& inputFile,
+	                     avtranscoder::VideoDecoder& decoder,
+	                     const avtranscoder::VideoFrameDesc& frameDesc,
+	                     const AVReaderFrameIndex& index,
+	                     const size_t nbFramesAhead );
+
+	/// Stop and join the decoding thread
+	~AVReaderDecodeAhead();
+
+	/**
+	 * @brief Get a decoded frame, wait for the decoding thread if needed.
+	 * @return NULL if the frame can't be decoded.
+	 */
+	FramePtr getFrame( const int frame );
+
+private:
+	void run();
+
+	/// @warning _mutex must be locked
+	FramePtr allocateFrame();
+	/// @warning _mutex must be locked
+	void releaseFramesBefore( const int frame );
+	/// @warning _mutex must be locked
+	void releaseAllFrames();
+
+private:
+	avtranscoder::InputFile& _inputFile;
+	avtranscoder::VideoDecoder& _decoder;
+	const avtranscoder::VideoFrameDesc _frameDesc;
+	const AVReaderFrameIndex& _index;
+	const int _nbFramesAhead;
+
+	boost::mutex _mutex;
+	boost::condition_variable _condition;
+
+	std::map<int, FramePtr> _frames;    ///< decoded frames, indexed by frame number
+	std::vector<FramePtr> _freeFrames;  ///< frames buffers to reuse
+	int _requestedFrame;                ///< last frame asked by the render
+	int _nextFrame;                     ///< next frame which will be returned by the decoder
+	bool _seekRequested;
+	bool _endOfStream;
+	bool _stop;
+
+	boost::thread _thread;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -24,6 +24,9 @@ static const std::string kParamCustomSAR = common::kPrefixVideo + "customSAR";
 static const std::string kParamVideoStreamIndex      = common::kPrefixVideo + "streamIndex";
 static const std::string kParamVideoStreamIndexLabel = "Video stream index";
 
+static const std::string kParamDecodeAhead      = common::kPrefixVideo + "decodeAhead";
+static const std::string kParamDecodeAheadLabel = "Decode ahead";
+
 static const std::string kParamMetaDataWrapper = common::kPrefixMetaData + "wrapper";
 static const std::string kParamMetaDataWrapperLabel = "Wrapper";
 static const std::string kParamMetaDataVideo = common::kPrefixMetaData + "video";
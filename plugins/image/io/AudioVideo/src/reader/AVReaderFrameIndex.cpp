@@ -0,0 +1,97 @@
+#include "AVReaderFrameIndex.hpp"
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#include <algorithm>
+#include <utility>
+
+namespace tuttle {
+namespace plugin {
+namespace av {
+namespace reader {
+
+AVReaderFrameIndex::AVReaderFrameIndex()
+	: _filepath( "" )
+	, _videoStreamIndex( 0 )
+	, _keyFrames()
+{}
+
+void AVReaderFrameIndex::clear()
+{
+	_filepath = "";
+	_videoStreamIndex = 0;
+	_keyFrames.clear();
+}
+
+bool AVReaderFrameIndex::build( const std::string& filepath, const size_t videoStreamIndex )
+{
+	clear();
+	_filepath = filepath;
+	_videoStreamIndex = videoStreamIndex;
+
+	AVFormatContext* formatContext = NULL;
+	if( avformat_open_input( &formatContext, filepath.c_str(), NULL, NULL ) < 0 )
+		return false;
+
+	if( avformat_find_stream_info( formatContext, NULL ) < 0 )
+	{
+		avformat_close_input( &formatContext );
+		return false;
+	}
+
+	// get the absolute index of the n-th video stream
+	int streamIndex = -1;
+	size_t nbVideoStreams = 0;
+	for( unsigned int i = 0; i < formatContext->nb_streams; ++i )
+	{
+		if( formatContext->streams[i]->codec->codec_type != AVMEDIA_TYPE_VIDEO )
+			continue;
+		if( nbVideoStreams == videoStreamIndex )
+		{
+			streamIndex = i;
+			break;
+		}
+		++nbVideoStreams;
+	}
+	if( streamIndex < 0 )
+	{
+		avformat_close_input( &formatContext );
+		return false;
+	}
+
+	// packets are in decoding order: keep their timestamp to sort them in presentation order
+	std::vector< std::pair<int64_t, bool> > packets;
+	AVPacket packet;
+	av_init_packet( &packet );
+	while( av_read_frame( formatContext, &packet ) >= 0 )
+	{
+		if( packet.stream_index == streamIndex )
+		{
+			int64_t timestamp = packet.pts != AV_NOPTS_VALUE ? packet.pts : packet.dts;
+			if( timestamp == AV_NOPTS_VALUE )
+				timestamp = packets.empty() ? 0 : packets.back().first + 1;
+			packets.push_back( std::make_pair( timestamp, ( packet.flags & AV_PKT_FLAG_KEY ) != 0 ) );
+		}
+		av_free_packet( &packet );
+	}
+	avformat_close_input( &formatContext );
+
+	std::stable_sort( packets.begin(), packets.end() );
+
+	_keyFrames.resize( packets.size() );
+	int lastKeyFrame = 0;
+	for( size_t i = 0; i < packets.size(); ++i )
+	{
+		if( packets[i].second )
+			lastKeyFrame = i;
+		_keyFrames[i] = lastKeyFrame;
+	}
+	return true;
+}
+
+}
+}
+}
+}
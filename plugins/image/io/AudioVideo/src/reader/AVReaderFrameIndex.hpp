@@ -0,0 +1,61 @@
+#ifndef _TUTTLE_PLUGIN_AV_READER_FRAME_INDEX_HPP_
+#define _TUTTLE_PLUGIN_AV_READER_FRAME_INDEX_HPP_
+
+#include <string>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace av {
+namespace reader {
+
+/**
+ * @brief Index of the key frames of a video stream.
+ * It is built once per file by reading all the packets of the stream (without decoding),
+ * and gives in O(1) the key frame to seek at before decoding any frame.
+ */
+class AVReaderFrameIndex
+{
+public:
+	AVReaderFrameIndex();
+
+	/**
+	 * @brief Scan the packets of the video stream.
+	 * @param videoStreamIndex: index of the stream among the video streams of the file
+	 * @return false if the file can't be indexed (the index is then empty).
+	 */
+	bool build( const std::string& filepath, const size_t videoStreamIndex );
+
+	void clear();
+
+	bool isBuiltFor( const std::string& filepath, const size_t videoStreamIndex ) const
+	{
+		return _filepath == filepath && _videoStreamIndex == videoStreamIndex;
+	}
+
+	bool empty() const { return _keyFrames.empty(); }
+	size_t getNbFrames() const { return _keyFrames.size(); }
+
+	/**
+	 * @brief Get the closest key frame before @p frame (in presentation order).
+	 * If the frame is out of the index, return the frame itself.
+	 */
+	int getKeyFrame( const int frame ) const
+	{
+		if( frame < 0 || frame >= static_cast<int>( _keyFrames.size() ) )
+			return frame;
+		return _keyFrames[frame];
+	}
+
+private:
+	std::string _filepath;
+	size_t _videoStreamIndex;
+	std::vector<int> _keyFrames; ///< for each frame, the key frame to start decoding from
+};
+
+}
+}
+}
+}
+
+#endif
@@ -29,16 +29,18 @@ AVReaderPlugin::AVReaderPlugin( OfxImageEffectHandle handle )
 	, _paramVideoDetailCustom( common::kPrefixVideo, AV_OPT_FLAG_DECODING_PARAM | AV_OPT_FLAG_VIDEO_PARAM, true )
 	, _inputFile( NULL )
 	, _inputStreamVideo( NULL )
-	, _sourceImage( NULL )
 	, _imageToDecode( NULL )
+	, _frameIndex()
+	, _decodeAhead( NULL )
+	, _swsContext( NULL )
 	, _lastInputFilePath( "" )
 	, _lastVideoStreamIndex( 0 )
-	, _lastFrame( -1 )
 	, _initVideo( false )
 {
 	_clipDst = fetchClip( kOfxImageEffectOutputClipName );
 
 	_paramVideoStreamIndex = fetchIntParam( kParamVideoStreamIndex );
+	_paramDecodeAhead = fetchIntParam( kParamDecodeAhead );
 	_paramUseCustomSAR = fetchBooleanParam( kParamUseCustomSAR );
 	_paramCustomSAR = fetchDoubleParam( kParamCustomSAR );
 
@@ -75,6 +77,12 @@ AVReaderPlugin::AVReaderPlugin( OfxImageEffectHandle handle )
 	updateVisibleTools();
 }
 
+AVReaderPlugin::~AVReaderPlugin()
+{
+	_decodeAhead.reset();
+	sws_freeContext( _swsContext );
+}
+
 void AVReaderPlugin::ensureVideoIsOpen()
 {
 	const std::string& filepath = _paramFilepath->getValue();
@@ -94,6 +102,9 @@ void AVReaderPlugin::ensureVideoIsOpen()
 	
 	try
 	{
+		// the decoding thread uses the previous input file
+		_decodeAhead.reset();
+
 		// set and analyse inputFile
 		_inputFile.reset( new avtranscoder::InputFile( filepath ) );
 		_lastInputFilePath = filepath;
@@ -126,10 +137,11 @@ void AVReaderPlugin::ensureVideoIsOpen()
 
 void AVReaderPlugin::cleanInputFile()
 {
+	_decodeAhead.reset();
 	_inputFile.reset();
 	_inputStreamVideo.reset();
-	_sourceImage.reset();
 	_imageToDecode.reset();
+	_frameIndex.clear();
 	_lastInputFilePath = "";
 	_lastVideoStreamIndex = 0;
 	_initVideo = false;
@@ -467,17 +479,29 @@ void AVReaderPlugin::beginSequenceRender( const OFX::BeginSequenceRenderArgument
 	ReaderPlugin::beginSequenceRender( args );
 
 	ensureVideoIsOpen();
+	_decodeAhead.reset();
 
 	_inputFile->setProfile( _paramFormatCustom.getCorrespondingProfile() );
-	_inputStreamVideo->setProfile( _paramVideoCustom.getCorrespondingProfile() );
+
+	// use libav frame/slice threading, with an automatic number of threads by default
+	avtranscoder::ProfileLoader::Profile videoProfile = _paramVideoCustom.getCorrespondingProfile();
+	if( videoProfile.find( common::kOptionThreads ) == videoProfile.end() )
+		videoProfile[ common::kOptionThreads ] = "0";
+	_inputStreamVideo->setProfile( videoProfile );
 
 	// get source image
 	const avtranscoder::VideoFrameDesc sourceImageDesc( _inputFile->getStream( _paramVideoStreamIndex->getValue() ).getVideoCodec().getVideoFrameDesc() );
-	_sourceImage.reset( new avtranscoder::VideoFrame( sourceImageDesc ) );
 
 	// get image to decode
 	const avtranscoder::VideoFrameDesc imageToDecodeDesc( sourceImageDesc.getWidth(), sourceImageDesc.getHeight(), "rgb24" );
 	_imageToDecode.reset( new avtranscoder::VideoFrame( imageToDecodeDesc ) );
+
+	// the index is built only once per file
+	const size_t videoStreamIndex = _paramVideoStreamIndex->getValue();
+	if( ! _frameIndex.isBuiltFor( _lastInputFilePath, videoStreamIndex ) )
+		_frameIndex.build( _lastInputFilePath, videoStreamIndex );
+
+	_decodeAhead.reset( new AVReaderDecodeAhead( *_inputFile, *_inputStreamVideo, sourceImageDesc, _frameIndex, _paramDecodeAhead->getValue() ) );
 }
 
 void AVReaderPlugin::render( const OFX::RenderArguments& args )
@@ -489,6 +513,14 @@ void AVReaderPlugin::render( const OFX::RenderArguments& args )
 	doGilRender<AVReaderProcess>( *this, args );
 }
 
+void AVReaderPlugin::endSequenceRender( const OFX::EndSequenceRenderArguments& args )
+{
+	// stop the decoding thread, the decoder could be modified outside of a sequence render
+	_decodeAhead.reset();
+
+	ReaderPlugin::endSequenceRender( args );
+}
+
 }
 }
 }
@@ -1,6 +1,9 @@
 #ifndef _TUTTLE_PLUGIN_AV_READER_PLUGIN_HPP_
 #define _TUTTLE_PLUGIN_AV_READER_PLUGIN_HPP_
 
+#include "AVReaderFrameIndex.hpp"
+#include "AVReaderDecodeAhead.hpp"
+
 #include <common/util.hpp>
 
 #include <tuttle/plugin/context/ReaderPlugin.hpp>
@@ -11,6 +14,10 @@
 #include <AvTranscoder/frame/VideoFrame.hpp>
 #include <AvTranscoder/transform/VideoTransform.hpp>
 
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
 #include <boost/scoped_ptr.hpp>
 
 #include <string>
@@ -32,6 +39,7 @@ class AVReaderPlugin : public ReaderPlugin
 {
 public:
 	AVReaderPlugin( OfxImageEffectHandle handle );
+	~AVReaderPlugin();
 
 public:
 	void ensureVideoIsOpen();
@@ -48,6 +56,7 @@ public:
 
 	void beginSequenceRender( const OFX::BeginSequenceRenderArguments& args );
 	void render( const OFX::RenderArguments& args );
+	void endSequenceRender( const OFX::EndSequenceRenderArguments& args );
 
 	inline bool varyOnTime() const { return true; }
 
@@ -63,6 +72,7 @@ public:
 	OFX::Clip*         _clipDst;           ///< Destination image clip
 
 	OFX::IntParam* _paramVideoStreamIndex; ///< video stream index
+	OFX::IntParam* _paramDecodeAhead;      ///< number of frames decoded in advance
 	OFX::BooleanParam* _paramUseCustomSAR; ///< Keep sample aspect ratio
 	OFX::DoubleParam*  _paramCustomSAR;    ///< Custom SAR to use
 	
@@ -85,16 +95,17 @@ public:
 	
 	boost::scoped_ptr<avtranscoder::InputFile> _inputFile;
 	boost::scoped_ptr<avtranscoder::VideoDecoder> _inputStreamVideo;
-	boost::scoped_ptr<avtranscoder::VideoFrame> _sourceImage;
 	boost::scoped_ptr<avtranscoder::VideoFrame> _imageToDecode;
 	
+	AVReaderFrameIndex _frameIndex; ///< key frames of the video stream, built once per file
+	boost::scoped_ptr<AVReaderDecodeAhead> _decodeAhead; ///< decoding thread, during a sequence render
+	
 	avtranscoder::VideoTransform _colorTransform;
+	SwsContext* _swsContext; ///< to convert the decoded frames directly into the output buffer
 	
 	std::string _lastInputFilePath;
 	size_t _lastVideoStreamIndex;
 	
-	int _lastFrame;
-	
 	bool _initVideo;
 };
 
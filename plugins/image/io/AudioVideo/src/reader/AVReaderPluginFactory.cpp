@@ -154,6 +154,14 @@ void AVReaderPluginFactory::describeInContext( OFX::ImageEffectDescriptor& desc,
 	streamIndex->setHint( "Choose a custom value to decode the video stream you want. Maximum value: 100." );
 	streamIndex->setParent( videoGroup );
 
+	OFX::IntParamDescriptor* decodeAhead = desc.defineIntParam( kParamDecodeAhead );
+	decodeAhead->setLabel( kParamDecodeAheadLabel );
+	decodeAhead->setDefault( 8 );
+	decodeAhead->setDisplayRange( 1., 32. );
+	decodeAhead->setRange( 1., 256. );
+	decodeAhead->setHint( "Number of frames decoded in advance on a background thread during a sequence render." );
+	decodeAhead->setParent( videoGroup );
+
 	OFX::GroupParamDescriptor* videoDetailedGroup  = desc.defineGroupParam( kParamVideoDetailedGroup );
 	videoDetailedGroup->setLabel( "Detailed" );
 	videoDetailedGroup->setAsTab( );
@@ -22,6 +22,7 @@ class AVReaderProcess : public ImageGilProcessor<View>
 {
 protected:
 	AVReaderPlugin& _plugin;
+	AVReaderDecodeAhead::FramePtr _frame; ///< decoded frame to render
 
 public:
 	AVReaderProcess( AVReaderPlugin& instance );
@@ -29,6 +30,12 @@ public:
 	void setup( const OFX::RenderArguments& args );
 	void multiThreadProcessImages( const OfxRectI& procWindowRoW );
 	
+	/**
+	 * @brief Convert the decoded frame directly into the output view with swscale.
+	 * @return false if the output pixel type has no libav equivalent.
+	 */
+	bool convertIntoView( View& dst, avtranscoder::VideoFrame& frame );
+
 	template<typename FileView>
 	View& readImage( View& dst, avtranscoder::VideoFrame& image );
 };
@@ -1,12 +1,81 @@
 #include "AVReaderProcess.hpp"
 
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
 #include <boost/gil/gil_all.hpp>
+#include <boost/mpl/bool.hpp>
 
 namespace tuttle {
 namespace plugin {
 namespace av {
 namespace reader {
 
+/**
+ * @brief libav pixel format to convert directly into a view of this pixel type.
+ */
+template<class Pixel>
+struct av_pixel_format { static const PixelFormat value = PIX_FMT_NONE; };
+
+template<>
+struct av_pixel_format<boost::gil::rgb8_pixel_t> { static const PixelFormat value = PIX_FMT_RGB24; };
+
+template<>
+struct av_pixel_format<boost::gil::rgba8_pixel_t> { static const PixelFormat value = PIX_FMT_RGBA; };
+
+template<>
+struct av_pixel_format<boost::gil::gray8_pixel_t> { static const PixelFormat value = PIX_FMT_GRAY8; };
+
+template<>
+struct av_pixel_format<boost::gil::rgb16_pixel_t> { static const PixelFormat value = PIX_FMT_RGB48; };
+
+template<>
+struct av_pixel_format<boost::gil::gray16_pixel_t> { static const PixelFormat value = PIX_FMT_GRAY16; };
+
+/**
+ * @brief Convert the frame with swscale, writing directly into the output buffer.
+ * The output view is top to bottom: swscale writes from its first row with the row size
+ * of the view, which is negative if the buffer is stored from bottom to top.
+ */
+template<class View>
+bool convertFrameIntoView( SwsContext*& context, avtranscoder::VideoFrame& frame, View& dst, const boost::mpl::true_ )
+{
+	const avtranscoder::VideoFrameDesc& desc = frame.desc();
+	const int width = desc.getWidth();
+	const int height = desc.getHeight();
+	if( dst.width() != width || dst.height() != height )
+		return false;
+
+	const PixelFormat srcPixelFormat = desc.getPixelFormat();
+	const PixelFormat dstPixelFormat = av_pixel_format<typename View::value_type>::value;
+
+	context = sws_getCachedContext( context,
+		width, height, srcPixelFormat,
+		width, height, dstPixelFormat,
+		SWS_POINT, NULL, NULL, NULL );
+	if( context == NULL )
+		return false;
+
+	uint8_t* srcData[4];
+	int srcLinesize[4];
+	av_image_fill_linesizes( srcLinesize, srcPixelFormat, width );
+	av_image_fill_pointers( srcData, srcPixelFormat, height, frame.getData(), srcLinesize );
+
+	uint8_t* dstData[4] = { reinterpret_cast<uint8_t*>( &dst( 0, 0 ) ), NULL, NULL, NULL };
+	const int dstLinesize[4] = { static_cast<int>( dst.pixels().row_size() ), 0, 0, 0 };
+
+	sws_scale( context, srcData, srcLinesize, 0, height, dstData, dstLinesize );
+	return true;
+}
+
+template<class View>
+bool convertFrameIntoView( SwsContext*&, avtranscoder::VideoFrame&, View&, const boost::mpl::false_ )
+{
+	return false;
+}
+
 template<class View>
 AVReaderProcess<View>::AVReaderProcess( AVReaderPlugin& instance )
 	: ImageGilProcessor<View>( instance, eImageOrientationFromTopToBottom )
@@ -22,24 +91,21 @@ void AVReaderProcess<View>::setup( const OFX::RenderArguments& args )
 
 	// if need to support interlace, use args.fieldToRender
 	
-	// optimization for seek
-	if( ( _plugin._lastFrame + 1 ) != args.time )
+	if( ! _plugin._decodeAhead )
 	{
-		_plugin._inputFile->seekAtFrame( args.time );
-		_plugin._inputStreamVideo->flushDecoder();
+		BOOST_THROW_EXCEPTION( exception::Failed()
+		    << exception::dev() + "Render outside of a sequence render."
+		    << exception::filename( _plugin._paramFilepath->getValue() ) );
 	}
-	
-	_plugin._lastFrame = args.time;
-	
-	// Fetch output image
-	if( ! _plugin._inputStreamVideo->decodeNextFrame( *_plugin._sourceImage ) )
+
+	// Fetch the decoded frame (seek, decode or wait for the decoding thread)
+	_frame = _plugin._decodeAhead->getFrame( args.time );
+	if( ! _frame )
 	{
 		BOOST_THROW_EXCEPTION( exception::Failed()
 		    << exception::user() + "Can't open the frame at time " + args.time
 		    << exception::filename( _plugin._paramFilepath->getValue() ) );
 	}
-	
-	_plugin._colorTransform.convert( *_plugin._sourceImage, *_plugin._imageToDecode );
 }
 
 /**
@@ -52,59 +118,21 @@ void AVReaderProcess<View>::multiThreadProcessImages( const OfxRectI& procWindow
 	using namespace boost::gil;
 	BOOST_ASSERT( procWindowRoW == this->_dstPixelRod );
 
-	avtranscoder::PixelProperties pixel( _plugin._inputFile->getProperties().getVideoProperties().at( _plugin._paramVideoStreamIndex->getValue() ).getPixelProperties() );
-	size_t components = pixel.getNbComponents();
-	size_t bitDepth = 8; // @todo: waiting for getMaxBitPerChannel() in avTranscoder
-	
-	switch( bitDepth )
-	{
-		case 8:
-			switch( components )
-			{
-				case 3:
-					readImage<rgb8c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-				case 4:
-					readImage<rgba8c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-				default:
-					readImage<gray8c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-			}
-			break;
-		case 16:
-			switch( components )
-			{
-				case 3:
-					readImage<rgb16c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-				case 4:
-					readImage<rgba16c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-				default:
-					readImage<gray16c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-			}
-			break;
-		case 32:
-			switch( components )
-			{
-				case 3:
-					readImage<rgb32c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-				case 4:
-					readImage<rgba32c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-				default:
-					readImage<gray32c_view_t>( this->_dstView, *_plugin._imageToDecode );
-					break;
-			}
-			break;
-		default:
-			readImage<gray16c_view_t>( this->_dstView, *_plugin._imageToDecode );
-			break;
-			
-	}
+	if( convertIntoView( this->_dstView, *_frame ) )
+		return;
+
+	// Output pixel type without libav equivalent: convert to rgb24 and copy.
+	_plugin._colorTransform.convert( *_frame, *_plugin._imageToDecode );
+	readImage<rgb8c_view_t>( this->_dstView, *_plugin._imageToDecode );
+}
+
+template<class View>
+bool AVReaderProcess<View>::convertIntoView( View& dst, avtranscoder::VideoFrame& frame )
+{
+	typedef typename View::value_type Pixel;
+	typedef boost::mpl::bool_<( av_pixel_format<Pixel>::value != PIX_FMT_NONE ) && ! boost::gil::is_planar<View>::value> IsDirectlyConvertible;
+
+	return convertFrameIntoView( _plugin._swsContext, frame, dst, IsDirectlyConvertible() );
 }
 
 template<class View>
@@ -115,8 +143,7 @@ View& AVReaderProcess<View>::readImage( View& dst, avtranscoder::VideoFrame& ima
 
 	size_t width = image.desc().getWidth();
 	size_t height = image.desc().getHeight();
-	avtranscoder::PixelProperties pixel = _plugin._inputFile->getProperties().getVideoProperties().at( _plugin._paramVideoStreamIndex->getValue() ).getPixelProperties();
-	size_t rowSizeInBytes = pixel.getNbComponents() * width;
+	size_t rowSizeInBytes = sizeof( Pixel ) * width;
 
 	FileView avSrcView = interleaved_view( 
 		width, height,
@@ -45,6 +45,8 @@ static const std::string kParamCustomFps                 = common::kPrefixVideo
 static const std::string kParamUseCustomSize             = common::kPrefixVideo + "useCustomSize";
 static const std::string kParamCustomSize                = common::kPrefixVideo + "customSize";
 
+static const std::string kParamEncodeQueueSize           = common::kPrefixVideo + "encodeQueueSize";
+
 static const std::string kParamVideoCodecPixelFmt        = common::kPrefixVideo + "pixelFormat";
 static const std::string kParamAudioCodecSampleFmt       = common::kPrefixAudio + "sampleFormat";
 
@@ -0,0 +1,135 @@
+#include "AVWriterEncodeQueue.hpp"
+
+#include <boost/bind/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace tuttle {
+namespace plugin {
+namespace av {
+namespace writer {
+
+AVWriterEncodeQueue::AVWriterEncodeQueue( const EncodeFunction& encode, const size_t maxSize )
+	: _encode( encode )
+	, _maxSize( maxSize > 0 ? maxSize : 1 )
+	, _encoding( false )
+	, _stop( false )
+	, _nbWaits( 0 )
+	, _waitDuration()
+	, _thread( boost::bind( &AVWriterEncodeQueue::run, this ) )
+{}
+
+AVWriterEncodeQueue::~AVWriterEncodeQueue()
+{
+	stop();
+}
+
+AVWriterEncodeQueue::BufferPtr AVWriterEncodeQueue::getBuffer( const size_t size )
+{
+	BufferPtr buffer;
+	{
+		boost::lock_guard<boost::mutex> lock( _mutex );
+		if( ! _freeBuffers.empty() )
+		{
+			buffer = _freeBuffers.back();
+			_freeBuffers.pop_back();
+		}
+	}
+	if( ! buffer )
+		buffer.reset( new Buffer() );
+	buffer->resize( size );
+	return buffer;
+}
+
+void AVWriterEncodeQueue::push( const BufferPtr& buffer )
+{
+	boost::unique_lock<boost::mutex> lock( _mutex );
+	rethrowEncodingError();
+
+	if( _queue.size() >= _maxSize )
+	{
+		++_nbWaits;
+		const boost::posix_time::ptime t1( boost::posix_time::microsec_clock::local_time() );
+		while( _queue.size() >= _maxSize && ! _error )
+			_condition.wait( lock );
+		const boost::posix_time::ptime t2( boost::posix_time::microsec_clock::local_time() );
+		_waitDuration += t2 - t1;
+		rethrowEncodingError();
+	}
+
+	_queue.push_back( buffer );
+	_condition.notify_all();
+}
+
+void AVWriterEncodeQueue::flush()
+{
+	{
+		boost::unique_lock<boost::mutex> lock( _mutex );
+		while( ( ! _queue.empty() || _encoding ) && ! _error )
+			_condition.wait( lock );
+	}
+	stop();
+
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	rethrowEncodingError();
+}
+
+void AVWriterEncodeQueue::stop()
+{
+	{
+		boost::lock_guard<boost::mutex> lock( _mutex );
+		_stop = true;
+	}
+	_condition.notify_all();
+	if( _thread.joinable() )
+		_thread.join();
+}
+
+void AVWriterEncodeQueue::rethrowEncodingError()
+{
+	if( _error )
+		boost::rethrow_exception( _error );
+}
+
+void AVWriterEncodeQueue::run()
+{
+	boost::unique_lock<boost::mutex> lock( _mutex );
+	while( ! _stop )
+	{
+		if( _queue.empty() || _error )
+		{
+			_condition.wait( lock );
+			continue;
+		}
+
+		BufferPtr buffer = _queue.front();
+		_queue.pop_front();
+		_encoding = true;
+		// there is a free place in the queue
+		_condition.notify_all();
+
+		lock.unlock();
+		try
+		{
+			_encode( *buffer );
+		}
+		catch( ... )
+		{
+			lock.lock();
+			_error = boost::current_exception();
+			_encoding = false;
+			_condition.notify_all();
+			continue;
+		}
+		lock.lock();
+
+		_freeBuffers.push_back( buffer );
+		_encoding = false;
+		_condition.notify_all();
+	}
+}
+
+}
+}
+}
+}
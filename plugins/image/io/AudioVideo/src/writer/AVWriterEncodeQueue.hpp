@@ -0,0 +1,94 @@
+#ifndef _TUTTLE_PLUGIN_AV_WRITER_ENCODE_QUEUE_HPP_
+#define _TUTTLE_PLUGIN_AV_WRITER_ENCODE_QUEUE_HPP_
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace av {
+namespace writer {
+
+/**
+ * @brief Bounded queue of converted frames, consumed by an encoding thread.
+ *
+ * The render pushes its converted frame and returns, so the upstream graph
+ * computes the next frame while the encoder works.
+ * When the queue is full the render waits: this backpressure is measured.
+ */
+class AVWriterEncodeQueue
+{
+public:
+	typedef std::vector<unsigned char> Buffer;
+	typedef boost::shared_ptr<Buffer> BufferPtr;
+	typedef boost::function<void( Buffer& )> EncodeFunction;
+
+public:
+	/**
+	 * @param encode: function called by the encoding thread for each frame, in the push order
+	 * @param maxSize: maximum number of frames waiting to be encoded
+	 */
+	AVWriterEncodeQueue( const EncodeFunction& encode, const size_t maxSize );
+
+	/// Stop the encoding thread, the frames still in the queue are not encoded
+	~AVWriterEncodeQueue();
+
+	/// Get a buffer to fill, reused from the already encoded frames if possible
+	BufferPtr getBuffer( const size_t size );
+
+	/**
+	 * @brief Add a frame to encode, wait while the queue is full.
+	 * @exception rethrow the encoding error if the encoding thread has failed
+	 */
+	void push( const BufferPtr& buffer );
+
+	/**
+	 * @brief Wait until all the frames are encoded and stop the encoding thread.
+	 * @exception rethrow the encoding error if the encoding thread has failed
+	 */
+	void flush();
+
+	/// Number of push which had to wait for the encoder
+	size_t getNbWaits() const { return _nbWaits; }
+	/// Total time spent by push to wait for the encoder
+	boost::posix_time::time_duration getWaitDuration() const { return _waitDuration; }
+
+private:
+	void run();
+	void stop();
+	/// @warning _mutex must be locked
+	void rethrowEncodingError();
+
+private:
+	const EncodeFunction _encode;
+	const size_t _maxSize;
+
+	boost::mutex _mutex;
+	boost::condition_variable _condition;
+
+	std::deque<BufferPtr> _queue;      ///< frames to encode
+	std::vector<BufferPtr> _freeBuffers;
+	bool _encoding;                    ///< the encoding thread is processing a frame
+	bool _stop;
+	boost::exception_ptr _error;
+
+	size_t _nbWaits;
+	boost::posix_time::time_duration _waitDuration;
+
+	boost::thread _thread;
+};
+
+}
+}
+}
+}
+
+#endif
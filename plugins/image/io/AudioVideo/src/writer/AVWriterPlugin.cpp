@@ -5,6 +5,8 @@
 #include <AvTranscoder/codec/AudioCodec.hpp>
 #include <AvTranscoder/progress/NoDisplayProgress.hpp>
 
+#include <boost/bind/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/filesystem.hpp>
@@ -35,6 +37,7 @@ AVWriterPlugin::AVWriterPlugin( OfxImageEffectHandle handle )
 	, _paramMetadatas()
 	, _outputFile( NULL )
 	, _transcoder( NULL )
+	, _encodeQueue( NULL )
 	, _presetLoader( true ) 
 	, _outputFps( 0 )
 	, _initVideo( false )
@@ -106,6 +109,8 @@ AVWriterPlugin::AVWriterPlugin( OfxImageEffectHandle handle )
 	_paramUseCustomSize = fetchBooleanParam( kParamUseCustomSize );
 	_paramCustomSize = fetchInt2DParam( kParamCustomSize );
 
+	_paramEncodeQueueSize = fetchIntParam( kParamEncodeQueueSize );
+
 	_paramVideoPixelFormat = fetchChoiceParam( kParamVideoCodecPixelFmt );
 	_paramAudioSampleFormat = fetchChoiceParam( kParamAudioCodecSampleFmt );
 
@@ -961,6 +966,8 @@ void AVWriterPlugin::updateAudioFromExistingProfile()
 
 void AVWriterPlugin::cleanVideoAndAudio()
 {
+	// stop the encoding thread before to delete the transcoder
+	_encodeQueue.reset();
 	_outputFile.reset();
 	_transcoder.reset();
 	
@@ -1019,6 +1026,11 @@ void AVWriterPlugin::render( const OFX::RenderArguments& args )
 
 		// manage codec lantancy
 		_transcoder->preProcessCodecLatency();
+
+		// encode on a separate thread
+		const size_t encodeQueueSize = _paramEncodeQueueSize->getValue();
+		if( encodeQueueSize > 0 )
+			_encodeQueue.reset( new AVWriterEncodeQueue( boost::bind( &AVWriterPlugin::encodeVideoFrame, this, _1 ), encodeQueueSize ) );
 	}
 	
 	doGilRender<AVWriterProcess>( *this, args );
@@ -1031,6 +1043,18 @@ void AVWriterPlugin::endSequenceRender( const OFX::EndSequenceRenderArguments& a
 	
 	WriterPlugin::endSequenceRender( args );
 
+	// wait for the frames still in the encoding queue
+	if( _encodeQueue )
+	{
+		_encodeQueue->flush();
+		if( _encodeQueue->getNbWaits() )
+		{
+			TUTTLE_LOG_INFO( "[AVWriter] render waited for the encoder " << _encodeQueue->getNbWaits() << " times, "
+				"took: " << _encodeQueue->getWaitDuration() );
+		}
+		_encodeQueue.reset();
+	}
+
 	// encode and wrap last frames
 	std::vector< avtranscoder::StreamTranscoder* >& streams = _transcoder->getStreamTranscoders();
 	for( size_t streamIndex = 0; streamIndex < streams.size(); ++streamIndex )
@@ -1045,6 +1069,18 @@ void AVWriterPlugin::endSequenceRender( const OFX::EndSequenceRenderArguments& a
 	_outputFile->endWrap();
 }
 
+void AVWriterPlugin::encodeVideoFrame( AVWriterEncodeQueue::Buffer& imageData )
+{
+	avtranscoder::VideoGenerator& videoStream = static_cast<avtranscoder::VideoGenerator&>( _transcoder->getStreamTranscoder( 0 ).getCurrentDecoder() );
+
+	// set video stream next frame
+	_videoFrame.refData( &imageData[0], videoStream.getVideoFrameDesc().getDataSize() );
+	videoStream.setNextFrame( _videoFrame );
+
+	// process
+	_transcoder->processFrame();
+}
+
 std::string AVWriterPlugin::getFormatName( const size_t formatIndex ) const
 {
 	try
@@ -1,6 +1,8 @@
 #ifndef _TUTTLE_PLUGIN_AV_WRITER_PLUGIN_HPP_
 #define _TUTTLE_PLUGIN_AV_WRITER_PLUGIN_HPP_
 
+#include "AVWriterEncodeQueue.hpp"
+
 #include <common/util.hpp>
 
 #include <tuttle/plugin/context/WriterPlugin.hpp>
@@ -89,6 +91,11 @@ public:
 
 	void cleanVideoAndAudio();  ///< Called before each new render.
 
+	/**
+	 * @brief Encode a rgb24 frame (called by the encoding thread, or during the render without queue).
+	 */
+	void encodeVideoFrame( AVWriterEncodeQueue::Buffer& imageData );
+
 	void beginSequenceRender( const OFX::BeginSequenceRenderArguments& args );
 	void render( const OFX::RenderArguments& args );
 	void endSequenceRender( const OFX::EndSequenceRenderArguments& args );
@@ -150,6 +157,8 @@ public:
 	OFX::BooleanParam* _paramUseCustomSize;
 	OFX::Int2DParam* _paramCustomSize;  ///< width / height
 
+	OFX::IntParam* _paramEncodeQueueSize;  ///< max number of frames waiting for the encoding thread
+
 	OFX::ChoiceParam* _paramVideoPixelFormat;
 	OFX::ChoiceParam* _paramAudioSampleFormat;
 	
@@ -175,6 +184,7 @@ public:
 	// to process transcode
 	boost::scoped_ptr<avtranscoder::OutputFile> _outputFile;
 	boost::scoped_ptr<avtranscoder::Transcoder> _transcoder;
+	boost::scoped_ptr<AVWriterEncodeQueue> _encodeQueue;  ///< NULL if the encoding is synchronous
 	
 	// to process video
 	avtranscoder::Frame _videoFrame;
@@ -232,6 +232,16 @@ void AVWriterPluginFactory::describeInContext( OFX::ImageEffectDescriptor& desc,
 	customWidth->setHint( "Choose a custom value to override the Size (width / height)." );
 	customWidth->setParent( videoCustomGroupParam );
 
+	OFX::IntParamDescriptor* encodeQueueSize = desc.defineIntParam( kParamEncodeQueueSize );
+	encodeQueueSize->setLabel( "Encoding queue size" );
+	encodeQueueSize->setRange( 0, 64 );
+	encodeQueueSize->setDisplayRange( 0, 16 );
+	encodeQueueSize->setDefault( 4 );
+	encodeQueueSize->setHint( "Maximum number of frames waiting for the encoder. "
+		"The frames are encoded on a separate thread, so the rendering of the next frames is not stopped by the encoder. "
+		"0 encodes synchronously during the render." );
+	encodeQueueSize->setParent( videoCustomGroupParam );
+
 	int default_codec = 0;
 	std::string defaultVideoCodec( "mpeg4" );
 	OFX::ChoiceParamDescriptor* videoCodec = desc.defineChoiceParam( kParamVideoCodec );
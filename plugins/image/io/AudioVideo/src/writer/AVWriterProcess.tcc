@@ -4,6 +4,8 @@
 
 #include <AvTranscoder/codec/VideoCodec.hpp>
 
+#include <algorithm>
+
 namespace tuttle {
 namespace plugin {
 namespace av {
@@ -36,22 +38,23 @@ void AVWriterProcess<View>::multiThreadProcessImages( const OfxRectI& procWindow
 	
 	using namespace terry;
 	
-	rgb8_image_t img ( this->_srcView.dimensions() );
-	rgb8_view_t  vw  ( view( img ) );
+	const size_t bufferSize = std::max( _videoStream.getVideoFrameDesc().getDataSize(), this->_srcView.size() * sizeof( rgb8_pixel_t ) );
+	AVWriterEncodeQueue::BufferPtr buffer = _plugin._encodeQueue ?
+		_plugin._encodeQueue->getBuffer( bufferSize ) :
+		AVWriterEncodeQueue::BufferPtr( new AVWriterEncodeQueue::Buffer( bufferSize ) );
+
+	rgb8_view_t vw = interleaved_view( this->_srcView.width(), this->_srcView.height(),
+	                                   ( rgb8_pixel_t* )( &( *buffer )[0] ),
+	                                   this->_srcView.width() * sizeof( rgb8_pixel_t ) );
 
 	// Convert pixels in PIX_FMT_RGB24
 	copy_and_convert_pixels( this->_srcView, vw );
 	
-	uint8_t* imageData = (uint8_t*)boost::gil::interleaved_view_get_raw_data( vw );
-	
-	// set video stream next frame
-	
-	const size_t bufferSize = _videoStream.getVideoFrameDesc().getDataSize();
-	_plugin._videoFrame.refData( imageData, bufferSize );
-	_videoStream.setNextFrame( _plugin._videoFrame );
-
-	// process
-	_plugin._transcoder->processFrame();
+	// encode on the encoding thread if any, the render continues with the next frame
+	if( _plugin._encodeQueue )
+		_plugin._encodeQueue->push( buffer );
+	else
+		_plugin.encodeVideoFrame( *buffer );
 }
 
 }
@@ -0,0 +1,81 @@
+#include "JpegReaderAlgorithm.hpp"
+
+#include <tuttle/plugin/exceptions.hpp>
+
+namespace tuttle {
+namespace plugin {
+namespace jpeg {
+namespace reader {
+
+void JpegScanlineReader::errorExit( j_common_ptr info )
+{
+	ErrorManager* error = reinterpret_cast<ErrorManager*>( info->err );
+	( *info->err->format_message )( info, error->message );
+	std::longjmp( error->jump, 1 );
+}
+
+JpegScanlineReader::JpegScanlineReader( const std::string& filepath )
+	: _filepath( filepath )
+	, _file( NULL )
+{
+	_file = std::fopen( filepath.c_str(), "rb" );
+	if( _file == NULL )
+	{
+		BOOST_THROW_EXCEPTION( exception::FileNotExist()
+			<< exception::user( "Jpeg: Unable to open file" )
+			<< exception::filename( filepath ) );
+	}
+
+	_decompress.err = jpeg_std_error( &_error.pub );
+	_error.pub.error_exit = &JpegScanlineReader::errorExit;
+	_error.message[0] = '\0';
+
+	if( setjmp( _error.jump ) )
+	{
+		jpeg_destroy_decompress( &_decompress );
+		std::fclose( _file );
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Jpeg: Unable to read the header." )
+			<< exception::dev( _error.message )
+			<< exception::filename( filepath ) );
+	}
+
+	jpeg_create_decompress( &_decompress );
+	jpeg_stdio_src( &_decompress, _file );
+	jpeg_read_header( &_decompress, TRUE );
+
+	// CMYK/YCCK can't be converted by libjpeg and will fail in jpeg_start_decompress
+	_decompress.out_color_space = _decompress.jpeg_color_space == JCS_GRAYSCALE ? JCS_GRAYSCALE : JCS_RGB;
+	jpeg_start_decompress( &_decompress );
+}
+
+JpegScanlineReader::~JpegScanlineReader()
+{
+	// don't call jpeg_finish_decompress: the remaining data (if any) is not needed
+	jpeg_destroy_decompress( &_decompress );
+	std::fclose( _file );
+}
+
+void JpegScanlineReader::readRow( JSAMPROW row )
+{
+	if( _decompress.output_scanline >= _decompress.output_height )
+	{
+		BOOST_THROW_EXCEPTION( exception::Bug()
+			<< exception::dev( "Jpeg: Read after the last scanline." )
+			<< exception::filename( _filepath ) );
+	}
+
+	if( setjmp( _error.jump ) )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Jpeg: Unable to read the image." )
+			<< exception::dev( _error.message )
+			<< exception::filename( _filepath ) );
+	}
+	jpeg_read_scanlines( &_decompress, &row, 1 );
+}
+
+}
+}
+}
+}
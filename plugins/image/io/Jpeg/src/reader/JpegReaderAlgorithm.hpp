@@ -0,0 +1,72 @@
+#ifndef _TUTTLE_PLUGIN_JPEG_READER_ALGORITHM_HPP_
+#define _TUTTLE_PLUGIN_JPEG_READER_ALGORITHM_HPP_
+
+#include <cstdio>
+#include <cstddef>
+#include <csetjmp>
+
+extern "C" {
+#include <jpeglib.h>
+}
+
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+namespace tuttle {
+namespace plugin {
+namespace jpeg {
+namespace reader {
+
+/**
+ * @brief Read a jpeg file scanline by scanline with libjpeg.
+ *
+ * The scanlines are gray (1 channel) or rgb (3 channels), 8 bits per channel.
+ * There is no allocation of the full image.
+ *
+ * An instance is only used by one render thread, there is no shared state
+ * between instances, so different frames can be decoded concurrently.
+ */
+class JpegScanlineReader : boost::noncopyable
+{
+public:
+	/// @throw exception::File if the file can't be opened or is not a valid jpeg.
+	JpegScanlineReader( const std::string& filepath );
+	~JpegScanlineReader();
+
+	std::size_t getWidth() const { return _decompress.output_width; }
+	std::size_t getHeight() const { return _decompress.output_height; }
+	/// 1 (gray) or 3 (rgb)
+	int getNbChannels() const { return _decompress.output_components; }
+	std::size_t getRowBytes() const { return getWidth() * getNbChannels(); }
+
+	/**
+	 * @brief Decode the next scanline into @p row (getRowBytes() bytes).
+	 * @throw exception::File on a corrupted file.
+	 */
+	void readRow( JSAMPROW row );
+
+private:
+	/// libjpeg error manager which goes back to the calling method instead of exiting.
+	struct ErrorManager
+	{
+		jpeg_error_mgr pub;
+		std::jmp_buf jump;
+		char message[JMSG_LENGTH_MAX];
+	};
+
+	static void errorExit( j_common_ptr info );
+
+private:
+	std::string _filepath;
+	std::FILE* _file;
+	jpeg_decompress_struct _decompress;
+	ErrorManager _error;
+};
+
+}
+}
+}
+}
+
+#endif
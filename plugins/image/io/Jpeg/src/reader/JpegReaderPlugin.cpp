@@ -3,6 +3,7 @@
 #include "JpegReaderDefinitions.hpp"
 
 #include <boost/gil/gil_all.hpp>
+#include <boost/gil/extension/io/jpeg_io.hpp>
 #include <boost/filesystem.hpp>
 
 namespace tuttle {
@@ -1,18 +1,18 @@
 #include "JpegReaderDefinitions.hpp"
 #include "JpegReaderProcess.hpp"
+#include "JpegReaderAlgorithm.hpp"
 
 #include <terry/globals.hpp>
 #include <tuttle/plugin/exceptions.hpp>
 
 #include <boost/gil/gil_all.hpp>
-#include <boost/gil/extension/dynamic_image/dynamic_image_all.hpp>
-#include <boost/gil/extension/io/jpeg_io.hpp>
-#include <boost/gil/extension/io/jpeg_dynamic_io.hpp>
-#include <boost/filesystem/fstream.hpp>
-
-#include <boost/scoped_ptr.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include <boost/assert.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace tuttle {
 namespace plugin {
 namespace jpeg {
@@ -21,11 +21,54 @@ namespace reader {
 using namespace boost::gil;
 namespace bfs = boost::filesystem;
 
-typedef any_image < boost::mpl::vector
-		    < rgba8_image_t, rgba16_image_t, rgba32f_image_t,
-		      rgb8_image_t,  rgb16_image_t,  rgb32f_image_t >
-		    > any_image_t;
-typedef any_image_t::view_t any_view_t;
+/**
+ * @brief Decode the scanlines directly into the output view.
+ * Only if the scanline has the same memory layout than a row of the output view.
+ */
+template<class SrcPixel, class View>
+void readRows( JpegScanlineReader& reader, View& dst, const boost::mpl::true_ )
+{
+	for( std::ptrdiff_t y = 0; y < dst.height(); ++y )
+	{
+		reader.readRow( reinterpret_cast<JSAMPROW>( &dst( 0, y ) ) );
+	}
+}
+
+/**
+ * @brief Decode each scanline in a row buffer and convert it into the output view.
+ */
+template<class SrcPixel, class View>
+void readRows( JpegScanlineReader& reader, View& dst, const boost::mpl::false_ )
+{
+	typedef typename view_type_from_pixel<SrcPixel>::type SrcView;
+
+	std::vector<JSAMPLE> rowBuffer( reader.getRowBytes() );
+	const SrcView srcRow = interleaved_view( reader.getWidth(), 1,
+	                                         reinterpret_cast<SrcPixel*>( &rowBuffer[0] ),
+	                                         reader.getRowBytes() );
+	const std::ptrdiff_t width = std::min<std::ptrdiff_t>( srcRow.width(), dst.width() );
+
+	for( std::ptrdiff_t y = 0; y < dst.height(); ++y )
+	{
+		reader.readRow( &rowBuffer[0] );
+		copy_and_convert_pixels( subimage_view( srcRow, 0, 0, width, 1 ),
+		                         subimage_view( dst, 0, y, width, 1 ) );
+	}
+}
+
+template<class SrcPixel, class View>
+void readRows( JpegScanlineReader& reader, View& dst )
+{
+	typedef boost::mpl::bool_<
+		boost::is_same<SrcPixel, typename View::value_type>::value &&
+		! is_planar<View>::value
+		> CanDecodeIntoView;
+
+	if( CanDecodeIntoView::value && dst.width() == static_cast<std::ptrdiff_t>( reader.getWidth() ) )
+		readRows<SrcPixel>( reader, dst, CanDecodeIntoView() );
+	else
+		readRows<SrcPixel>( reader, dst, boost::mpl::false_() );
+}
 
 template<class View>
 JpegReaderProcess<View>::JpegReaderProcess( JpegReaderPlugin& instance )
@@ -50,7 +93,8 @@ void JpegReaderProcess<View>::setup( const OFX::RenderArguments& args )
 template<class View>
 void JpegReaderProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
 {
-	// no tiles and no multithreading supported
+	// no tiles and no multithreading supported:
+	// the scanlines are decoded sequentially, the parallelism is between frames.
 	BOOST_ASSERT( procWindowRoW == this->_dstPixelRod );
 	readImage( this->_dstView );
 }
@@ -60,15 +104,21 @@ void JpegReaderProcess<View>::multiThreadProcessImages( const OfxRectI& procWind
 template<class View>
 View& JpegReaderProcess<View>::readImage( View& dst )
 {
-	any_image_t anyImg;
-
 	try
 	{
-		jpeg_read_image( _params._filepath, anyImg );
+		JpegScanlineReader reader( _params._filepath );
+
+		// the output view can't be higher than the image
+		View dstView = subimage_view( dst, 0, 0, dst.width(), std::min<std::ptrdiff_t>( dst.height(), reader.getHeight() ) );
 
-		any_view_t srcView = view( anyImg );
-		srcView = subimage_view( srcView, 0, 0, dst.width(), dst.height() );
-		copy_and_convert_pixels( srcView, dst );
+		switch( reader.getNbChannels() )
+		{
+			case 1: readRows<gray8_pixel_t>( reader, dstView ); break;
+			case 3: readRows<rgb8_pixel_t>( reader, dstView ); break;
+			default:
+				BOOST_THROW_EXCEPTION( exception::ImageFormat()
+					<< exception::user( "Jpeg: Unsupported pixel format." ) );
+		}
 	}
 	catch( boost::exception& e )
 	{
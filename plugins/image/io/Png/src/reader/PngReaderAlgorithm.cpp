@@ -0,0 +1,175 @@
+#include "PngReaderAlgorithm.hpp"
+
+#include <tuttle/plugin/exceptions.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <csetjmp>
+#include <cstring>
+
+namespace tuttle {
+namespace plugin {
+namespace png {
+namespace reader {
+
+namespace {
+
+static const std::size_t kPngSignatureSize = 8;
+
+/// Keep the libpng message and go back to the setjmp of the calling method.
+void pngErrorCallback( png_structp png, png_const_charp message )
+{
+	std::string* error = static_cast<std::string*>( png_get_error_ptr( png ) );
+	if( error )
+		*error = message;
+	longjmp( png_jmpbuf( png ), 1 );
+}
+
+void pngWarningCallback( png_structp, png_const_charp )
+{}
+
+bool isLittleEndian()
+{
+	const boost::uint16_t one = 1;
+	return *reinterpret_cast<const unsigned char*>( &one ) == 1;
+}
+
+}
+
+PngScanlineReader::PngScanlineReader( const std::string& filepath )
+	: _filepath( filepath )
+	, _file( NULL )
+	, _png( NULL )
+	, _info( NULL )
+	, _width( 0 )
+	, _height( 0 )
+	, _nbChannels( 0 )
+	, _bitDepth( 0 )
+	, _rowBytes( 0 )
+	, _nbPasses( 1 )
+	, _currentRow( 0 )
+{
+	_file = std::fopen( filepath.c_str(), "rb" );
+	if( _file == NULL )
+	{
+		BOOST_THROW_EXCEPTION( exception::FileNotExist()
+			<< exception::user( "Png: Unable to open file" )
+			<< exception::filename( filepath ) );
+	}
+
+	png_byte signature[kPngSignatureSize];
+	if( std::fread( signature, 1, kPngSignatureSize, _file ) != kPngSignatureSize ||
+	    png_sig_cmp( signature, 0, kPngSignatureSize ) != 0 )
+	{
+		std::fclose( _file );
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Png: Not a valid png file" )
+			<< exception::filename( filepath ) );
+	}
+
+	_png = png_create_read_struct( PNG_LIBPNG_VER_STRING, &_error, pngErrorCallback, pngWarningCallback );
+	if( _png )
+		_info = png_create_info_struct( _png );
+	if( _png == NULL || _info == NULL )
+	{
+		png_destroy_read_struct( &_png, &_info, NULL );
+		std::fclose( _file );
+		BOOST_THROW_EXCEPTION( exception::Bug()
+			<< exception::dev( "Png: Unable to create the libpng structures." ) );
+	}
+
+	if( setjmp( png_jmpbuf( _png ) ) )
+	{
+		png_destroy_read_struct( &_png, &_info, NULL );
+		std::fclose( _file );
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Png: Unable to read the header." )
+			<< exception::dev( _error )
+			<< exception::filename( filepath ) );
+	}
+
+	png_init_io( _png, _file );
+	png_set_sig_bytes( _png, kPngSignatureSize );
+	png_read_info( _png, _info );
+
+	const int colorType = png_get_color_type( _png, _info );
+	const int bitDepth  = png_get_bit_depth( _png, _info );
+
+	// normalize the rows to gray, rgb or rgba with 8 or 16 bits per channel
+	if( colorType == PNG_COLOR_TYPE_PALETTE )
+		png_set_palette_to_rgb( _png );
+	if( colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8 )
+		png_set_expand_gray_1_2_4_to_8( _png );
+	if( png_get_valid( _png, _info, PNG_INFO_tRNS ) )
+		png_set_tRNS_to_alpha( _png );
+	if( colorType == PNG_COLOR_TYPE_GRAY_ALPHA ||
+	    ( colorType == PNG_COLOR_TYPE_GRAY && png_get_valid( _png, _info, PNG_INFO_tRNS ) ) )
+		png_set_gray_to_rgb( _png );
+	if( bitDepth == 16 && isLittleEndian() )
+		png_set_swap( _png );
+	_nbPasses = png_set_interlace_handling( _png );
+	png_read_update_info( _png, _info );
+
+	_width      = png_get_image_width( _png, _info );
+	_height     = png_get_image_height( _png, _info );
+	_nbChannels = png_get_channels( _png, _info );
+	_bitDepth   = png_get_bit_depth( _png, _info );
+	_rowBytes   = png_get_rowbytes( _png, _info );
+}
+
+PngScanlineReader::~PngScanlineReader()
+{
+	png_destroy_read_struct( &_png, &_info, NULL );
+	std::fclose( _file );
+}
+
+void PngScanlineReader::readRow( png_bytep row )
+{
+	if( _currentRow >= _height )
+	{
+		BOOST_THROW_EXCEPTION( exception::Bug()
+			<< exception::dev( "Png: Read after the last row." )
+			<< exception::filename( _filepath ) );
+	}
+
+	if( _nbPasses > 1 )
+	{
+		if( _interlacedBuffer.empty() )
+			readInterlacedImage();
+		std::memcpy( row, &_interlacedBuffer[_currentRow * _rowBytes], _rowBytes );
+		++_currentRow;
+		return;
+	}
+
+	if( setjmp( png_jmpbuf( _png ) ) )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Png: Unable to read the image." )
+			<< exception::dev( _error )
+			<< exception::filename( _filepath ) );
+	}
+	png_read_row( _png, row, NULL );
+	++_currentRow;
+}
+
+void PngScanlineReader::readInterlacedImage()
+{
+	_interlacedBuffer.resize( _rowBytes * _height );
+	_rows.resize( _height );
+	for( std::size_t y = 0; y < _height; ++y )
+		_rows[y] = &_interlacedBuffer[y * _rowBytes];
+
+	if( setjmp( png_jmpbuf( _png ) ) )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Png: Unable to read the image." )
+			<< exception::dev( _error )
+			<< exception::filename( _filepath ) );
+	}
+	png_read_image( _png, &_rows[0] );
+}
+
+}
+}
+}
+}
@@ -0,0 +1,81 @@
+#ifndef _TUTTLE_PLUGIN_PNG_READER_ALGORITHM_HPP_
+#define _TUTTLE_PLUGIN_PNG_READER_ALGORITHM_HPP_
+
+#include <png.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdio>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace png {
+namespace reader {
+
+/**
+ * @brief Read a png file row by row with libpng.
+ *
+ * Transformations are set so that the rows are always gray, rgb or rgba,
+ * with 8 or 16 bits per channel in the native endianness
+ * (palette expanded to rgb, low bit depth gray expanded to 8 bits,
+ * transparency chunk expanded to alpha, gray + alpha expanded to rgba).
+ *
+ * Non interlaced images are streamed: there is no allocation of the full image.
+ * Interlaced images need all the passes, so they are decoded in an internal buffer
+ * on the first call to readRow.
+ *
+ * An instance is only used by one render thread, there is no shared state
+ * between instances, so different frames can be decoded concurrently.
+ */
+class PngScanlineReader : boost::noncopyable
+{
+public:
+	/// @throw exception::File if the file can't be opened or is not a valid png.
+	PngScanlineReader( const std::string& filepath );
+	~PngScanlineReader();
+
+	std::size_t getWidth() const { return _width; }
+	std::size_t getHeight() const { return _height; }
+	/// 1 (gray), 3 (rgb) or 4 (rgba)
+	int getNbChannels() const { return _nbChannels; }
+	/// 8 or 16
+	int getBitDepth() const { return _bitDepth; }
+	std::size_t getRowBytes() const { return _rowBytes; }
+
+	/**
+	 * @brief Decode the next row into @p row (getRowBytes() bytes).
+	 * @throw exception::File on a corrupted file.
+	 */
+	void readRow( png_bytep row );
+
+private:
+	void readInterlacedImage();
+
+private:
+	std::string _filepath;
+	std::FILE* _file;
+	png_structp _png;
+	png_infop _info;
+
+	std::size_t _width;
+	std::size_t _height;
+	int _nbChannels;
+	int _bitDepth;
+	std::size_t _rowBytes;
+	int _nbPasses;
+
+	std::size_t _currentRow;
+	std::string _error;                      ///< last libpng error message
+	std::vector<png_byte> _interlacedBuffer; ///< full image, only used for interlaced files
+	std::vector<png_bytep> _rows;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -1,19 +1,19 @@
 #include "PngReaderDefinitions.hpp"
 #include "PngReaderProcess.hpp"
 #include "PngReaderPlugin.hpp"
+#include "PngReaderAlgorithm.hpp"
 
 #include <terry/globals.hpp>
 #include <tuttle/plugin/exceptions.hpp>
 
 #include <boost/gil/gil_all.hpp>
-#include <boost/gil/extension/dynamic_image/dynamic_image_all.hpp>
-#include <boost/gil/extension/io/png_io.hpp>
-#include <boost/gil/extension/io/png_dynamic_io.hpp>
-#include <boost/filesystem/fstream.hpp>
-
-#include <boost/scoped_ptr.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include <boost/assert.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace tuttle {
 namespace plugin {
 namespace png {
@@ -22,12 +22,54 @@ namespace reader {
 using namespace boost::gil;
 namespace bfs = boost::filesystem;
 
-typedef any_image < boost::mpl::vector
-		    < gray8_image_t, gray16_image_t, gray32f_image_t,
-		      rgba8_image_t, rgba16_image_t, rgba32f_image_t,
-		      rgb8_image_t,  rgb16_image_t,  rgb32f_image_t >
-		    > any_image_t;
-typedef any_image_t::view_t any_view_t;
+/**
+ * @brief Decode the rows directly into the output view.
+ * Only if the row of the file has the same memory layout than a row of the output view.
+ */
+template<class SrcPixel, class View>
+void readRows( PngScanlineReader& reader, View& dst, const boost::mpl::true_ )
+{
+	for( std::ptrdiff_t y = 0; y < dst.height(); ++y )
+	{
+		reader.readRow( reinterpret_cast<png_bytep>( &dst( 0, y ) ) );
+	}
+}
+
+/**
+ * @brief Decode each row in a row buffer and convert it into the output view.
+ */
+template<class SrcPixel, class View>
+void readRows( PngScanlineReader& reader, View& dst, const boost::mpl::false_ )
+{
+	typedef typename view_type_from_pixel<SrcPixel>::type SrcView;
+
+	std::vector<png_byte> rowBuffer( reader.getRowBytes() );
+	const SrcView srcRow = interleaved_view( reader.getWidth(), 1,
+	                                         reinterpret_cast<SrcPixel*>( &rowBuffer[0] ),
+	                                         reader.getRowBytes() );
+	const std::ptrdiff_t width = std::min<std::ptrdiff_t>( srcRow.width(), dst.width() );
+
+	for( std::ptrdiff_t y = 0; y < dst.height(); ++y )
+	{
+		reader.readRow( &rowBuffer[0] );
+		copy_and_convert_pixels( subimage_view( srcRow, 0, 0, width, 1 ),
+		                         subimage_view( dst, 0, y, width, 1 ) );
+	}
+}
+
+template<class SrcPixel, class View>
+void readRows( PngScanlineReader& reader, View& dst )
+{
+	typedef boost::mpl::bool_<
+		boost::is_same<SrcPixel, typename View::value_type>::value &&
+		! is_planar<View>::value
+		> CanDecodeIntoView;
+
+	if( CanDecodeIntoView::value && dst.width() == static_cast<std::ptrdiff_t>( reader.getWidth() ) )
+		readRows<SrcPixel>( reader, dst, CanDecodeIntoView() );
+	else
+		readRows<SrcPixel>( reader, dst, boost::mpl::false_() );
+}
 
 template<class View>
 PngReaderProcess<View>::PngReaderProcess( PngReaderPlugin& instance )
@@ -54,7 +96,8 @@ void PngReaderProcess<View>::setup( const OFX::RenderArguments& args )
 template<class View>
 void PngReaderProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
 {
-	// no tiles and no multithreading supported
+	// no tiles and no multithreading supported:
+	// the rows are decoded sequentially, the parallelism is between frames.
 	BOOST_ASSERT( procWindowRoW == this->_dstPixelRod );
 	readImage( this->_dstView );
 }
@@ -64,14 +107,25 @@ void PngReaderProcess<View>::multiThreadProcessImages( const OfxRectI& procWindo
 template<class View>
 View& PngReaderProcess<View>::readImage( View& dst )
 {
-	any_image_t anyImg;
-
 	try
 	{
-		png_read_image( _params._filepath, anyImg );
-		any_view_t srcView = view( anyImg );
-		srcView = subimage_view( srcView, 0, 0, dst.width(), dst.height() );
-		copy_and_convert_pixels( srcView, dst );
+		PngScanlineReader reader( _params._filepath );
+
+		// the output view can't be higher than the image
+		View dstView = subimage_view( dst, 0, 0, dst.width(), std::min<std::ptrdiff_t>( dst.height(), reader.getHeight() ) );
+
+		switch( reader.getNbChannels() * 100 + reader.getBitDepth() )
+		{
+			case 108: readRows<gray8_pixel_t>( reader, dstView ); break;
+			case 116: readRows<gray16_pixel_t>( reader, dstView ); break;
+			case 308: readRows<rgb8_pixel_t>( reader, dstView ); break;
+			case 316: readRows<rgb16_pixel_t>( reader, dstView ); break;
+			case 408: readRows<rgba8_pixel_t>( reader, dstView ); break;
+			case 416: readRows<rgba16_pixel_t>( reader, dstView ); break;
+			default:
+				BOOST_THROW_EXCEPTION( exception::ImageFormat()
+					<< exception::user( "Png: Unsupported pixel format." ) );
+		}
 	}
 	catch( boost::exception& e )
 	{
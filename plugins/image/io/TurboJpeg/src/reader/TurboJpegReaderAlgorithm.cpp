@@ -0,0 +1,177 @@
+#include "TurboJpegReaderAlgorithm.hpp"
+
+#include <tuttle/plugin/exceptions.hpp>
+
+#include <terry/lru_cache.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace tuttle {
+namespace plugin {
+namespace turboJpeg {
+namespace reader {
+
+namespace {
+
+/// Size of the first chunk read to decode the header, enough for nearly all files.
+static const std::size_t kHeaderChunkSize = 64 * 1024;
+
+/// Number of file headers kept, the least recently read are removed.
+static const std::size_t kMaxNbCachedHeaders = 256;
+
+struct HeaderCacheKey
+{
+	std::string filepath;
+	std::time_t mtime;
+
+	bool operator==( const HeaderCacheKey& other ) const
+	{
+		return mtime == other.mtime && filepath == other.filepath;
+	}
+};
+
+typedef terry::lru_cache<HeaderCacheKey, TurboJpegHeader> HeaderCache;
+
+HeaderCache& headerCache()
+{
+	static HeaderCache cache( kMaxNbCachedHeaders );
+	return cache;
+}
+
+std::time_t lastWriteTime( const std::string& filepath )
+{
+	boost::system::error_code error;
+	const std::time_t t = boost::filesystem::last_write_time( filepath, error );
+	if( error )
+	{
+		BOOST_THROW_EXCEPTION( exception::FileNotExist()
+			<< exception::user( "TurboJpeg: Unable to open file" )
+			<< exception::filename( filepath ) );
+	}
+	return t;
+}
+
+boost::thread_specific_ptr<TurboJpegThreadContext>& threadContextPtr()
+{
+	static boost::thread_specific_ptr<TurboJpegThreadContext> context;
+	return context;
+}
+
+}
+
+TurboJpegThreadContext::TurboJpegThreadContext()
+: handle( tjInitDecompress() )
+{
+	if( handle == NULL )
+	{
+		BOOST_THROW_EXCEPTION( exception::Failed()
+			<< exception::user( tjGetErrorStr() ) );
+	}
+}
+
+TurboJpegThreadContext::~TurboJpegThreadContext()
+{
+	tjDestroy( handle );
+}
+
+TurboJpegThreadContext& getThreadContext()
+{
+	boost::thread_specific_ptr<TurboJpegThreadContext>& context = threadContextPtr();
+	if( context.get() == NULL )
+	{
+		context.reset( new TurboJpegThreadContext() );
+	}
+	return *context;
+}
+
+void readJpegFile( const std::string& filepath, std::vector<unsigned char>& buffer )
+{
+	FILE* file = fopen( filepath.c_str(), "rb" );
+	if( file == NULL )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "TurboJpeg: Unable to open file" )
+			<< exception::filename( filepath ) );
+	}
+
+	fseek( file, 0, SEEK_END );
+	const long fileSize = ftell( file );
+	fseek( file, 0, SEEK_SET );
+
+	// keep the capacity of the buffer between frames
+	buffer.resize( fileSize > 0 ? fileSize : 0 );
+	const bool readOk = ( fileSize > 0 ) && ( fread( &buffer[0], fileSize, 1, file ) == 1 );
+	fclose( file );
+
+	if( ! readOk )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "TurboJpeg: Unable to read file" )
+			<< exception::filename( filepath ) );
+	}
+}
+
+TurboJpegHeader getJpegHeader( const std::string& filepath )
+{
+	HeaderCacheKey key;
+	key.filepath = filepath;
+	key.mtime = lastWriteTime( filepath );
+	TurboJpegHeader header;
+	if( headerCache().find( key, header ) )
+		return header;
+
+	FILE* file = fopen( filepath.c_str(), "rb" );
+	if( file == NULL )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "TurboJpeg: Unable to open file" )
+			<< exception::filename( filepath ) );
+	}
+
+	fseek( file, 0, SEEK_END );
+	const long fileSize = ftell( file );
+	fseek( file, 0, SEEK_SET );
+
+	TurboJpegThreadContext& context = getThreadContext();
+	std::vector<unsigned char>& buffer = context.jpegBuffer;
+
+	// Only read the beginning of the file, the frame header is nearly always inside.
+	// If it's not the case, read the rest of the file and retry.
+	std::size_t bufferSize = std::min<std::size_t>( kHeaderChunkSize, fileSize > 0 ? fileSize : 0 );
+	buffer.resize( bufferSize );
+	bool readOk = ( bufferSize > 0 ) && ( fread( &buffer[0], bufferSize, 1, file ) == 1 );
+	int ret = -1;
+	if( readOk )
+	{
+		ret = tjDecompressHeader2( context.handle, &buffer[0], bufferSize, &header.width, &header.height, &header.subsampling );
+		if( ret != 0 && bufferSize < static_cast<std::size_t>( fileSize ) )
+		{
+			buffer.resize( fileSize );
+			readOk = fread( &buffer[bufferSize], fileSize - bufferSize, 1, file ) == 1;
+			bufferSize = fileSize;
+			if( readOk )
+				ret = tjDecompressHeader2( context.handle, &buffer[0], bufferSize, &header.width, &header.height, &header.subsampling );
+		}
+	}
+	fclose( file );
+
+	if( ! readOk || ret != 0 )
+	{
+		BOOST_THROW_EXCEPTION( exception::FileNotExist()
+			<< exception::user( readOk ? tjGetErrorStr() : "TurboJpeg: Unable to read file" )
+			<< exception::filename( filepath ) );
+	}
+
+	headerCache().insert( key, header );
+	return header;
+}
+
+}
+}
+}
+}
@@ -1,11 +1,82 @@
 #ifndef _TUTTLE_PLUGIN_TURBOJPEG_READER_ALGORITHM_HPP_
 #define _TUTTLE_PLUGIN_TURBOJPEG_READER_ALGORITHM_HPP_
 
+#include <boost/gil/gil_all.hpp>
+
+#include <turbojpeg.h>
+
+#include <string>
+#include <vector>
+
 namespace tuttle {
 namespace plugin {
 namespace turboJpeg {
 namespace reader {
 
+/**
+ * @brief Informations extracted from a jpeg header.
+ */
+struct TurboJpegHeader
+{
+	TurboJpegHeader()
+	: width( 0 )
+	, height( 0 )
+	, subsampling( -1 )
+	{}
+
+	int width;
+	int height;
+	int subsampling;
+};
+
+/**
+ * @brief Decompression context owned by a render thread.
+ * The tjhandle and the compressed buffer are reused from one frame to the next.
+ */
+class TurboJpegThreadContext
+{
+public:
+	TurboJpegThreadContext();
+	~TurboJpegThreadContext();
+
+	tjhandle                   handle;
+	std::vector<unsigned char> jpegBuffer; ///< compressed file content
+	std::vector<unsigned char> rgbBuffer;  ///< only used if we can't decode directly into the output view
+};
+
+/**
+ * @brief Get the decompression context of the calling thread (created on first use).
+ */
+TurboJpegThreadContext& getThreadContext();
+
+/**
+ * @brief Read the whole file into @p buffer with a single read.
+ */
+void readJpegFile( const std::string& filepath, std::vector<unsigned char>& buffer );
+
+/**
+ * @brief Read the jpeg header of a file.
+ * The result is cached per filepath and modification time,
+ * so only the first call reads the file (and only the beginning of it).
+ */
+TurboJpegHeader getJpegHeader( const std::string& filepath );
+
+/**
+ * @brief TurboJpeg pixel format to decode directly into a view of this pixel type.
+ * value is -1 if there is no equivalent pixel format.
+ */
+template<class Pixel>
+struct turbojpeg_pixel_format { static const int value = -1; };
+
+template<>
+struct turbojpeg_pixel_format<boost::gil::rgb8_pixel_t> { static const int value = TJPF_RGB; };
+
+template<>
+struct turbojpeg_pixel_format<boost::gil::rgba8_pixel_t> { static const int value = TJPF_RGBA; };
+
+template<>
+struct turbojpeg_pixel_format<boost::gil::gray8_pixel_t> { static const int value = TJPF_GRAY; };
+
 }
 }
 }
@@ -1,13 +1,11 @@
 #include "TurboJpegReaderPlugin.hpp"
 #include "TurboJpegReaderProcess.hpp"
 #include "TurboJpegReaderDefinitions.hpp"
+#include "TurboJpegReaderAlgorithm.hpp"
 
 #include <boost/gil/gil_all.hpp>
 #include <boost/filesystem.hpp>
 
-#include <cstdio>
-#include <turbojpeg.h>
-
 namespace tuttle {
 namespace plugin {
 namespace turboJpeg {
@@ -38,51 +36,12 @@ bool TurboJpegReaderPlugin::getRegionOfDefinition( const OFX::RegionOfDefinition
 {
 	try
 	{
-		FILE *file = NULL;
-		unsigned char *jpegbuf = NULL;
-		unsigned long jpgbufsize = 0;
-
-		file = fopen( getAbsoluteFilenameAt( args.time ).c_str(), "rb" );
-		if( file == NULL )
-		{
-			BOOST_THROW_EXCEPTION( exception::File()
-				<< exception::user( "TurboJpeg: Unable to open file" )
-				<< exception::filename( getAbsoluteFilenameAt( args.time ) ) );
-		}
-		
-		fseek( file, 0, SEEK_END );
-		jpgbufsize = ftell( file );
-		jpegbuf = new unsigned char[ jpgbufsize ];
-		
-		fseek(file, 0, SEEK_SET);
-		fread( jpegbuf, jpgbufsize, 1, file );
+		const TurboJpegHeader header = getJpegHeader( getAbsoluteFilenameAt( args.time ) );
 
-		const tjhandle jpeghandle = tjInitDecompress();
-		int width = 0;
-		int height = 0;
-		int jpegsubsamp = -1;
-		
-		int ret = tjDecompressHeader2( jpeghandle, jpegbuf, jpgbufsize, &width, &height, &jpegsubsamp );
-		
-		if( ret != 0 )
-		{
-			BOOST_THROW_EXCEPTION( exception::FileNotExist()
-				<< exception::user( tjGetErrorStr() )
-				<< exception::filename( getAbsoluteFilenameAt( args.time ) ) );
-		}
-		
-		tjDestroy( jpeghandle );
-		//free(jpegbuf);
-		delete[] jpegbuf;
-		jpegbuf = NULL;
-		
-		fclose(file);
-		file=NULL;
-		
 		rod.x1 = 0;
-		rod.x2 = width * this->_clipDst->getPixelAspectRatio();
+		rod.x2 = header.width * this->_clipDst->getPixelAspectRatio();
 		rod.y1 = 0;
-		rod.y2 = height;
+		rod.y2 = header.height;
 		//TUTTLE_LOG_VAR( TUTTLE_INFO, rod );
 	}
 	catch( std::exception& e )
@@ -1,6 +1,7 @@
 #include "TurboJpegReaderAlgorithm.hpp"
 
 #include <boost/gil/gil_all.hpp>
+#include <boost/mpl/bool.hpp>
 
 #include <turbojpeg.h>
 
@@ -37,33 +38,62 @@ void TurboJpegReaderProcess<View>::multiThreadProcessImages( const OfxRectI& pro
 	readImage( this->_dstView );
 }
 
+/**
+ * @brief Decompress directly into the output buffer.
+ * The output view is top to bottom, so if the rows are stored from bottom to top in memory
+ * we give the first row in memory with a positive pitch and let TurboJpeg flip the image.
+ */
+template<class View>
+bool decompressIntoView( const tjhandle handle, unsigned char* jpegbuf, const unsigned long jpegbufsize,
+                         const TurboJpegHeader& header, int flags, View& dst, const boost::mpl::true_ )
+{
+	if( dst.width() != header.width || dst.height() != header.height )
+		return false;
+
+	const std::ptrdiff_t rowSize = dst.pixels().row_size();
+	unsigned char* dstbuf = NULL;
+	int pitch = 0;
+	if( rowSize >= 0 )
+	{
+		dstbuf = reinterpret_cast<unsigned char*>( &dst( 0, 0 ) );
+		pitch = rowSize;
+	}
+	else
+	{
+		dstbuf = reinterpret_cast<unsigned char*>( &dst( 0, dst.height() - 1 ) );
+		pitch = -rowSize;
+		flags |= TJFLAG_BOTTOMUP;
+	}
+
+	const int pixelFormat = turbojpeg_pixel_format<typename View::value_type>::value;
+	if( tjDecompress2( handle, jpegbuf, jpegbufsize, dstbuf, header.width, pitch, header.height, pixelFormat, flags ) != 0 )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( tjGetErrorStr() ) );
+	}
+	return true;
+}
+
+template<class View>
+bool decompressIntoView( const tjhandle, unsigned char*, const unsigned long,
+                         const TurboJpegHeader&, const int, View&, const boost::mpl::false_ )
+{
+	return false;
+}
+
 template<class View>
 void TurboJpegReaderProcess<View>::readImage( View& dst )
 {
-	FILE          *file    = NULL;
-	unsigned char *jpegbuf = NULL;
-	unsigned char *rgbbuf  = NULL;
-	unsigned long jpgbufsize = 0;
-
-	const tjhandle jpeghandle = tjInitDecompress();
-	int width       = 0;
-	int height      = 0;
-	int jpegsubsamp = -1;
-	int yuvsize     = 0;
-	int bufsize     = 0;
-	int ret         = 0;
-	int ps          = TJPF_RGB;
-	int flags       = 0;
-	
-	
-	file = fopen( _params.filepath.c_str(), "rb");
-	fseek( file, 0, SEEK_END );
-	jpgbufsize = ftell( file );
-	jpegbuf = new unsigned char[ jpgbufsize ];
-	
-	fseek( file, 0, SEEK_SET );
-	fread( jpegbuf, jpgbufsize, 1, file );
-	
+	typedef typename View::value_type Pixel;
+	typedef boost::mpl::bool_<( turbojpeg_pixel_format<Pixel>::value != -1 ) && ! is_planar<View>::value> IsDirectlyDecodable;
+
+	TurboJpegThreadContext& context = getThreadContext();
+	readJpegFile( _params.filepath, context.jpegBuffer );
+
+	unsigned char* jpegbuf = &context.jpegBuffer[0];
+	const unsigned long jpegbufsize = context.jpegBuffer.size();
+	int flags = 0;
+
 	switch( _params.optimization )
 	{
 		case eTurboJpegOptimizationNone: flags = 0; break;
@@ -78,37 +108,38 @@ void TurboJpegReaderProcess<View>::readImage( View& dst )
 		flags |= TJ_FASTUPSAMPLE;
 	}
 	
-	ret = tjDecompressHeader2( jpeghandle, jpegbuf, jpgbufsize, &width, &height, &jpegsubsamp );
-	if( ret != 0 )
+	TurboJpegHeader header;
+	if( tjDecompressHeader2( context.handle, jpegbuf, jpegbufsize, &header.width, &header.height, &header.subsampling ) != 0 )
 	{
 		BOOST_THROW_EXCEPTION( exception::FileNotExist()
 			<< exception::user( tjGetErrorStr() )
 			<< exception::filename( _params.filepath ) );
 	}
 	
-	yuvsize = tjBufSizeYUV( width, height, jpegsubsamp );
-	bufsize = tjBufSize( width, height, jpegsubsamp );
-	
-	rgbbuf = new unsigned char[ bufsize ];
-	
-	ret = tjDecompress2( jpeghandle, jpegbuf, jpgbufsize, rgbbuf, width, 0, height, ps, flags );
-	if( ret != 0 )
+	try
 	{
-		BOOST_THROW_EXCEPTION( exception::File()
-			<< exception::user( tjGetErrorStr() )
-			<< exception::filename( _params.filepath ) );
+		if( decompressIntoView( context.handle, jpegbuf, jpegbufsize, header, flags, dst, IsDirectlyDecodable() ) )
+			return;
+
+		// Pixel type without TurboJpeg equivalent: decode in rgb8 and convert.
+		context.rgbBuffer.resize( header.width * header.height * tjPixelSize[TJPF_RGB] );
+		if( tjDecompress2( context.handle, jpegbuf, jpegbufsize, &context.rgbBuffer[0], header.width, 0, header.height, TJPF_RGB, flags ) != 0 )
+		{
+			BOOST_THROW_EXCEPTION( exception::File()
+				<< exception::user( tjGetErrorStr() ) );
+		}
+	}
+	catch( exception::Common& e )
+	{
+		e << exception::filename( _params.filepath );
+		throw;
 	}
 	
-	rgb8_view_t bufferView = interleaved_view( width, height,
-											( typename rgb8_view_t::value_type* )( rgbbuf ),
-											 width * sizeof( typename rgb8_view_t::value_type ) );
+	rgb8_view_t bufferView = interleaved_view( header.width, header.height,
+	                                           ( rgb8_view_t::value_type* )( &context.rgbBuffer[0] ),
+	                                           header.width * sizeof( rgb8_view_t::value_type ) );
 	
 	boost::gil::copy_and_convert_pixels( bufferView, dst );
-	
-	delete[] jpegbuf; jpegbuf = NULL;
-	delete[] rgbbuf;  rgbbuf = NULL;
-	tjDestroy( jpeghandle );
-	fclose(file); file = NULL;
 }
 
 }
@@ -3,12 +3,120 @@
 
 #include <terry/channel.hpp>
 
+#include <Iex.h>
+#include <CtlSimdInterpreter.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
 namespace tuttle {
 namespace plugin {
 namespace ctl {
 
+template<class Type>
+void fillInputArg( Ctl::FunctionArgPtr& arg, const std::string& argStr, const Type& v, const std::size_t n )
+{
+	if( !arg ||
+//		!arg->type().cast<half>() ||
+		!arg->isVarying( ) )
+	{
+		// The CTL function has no argument argStr, the argument
+		// is not of type half, or the argument is not varying
+		BOOST_THROW_EXCEPTION( Iex::ArgExc( std::string("Cannot set value of argument ")+argStr ) );
+	}
+
+	memcpy( arg->data(), &v, n*sizeof(Type) );
+}
+
+template<class Type>
+void retrieveOutputArg( const Ctl::FunctionArgPtr& arg, const std::string& argStr, Type& v, const std::size_t n )
+{
+	if( !arg ||
+//		!arg->type( ).cast<half>() ||
+		!arg->isVarying( ) )
+	{
+		// The CTL function has no argument argStr, the argument
+		// is not of type half, or the argument is not varying
+		BOOST_THROW_EXCEPTION( Iex::ArgExc( std::string("Cannot set value of argument ")+argStr ) );
+	}
+
+	memcpy( &v, arg->data(), n*sizeof(Type) );
+}
+
+template<class Type>
+void callCtlChunk(
+	Ctl::FunctionCallPtr call,
+	const std::size_t n,
+	Type& rOut,
+	Type& gOut,
+	Type& bOut,
+	Type& aOut,
+	const Type& r,
+	const Type& g,
+	const Type& b,
+	const Type& a )
+{
+	// First set the input arguments for the function call:
+	Ctl::FunctionArgPtr rArg = call->findInputArg( "rIn" );
+	fillInputArg( rArg, "rIn", r, n );
+	Ctl::FunctionArgPtr gArg = call->findInputArg( "gIn" );
+	fillInputArg( gArg, "gIn", g, n );
+	Ctl::FunctionArgPtr bArg = call->findInputArg( "bIn" );
+	fillInputArg( bArg, "bIn", b, n );
+	Ctl::FunctionArgPtr aArg = call->findInputArg( "aIn" );
+	fillInputArg( aArg, "aIn", a, n );
+
+	// Now we can call the CTL function for
+	// pixels 0, through n-1
+	call->callFunction( n );
 
+	// Retrieve the results
+	Ctl::FunctionArgPtr rOutArg = call->findOutputArg( "rOut" );
+	retrieveOutputArg( rOutArg, "rOut", rOut, n );
+	Ctl::FunctionArgPtr gOutArg = call->findOutputArg( "gOut" );
+	retrieveOutputArg( gOutArg, "gOut", gOut, n );
+	Ctl::FunctionArgPtr bOutArg = call->findOutputArg( "bOut" );
+	retrieveOutputArg( bOutArg, "bOut", bOut, n );
+	Ctl::FunctionArgPtr aOutArg = call->findOutputArg( "aOut" );
+	retrieveOutputArg( aOutArg, "aOut", aOut, n );
+}
+
+/**
+ * @brief Call the CTL function on @p size samples (planar buffers),
+ * by chunks of the maximum number of samples of the interpreter.
+ */
+template<class Type>
+void callCtl(
+	Ctl::Interpreter &interp,
+	Ctl::FunctionCallPtr call,
+	const std::size_t size,
+	Type* rOut,
+	Type* gOut,
+	Type* bOut,
+	Type* aOut,
+	const Type* r,
+	const Type* g,
+	const Type* b,
+	const Type* a )
+{
+	std::size_t n = size;
+	while( n > 0 )
+	{
+		const std::size_t m = std::min( n, interp.maxSamples() );
+		callCtlChunk( call, m, *rOut, *gOut, *bOut, *aOut, *r, *g, *b, *a );
 
+		n    -= m;
+		rOut += m;
+		gOut += m;
+		bOut += m;
+		aOut += m;
+		r    += m;
+		g    += m;
+		b    += m;
+		a    += m;
+	}
+}
 
 }
 }
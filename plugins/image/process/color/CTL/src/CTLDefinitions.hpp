@@ -22,6 +22,9 @@ enum EParamChooseInput
 
 static const std::string kParamCTLCode               ( "code" );
 
+static const std::string kParamBakeLut               ( "bakeLut" );
+static const std::string kParamLutSize               ( "lutSize" );
+
 }
 }
 }
@@ -0,0 +1,190 @@
+#include "CTLModule.hpp"
+#include "CTLAlgorithm.hpp"
+
+#include <terry/lru_cache.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <ctime>
+
+namespace bfs = boost::filesystem;
+
+namespace tuttle {
+namespace plugin {
+namespace ctl {
+
+namespace {
+
+static const std::size_t kMaxNbModules = 8;
+/// more than the render threads, the others are released
+static const std::size_t kMaxNbCalls = 64;
+
+/**
+ * @brief Identifies the code of a module: the hash is compared first, then the content.
+ */
+struct CTLModuleKey
+{
+	std::size_t _hash;
+	EParamChooseInput _inputType;
+	std::string _code;
+	std::string _filename;
+	std::string _module;
+	std::vector<std::string> _paths;
+	std::time_t _lastWriteTime;
+
+	CTLModuleKey( const CTLProcessParams<float>& params )
+		: _hash( 0 )
+		, _inputType( params._inputType )
+		, _code( params._code )
+		, _filename( params._filename )
+		, _module( params._module )
+		, _paths( params._paths )
+		, _lastWriteTime( 0 )
+	{
+		if( _inputType == eParamChooseInputFile )
+		{
+			boost::system::error_code error;
+			_lastWriteTime = bfs::last_write_time( _filename, error );
+		}
+		boost::hash_combine( _hash, static_cast<int>( _inputType ) );
+		boost::hash_combine( _hash, _code );
+		boost::hash_combine( _hash, _filename );
+		boost::hash_combine( _hash, _module );
+		boost::hash_range( _hash, _paths.begin(), _paths.end() );
+		boost::hash_combine( _hash, _lastWriteTime );
+	}
+
+	bool operator==( const CTLModuleKey& other ) const
+	{
+		return _hash == other._hash &&
+		       _inputType == other._inputType &&
+		       _lastWriteTime == other._lastWriteTime &&
+		       _code == other._code &&
+		       _filename == other._filename &&
+		       _module == other._module &&
+		       _paths == other._paths;
+	}
+};
+
+/// The last used modules, shared by all the instances.
+typedef terry::lru_cache<CTLModuleKey, CTLModulePtr> CTLModuleCache;
+
+CTLModuleCache& ctlModuleCache()
+{
+	static CTLModuleCache cache( kMaxNbModules );
+	return cache;
+}
+
+struct CTLModuleLoader
+{
+	const CTLProcessParams<float>& _params;
+	CTLModuleLoader( const CTLProcessParams<float>& params ) : _params( params ) {}
+	CTLModulePtr operator()() const { return CTLModulePtr( new CTLModule( _params ) ); }
+};
+
+}
+
+CTLModule::CTLModule( const CTLProcessParams<float>& params )
+{
+	switch( params._inputType )
+	{
+		case eParamChooseInputCode:
+		{
+			TUTTLE_LOG_TRACE( "CTL -- Load code: " << params._code );
+			_interpreter.loadModule( "", "", params._code );
+			break;
+		}
+		case eParamChooseInputFile:
+		{
+			_interpreter.setModulePaths( params._paths );
+			TUTTLE_LOG_TRACE( "CTL -- Load module: " << params._filename << " " << params._module );
+			_interpreter.loadFile( params._filename, params._module );
+			break;
+		}
+	}
+}
+
+Ctl::FunctionCallPtr CTLModule::acquireCall()
+{
+	{
+		boost::lock_guard<boost::mutex> lock( _mutex );
+		if( ! _calls.empty() )
+		{
+			Ctl::FunctionCallPtr call = _calls.back();
+			_calls.pop_back();
+			return call;
+		}
+	}
+	return _interpreter.newFunctionCall( "main" );
+}
+
+void CTLModule::releaseCall( const Ctl::FunctionCallPtr& call )
+{
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	if( _calls.size() < kMaxNbCalls )
+		_calls.push_back( call );
+}
+
+CTLLutPtr CTLModule::lut( const std::size_t size )
+{
+	{
+		boost::lock_guard<boost::mutex> lock( _mutex );
+		if( _lut && _lut->size() == size )
+			return _lut;
+	}
+
+	// the nodes of the grid, blue varies the fastest
+	const std::size_t nbNodes = size * size * size;
+	std::vector<float> inputs( nbNodes * 4 );
+	float* r = &inputs[0];
+	float* g = r + nbNodes;
+	float* b = g + nbNodes;
+	float* a = b + nbNodes;
+	std::size_t i = 0;
+	for( std::size_t ir = 0; ir < size; ++ir )
+		for( std::size_t ig = 0; ig < size; ++ig )
+			for( std::size_t ib = 0; ib < size; ++ib, ++i )
+			{
+				r[i] = float( ir ) / ( size - 1 );
+				g[i] = float( ig ) / ( size - 1 );
+				b[i] = float( ib ) / ( size - 1 );
+				a[i] = 1.0f;
+			}
+
+	std::vector<float> outputs( nbNodes * 4 );
+	float* rOut = &outputs[0];
+	float* gOut = rOut + nbNodes;
+	float* bOut = gOut + nbNodes;
+	float* aOut = bOut + nbNodes;
+	{
+		ScopedCTLFunctionCall call( *this );
+		callCtl<float>( _interpreter, call.get(), nbNodes, rOut, gOut, bOut, aOut, r, g, b, a );
+	}
+
+	std::vector<float> nodes( nbNodes * 3 );
+	for( i = 0; i < nbNodes; ++i )
+	{
+		nodes[i * 3]     = rOut[i];
+		nodes[i * 3 + 1] = gOut[i];
+		nodes[i * 3 + 2] = bOut[i];
+	}
+	boost::shared_ptr<terry::color::lut3d> lut( new terry::color::lut3d() );
+	lut->assign( size, nodes.begin() );
+
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	_lut = lut;
+	return _lut;
+}
+
+CTLModulePtr getCTLModule( const CTLProcessParams<float>& params )
+{
+	// the module is loaded under the lock, the other renders wait for it.
+	// The renders using a module removed from the cache keep it alive.
+	return ctlModuleCache().get( CTLModuleKey( params ), CTLModuleLoader( params ) );
+}
+
+}
+}
+}
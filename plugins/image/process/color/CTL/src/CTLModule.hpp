@@ -0,0 +1,90 @@
+#ifndef _TUTTLE_PLUGIN_CTL_MODULE_HPP_
+#define _TUTTLE_PLUGIN_CTL_MODULE_HPP_
+
+#include "CTLPlugin.hpp"
+
+#include <terry/color/lut.hpp>
+
+#include <CtlSimdInterpreter.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace ctl {
+
+typedef boost::shared_ptr<const terry::color::lut3d> CTLLutPtr;
+
+/**
+ * @brief A CTL module loaded in its interpreter, with the calls of its main
+ * function ready to be used by the render threads.
+ *
+ * The modules are shared by the frames and the instances with the same code
+ * (see getCTLModule), they are only loaded once.
+ * A function call holds its arguments, so it is used by only one thread at a time.
+ */
+class CTLModule : boost::noncopyable
+{
+public:
+	/// @brief Load the code or the file of @p params, throws the CTL exceptions.
+	CTLModule( const CTLProcessParams<float>& params );
+
+	Ctl::Interpreter& interpreter() { return _interpreter; }
+
+	/// @brief A call of the main function, to give back with releaseCall().
+	Ctl::FunctionCallPtr acquireCall();
+	void releaseCall( const Ctl::FunctionCallPtr& call );
+
+	/**
+	 * @brief The main function baked in a 3D LUT on [0, 1]^3, with @p size nodes on each axis.
+	 * The alpha input of the bake is 1.
+	 */
+	CTLLutPtr lut( const std::size_t size );
+
+private:
+	Ctl::SimdInterpreter _interpreter;
+	boost::mutex _mutex;
+	std::vector<Ctl::FunctionCallPtr> _calls; ///< the free function calls
+	CTLLutPtr _lut; ///< last baked LUT
+};
+
+typedef boost::shared_ptr<CTLModule> CTLModulePtr;
+
+/**
+ * @brief The module of @p params, loaded on the first use.
+ * The files are identified by their name and their last modification.
+ */
+CTLModulePtr getCTLModule( const CTLProcessParams<float>& params );
+
+/**
+ * @brief A function call taken from a module for the current scope.
+ */
+class ScopedCTLFunctionCall : boost::noncopyable
+{
+public:
+	ScopedCTLFunctionCall( CTLModule& module )
+		: _module( module )
+		, _call( module.acquireCall() )
+	{}
+
+	~ScopedCTLFunctionCall()
+	{
+		_module.releaseCall( _call );
+	}
+
+	const Ctl::FunctionCallPtr& get() const { return _call; }
+
+private:
+	CTLModule& _module;
+	Ctl::FunctionCallPtr _call;
+};
+
+}
+}
+}
+
+#endif
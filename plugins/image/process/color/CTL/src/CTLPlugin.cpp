@@ -5,6 +5,7 @@
 #include <boost/gil/gil_all.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <boost/filesystem/path.hpp>
 
@@ -20,8 +21,11 @@ CTLPlugin::CTLPlugin( OfxImageEffectHandle handle )
 	_paramCode         = fetchStringParam     ( kParamCTLCode );
 	_paramFile         = fetchStringParam     ( kTuttlePluginFilename );
 	_paramUpdateRender = fetchPushButtonParam ( kParamChooseInputCodeUpdate );
+	_paramBakeLut      = fetchBooleanParam    ( kParamBakeLut );
+	_paramLutSize      = fetchIntParam        ( kParamLutSize );
 
 	changedParam ( _instanceChangedArgs, kParamChooseInput );
+	changedParam ( _instanceChangedArgs, kParamBakeLut );
 }
 
 CTLProcessParams<CTLPlugin::Scalar> CTLPlugin::getProcessParams( const OfxPointD& renderScale ) const
@@ -49,6 +53,8 @@ CTLProcessParams<CTLPlugin::Scalar> CTLPlugin::getProcessParams( const OfxPointD
 			break;
 		}
 	}
+	params._bakeLut = _paramBakeLut->getValue();
+	params._lutSize = std::max( 2, _paramLutSize->getValue() );
 	return params;
 }
 
@@ -83,6 +89,10 @@ void CTLPlugin::changedParam( const OFX::InstanceChangedArgs &args, const std::s
 	{
 		_paramInput->setValue( eParamChooseInputFile );
 	}
+	else if( paramName == kParamBakeLut )
+	{
+		_paramLutSize->setEnabled( _paramBakeLut->getValue() );
+	}
 }
 
 bool CTLPlugin::getRegionOfDefinition( const OFX::RegionOfDefinitionArguments& args, OfxRectD& rod )
@@ -17,6 +17,8 @@ struct CTLProcessParams
 	std::string _filename;
 	std::string _module;
 	std::string _code;
+	bool _bakeLut;
+	std::size_t _lutSize;
 };
 
 /**
@@ -44,6 +46,8 @@ public:
 	OFX::StringParam*        _paramCode;
 	OFX::StringParam*        _paramFile;
 	OFX::PushButtonParam*    _paramUpdateRender;
+	OFX::BooleanParam*       _paramBakeLut;
+	OFX::IntParam*           _paramLutSize;
 private:
 	OFX::InstanceChangedArgs _instanceChangedArgs;
 };
@@ -112,6 +112,19 @@ void CTLPluginFactory::describeInContext( OFX::ImageEffectDescriptor& desc,
 	file->setHint ( "CTL source code file." );
 	file->setStringType( OFX::eStringTypeFilePath );
 
+	OFX::BooleanParamDescriptor* bakeLut = desc.defineBooleanParam( kParamBakeLut );
+	bakeLut->setLabel( "Bake LUT" );
+	bakeLut->setHint( "Apply the CTL function through a 3D LUT of the [0, 1] cube, computed once.\n"
+	                  "Only for the transforms of the color of each pixel which don't depend on the alpha: "
+	                  "the alpha is kept and the values out of [0, 1] are clamped." );
+	bakeLut->setDefault( false );
+
+	OFX::IntParamDescriptor* lutSize = desc.defineIntParam( kParamLutSize );
+	lutSize->setLabel( "LUT size" );
+	lutSize->setHint( "Number of nodes of the 3D LUT on each axis." );
+	lutSize->setRange( 2, 129 );
+	lutSize->setDisplayRange( 17, 65 );
+	lutSize->setDefault( 33 );
 
 }
 
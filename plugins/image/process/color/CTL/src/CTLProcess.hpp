@@ -1,9 +1,9 @@
 #ifndef _TUTTLE_PLUGIN_CTL_PROCESS_HPP_
 #define _TUTTLE_PLUGIN_CTL_PROCESS_HPP_
 
-#include <tuttle/plugin/ImageGilFilterProcessor.hpp>
+#include "CTLModule.hpp"
 
-#include <CtlSimdInterpreter.h>
+#include <tuttle/plugin/ImageGilFilterProcessor.hpp>
 
 namespace tuttle {
 namespace plugin {
@@ -24,7 +24,8 @@ protected:
     CTLPlugin&    _plugin;            ///< Rendering plugin
 	CTLProcessParams<Scalar> _params; ///< parameters
 
-	Ctl::SimdInterpreter _interpreter;
+	CTLModulePtr _module; ///< loaded module, shared with the other renders
+	CTLLutPtr _lut;       ///< baked main function, if requested
 
 public:
     CTLProcess( CTLPlugin& effect );
@@ -32,6 +33,10 @@ public:
 	void setup( const OFX::RenderArguments& args );
 
     void multiThreadProcessImages( const OfxRectI& procWindowRoW );
+
+private:
+	void processCtl( const OfxRectI& procWindow );
+	void processLut( const OfxRectI& procWindow );
 };
 
 }
@@ -6,6 +6,9 @@
 #include <Iex.h>
 #include <CtlMessage.h>
 
+#include <algorithm>
+#include <vector>
+
 
 namespace tuttle {
 namespace plugin {
@@ -23,106 +26,6 @@ void ctlMessageOutput( const std::string& message )
 	}
 }
 
-template<class Type>
-void fillInputArg( Ctl::FunctionArgPtr& arg, const std::string& argStr, const Type& v, const std::size_t n )
-{
-	if( !arg ||
-//		!arg->type().cast<half>() ||
-		!arg->isVarying( ) )
-	{
-		// The CTL function has no argument argStr, the argument
-		// is not of type half, or the argument is not varying
-		BOOST_THROW_EXCEPTION( Iex::ArgExc( std::string("Cannot set value of argument ")+argStr ) );
-	}
-
-	memcpy( arg->data(), &v, n*sizeof(Type) );
-}
-
-template<class Type>
-void retrieveOutputArg( const Ctl::FunctionArgPtr& arg, const std::string& argStr, Type& v, const std::size_t n )
-{
-	if( !arg ||
-//		!arg->type( ).cast<half>() ||
-		!arg->isVarying( ) )
-	{
-		// The CTL function has no argument argStr, the argument
-		// is not of type half, or the argument is not varying
-		BOOST_THROW_EXCEPTION( Iex::ArgExc( std::string("Cannot set value of argument ")+argStr ) );
-	}
-
-	memcpy( &v, arg->data(), n*sizeof(Type) );
-}
-
-template<class Type>
-void callCtlChunk(
-	Ctl::FunctionCallPtr call,
-	const std::size_t n,
-	Type& rOut,
-	Type& gOut,
-	Type& bOut,
-	Type& aOut,
-	const Type& r,
-	const Type& g,
-	const Type& b,
-	const Type& a )
-{
-	// First set the input arguments for the function call:
-	Ctl::FunctionArgPtr rArg = call->findInputArg( "rIn" );
-	fillInputArg( rArg, "rIn", r, n );
-	Ctl::FunctionArgPtr gArg = call->findInputArg( "gIn" );
-	fillInputArg( gArg, "gIn", g, n );
-	Ctl::FunctionArgPtr bArg = call->findInputArg( "bIn" );
-	fillInputArg( bArg, "bIn", b, n );
-	Ctl::FunctionArgPtr aArg = call->findInputArg( "aIn" );
-	fillInputArg( aArg, "aIn", a, n );
-
-	// Now we can call the CTL function for
-	// pixels 0, through n-1
-	call->callFunction( n );
-
-	// Retrieve the results
-	Ctl::FunctionArgPtr rOutArg = call->findOutputArg( "rOut" );
-	retrieveOutputArg( rOutArg, "rOut", rOut, n );
-	Ctl::FunctionArgPtr gOutArg = call->findOutputArg( "gOut" );
-	retrieveOutputArg( gOutArg, "gOut", gOut, n );
-	Ctl::FunctionArgPtr bOutArg = call->findOutputArg( "bOut" );
-	retrieveOutputArg( bOutArg, "bOut", bOut, n );
-	Ctl::FunctionArgPtr aOutArg = call->findOutputArg( "aOut" );
-	retrieveOutputArg( aOutArg, "aOut", aOut, n );
-}
-
-template<class Type>
-void callCtl(
-	Ctl::Interpreter &interp,
-	Ctl::FunctionCallPtr call,
-	const std::size_t size,
-	Type* rOut,
-	Type* gOut,
-	Type* bOut,
-	Type* aOut,
-	const Type* r,
-	const Type* g,
-	const Type* b,
-	const Type* a )
-{
-	std::size_t n = size;
-	while( n > 0 )
-	{
-		const std::size_t m = std::min( n, interp.maxSamples() );
-		callCtlChunk( call, m, *rOut, *gOut, *bOut, *aOut, *r, *g, *b, *a );
-
-		n    -= m;
-		rOut += m;
-		gOut += m;
-		bOut += m;
-		aOut += m;
-		r    += m;
-		g    += m;
-		b    += m;
-		a    += m;
-	}
-}
-
 }
 
 template<class View>
@@ -140,23 +43,11 @@ void CTLProcess<View>::setup( const OFX::RenderArguments& args )
 	ImageGilFilterProcessor<View>::setup( args );
 	_params = _plugin.getProcessParams( args.renderScale );
 
-	switch( _params._inputType )
-	{
-		case eParamChooseInputCode:
-		{
-			TUTTLE_LOG_TRACE( "CTL -- Load code: " << _params._code );
-			_interpreter.loadModule( "", "", _params._code );
-			break;
-		}
-		case eParamChooseInputFile:
-		{
-			_interpreter.setModulePaths( _params._paths );
-			TUTTLE_LOG_TRACE( "CTL -- Load module: " << _params._filename << " " << _params._module );
-			_interpreter.loadFile( _params._filename, _params._module );
-			break;
-		}
-	}
 	Ctl::setMessageOutputFunction( ctlMessageOutput );
+	// loaded only if the code or the file has changed
+	_module = getCTLModule( _params );
+	if( _params._bakeLut )
+		_lut = _module->lut( _params._lutSize );
 }
 
 /**
@@ -165,43 +56,64 @@ void CTLProcess<View>::setup( const OFX::RenderArguments& args )
  */
 template<class View>
 void CTLProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
+{
+	if( procWindowRoW.x2 <= procWindowRoW.x1 )
+		return;
+	if( _lut )
+		processLut( procWindowRoW );
+	else
+		processCtl( procWindowRoW );
+}
+
+/**
+ * @brief Call the CTL function on groups of lines, filling the buffers of the interpreter.
+ */
+template<class View>
+void CTLProcess<View>::processCtl( const OfxRectI& procWindow )
 {
 	using namespace boost::gil;
 
-	Ctl::FunctionCallPtr call = _interpreter.newFunctionCall( "main" );
+	ScopedCTLFunctionCall call( *_module );
 
 	const OfxPointI procWindowSize = {
-		procWindowRoW.x2 - procWindowRoW.x1,
-		procWindowRoW.y2 - procWindowRoW.y1 };
-
-	const std::size_t alignment = 2;
-	rgba32f_planar_image_t srcWorkLine( procWindowSize.x, 1, alignment );
-	rgba32f_planar_view_t  srcWorkLineV = view( srcWorkLine );
-	rgba32f_planar_image_t dstWorkLine( procWindowSize.x, 1, alignment );
-	rgba32f_planar_view_t  dstWorkLineV = view( dstWorkLine );
-
-	for( int y = procWindowRoW.y1;
-			 y < procWindowRoW.y2;
-			 ++y )
+		procWindow.x2 - procWindow.x1,
+		procWindow.y2 - procWindow.y1 };
+
+	// as many lines as the interpreter can process in one call
+	const int nbLines = std::max( 1, std::min( procWindowSize.y, int( _module->interpreter().maxSamples() / procWindowSize.x ) ) );
+	const std::size_t chunkSize = std::size_t( procWindowSize.x ) * nbLines;
+
+	// planar buffers, the lines of a chunk are contiguous
+	std::vector<float> srcWork( chunkSize * 4 );
+	std::vector<float> dstWork( chunkSize * 4 );
+	float* r    = &srcWork[0];
+	float* g    = r + chunkSize;
+	float* b    = g + chunkSize;
+	float* a    = b + chunkSize;
+	float* rOut = &dstWork[0];
+	float* gOut = rOut + chunkSize;
+	float* bOut = gOut + chunkSize;
+	float* aOut = bOut + chunkSize;
+
+	for( int y = procWindow.y1;
+			 y < procWindow.y2;
+			 y += nbLines )
 	{
-		View srcLineV = subimage_view( this->_srcView, procWindowRoW.x1, y, procWindowSize.x, 1 );
-		View dstLineV = subimage_view( this->_dstView, procWindowRoW.x1, y, procWindowSize.x, 1 );
-
-		copy_pixels( srcLineV, srcWorkLineV );
+		const int height = std::min( nbLines, procWindow.y2 - y );
+		const std::size_t n = std::size_t( procWindowSize.x ) * height;
+		const rgba32f_planar_view_t srcWorkV = planar_rgba_view( procWindowSize.x, height,
+			reinterpret_cast<bits32f*>( r ), reinterpret_cast<bits32f*>( g ), reinterpret_cast<bits32f*>( b ), reinterpret_cast<bits32f*>( a ),
+			procWindowSize.x * sizeof( float ) );
+		const rgba32f_planar_view_t dstWorkV = planar_rgba_view( procWindowSize.x, height,
+			reinterpret_cast<bits32f*>( rOut ), reinterpret_cast<bits32f*>( gOut ), reinterpret_cast<bits32f*>( bOut ), reinterpret_cast<bits32f*>( aOut ),
+			procWindowSize.x * sizeof( float ) );
 
-		float* rOut    = reinterpret_cast<float*>( &dstWorkLineV(0,0)[0] );
-		float* gOut    = reinterpret_cast<float*>( &dstWorkLineV(0,0)[1] );
-		float* bOut    = reinterpret_cast<float*>( &dstWorkLineV(0,0)[2] );
-		float* aOut    = reinterpret_cast<float*>( &dstWorkLineV(0,0)[3] );
-		const float* r = reinterpret_cast<float*>( &srcWorkLineV(0,0)[0] );
-		const float* g = reinterpret_cast<float*>( &srcWorkLineV(0,0)[1] );
-		const float* b = reinterpret_cast<float*>( &srcWorkLineV(0,0)[2] );
-		const float* a = reinterpret_cast<float*>( &srcWorkLineV(0,0)[3] );
+		copy_and_convert_pixels( subimage_view( this->_srcView, procWindow.x1, y, procWindowSize.x, height ), srcWorkV );
 
 		callCtl<float>(
-				_interpreter,
-				call,
-				procWindowSize.x,
+				_module->interpreter(),
+				call.get(),
+				n,
 				rOut,
 				gOut,
 				bOut,
@@ -212,8 +124,33 @@ void CTLProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
 				a
 			);
 
-		copy_pixels( dstWorkLineV, dstLineV );
+		copy_and_convert_pixels( dstWorkV, subimage_view( this->_dstView, procWindow.x1, y, procWindowSize.x, height ) );
 
+		if( this->progressForward( n ) )
+			return;
+	}
+}
+
+/**
+ * @brief Apply the baked LUT line by line, on a float copy of the line (like the Lut plugin).
+ */
+template<class View>
+void CTLProcess<View>::processLut( const OfxRectI& procWindow )
+{
+	using namespace boost::gil;
+	const OfxPointI procWindowSize = {
+		procWindow.x2 - procWindow.x1,
+		procWindow.y2 - procWindow.y1 };
+
+	std::vector<rgba32f_pixel_t> line( procWindowSize.x );
+	rgba32f_view_t lineView = interleaved_view( procWindowSize.x, 1, &line.front(), procWindowSize.x * sizeof( rgba32f_pixel_t ) );
+	float* lineFloats = reinterpret_cast<float*>( &line.front()[0] );
+
+	for( int y = procWindow.y1; y < procWindow.y2; ++y )
+	{
+		copy_and_convert_pixels( subimage_view( this->_srcView, procWindow.x1, y, procWindowSize.x, 1 ), lineView );
+		_lut->apply_floats( lineFloats, lineFloats, procWindowSize.x, 4 );
+		copy_and_convert_pixels( lineView, subimage_view( this->_dstView, procWindow.x1, y, procWindowSize.x, 1 ) );
 		if( this->progressForward( procWindowSize.x ) )
 			return;
 	}
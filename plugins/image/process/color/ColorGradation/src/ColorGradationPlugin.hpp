@@ -4,6 +4,11 @@
 #include "ColorGradationDefinitions.hpp"
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 
+#include <terry/color/lut.hpp>
+#include <terry/color/lut_cache.hpp>
+
+#include <typeinfo>
+
 namespace tuttle {
 namespace plugin {
 namespace colorGradation {
@@ -27,6 +32,58 @@ struct ColorGradationProcessParams
 	bool              _processAlpha;
 };
 
+/**
+ * @brief Everything a baked gradation depends on: all the parameters except
+ * processAlpha, and the channel type of the images.
+ */
+struct GradationLutKey
+{
+	EParamGradation       _in;
+	EParamGradation       _out;
+
+	double                _GammaValueIn;
+	double                _BlackPointIn;
+	double                _WhitePointIn;
+	double                _GammaSensitoIn;
+
+	double                _GammaValueOut;
+	double                _BlackPointOut;
+	double                _WhitePointOut;
+	double                _GammaSensitoOut;
+
+	const std::type_info* _channelType;
+
+	template<typename Scalar>
+	GradationLutKey( const ColorGradationProcessParams<Scalar>& params, const std::type_info& channelType )
+	: _in( params._in )
+	, _out( params._out )
+	, _GammaValueIn( params._GammaValueIn )
+	, _BlackPointIn( params._BlackPointIn )
+	, _WhitePointIn( params._WhitePointIn )
+	, _GammaSensitoIn( params._GammaSensitoIn )
+	, _GammaValueOut( params._GammaValueOut )
+	, _BlackPointOut( params._BlackPointOut )
+	, _WhitePointOut( params._WhitePointOut )
+	, _GammaSensitoOut( params._GammaSensitoOut )
+	, _channelType( &channelType )
+	{}
+
+	bool operator==( const GradationLutKey& other ) const
+	{
+		return _in == other._in &&
+		       _out == other._out &&
+		       _GammaValueIn == other._GammaValueIn &&
+		       _BlackPointIn == other._BlackPointIn &&
+		       _WhitePointIn == other._WhitePointIn &&
+		       _GammaSensitoIn == other._GammaSensitoIn &&
+		       _GammaValueOut == other._GammaValueOut &&
+		       _BlackPointOut == other._BlackPointOut &&
+		       _WhitePointOut == other._WhitePointOut &&
+		       _GammaSensitoOut == other._GammaSensitoOut &&
+		       *_channelType == *other._channelType;
+	}
+};
+
 /**
  * @brief ColorGradation plugin
  */
@@ -64,6 +121,8 @@ public:
 	OFX::DoubleParam*       _paramOutGammaSensito;
 
 	OFX::BooleanParam*      _paramProcessAlpha;
+
+	terry::color::lut_cache<terry::color::lut1d, GradationLutKey> _lutCache; ///< baked gradations, by parameters and channel type
 };
 
 }
@@ -9,6 +9,7 @@
 #include <terry/globals.hpp>
 #include <terry/copy.hpp>
 #include <terry/colorspace/gradation.hpp>
+#include <terry/color/lut.hpp>
 
 #include <boost/mpl/if.hpp>
 #include <boost/static_assert.hpp>
@@ -19,6 +20,30 @@ namespace colorGradation {
 
 using namespace boost::gil;
 
+/**
+ * @brief Bake of a gradation for the channels of type Channel.
+ */
+template<class Channel, class TIN, class TOUT>
+struct GradationLutBaker
+{
+	typedef boost::shared_ptr<const terry::color::lut1d> LutPtr;
+	const TIN& _in;
+	const TOUT& _out;
+
+	GradationLutBaker( const TIN& in, const TOUT& out )
+	: _in( in )
+	, _out( out )
+	{}
+
+	LutPtr operator()() const
+	{
+		boost::shared_ptr<terry::color::lut1d> lut( new terry::color::lut1d() );
+		if( ! terry::color::bake_channel_lut1d<Channel>( terry::color::channel_color_gradation_t<Channel, TIN, TOUT>( _in, _out ), *lut ) )
+			return LutPtr(); // not accurate enough, use the exact gradation
+		return lut;
+	}
+};
+
 template<class View>
 ColorGradationProcess<View>::ColorGradationProcess( ColorGradationPlugin& effect )
 	: ImageGilFilterProcessor<View>( effect, eImageOrientationIndependant )
@@ -40,15 +65,22 @@ GIL_FORCEINLINE
 void ColorGradationProcess<View>::processSwitchAlpha( const bool processAlpha, const View& src, const View& dst, TIN gradationIn, TOUT gradationOut )
 {
 	using namespace boost::gil;
-	if( processAlpha )
-	{
-		terry::algorithm::transform_pixels_progress( src, dst, terry::color::transform_pixel_color_gradation_t<TIN, TOUT>( gradationIn, gradationOut ), *this );
-	}
+	typedef typename channel_type<View>::type Channel;
+	typedef terry::color::channel_color_gradation_t<Channel, TIN, TOUT> ChannelGradation;
+
+	// the gradation is baked once for all the threads and the frames with the same parameters
+	const boost::shared_ptr<const terry::color::lut1d> lut =
+		_plugin._lutCache.get( GradationLutKey( _params, typeid( Channel ) ), GradationLutBaker<Channel, TIN, TOUT>( gradationIn, gradationOut ) );
+	const ChannelGradation channelGradation( gradationIn, gradationOut );
+
+	/// @todo do not apply process on alpha directly inside transform, with a "channel_for_each_if_channel"
+	if( lut )
+		terry::algorithm::transform_pixels_progress( src, dst, terry::color::transform_pixel_lut1d_t<ChannelGradation>( *lut, channelGradation ), *this );
 	else
-	{
-		/// @todo do not apply process on alpha directly inside transform, with a "channel_for_each_if_channel"
 		terry::algorithm::transform_pixels_progress( src, dst, terry::color::transform_pixel_color_gradation_t<TIN, TOUT>( gradationIn, gradationOut ), *this );
 
+	if( ! processAlpha )
+	{
 		// temporary solution copy alpha channel
 		terry::copy_channel_if_exist<alpha_t>( src, dst );
 	}
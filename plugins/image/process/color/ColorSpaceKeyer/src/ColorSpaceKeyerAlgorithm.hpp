@@ -1,11 +1,67 @@
 #ifndef _TUTTLE_PLUGIN_COLORSPACEKEYER_ALGORITHM_HPP_
 #define _TUTTLE_PLUGIN_COLORSPACEKEYER_ALGORITHM_HPP_
 
+#include "GeodesicForm.hpp"
+
+#include <cmath>
+
 namespace tuttle {
 namespace plugin {
 namespace colorSpaceKeyer {
 
+/**
+ * @brief Exact matte of a color: 1 into the color geodesic form, 0 out of the spill
+ * geodesic form and the relative distance to the color form in between.
+ * The intersection tests use the intersection attributes of the forms,
+ * so each thread needs its own copy of the forms.
+ */
+inline double computeExactMatte( GeodesicForm& dataColor, GeodesicForm& dataSpill, const Ofx3DPointD& testPoint )
+{
+	double alpha = 0.0;
+	if(dataSpill.isIntoBoundingBox(testPoint))						//if current pixel is into spill bounding box
+	{
+		if(dataColor.isIntoBoundingBox(testPoint))					//bounding box test (process optimization)
+		{
+			if(dataColor.isPointIntoGeodesicForm(testPoint))		//if current pixel is into the color geodesic form
+			{
+				alpha = 1.0;										//change alpha to 1
+			}
+		}
+		if(alpha != 1.0 && dataSpill.isPointIntoGeodesicForm(testPoint))
+		{
+			//intersections test
+			if(dataColor.testIntersection2(testPoint,false,true)) //normal intersection
+			{
+				//computes vectors
+				Ofx3DPointD vectMax;
+				Ofx3DPointD vectMin;
+				//compute min vector
+				vectMin.x = testPoint.x - dataColor._intersectionPoint.x; //x value
+				vectMin.y = testPoint.y - dataColor._intersectionPoint.y; //y value
+				vectMin.z = testPoint.z - dataColor._intersectionPoint.z; //z value
+				//compute max vector
+				vectMax.x = dataSpill._intersectionPoint.x - dataColor._intersectionPoint.x; //x value
+				vectMax.y = dataSpill._intersectionPoint.y - dataColor._intersectionPoint.y; //y value
+				vectMax.z = dataSpill._intersectionPoint.z - dataColor._intersectionPoint.z; //z value
+				//compute norms
+				double normMin,normMax;			//initialize
+				normMin  = vectMin.x*vectMin.x;	//add x*x
+				normMin += vectMin.y*vectMin.y;	//add y*y
+				normMin += vectMin.z*vectMin.z;	//add z*z
+				normMin = std::sqrt(normMin);	//compute norm minimal
 
+				normMax  = vectMax.x*vectMax.x;	//add x*x
+				normMax += vectMax.y*vectMax.y;	//add y*y
+				normMax += vectMax.z*vectMax.z;	//add z*z
+				normMax = std::sqrt(normMax);	//compute norm maximal
+
+				//compute alpha value
+				alpha = normMin/normMax;
+			}
+		}
+	}
+	return alpha;
+}
 
 }
 }
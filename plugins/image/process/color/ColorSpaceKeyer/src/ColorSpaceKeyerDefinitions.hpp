@@ -95,6 +95,10 @@ const static std::string kBoolSpillSelectionDisplayLabel = "Display spill select
 const static std::string kDoubleScaleGeodesicForm = "scaleGF";
 const static std::string kDoubleScaleGeodesicFormLabel = "Scale geodesic form";
 
+//Baked matte (check box)
+const static std::string kBoolMatteLut = "matteLut";
+const static std::string kBoolMatteLutLabel = "Fast matte";
+
 //Rotation constants
 const static int KMaxDegres = 360;		//360° max for a rotation
 const static int kRotationSpeed = 5;	//mouse rotation scale
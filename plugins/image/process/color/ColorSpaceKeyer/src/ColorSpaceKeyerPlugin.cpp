@@ -3,6 +3,8 @@
 #include "ColorSpaceKeyerDefinitions.hpp"
 #include "CloudPointData.hpp"
 
+#include <tuttle/plugin/OfxMultiThreadLauncher.hpp>
+
 #include <boost/gil/gil_all.hpp>
 
 namespace tuttle {
@@ -31,6 +33,7 @@ ColorSpaceKeyerPlugin::ColorSpaceKeyerPlugin( OfxImageEffectHandle handle )
 		_paramDoubleScaleGF = fetchDoubleParam(kDoubleScaleGeodesicForm);				//scale geodesic form - double parameter
 		_paramBoolSeeSpillSelection = fetchBooleanParam(kBoolSpillSelectionDisplay);	//see spill selection - check box
 		_paramBoolDisplaySpillGF = fetchBooleanParam(kBoolDisplaySpillGF);				//see spill geodesic form - check box
+		_paramBoolMatteLut = fetchBooleanParam(kBoolMatteLut);							//use the baked matte - check box
 		
 		//verify display Discrete enable value
 		if(_paramBoolPointCloudDisplay->getValue())	//called default value
@@ -60,6 +63,7 @@ ColorSpaceKeyerPlugin::ColorSpaceKeyerPlugin( OfxImageEffectHandle handle )
 ColorSpaceKeyerProcessParams<ColorSpaceKeyerPlugin::Scalar> ColorSpaceKeyerPlugin::getProcessParams( const OfxPointD& renderScale ) const
 {
 	ColorSpaceKeyerProcessParams<Scalar> params;                   // create parameters container object
+	params._useMatteLut = _paramBoolMatteLut->getValue();          // baked or exact matte
 	return params;                                                 // pass parameters to process
 }
 
@@ -70,6 +74,10 @@ ColorSpaceKeyerProcessParams<ColorSpaceKeyerPlugin::Scalar> ColorSpaceKeyerPlugi
  */
 void ColorSpaceKeyerPlugin::changedParam( const OFX::InstanceChangedArgs &args, const std::string &paramName )
 {
+	if( paramName == kColorAverageMode || paramName == kColorAverageSelection || paramName == kDoubleScaleGeodesicForm )
+	{
+		_renderAttributes.recomputeGeodesicForm = true;	//process forms (and baked matte) depend on these parameters (even without overlay)
+	}
 	if( paramName == kPointCloudDisplay) //display point cloud check box value has changed
 	{
 		if( _paramBoolPointCloudDisplay->getValue() && hasCloudPointData() )	//display point cloud is selected
@@ -343,6 +351,9 @@ void ColorSpaceKeyerPlugin::render( const OFX::RenderArguments &args )
 	//update process attributes
 	if(_renderAttributes.recomputeGeodesicForm || _renderAttributes.time != args.time)
 		updateProcessGeodesicForms(args);
+	//bake the matte of the forms (once for all the renders with the same forms)
+	if(_paramBoolMatteLut->getValue() && !_renderAttributes.matteLut.isBaked())
+		_renderAttributes.matteLut.bake(OfxMultiThreadLauncher(), _renderAttributes.geodesicFormColor, _renderAttributes.geodesicFormSpill);
 	//call process functions
 	doGilRender<ColorSpaceKeyerProcess>( *this, args ); //launch process
 }
@@ -426,6 +437,7 @@ void ColorSpaceKeyerPlugin::updateProcessGeodesicForms(const OFX::RenderArgument
 	selectionAverage.extendGeodesicForm(_clipColor,_renderScale,_renderAttributes.geodesicFormColor);	//extends geodesic form color
 	_renderAttributes.geodesicFormSpill.copyGeodesicForm(_renderAttributes.geodesicFormColor);							//extends geodesic form spill (color clip)
 	selectionAverage.extendGeodesicForm(_clipSpill,_renderScale,_renderAttributes.geodesicFormSpill);	//extends geodesic form spill (spill takes account of spill clip)
+	_renderAttributes.matteLut.clear();																	//forms have changed (baked again before the process)
 	_renderAttributes.recomputeGeodesicForm = false;
 }
 
@@ -3,6 +3,7 @@
 
 #include "ColorSpaceKeyerDefinitions.hpp"
 #include "CloudPointData.hpp"
+#include "MatteLut.hpp"
 
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 
@@ -16,8 +17,10 @@ template<typename Scalar>
 struct ColorSpaceKeyerProcessParams
 {
 	OFX::Clip* _clipColor;                   //clip color
+	bool       _useMatteLut;                 //use the baked matte instead of the exact matte
 	ColorSpaceKeyerProcessParams()
 		: _clipColor( NULL )
+		, _useMatteLut( true )
 	{
 	}
 };
@@ -30,6 +33,12 @@ struct CSProcessParams
 	//Create geodesic form
 	GeodesicForm geodesicFormColor;          //color form
 	GeodesicForm geodesicFormSpill;          //spill form
+	MatteLut     matteLut;                   //matte of the forms (baked when the forms change)
+	CSProcessParams()
+		: time( 0 )
+		, recomputeGeodesicForm( true )
+	{
+	}
 };
 
 
@@ -58,6 +67,7 @@ public:
 	OFX::DoubleParam*     _paramDoubleScaleGF;              // scale geodesic form - Double parameters
 	OFX::BooleanParam*    _paramBoolSeeSpillSelection;      // see spill selection on overlay - check box
 	OFX::BooleanParam*    _paramBoolDisplaySpillGF;         // see spill geodesic form on screen - check box
+	OFX::BooleanParam*    _paramBoolMatteLut;               // use the baked matte - check box
 	
 	//Overlay data parameters
 	bool                  _updateVBO;                       // VBO data has been changed so update VBO
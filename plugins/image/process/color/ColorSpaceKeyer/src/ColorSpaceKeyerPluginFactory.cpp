@@ -197,6 +197,14 @@ void ColorSpaceKeyerPluginFactory::describeInContext( OFX::ImageEffectDescriptor
 	scaleGF->setDisplayRange(0,2);									//set display range
 	scaleGF->setHint("Scale geodesic form");						//help
 	scaleGF->setParent(groupProcess);								//add to process group	
+	
+	//Check box baked matte
+	OFX::BooleanParamDescriptor* matteLut = desc.defineBooleanParam(kBoolMatteLut);
+	matteLut->setLabel(kBoolMatteLutLabel);						//add label
+	matteLut->setDefault(true);									//check box is checked by default
+	matteLut->setHint("Interpolate the matte from a table computed when the selection changes.\n"
+	                  "Uncheck to test each pixel against the geodesic forms (slower, exact on the borders of the forms).");	//help
+	matteLut->setParent(groupProcess);							//add to process group
 }
 
 /**
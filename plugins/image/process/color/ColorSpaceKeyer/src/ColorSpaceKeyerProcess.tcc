@@ -18,6 +18,7 @@ template<class View>
 void ColorSpaceKeyerProcess<View>::setup( const OFX::RenderArguments& args )
 {
 	ImageGilFilterProcessor<View>::setup( args );
+	_params = _plugin.getProcessParams( args.renderScale );
 }
 
 /**
@@ -39,8 +40,12 @@ void ColorSpaceKeyerProcess<View>::multiThreadProcessImages( const OfxRectI& pro
 	View dst = subimage_view( this->_dstView, procWindowOutput.x1, procWindowOutput.y1,
 							                  procWindowSize.x, procWindowSize.y );
 	
+	//the exact intersection tests modify the forms, so each thread works on its own copy
+	GeodesicForm geodesicFormColor( _plugin._renderAttributes.geodesicFormColor );
+	GeodesicForm geodesicFormSpill( _plugin._renderAttributes.geodesicFormSpill );
+	const MatteLut* matteLut = _params._useMatteLut ? &_plugin._renderAttributes.matteLut : NULL;
     //Create and initialize functor 
-	Compute_alpha_pixel funct(false,_plugin._renderAttributes.geodesicFormColor, _plugin._renderAttributes.geodesicFormSpill); //Output is alpha
+	Compute_alpha_pixel funct(false, geodesicFormColor, geodesicFormSpill, matteLut); //Output is alpha
 	//this function is chose because of functor reference and not copy
 	terry::algorithm::transform_pixels_progress(src,dst,funct,*this);
 }
@@ -0,0 +1,23 @@
+#include "MatteLut.hpp"
+
+namespace tuttle {
+namespace plugin {
+namespace colorSpaceKeyer {
+
+MatteLut::MatteLut()
+: _size(0)
+{
+	_min.x = _min.y = _min.z = 0.0;
+	_max = _min;
+	_invStep = _min;
+}
+
+void MatteLut::clear()
+{
+	_values.clear();
+	_surfaceCells.clear();
+}
+
+}
+}
+}
@@ -0,0 +1,93 @@
+#ifndef MATTELUT_HPP
+#define	MATTELUT_HPP
+
+#include "GeodesicForm.hpp"
+#include "ColorSpaceKeyerAlgorithm.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace colorSpaceKeyer {
+
+/**
+ * @brief 3D table of the matte of the geodesic forms (see computeExactMatte).
+ *
+ * The matte is sampled on a regular grid over the bounding box of the spill
+ * form (the matte is 0 outside), each time the forms change, then each pixel
+ * only needs a trilinear interpolation of the 8 samples around its color.
+ * The matte is not continuous on the surfaces of the forms, so the cells
+ * with samples on both sides of a surface keep the exact matte.
+ */
+class MatteLut
+{
+public:
+	static const std::size_t kDefaultSize = 65;	//number of samples on each axis
+
+	MatteLut();
+
+	//Sample the matte of the geodesic forms on the threads of the launcher (OfxMultiThreadLauncher into the plugin)
+	template<class Launcher>
+	void bake(const Launcher& launcher, const GeodesicForm& dataColor, const GeodesicForm& dataSpill, const std::size_t size = kDefaultSize);
+	//Forget the samples (the forms have changed)
+	void clear();
+	//Has the table been baked since the last change of the forms
+	bool isBaked() const { return ! _values.empty(); }
+
+	//Trilinear interpolation of the matte (exact matte of the forms on the surfaces of the forms)
+	double operator()(GeodesicForm& dataColor, GeodesicForm& dataSpill, const Ofx3DPointD& testPoint) const
+	{
+		if(testPoint.x < _min.x || testPoint.x > _max.x ||
+		   testPoint.y < _min.y || testPoint.y > _max.y ||
+		   testPoint.z < _min.z || testPoint.z > _max.z)
+			return 0.0;	//out of the spill bounding box
+
+		std::size_t ix, iy, iz;
+		double fx, fy, fz;
+		cellCoordinate(testPoint.x - _min.x, _invStep.x, ix, fx);
+		cellCoordinate(testPoint.y - _min.y, _invStep.y, iy, fy);
+		cellCoordinate(testPoint.z - _min.z, _invStep.z, iz, fz);
+
+		const std::size_t cell = (iz * _size + iy) * _size + ix;
+		if(_surfaceCells[cell])
+			return computeExactMatte(dataColor, dataSpill, testPoint);
+
+		const float* v = &_values[cell];
+		const std::size_t dy = _size;
+		const std::size_t dz = _size * _size;
+		const double v00 = v[0]       + (v[1]           - v[0])       * fx;
+		const double v10 = v[dy]      + (v[dy + 1]      - v[dy])      * fx;
+		const double v01 = v[dz]      + (v[dz + 1]      - v[dz])      * fx;
+		const double v11 = v[dz + dy] + (v[dz + dy + 1] - v[dz + dy]) * fx;
+		const double v0 = v00 + (v10 - v00) * fy;
+		const double v1 = v01 + (v11 - v01) * fy;
+		return v0 + (v1 - v0) * fz;
+	}
+
+private:
+	//Index of the cell and position into the cell, on one axis
+	void cellCoordinate(const double offset, const double invStep, std::size_t& index, double& fraction) const
+	{
+		const double position = offset * invStep;
+		index = static_cast<std::size_t>(position);
+		if(index > _size - 2)	//the last sample is the end of the last cell
+			index = _size - 2;
+		fraction = position - index;
+	}
+
+	std::size_t _size;				//number of samples on each axis
+	Ofx3DPointD _min;				//first sample (spill bounding box)
+	Ofx3DPointD _max;				//last sample (spill bounding box)
+	Ofx3DPointD _invStep;			//number of cells by unit on each axis
+	std::vector<float> _values;		//samples, X first
+	std::vector<char> _surfaceCells;	//cells crossed by a surface of the forms (indexed by their first sample)
+};
+
+}
+}
+}
+
+#include "MatteLut.tcc"
+
+#endif	/* MATTELUT_HPP */
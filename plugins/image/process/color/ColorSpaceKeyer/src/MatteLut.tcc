@@ -0,0 +1,129 @@
+#include <terry/algorithm/parallel_reduce.hpp>
+
+namespace tuttle {
+namespace plugin {
+namespace colorSpaceKeyer {
+
+namespace detail {
+
+/*
+ * Sample the exact matte on the Z slices of the table.
+ * Each chunk of slices works on its own copy of the forms (intersection attributes).
+ */
+struct MatteSlices
+{
+	GeodesicForm _dataColor;	//copy of the color geodesic form
+	GeodesicForm _dataSpill;	//copy of the spill geodesic form
+	Ofx3DPointD _min;			//first sample
+	Ofx3DPointD _step;			//distance between two samples
+	std::size_t _size;			//number of samples on each axis
+	float* _values;				//samples
+
+	MatteSlices(const GeodesicForm& dataColor, const GeodesicForm& dataSpill, const Ofx3DPointD& min,
+	            const Ofx3DPointD& step, const std::size_t size, float* values)
+	: _dataColor(dataColor)
+	, _dataSpill(dataSpill)
+	, _min(min)
+	, _step(step)
+	, _size(size)
+	, _values(values)
+	{}
+
+	void operator()(const std::ptrdiff_t z)
+	{
+		float* v = _values + z * _size * _size;
+		Ofx3DPointD testPoint;
+		testPoint.z = _min.z + z * _step.z;
+		for(std::size_t y = 0; y < _size; ++y)
+		{
+			testPoint.y = _min.y + y * _step.y;
+			for(std::size_t x = 0; x < _size; ++x, ++v)
+			{
+				testPoint.x = _min.x + x * _step.x;
+				*v = static_cast<float>(computeExactMatte(_dataColor, _dataSpill, testPoint));
+			}
+		}
+	}
+};
+
+//Part of the forms of a matte value: out of the spill form, between the forms or into the color form
+inline int matteRegion(const float matte)
+{
+	if(matte == 0.0f)
+		return 0;
+	if(matte == 1.0f)
+		return 2;
+	return 1;
+}
+
+/*
+ * Find the cells of the Z slices with samples in different parts of the forms.
+ */
+struct SurfaceSlices
+{
+	const float* _values;	//samples
+	std::size_t _size;		//number of samples on each axis
+	char* _surfaceCells;	//cells crossed by a surface
+
+	SurfaceSlices(const float* values, const std::size_t size, char* surfaceCells)
+	: _values(values)
+	, _size(size)
+	, _surfaceCells(surfaceCells)
+	{}
+
+	void operator()(const std::ptrdiff_t z)
+	{
+		const std::size_t dy = _size;
+		const std::size_t dz = _size * _size;
+		for(std::size_t y = 0; y < _size - 1; ++y)
+		{
+			const std::size_t first = z * dz + y * dy;
+			for(std::size_t x = 0; x < _size - 1; ++x)
+			{
+				const float* v = _values + first + x;
+				const int region = matteRegion(v[0]);
+				_surfaceCells[first + x] =
+					matteRegion(v[1]) != region ||
+					matteRegion(v[dy]) != region || matteRegion(v[dy + 1]) != region ||
+					matteRegion(v[dz]) != region || matteRegion(v[dz + 1]) != region ||
+					matteRegion(v[dz + dy]) != region || matteRegion(v[dz + dy + 1]) != region;
+			}
+		}
+	}
+};
+
+//Number of cells by unit (0 for an empty axis)
+inline double inverseStep(const double step)
+{
+	return step > 0.0 ? 1.0 / step : 0.0;
+}
+
+}
+
+/*
+ * Sample the matte of the geodesic forms on the spill bounding box
+ */
+template<class Launcher>
+void MatteLut::bake(const Launcher& launcher, const GeodesicForm& dataColor, const GeodesicForm& dataSpill, const std::size_t size)
+{
+	_size = size < 2 ? 2 : size;
+	_min = dataSpill._boundingBox.min;
+	_max = dataSpill._boundingBox.max;
+
+	Ofx3DPointD step;
+	step.x = (_max.x - _min.x) / (_size - 1);
+	step.y = (_max.y - _min.y) / (_size - 1);
+	step.z = (_max.z - _min.z) / (_size - 1);
+	_invStep.x = detail::inverseStep(step.x);
+	_invStep.y = detail::inverseStep(step.y);
+	_invStep.z = detail::inverseStep(step.z);
+
+	_values.resize(_size * _size * _size);
+	terry::algorithm::parallel_for_rows(launcher, _size, detail::MatteSlices(dataColor, dataSpill, _min, step, _size, &_values[0]));
+	_surfaceCells.assign(_values.size(), 0);
+	terry::algorithm::parallel_for_rows(launcher, _size - 1, detail::SurfaceSlices(&_values[0], _size, &_surfaceCells[0]));
+}
+
+}
+}
+}
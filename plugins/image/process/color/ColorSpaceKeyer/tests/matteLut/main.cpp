@@ -0,0 +1,154 @@
+#include <MatteLut.hpp>
+#include <ColorSpaceKeyerAlgorithm.hpp>
+
+#include <terry/algorithm/parallel_reduce.hpp>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real.hpp>
+#include <boost/random/variate_generator.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#define BOOST_TEST_MODULE plugin_colorSpaceKeyer_matteLut
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test;
+using namespace tuttle::plugin::colorSpaceKeyer;
+
+namespace {
+
+/// Mean absolute difference allowed between the baked and the exact matte
+const double kMeanTolerance = 1e-3;
+/// Difference allowed on each color (the exact matte is not smooth on the edges of the triangles)
+const double kMaxTolerance = 5e-2;
+/// Part of the colors allowed over kMaxTolerance, into the cells crossed by a surface between their samples
+const double kSurfaceMissTolerance = 2e-3;
+
+typedef boost::variate_generator<boost::mt19937&, boost::uniform_real<> > Random;
+
+Ofx3DPointD randomPoint( Random& random, const Ofx3DPointD& center, const double radius )
+{
+	Ofx3DPointD point;
+	point.x = center.x + ( random() * 2.0 - 1.0 ) * radius;
+	point.y = center.y + ( random() * 2.0 - 1.0 ) * radius;
+	point.z = center.z + ( random() * 2.0 - 1.0 ) * radius;
+	return point;
+}
+
+/// Geodesic forms extended to random selections around a random color, like the process forms of the plugin
+struct RandomForms
+{
+	GeodesicForm _color;
+	GeodesicForm _spill;
+
+	explicit RandomForms( Random& random )
+	{
+		Ofx3DPointD center;
+		center.x = 0.2 + random() * 0.6;
+		center.y = 0.2 + random() * 0.6;
+		center.z = 0.2 + random() * 0.6;
+		_color.subdiviseFaces( center, 10 );
+		_spill.subdiviseFaces( center, 10 );
+		for( int i = 0; i < 50; ++i )
+		{
+			Ofx3DPointD point = randomPoint( random, center, 0.1 );
+			if( ! _color.isPointIntoGeodesicForm( point ) )
+				_color.extendOnePoint( point );
+		}
+		_spill.copyGeodesicForm( _color );
+		for( int i = 0; i < 50; ++i )
+		{
+			Ofx3DPointD point = randomPoint( random, center, 0.25 );
+			if( ! _spill.isPointIntoGeodesicForm( point ) )
+				_spill.extendOnePoint( point );
+		}
+	}
+};
+
+/// Is the matte of @p point the same on all the corners of a cube of half side @p radius around it
+bool isFarFromSurfaces( GeodesicForm& color, GeodesicForm& spill, const Ofx3DPointD& point, const double radius )
+{
+	const double matte = computeExactMatte( color, spill, point );
+	const bool inside = matte > 0.0 && matte < 1.0;
+	for( int corner = 0; corner < 8; ++corner )
+	{
+		Ofx3DPointD cornerPoint = point;
+		cornerPoint.x += corner & 1 ? radius : -radius;
+		cornerPoint.y += corner & 2 ? radius : -radius;
+		cornerPoint.z += corner & 4 ? radius : -radius;
+		const double cornerMatte = computeExactMatte( color, spill, cornerPoint );
+		if( inside ? ( cornerMatte == 0.0 || cornerMatte == 1.0 ) : cornerMatte != matte )
+			return false;
+	}
+	return true;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( plugin_colorSpaceKeyer_matteLut )
+
+BOOST_AUTO_TEST_CASE( not_baked )
+{
+	MatteLut lut;
+	BOOST_CHECK( ! lut.isBaked() );
+}
+
+BOOST_AUTO_TEST_CASE( baked_matte_matches_exact_matte )
+{
+	boost::mt19937 generator( 42 );
+	Random random( generator, boost::uniform_real<>( 0.0, 1.0 ) );
+
+	for( int form = 0; form < 8; ++form )
+	{
+		RandomForms forms( random );
+		MatteLut lut;
+		lut.bake( terry::algorithm::thread_launcher(), forms._color, forms._spill );
+		BOOST_REQUIRE( lut.isBaked() );
+
+		// colors into the spill bounding box and around it
+		const BoundingBox& box = forms._spill._boundingBox;
+		Ofx3DPointD center;
+		center.x = ( box.min.x + box.max.x ) * 0.5;
+		center.y = ( box.min.y + box.max.y ) * 0.5;
+		center.z = ( box.min.z + box.max.z ) * 0.5;
+		const double radius = std::max( box.max.x - box.min.x, std::max( box.max.y - box.min.y, box.max.z - box.min.z ) ) * 0.6;
+		const double cellSize = radius / ( MatteLut::kDefaultSize - 1 ) * 2.0;
+
+		const int nbColors = 20000;
+		double sum = 0.0;
+		int nbMisses = 0;
+		for( int i = 0; i < nbColors; ++i )
+		{
+			const Ofx3DPointD point = randomPoint( random, center, radius );
+			const double exact = computeExactMatte( forms._color, forms._spill, point );
+			const double baked = lut( forms._color, forms._spill, point );
+			BOOST_REQUIRE( baked >= 0.0 && baked <= 1.0 );
+			const double difference = std::fabs( baked - exact );
+			sum += difference;
+			if( difference > kMaxTolerance )
+			{
+				// the cells far from the surfaces are always interpolated right
+				if( isFarFromSurfaces( forms._color, forms._spill, point, cellSize ) )
+					BOOST_CHECK_SMALL( difference, kMaxTolerance );
+				++nbMisses;
+			}
+		}
+		BOOST_CHECK_SMALL( sum / nbColors, kMeanTolerance );
+		BOOST_CHECK_SMALL( double( nbMisses ) / nbColors, kSurfaceMissTolerance );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( cleared )
+{
+	boost::mt19937 generator( 7 );
+	Random random( generator, boost::uniform_real<>( 0.0, 1.0 ) );
+	RandomForms forms( random );
+
+	MatteLut lut;
+	lut.bake( terry::algorithm::serial_launcher(), forms._color, forms._spill, 9 );
+	BOOST_CHECK( lut.isBaked() );
+	lut.clear();
+	BOOST_CHECK( ! lut.isBaked() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -108,6 +108,10 @@ void ColorTransferPlugin::render( const OFX::RenderArguments &args )
 	BOOST_THROW_EXCEPTION( exception::Unknown() );
 }
 
+void ColorTransferPlugin::purgeCaches()
+{
+	_statisticsCache.clear();
+}
 
 }
 }
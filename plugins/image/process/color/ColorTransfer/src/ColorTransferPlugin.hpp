@@ -2,6 +2,7 @@
 #define _TUTTLE_PLUGIN_COLORTRANSFER_PLUGIN_HPP_
 
 #include "ColorTransferDefinitions.hpp"
+#include "ColorTransferStatisticsCache.hpp"
 
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 
@@ -35,6 +36,8 @@ public:
 	void getRegionsOfInterest( const OFX::RegionsOfInterestArguments& args, OFX::RegionOfInterestSetter& rois );
 
 	void render( const OFX::RenderArguments &args );
+
+	void purgeCaches();
 	
 public:
 	OFX::Clip* _clipSrcRef; ///< Source reference
@@ -44,6 +47,8 @@ public:
 	OFX::DoubleParam* _paramAverageCoef;
 	OFX::DoubleParam* _paramDynamicCoef;
 
+	ColorTransferStatisticsCache _statisticsCache; ///< statistics of the last reference images
+
 };
 
 }
@@ -62,6 +62,7 @@ public:
 	void multiThreadProcessImages( const OfxRectI& procWindowRoW );
 
 private:
+	/// @brief Statistics of the reference @p image, from the cache of the plugin if they are already computed.
 	void computeAverage( const View& image, Pixel& average, Pixel& deviation, const EColorspace& eColorspace );
 
 };
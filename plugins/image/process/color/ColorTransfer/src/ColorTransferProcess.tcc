@@ -13,6 +13,9 @@
 #include <terry/numeric/assign.hpp>
 #include <terry/numeric/sqrt.hpp>
 #include <terry/numeric/operations_assign.hpp>
+#include <terry/numeric/statistics.hpp>
+#include <terry/numeric/hash.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
 #include <terry/globals.hpp>
 
 #include <boost/units/pow.hpp>
@@ -120,6 +123,35 @@ struct ColorParams
 };
 
 
+/**
+ * @brief Row reducer of the mean and variance of an image in the colorspace of the transfer.
+ */
+template<class View, typename CPixel>
+struct ColorStatistics
+{
+	typedef typename View::value_type Pixel;
+	View _image;
+	EColorspace _eColorspace;
+	pixel_mean_variance_t<CPixel> _meanVariance;
+
+	ColorStatistics( const View& image, const EColorspace eColorspace )
+	: _image( image )
+	, _eColorspace( eColorspace )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		typename View::x_iterator src_it = _image.row_begin( y );
+		for( std::ptrdiff_t x = 0; x < _image.width(); ++x, ++src_it )
+			_meanVariance( getPixel<Pixel, CPixel>( *src_it, _eColorspace ) );
+	}
+
+	void merge( const ColorStatistics& other )
+	{
+		_meanVariance.merge( other._meanVariance );
+	}
+};
+
 template<class View>
 ColorTransferProcess<View>::ColorTransferProcess( ColorTransferPlugin &effect )
 : ImageGilFilterProcessor<View>( effect, eImageOrientationIndependant )
@@ -132,55 +164,43 @@ void ColorTransferProcess<View>::computeAverage( const View& image, Pixel& avera
 {
 	typedef typename color_space_type<View>::type Colorspace;
 	typedef pixel<boost::gil::bits64f, layout<Colorspace> > CPixel;
-	CPixel sumAverage, sumDeviation;
-	pixel_zeros_t<CPixel>()( sumAverage );
-	pixel_zeros_t<CPixel>()( sumDeviation );
-//	const std::size_t nbPixels = image.width( ) * image.height( );
-
-	// Average
-	CPixel cAverage;
-	pixel_zeros_t<CPixel>()( cAverage );
-	for( std::ssize_t y = 0; y < image.height( ); ++y )
+	static const std::size_t nbChannels = sizeof( Pixel ) / sizeof( Channel );
+	BOOST_STATIC_ASSERT( nbChannels <= ColorTransferStatistics::kMaxNbChannels );
+
+	// the hash of the pixels is much cheaper than the conversions to the colorspace
+	ColorTransferStatisticsKey key;
+	key._contentHash = terry::algorithm::parallel_reduce_rows( this->getLauncher(), image.height(), terry::numeric::view_content_hash_t<View>( image ) )._hash;
+	key._rod.x1 = 0;
+	key._rod.y1 = 0;
+	key._rod.x2 = image.width();
+	key._rod.y2 = image.height();
+	key._pixelSize = sizeof( Pixel );
+	key._nbChannels = nbChannels;
+	key._colorspace = eColorspace;
+
+	ColorTransferStatistics stats;
+	if( ! _plugin._statisticsCache.find( key, stats ) )
 	{
-		CPixel sumAverageLine;
-		pixel_zeros_t<CPixel>()( sumAverageLine );
-		typename View::x_iterator src_it = image.x_at( 0, y );
-		for( std::ssize_t x = 0; x < image.width( ); ++x, ++src_it )
+		// average and standard deviation in one parallel pass
+		const ColorStatistics<View, CPixel> reducer = terry::algorithm::parallel_reduce_rows( this->getLauncher(), image.height(),
+			ColorStatistics<View, CPixel>( image, eColorspace ) );
+		const CPixel standardDeviation = reducer._meanVariance.standard_deviation();
+		for( std::size_t c = 0; c < nbChannels; ++c )
 		{
-//			CPixel pix; pixel_assigns_t<Pixel, CPixel>()( * src_it, pix );
-			CPixel pix = getPixel<Pixel, CPixel>( *src_it, eColorspace );
-			pixel_plus_assign_t<CPixel, CPixel>()( pix, sumAverageLine );
+			stats._average[c] = reducer._meanVariance.mean[c];
+			stats._deviation[c] = standardDeviation[c];
 		}
-		pixel_divides_scalar_assign_t<double, CPixel>()( image.width(), sumAverageLine );
-		pixel_plus_assign_t<CPixel>()( sumAverageLine, cAverage );
+		_plugin._statisticsCache.insert( key, stats );
 	}
-	pixel_divides_scalar_assign_t<double, CPixel>()( image.height(), cAverage );
-	pixel_assigns_t<CPixel, Pixel>()( cAverage, average );
-//	average = pixel_divides_scalar_t<CPixel, double, Pixel>()( sumAverage, nbPixels );
 
-	CPixel cDeviation;
-	pixel_zeros_t<CPixel>()( cDeviation );
-	// Standard deviation
-	for( std::ssize_t y = 0; y < image.height( ); ++y )
+	CPixel cAverage, cDeviation;
+	for( std::size_t c = 0; c < nbChannels; ++c )
 	{
-		CPixel sumDeviationLine;
-		pixel_zeros_t<CPixel>()( sumDeviationLine );
-		typename View::x_iterator src_it = image.x_at( 0, y );
-		for( std::ssize_t x = 0; x < image.width(); ++x, ++src_it )
-		{
-//			CPixel pix; pixel_assigns_t<Pixel, CPixel>()( *src_it, pix );
-			CPixel pix = getPixel<Pixel, CPixel>( *src_it, eColorspace );
-			pixel_minus_assign_t<CPixel>()( cAverage, pix );
-			pix = pixel_pow_t<CPixel, 2>()( pix );
-			pixel_plus_assign_t<CPixel>()( pix, sumDeviationLine );
-		}
-		pixel_plus_assign_t<CPixel>()(
-				pixel_divides_scalar_t<CPixel, double>()( sumDeviationLine, image.width() ),
-				cDeviation
-			);
+		cAverage[c] = stats._average[c];
+		cDeviation[c] = stats._deviation[c];
 	}
-	pixel_divides_scalar_assign_t<double, CPixel>()( image.height(), cDeviation );
-	deviation = pixel_sqrt_t<CPixel,Pixel>()( cDeviation );
+	pixel_assigns_t<CPixel, Pixel>()( cAverage, average );
+	pixel_assigns_t<CPixel, Pixel>()( cDeviation, deviation );
 }
 
 template<class View>
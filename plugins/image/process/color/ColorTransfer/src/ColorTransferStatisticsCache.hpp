@@ -0,0 +1,62 @@
+#ifndef _TUTTLE_PLUGIN_COLORTRANSFER_STATISTICSCACHE_HPP_
+#define _TUTTLE_PLUGIN_COLORTRANSFER_STATISTICSCACHE_HPP_
+
+#include "ColorTransferDefinitions.hpp"
+
+#include <terry/lru_cache.hpp>
+
+#include <ofxCore.h>
+
+#include <cstddef>
+
+namespace tuttle {
+namespace plugin {
+namespace colorTransfer {
+
+/**
+ * @brief Average and standard deviation of each channel of a reference image,
+ * in the colorspace of the transfer.
+ */
+struct ColorTransferStatistics
+{
+	static const std::size_t kMaxNbChannels = 4;
+	double _average[kMaxNbChannels];
+	double _deviation[kMaxNbChannels];
+};
+
+/**
+ * @brief Identification of the statistics of a reference image.
+ * The host doesn't give any identifier of the content of the images,
+ * so the pixels are identified by a hash of their values (terry::numeric::view_content_hash_t).
+ * The time is not part of the key: a still reference has the same statistics at all the frames.
+ */
+struct ColorTransferStatisticsKey
+{
+	std::size_t _contentHash;
+	OfxRectI _rod;
+	std::size_t _pixelSize; ///< bytes per pixel
+	std::size_t _nbChannels;
+	EColorspace _colorspace;
+
+	bool operator==( const ColorTransferStatisticsKey& other ) const
+	{
+		return _contentHash == other._contentHash &&
+		       _rod.x1 == other._rod.x1 && _rod.y1 == other._rod.y1 &&
+		       _rod.x2 == other._rod.x2 && _rod.y2 == other._rod.y2 &&
+		       _pixelSize == other._pixelSize &&
+		       _nbChannels == other._nbChannels &&
+		       _colorspace == other._colorspace;
+	}
+};
+
+/**
+ * @brief The statistics of the last analysed reference images
+ * (the source and the destination references of a few instances).
+ */
+typedef terry::lru_cache<ColorTransferStatisticsKey, ColorTransferStatistics> ColorTransferStatisticsCache;
+
+}
+}
+}
+
+#endif
@@ -5,6 +5,9 @@
 
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 
+#include <terry/color/lut.hpp>
+#include <terry/color/lut_cache.hpp>
+
 namespace tuttle {
 namespace plugin {
 namespace gamma {
@@ -44,6 +47,8 @@ public:
 	OFX::DoubleParam* _alpha;
 	OFX::BooleanParam* _invert;
 	EGammaType getGammaType() const { return static_cast<EGammaType>( _gammaType->getValue() ); }
+
+	terry::color::lut_cache<terry::color::lut1d, double> _lutCache; ///< baked gammas, by exponent
 };
 
 }
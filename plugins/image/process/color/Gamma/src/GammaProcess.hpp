@@ -2,12 +2,37 @@
 #define _TUTTLE_PLUGIN_GAMMA_PROCESS_HPP_
 
 #include <tuttle/plugin/ImageGilFilterProcessor.hpp>
+
+#include <terry/color/lut.hpp>
+
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/array.hpp>
+
+#include <cmath>
 
 namespace tuttle {
 namespace plugin {
 namespace gamma {
 
+/**
+ * @brief x^exponent for the positive values, the other values are unchanged.
+ */
+struct GammaFunction
+{
+	double _exponent;
+
+	GammaFunction( const double exponent = 1.0 ) : _exponent( exponent ) {}
+
+	float operator()( const float v ) const
+	{
+		//x^a = e^aln(x)
+		if( v > 0.0 )
+			return float( std::exp( std::log( double( v ) ) * _exponent ) );
+		return v;
+	}
+};
+
 /**
  * @brief Gamma process
  *
@@ -20,10 +45,14 @@ public:
 
 protected:
 	GammaPlugin&    _plugin;        ///< Rendering plugin
+	boost::array<GammaFunction, 4> _gammas; ///< exact gamma of each channel (rgba)
+	boost::array<boost::shared_ptr<const terry::color::lut1d>, 4> _luts; ///< baked gamma of each channel, null if not accurate enough
 
 public:
 	GammaProcess( GammaPlugin& effect );
 
+	void setup( const OFX::RenderArguments& args );
+
 	void multiThreadProcessImages( const OfxRectI& procWindowRoW );
 };
 
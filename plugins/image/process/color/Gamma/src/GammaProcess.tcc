@@ -13,6 +13,40 @@ GammaProcess<View>::GammaProcess( GammaPlugin& effect )
 	, _plugin( effect )
 {}
 
+/**
+ * @brief Bake of a gamma on [0, 1].
+ */
+struct GammaLutBaker
+{
+	typedef boost::shared_ptr<const terry::color::lut1d> LutPtr;
+	const GammaFunction& _gamma;
+
+	GammaLutBaker( const GammaFunction& gamma ) : _gamma( gamma ) {}
+
+	LutPtr operator()() const
+	{
+		boost::shared_ptr<terry::color::lut1d> lut( new terry::color::lut1d() );
+		if( ! lut->bake( _gamma, 4096, 0.0f, 1.0f ) )
+			return LutPtr(); // not accurate enough, use the exact gamma
+		return lut;
+	}
+};
+
+template<class View>
+void GammaProcess<View>::setup( const OFX::RenderArguments& args )
+{
+	ImageGilFilterProcessor<View>::setup( args );
+	GammaProcessParams<GammaPlugin::Scalar> params = _plugin.getProcessParams();
+
+	_gammas[0] = GammaFunction( params.iRGamma );
+	_gammas[1] = GammaFunction( params.iGGamma );
+	_gammas[2] = GammaFunction( params.iBGamma );
+	_gammas[3] = GammaFunction( params.iAGamma );
+	// the baked gammas are shared by the channels, the threads and the frames with the same exponent
+	for( std::size_t c = 0; c < _gammas.size(); ++c )
+		_luts[c] = _plugin._lutCache.get( _gammas[c]._exponent, GammaLutBaker( _gammas[c] ) );
+}
+
 /**
  * @brief Function called by rendering thread each time a process must be done.
  * @param[in] procWindowRoW  Processing window
@@ -21,8 +55,7 @@ template<class View>
 void GammaProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
 {
 	using namespace boost::gil;
-	GammaProcessParams<GammaPlugin::Scalar> params = _plugin.getProcessParams();
-	OfxRectI procWindowOutput                      = this->translateRoWToOutputClipCoordinates( procWindowRoW );
+	OfxRectI procWindowOutput = this->translateRoWToOutputClipCoordinates( procWindowRoW );
 	const OfxPointI procWindowSize = {
 		procWindowRoW.x2 - procWindowRoW.x1,
 		procWindowRoW.y2 - procWindowRoW.y1 };
@@ -39,26 +72,14 @@ void GammaProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW
 		     x < procWindowOutput.x2;
 		     ++x, ++src_it, ++dst_it )
 		{
-			//x^a = e^aln(x)
 			color_convert( *src_it, wpix );
-			if( wpix[ 0 ] > 0.0 )
-			{
-				wpix[ 0 ] = exp( log( wpix[ 0 ] ) * params.iRGamma );
-			}
-
-			if( wpix[ 1 ] > 0.0 )
-			{
-				wpix[ 1 ] = exp( log( wpix[ 1 ] ) * params.iGGamma );
-			}
-
-			if( wpix[ 2 ] > 0.0 )
-			{
-				wpix[ 2 ] = exp( log( wpix[ 2 ] ) * params.iBGamma );
-			}
-
-			if( wpix[ 3 ] > 0.0 )
+			for( int c = 0; c < 4; ++c )
 			{
-				wpix[ 3 ] = exp( log( wpix[ 3 ] ) * params.iAGamma );
+				const float v = wpix[c];
+				if( _luts[c] && _luts[c]->in_domain( v ) )
+					wpix[c] = (*_luts[c])( v );
+				else
+					wpix[c] = _gammas[c]( v );
 			}
 			color_convert( wpix, *dst_it );
 		}
@@ -95,6 +95,10 @@ const static std::string kButtonRefreshOverlayLabel = "Refresh overlay";
 const static std::string knbStepRange = "numberOfStep";
 const static std::string knbStepRangeLabel = "Number of steps ";
 
+//sampling step
+const static std::string kSamplingStep = "samplingStep";
+const static std::string kSamplingStepLabel = "Sampling step ";
+
 //Curve from selection precision
 const static std::string kprecisionCurveFromSelection = "PrecisionCurvesFromSelection";
 const static std::string kprecisionCurveFromSelectionLabel = "Curves from selection precision";
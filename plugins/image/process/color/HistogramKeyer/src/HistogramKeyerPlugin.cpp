@@ -51,6 +51,7 @@ HistogramKeyerPlugin::HistogramKeyerPlugin( OfxImageEffectHandle handle )
 	_paramSelectionMultiplierSelection = fetchDoubleParam( kselectionMultiplier ); //selection multiplier (Advanced group)
 	_paramRefreshOverlaySelection = fetchPushButtonParam( kButtonRefreshOverlay ); //refresh overlay (Advanced group)
 	_paramNbStepSelection = fetchIntParam( knbStepRange ); //nb step range (Advanced group)
+	_paramSamplingStep = fetchIntParam( kSamplingStep ); //sampling step (Advanced group)
 	_paramClampCurveValues = fetchBooleanParam(kBoolClampValues); //clamp curve values (Advanced group)
 
 	_paramOutputSettingSelection = fetchChoiceParam( kOutputListParamLabel ); //output type (BW/alpha)
@@ -201,6 +202,15 @@ void HistogramKeyerPlugin::changedParam( const OFX::InstanceChangedArgs &args, c
 			getOverlayData()._isDataInvalid = true;
 		}
 	}
+	// sampling step changed
+	else if( paramName == kSamplingStep )
+	{
+		if( this->hasOverlayData( ) ) //if there is overlay value
+		{
+			getOverlayData().setSamplingStep( _paramSamplingStep->getValue( ) ); //change sampling step value
+			getOverlayData()._isDataInvalid = true;
+		}
+	}
 	// Clear user selection
 	else if( paramName == kButtonResetSelection )
 	{
@@ -729,6 +739,7 @@ void HistogramKeyerPlugin::changedClip( const OFX::InstanceChangedArgs& args, co
 	{
 		if( this->hasOverlayData( ) )
 		{
+			this->getOverlayData().invalidateSource();
 			this->getOverlayData()._isDataInvalid = true;
 			this->redrawOverlays();
 		}
@@ -757,6 +768,11 @@ void HistogramKeyerPlugin::render( const OFX::RenderArguments &args )
 	doGilRender<HistogramKeyerProcess>( *this, args );
 	_isRendering = false;		//plugin is not rendering anymore
 	
+	if( this->hasOverlayData( ) )
+	{
+		this->getOverlayData().invalidateSource(); //the source may have changed, the next overlay update analyses it again
+	}
+	
 	if( OFX::getImageEffectHostDescription()->hostName == "uk.co.thefoundry.nuke" )	/// @todo: HACK Nuke doesn't call changeClip function when time is changed
 	{
 		if( getOverlayData().isCurrentTimeModified(args.time) ) //if time is changed
@@ -776,6 +792,7 @@ void HistogramKeyerPlugin::addRefOverlayData( )
 	{
 		const OfxPointI imgSize = this->_clipSrc->getPixelRodSize( 0 ); ///@todo set the correct time !
 		_overlayData.reset( new OverlayData( imgSize, this->_paramNbStepSelection->getValue( ),this->_paramSelectionFromCurve->getValue()) );
+		_overlayData->setSamplingStep( this->_paramSamplingStep->getValue() );
 	}
 	++_overlayDataCount;
 }
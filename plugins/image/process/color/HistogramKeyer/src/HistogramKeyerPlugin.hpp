@@ -72,6 +72,7 @@ public:
 	OFX::ChoiceParam* _paramSelectionMode;			//selection mode unique/additive/subtractive (Selection group)
 	
 	OFX::IntParam* _paramNbStepSelection;				//step selection (Advanced group)
+	OFX::IntParam* _paramSamplingStep;					//sampling step (Advanced group)
 	OFX::DoubleParam* _paramSelectionMultiplierSelection;//selection multiplier (Advanced group)
 	OFX::PushButtonParam* _paramRefreshOverlaySelection; //refresh overlay button (Advanced group)
 	OFX::BooleanParam* _paramClampCurveValues;			//clamp curve values (Advanced group)
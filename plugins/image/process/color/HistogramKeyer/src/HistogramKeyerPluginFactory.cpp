@@ -350,6 +350,16 @@ void HistogramKeyerPluginFactory::describeInContext( OFX::ImageEffectDescriptor&
 		nbStepRange->setDefault(255);
 		nbStepRange->setEvaluateOnChange(false); // don't need to recompute on change
 		nbStepRange->setParent(groupAdvanced);
+
+		//sampling step (advanced group)
+		OFX::IntParamDescriptor* samplingStep = desc.defineIntParam(kSamplingStep);
+		samplingStep->setLabel(kSamplingStepLabel);
+		samplingStep->setHint("Analyse only one pixel every n pixels on each axis: faster histograms on large images, for interactive use.");
+		samplingStep->setRange(1, 64);
+		samplingStep->setDisplayRange(1, 16);
+		samplingStep->setDefault(1);
+		samplingStep->setEvaluateOnChange(false); // don't need to recompute on change
+		samplingStep->setParent(groupAdvanced);
 		//selection multiplier (advanced group)
 		OFX::DoubleParamDescriptor* selectionMultiplier = desc.defineDoubleParam(kselectionMultiplier);
 		selectionMultiplier->setLabel(kselectionMultiplierLabel);
@@ -3,6 +3,7 @@
 
 #include <tuttle/plugin/ImageGilFilterProcessor.hpp>
 #include <terry/clamp.hpp>
+#include <boost/gil/extension/color/hsl.hpp>
 
 namespace tuttle {
 namespace plugin {
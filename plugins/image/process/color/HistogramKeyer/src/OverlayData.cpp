@@ -3,7 +3,7 @@
 #include <tuttle/plugin/global.hpp>
 #include <tuttle/plugin/ImageGilProcessor.hpp>
 
-#include <terry/algorithm/transform_pixels.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
 
 namespace tuttle {
 namespace plugin {
@@ -16,6 +16,7 @@ namespace histogramKeyer {
 OverlayData::OverlayData( const OfxPointI& size, const int nbSteps, const int nbStepsCurvesFromSelection)
 : _currentTime( 0 )
 , _vNbStep( nbSteps )
+, _samplingStep( 1 )
 , _vNbStepCurveFromSelection( nbStepsCurvesFromSelection )
 , _isComputing( false )
 , _isDataInvalid( true )
@@ -24,27 +25,6 @@ OverlayData::OverlayData( const OfxPointI& size, const int nbSteps, const int nb
 	clearAll( size );
 }
 
-/**
- * Update selection areas buffer to selection histograms overlay
- * @param args needed to have current time
- */
-void OverlayData::computeHistogramBufferData( HistogramBufferData& data, SView& srcView, const OfxTime time, const bool isSelection)
-{
-	data._step = _vNbStep;					//prepare HistogramBuffer structure
-	
-	BOOST_ASSERT( _imgBool.shape()[0] == std::size_t(_size.y) );
-	BOOST_ASSERT( _imgBool.shape()[1] == std::size_t(_size.x) );
-	BOOST_ASSERT( srcView.width()  == std::size_t(_size.x) );
-	BOOST_ASSERT( srcView.height() == std::size_t(_size.y) );
-	
-	Pixel_compute_histograms funct( _imgBool, data, isSelection );			//functor declaration
-	
-	terry::algorithm::transform_pixels( srcView, funct );		//(USED functor reference)
-	//boost::gil::for_each_pixel(srcView, funct);		(NOT USED)
-	
-	this->correctHistogramBufferData(data);				//correct Histogram data to make up for discretization (average)
-}
-
 /**
  * @brief Set each values of the vector to null
  * @param v vector to reset
@@ -218,12 +198,12 @@ void OverlayData::computeFullData( OFX::Clip* clipSrc, const OfxTime time, const
 	}
 	
 	//TUTTLE_TLOG_INFOS;
-	//Compute histogram buffer
-	this->computeHistogramBufferData( _data, srcView, time);
-	
-	//TUTTLE_TLOG_INFOS;
-	//Compute selection histogram buffer
-	this->computeHistogramBufferData( _selectionData, srcView, time, true );
+	//Compute histogram and selection histogram buffers (only the modified selection if it is the same image)
+	_histograms.update( OfxMultiThreadLauncher(), srcView, _imgBool, srcPixelRod, time, _vNbStep, _samplingStep );
+	assignHistograms( _histograms.full(), _data );
+	this->correctHistogramBufferData( _data );				//correct Histogram data to make up for discretization (average)
+	assignHistograms( _histograms.selection(), _selectionData );
+	this->correctHistogramBufferData( _selectionData );
 	
 	//TUTTLE_TLOG_INFOS;
 	//Compute averages
@@ -372,8 +352,9 @@ void OverlayData::computeCurveFromSelectionData( OFX::Clip* clipSrc, const OfxTi
 		clearAll( imgSize );
 	}
 	//Compute histogram buffer
-	Pixel_compute_histograms funct( _imgBool,_curveFromSelection, true);			//functor declaration
-	terry::algorithm::transform_pixels( srcView, funct );		//(USED functor reference)
+	const Rows_compute_histograms<SView> histograms = terry::algorithm::parallel_reduce_rows( OfxMultiThreadLauncher(), srcView.height(),
+		Rows_compute_histograms<SView>( srcView, _imgBool, true, _curveFromSelection._step ) );
+	assignHistograms( histograms._histograms, _curveFromSelection );
 	
 	this->correctHistogramBufferData(_curveFromSelection);				//correct Histogram data to make up for discretization (average)
 }
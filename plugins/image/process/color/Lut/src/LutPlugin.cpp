@@ -1,11 +1,17 @@
 #include "LutPlugin.hpp"
 #include "LutProcess.hpp"
 #include "LutDefinitions.hpp"
+#include "lutEngine/LutReader.hpp"
+
+#include <terry/color/lut_cache.hpp>
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/gil/gil_all.hpp>
 #include <boost/filesystem.hpp>
 
+#include <ctime>
+#include <utility>
+
 namespace bfs = boost::filesystem;
 
 namespace tuttle {
@@ -14,38 +20,76 @@ namespace lut {
 
 using namespace boost::gil;
 
+namespace {
+
+/// A file is identified by its name and its last modification.
+typedef std::pair<std::string, std::time_t> LutFileKey;
+typedef terry::color::lut_cache<terry::color::lut3d, LutFileKey> LutFileCache;
+
+LutFileCache& lutFileCache()
+{
+	static LutFileCache cache;
+	return cache;
+}
+
+/**
+ * @brief Read a LUT file into the float nodes of a lut3d.
+ */
+struct LutFileReader
+{
+	const std::string& _filename;
+
+	LutFileReader( const std::string& filename ) : _filename( filename ) {}
+
+	LutPlugin::LutPtr operator()() const
+	{
+		LutReader reader;
+		if( ! reader.read( _filename ) )
+			return LutPlugin::LutPtr();
+		const std::size_t size = reader.steps().size();
+		if( size < 2 || reader.data().size() != size * size * size * 3 )
+			return LutPlugin::LutPtr();
+		boost::shared_ptr<terry::color::lut3d> lut( new terry::color::lut3d() );
+		lut->assign( size, reader.data().begin() );
+		return lut;
+	}
+};
+
+}
+
 LutPlugin::LutPlugin( OfxImageEffectHandle handle )
 	: ImageEffectGilPlugin( handle )
 {
 	_sFilename = fetchStringParam( kTuttlePluginFilename );
 }
 
+LutPlugin::LutPtr LutPlugin::getLut() const
+{
+	std::string str;
+	_sFilename->getValue( str );
+	boost::system::error_code error;
+	const std::time_t lastWriteTime = bfs::last_write_time( str, error );
+	if( error )
+	{
+		BOOST_THROW_EXCEPTION( exception::FileNotExist()
+			<< exception::filename(str) );
+	}
+	const LutPtr lut = lutFileCache().get( LutFileKey( str, lastWriteTime ), LutFileReader( str ) );
+	if( ! lut )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "Unable to read lut file." )
+			<< exception::filename(str) );
+	}
+	return lut;
+}
+
 /**
  * @brief The overridden render function
  * @param[in]   args     Rendering parameters
  */
 void LutPlugin::render( const OFX::RenderArguments& args )
 {
-	if( !_lutReader.readOk() )
-	{
-		std::string str;
-		_sFilename->getValue( str );
-		if( ! bfs::exists( str ) )
-		{
-			BOOST_THROW_EXCEPTION( exception::FileNotExist()
-				<< exception::filename(str) );
-		}
-		if( ! _lutReader.read( str ) )
-		{
-			BOOST_THROW_EXCEPTION( exception::File()
-				<< exception::user( "Unable to read lut file." ) );
-		}
-		_lut3D.reset( new TetraInterpolator(), _lutReader );
-	}
-	if( !_lutReader.readOk() )
-	{
-		BOOST_THROW_EXCEPTION( exception::Unknown() );
-	}
 	doGilRender<LutProcess>( *this, args );
 }
 
@@ -57,11 +101,8 @@ void LutPlugin::changedParam( const OFX::InstanceChangedArgs& args, const std::s
 		_sFilename->getValue( str );
 		if( bfs::exists( str ) )
 		{
-			if( ! _lutReader.read( str ) )
-			{
-				BOOST_THROW_EXCEPTION( exception::File() << exception::user( "Unable to read lut file..." ) );
-			}
-			_lut3D.reset( new TetraInterpolator(), _lutReader );
+			// read the file now, to report the errors to the user
+			getLut();
 		}
 	}
 }
@@ -1,11 +1,12 @@
 #ifndef _TUTTLE_PLUGIN_LUTPLUGIN_HPP_
 #define _TUTTLE_PLUGIN_LUTPLUGIN_HPP_
 
-#include "lutEngine/LutReader.hpp"
-#include "lutEngine/Lut.hpp"
-
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 
+#include <terry/color/lut.hpp>
+
+#include <boost/shared_ptr.hpp>
+
 namespace tuttle {
 namespace plugin {
 namespace lut {
@@ -16,6 +17,9 @@ namespace lut {
  */
 class LutPlugin : public ImageEffectGilPlugin
 {
+public:
+	typedef boost::shared_ptr<const terry::color::lut3d> LutPtr;
+
 public:
 	LutPlugin( OfxImageEffectHandle handle );
 
@@ -23,11 +27,16 @@ public:
 	void render( const OFX::RenderArguments& args );
 	void changedParam( const OFX::InstanceChangedArgs& args, const std::string& paramName );
 
+	/**
+	 * @brief The LUT of the current file.
+	 *
+	 * The files are read once and shared by all the instances,
+	 * until they are modified.
+	 */
+	LutPtr getLut() const;
+
 public:
 	OFX::StringParam* _sFilename;    ///< Filename
-
-	LutReader _lutReader;               ///< Reader
-	Lut3D _lut3D;
 };
 
 }
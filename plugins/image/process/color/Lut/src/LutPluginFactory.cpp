@@ -32,7 +32,7 @@ void LutPluginFactory::describe( OFX::ImageEffectDescriptor& desc )
 	desc.addSupportedBitDepth( OFX::eBitDepthFloat );
 
 	desc.setSupportsTiles( kSupportTiles );
-	//desc.setRenderThreadSafety( OFX::eRenderFullySafe ); //< @todo tuttle: remove process data from LutPlugin
+	desc.setRenderThreadSafety( OFX::eRenderFullySafe );
 }
 
 /**
@@ -2,8 +2,6 @@
 #define _TUTTLE_PLUGIN_LUTPROCESS_HPP_
 
 #include "LutPlugin.hpp"
-#include "lutEngine/LutReader.hpp"
-#include "lutEngine/Lut.hpp"
 
 #include <tuttle/plugin/global.hpp>
 #include <tuttle/plugin/ImageGilFilterProcessor.hpp>
@@ -25,15 +23,17 @@ template<class View>
 class LutProcess : public ImageGilFilterProcessor<View>
 {
 private:
-	Lut3D* _lut3D;               ///< Lut3D
 	LutPlugin&  _plugin;        ///< Rendering plugin
+	LutPlugin::LutPtr _lut;     ///< float nodes of the LUT, shared with the other instances
 
 public:
 	LutProcess<View>( LutPlugin & instance );
 
+	void setup( const OFX::RenderArguments& args );
+
 	void multiThreadProcessImages( const OfxRectI& procWindowRoW );
 
-	// Lut3D Transform
+	// 3D LUT transform
 	void applyLut( View& dst, View& src, const OfxRectI& procWindow );
 };
 
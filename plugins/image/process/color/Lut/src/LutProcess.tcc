@@ -4,9 +4,6 @@
 
 #include "LutProcess.hpp"
 #include "LutDefinitions.hpp"
-#include "lutEngine/LutReader.hpp"
-#include "lutEngine/Lut.hpp"
-#include "lutEngine/TetraInterpolator.hpp"
 
 #include <tuttle/plugin/global.hpp>
 #include <tuttle/plugin/ImageGilProcessor.hpp>
@@ -17,20 +14,24 @@
 #include <ofxsMultiThread.h>
 
 #include <boost/gil/gil_all.hpp>
-#include <boost/filesystem/fstream.hpp>
+
+#include <vector>
 
 namespace tuttle {
 namespace plugin {
 namespace lut {
 
-using namespace boost::filesystem;
-
 template<class View>
 LutProcess<View>::LutProcess( LutPlugin& instance )
 	: ImageGilFilterProcessor<View>( instance, eImageOrientationIndependant )
 	, _plugin( instance )
+{}
+
+template<class View>
+void LutProcess<View>::setup( const OFX::RenderArguments& args )
 {
-	_lut3D = &_plugin._lut3D;
+	ImageGilFilterProcessor<View>::setup( args );
+	_lut = _plugin.getLut();
 }
 
 /**
@@ -45,31 +46,33 @@ void LutProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
 	applyLut( this->_dstView, this->_srcView, procWindowOutput );
 }
 
+/**
+ * @brief Apply the LUT line by line, on a float copy of the line.
+ *
+ * The tetrahedral interpolation of the float copy is vectorized,
+ * the alpha of the output is opaque.
+ */
 template<class View>
 void LutProcess<View>::applyLut( View& dst, View& src, const OfxRectI& procWindow )
 {
 	using namespace terry;
-	typedef typename View::x_iterator vIterator;
-	typedef typename channel_type<View>::type Pixel;
 	const OfxPointI procWindowSize = {
 		procWindow.x2 - procWindow.x1,
 		procWindow.y2 - procWindow.y1 };
+	if( procWindowSize.x <= 0 )
+		return;
+
+	std::vector<rgba32f_pixel_t> line( procWindowSize.x );
+	rgba32f_view_t lineView = interleaved_view( procWindowSize.x, 1, &line.front(), procWindowSize.x * sizeof( rgba32f_pixel_t ) );
+	float* lineFloats = reinterpret_cast<float*>( &line.front()[0] );
 
 	for( int y = procWindow.y1; y < procWindow.y2; ++y )
 	{
-		vIterator sit = src.row_begin( y );
-		vIterator dit = dst.row_begin( y );
-		for( int x = procWindow.x1; x < procWindow.x2; ++x )
-		{
-			tuttle::Color col = _lut3D->getColor( ( *sit )[0], ( *sit )[1], ( *sit )[2] );
-			( *dit )[0] = static_cast<Pixel>( col.x );
-			( *dit )[1] = static_cast<Pixel>( col.y );
-			( *dit )[2] = static_cast<Pixel>( col.z );
-			if( dst.num_channels() > 3 )
-				( *dit )[3] = channel_traits< typename channel_type< View >::type >::max_value();
-			++sit;
-			++dit;
-		}
+		copy_and_convert_pixels( subimage_view( src, procWindow.x1, y, procWindowSize.x, 1 ), lineView );
+		_lut->apply_floats( lineFloats, lineFloats, procWindowSize.x, 4 );
+		for( int x = 0; x < procWindowSize.x; ++x )
+			line[x][3] = 1.0f;
+		copy_and_convert_pixels( lineView, subimage_view( dst, procWindow.x1, y, procWindowSize.x, 1 ) );
 		if( this->progressForward( procWindowSize.x ) )
 			return;
 	}
@@ -1,3 +0,0 @@
-#include "Interpolator.hpp"
-#include "Color.hpp"
-#include "AbstractLut.hpp"
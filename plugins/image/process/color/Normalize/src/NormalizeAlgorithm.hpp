@@ -7,14 +7,16 @@
 #include <terry/numeric/operations.hpp>
 #include <terry/numeric/assign.hpp>
 #include <terry/numeric/minmax.hpp>
-#include <terry/algorithm/transform_pixels_progress.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
+
+#include <tuttle/plugin/OfxMultiThreadLauncher.hpp>
 
 namespace tuttle {
 namespace plugin {
 namespace normalize {
 
 template< class View, typename LocalChannel >
-void analyseChannel( View& src, typename View::value_type& min, typename View::value_type& max, IProgress& p )
+void analyseChannel( View& src, typename View::value_type& min, typename View::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& p )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -23,10 +25,7 @@ void analyseChannel( View& src, typename View::value_type& min, typename View::v
 	typedef channel_view_type<LocalChannel,View> LocalView;
 	typename LocalView::type localView( LocalView::make(src) );
 	pixel_minmax_by_channel_t<typename LocalView::type::value_type> minmax( localView(0,0) );
-	transform_pixels_progress(
-		localView,
-		minmax,
-		p );
+	minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 	static_fill( min, minmax.min[0] );
 	static_fill( max, minmax.max[0] );
 }
@@ -39,9 +38,10 @@ void analyseChannel( View& src, typename View::value_type& min, typename View::v
  * @param[in] analyseMode: choose the analyse method
  * @param[out] min: output min values
  * @param[out] max: output max values
+ * @param[in] launcher: threads of the analyse
  */
 template<class View>
-void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, typename View::value_type& min, typename View::value_type& max, IProgress& p )
+void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, typename View::value_type& min, typename View::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& p )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -55,10 +55,7 @@ void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, t
 		{
 			pixel_minmax_by_channel_t<Pixel> minmax( src(0,0) );
 			// compute the maximum value
-			transform_pixels_progress(
-				src,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, src, minmax, p );
 			min = minmax.min;
 			max = minmax.max;
 			break;
@@ -69,10 +66,7 @@ void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, t
 			typedef typename color_converted_view_type<View, PixelGray>::type LocalView;
 			LocalView localView(src);
 			pixel_minmax_by_channel_t<typename LocalView::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-				localView,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -82,10 +76,7 @@ void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, t
 			typedef channel_view_type<red_t, View> LocalView;
 			typename LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t< typename LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -95,10 +86,7 @@ void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, t
 			typedef channel_view_type<green_t,View> LocalView;
 			typename LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t< typename LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -108,10 +96,7 @@ void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, t
 			typedef channel_view_type<blue_t,View> LocalView;
 			typename LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t< typename LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -121,10 +106,7 @@ void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, t
 			typedef channel_view_type<alpha_t,View> LocalView;
 			typename LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t< typename LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -133,7 +115,7 @@ void analyseInputMinMax( const View& src, const EParamAnalyseMode analyseMode, t
 }
 
 template<>
-void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::rgb32f_view_t::value_type& min, boost::gil::rgb32f_view_t::value_type& max, IProgress& progress )
+void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::rgb32f_view_t::value_type& min, boost::gil::rgb32f_view_t::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& progress )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -147,10 +129,7 @@ void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnaly
 		{
 			pixel_minmax_by_channel_t<Pixel> minmax( src(0,0) );
 			// compute the maximum value
-			transform_pixels_progress(
-				src,
-				minmax,
-				progress );
+			minmax = parallel_reduce_pixels( launcher, src, minmax, progress );
 			min = minmax.min;
 			max = minmax.max;
 			break;
@@ -161,10 +140,7 @@ void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnaly
 			typedef color_converted_view_type<rgb32f_view_t, PixelGray>::type LocalView;
 			LocalView localView(src);
 			pixel_minmax_by_channel_t<LocalView::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-				localView,
-				minmax,
-				progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -174,10 +150,7 @@ void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnaly
 			typedef channel_view_type<red_t,rgb32f_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -187,10 +160,7 @@ void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnaly
 			typedef channel_view_type<green_t,rgb32f_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -200,10 +170,7 @@ void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnaly
 			typedef channel_view_type<blue_t,rgb32f_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -218,7 +185,7 @@ void analyseInputMinMax( const boost::gil::rgb32f_view_t& src, const EParamAnaly
 }
 
 template<>
-void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::rgb16_view_t::value_type& min, boost::gil::rgb16_view_t::value_type& max, IProgress& progress )
+void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::rgb16_view_t::value_type& min, boost::gil::rgb16_view_t::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& progress )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -232,10 +199,7 @@ void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalys
 		{
 			pixel_minmax_by_channel_t<Pixel> minmax( src(0,0) );
 			// compute the maximum value
-			transform_pixels_progress(
-				src,
-				minmax,
-				progress );
+			minmax = parallel_reduce_pixels( launcher, src, minmax, progress );
 			min = minmax.min;
 			max = minmax.max;
 			break;
@@ -246,10 +210,7 @@ void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalys
 			typedef color_converted_view_type<rgb16_view_t, PixelGray>::type LocalView;
 			LocalView localView(src);
 			pixel_minmax_by_channel_t<LocalView::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-				localView,
-				minmax,
-				progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -259,10 +220,7 @@ void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalys
 			typedef channel_view_type<red_t,rgb16_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -272,10 +230,7 @@ void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalys
 			typedef channel_view_type<green_t,rgb16_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -285,10 +240,7 @@ void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalys
 			typedef channel_view_type<blue_t,rgb16_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					progress );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, progress );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -303,7 +255,7 @@ void analyseInputMinMax( const boost::gil::rgb16_view_t& src, const EParamAnalys
 }
 
 template<>
-void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::rgb8_view_t::value_type& min, boost::gil::rgb8_view_t::value_type& max, IProgress& p )
+void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::rgb8_view_t::value_type& min, boost::gil::rgb8_view_t::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& p )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -317,10 +269,7 @@ void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyse
 		{
 			pixel_minmax_by_channel_t<Pixel> minmax( src(0,0) );
 			// compute the maximum value
-			transform_pixels_progress(
-				src,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, src, minmax, p );
 			min = minmax.min;
 			max = minmax.max;
 			break;
@@ -331,10 +280,7 @@ void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyse
 			typedef color_converted_view_type<rgb8_view_t, PixelGray>::type LocalView;
 			LocalView localView(src);
 			pixel_minmax_by_channel_t<LocalView::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-				localView,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -344,10 +290,7 @@ void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyse
 			typedef channel_view_type<red_t,rgb8_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -357,10 +300,7 @@ void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyse
 			typedef channel_view_type<green_t,rgb8_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -370,10 +310,7 @@ void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyse
 			typedef channel_view_type<blue_t,rgb8_view_t> LocalView;
 			LocalView::type localView( LocalView::make(src) );
 			pixel_minmax_by_channel_t<LocalView::type::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-					localView,
-					minmax,
-					p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -388,7 +325,7 @@ void analyseInputMinMax( const boost::gil::rgb8_view_t& src, const EParamAnalyse
 }
 
 template<>
-void analyseInputMinMax( const boost::gil::gray32f_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::gray32f_view_t::value_type& min, boost::gil::gray32f_view_t::value_type& max, IProgress& p )
+void analyseInputMinMax( const boost::gil::gray32f_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::gray32f_view_t::value_type& min, boost::gil::gray32f_view_t::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& p )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -402,10 +339,7 @@ void analyseInputMinMax( const boost::gil::gray32f_view_t& src, const EParamAnal
 		{
 			pixel_minmax_by_channel_t<Pixel> minmax( src(0,0) );
 			// compute the maximum value
-			transform_pixels_progress(
-				src,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, src, minmax, p );
 			min = minmax.min;
 			max = minmax.max;
 			break;
@@ -416,10 +350,7 @@ void analyseInputMinMax( const boost::gil::gray32f_view_t& src, const EParamAnal
 			typedef color_converted_view_type<gray32f_view_t, PixelGray>::type LocalView;
 			LocalView localView(src);
 			pixel_minmax_by_channel_t<LocalView::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-				localView,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -437,7 +368,7 @@ void analyseInputMinMax( const boost::gil::gray32f_view_t& src, const EParamAnal
 }
 
 template<>
-void analyseInputMinMax( const boost::gil::gray16_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::gray16_view_t::value_type& min, boost::gil::gray16_view_t::value_type& max, IProgress& p )
+void analyseInputMinMax( const boost::gil::gray16_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::gray16_view_t::value_type& min, boost::gil::gray16_view_t::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& p )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -451,10 +382,7 @@ void analyseInputMinMax( const boost::gil::gray16_view_t& src, const EParamAnaly
 		{
 			pixel_minmax_by_channel_t<Pixel> minmax( src(0,0) );
 			// compute the maximum value
-			transform_pixels_progress(
-				src,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, src, minmax, p );
 			min = minmax.min;
 			max = minmax.max;
 			break;
@@ -465,10 +393,7 @@ void analyseInputMinMax( const boost::gil::gray16_view_t& src, const EParamAnaly
 			typedef color_converted_view_type<gray16_view_t, PixelGray>::type LocalView;
 			LocalView localView(src);
 			pixel_minmax_by_channel_t<LocalView::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-				localView,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -486,7 +411,7 @@ void analyseInputMinMax( const boost::gil::gray16_view_t& src, const EParamAnaly
 }
 
 template<>
-void analyseInputMinMax( const boost::gil::gray8_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::gray8_view_t::value_type& min, boost::gil::gray8_view_t::value_type& max, IProgress& p )
+void analyseInputMinMax( const boost::gil::gray8_view_t& src, const EParamAnalyseMode analyseMode, boost::gil::gray8_view_t::value_type& min, boost::gil::gray8_view_t::value_type& max, const OfxMultiThreadLauncher& launcher, IProgress& p )
 {
 	using namespace terry;
 	using namespace terry::numeric;
@@ -500,10 +425,7 @@ void analyseInputMinMax( const boost::gil::gray8_view_t& src, const EParamAnalys
 		{
 			pixel_minmax_by_channel_t<Pixel> minmax( src(0,0) );
 			// compute the maximum value
-			transform_pixels_progress(
-				src,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, src, minmax, p );
 			min = minmax.min;
 			max = minmax.max;
 			break;
@@ -514,10 +436,7 @@ void analyseInputMinMax( const boost::gil::gray8_view_t& src, const EParamAnalys
 			typedef color_converted_view_type<gray8_view_t, PixelGray>::type LocalView;
 			LocalView localView(src);
 			pixel_minmax_by_channel_t<LocalView::value_type> minmax( localView(0,0) );
-			transform_pixels_progress(
-				localView,
-				minmax,
-				p );
+			minmax = parallel_reduce_pixels( launcher, localView, minmax, p );
 			static_fill( min, minmax.min[0] );
 			static_fill( max, minmax.max[0] );
 			break;
@@ -99,6 +99,7 @@ void NormalizePlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 
 		EParamAnalyseMode mode = static_cast<EParamAnalyseMode>( _analyseMode->getValue() );
 		NoProgress progress;
+		const OfxMultiThreadLauncher launcher;
 
 		switch( _clipSrc->getPixelComponents() )
 		{
@@ -113,7 +114,7 @@ void NormalizePlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 						typedef rgba32f_view_t View;
 						typedef View::value_type Pixel;
 						View srcView = getGilView<View>( src.get(), srcPixelRod, eImageOrientationIndependant );
-						analyseInputMinMax<View>( srcView, mode, min, max, progress );
+						analyseInputMinMax<View>( srcView, mode, min, max, launcher, progress );
 						break;
 					}
 					case OFX::eBitDepthUShort:
@@ -122,7 +123,7 @@ void NormalizePlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 						typedef View::value_type Pixel;
 						View srcView = getGilView<View>( src.get(), srcPixelRod, eImageOrientationIndependant );
 						Pixel smin, smax;
-						analyseInputMinMax<View>( srcView, mode, smin, smax, progress );
+						analyseInputMinMax<View>( srcView, mode, smin, smax, launcher, progress );
 						color_convert(smin, min);
 						color_convert(smax, max);
 						break;
@@ -133,7 +134,7 @@ void NormalizePlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 						typedef View::value_type Pixel;
 						View srcView = getGilView<View>( src.get(), srcPixelRod, eImageOrientationIndependant );
 						Pixel smin, smax;
-						analyseInputMinMax<View>( srcView, mode, smin, smax, progress );
+						analyseInputMinMax<View>( srcView, mode, smin, smax, launcher, progress );
 						color_convert(smin, min);
 						color_convert(smax, max);
 						break;
@@ -168,7 +169,7 @@ void NormalizePlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 						typedef rgb32f_view_t View;
 						typedef View::value_type Pixel;
 						View srcView = getGilView<View>( src.get(), srcPixelRod, eImageOrientationIndependant );
-						analyseInputMinMax<View>( srcView, mode, min, max, progress );
+						analyseInputMinMax<View>( srcView, mode, min, max, launcher, progress );
 						break;
 					}
 					case OFX::eBitDepthUShort:
@@ -177,7 +178,7 @@ void NormalizePlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 						typedef View::value_type Pixel;
 						View srcView = getGilView<View>( src.get(), srcPixelRod, eImageOrientationIndependant );
 						Pixel smin, smax;
-						analyseInputMinMax<View>( srcView, mode, smin, smax, progress );
+						analyseInputMinMax<View>( srcView, mode, smin, smax, launcher, progress );
 						color_convert(smin, min);
 						color_convert(smax, max);
 						break;
@@ -188,7 +189,7 @@ void NormalizePlugin::changedParam( const OFX::InstanceChangedArgs &args, const
 						typedef View::value_type Pixel;
 						View srcView = getGilView<View>( src.get(), srcPixelRod, eImageOrientationIndependant );
 						Pixel smin, smax;
-						analyseInputMinMax<View>( srcView, mode, smin, smax, progress );
+						analyseInputMinMax<View>( srcView, mode, smin, smax, launcher, progress );
 						color_convert(smin, min);
 						color_convert(smax, max);
 						break;
@@ -49,7 +49,7 @@ void NormalizeProcess<View>::setup( const OFX::RenderArguments& args )
 	{
 		case eParamModeAnalyse:
 		{
-			analyseInputMinMax<View>( src, _params._analyseMode, smin, smax, *this );
+			analyseInputMinMax<View>( src, _params._analyseMode, smin, smax, this->getLauncher(), *this );
 			break;
 		}
 		case eParamModeCustom:
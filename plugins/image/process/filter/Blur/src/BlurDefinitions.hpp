@@ -24,6 +24,20 @@ enum EParamBorder
 	eParamBorderPadded
 };
 
+static const std::string kParamAlgorithm                  = "algorithm";
+static const std::string kParamAlgorithmConvolution       = "convolution";
+static const std::string kParamAlgorithmRecursiveGaussian = "recursiveGaussian";
+static const std::string kParamAlgorithmBox               = "box";
+
+enum EParamAlgorithm
+{
+	eParamAlgorithmConvolution = 0,
+	eParamAlgorithmRecursiveGaussian,
+	eParamAlgorithmBox
+};
+
+static const std::string kParamBoxPasses = "boxPasses";
+
 static const std::string kParamGroupAdvanced = "advanced";
 static const std::string kParamNormalizedKernel = "normalizedKernel";
 static const std::string kParamKernelEpsilon = "kernelEpsilon";
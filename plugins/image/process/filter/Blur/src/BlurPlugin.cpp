@@ -3,9 +3,13 @@
 #include "BlurDefinitions.hpp"
 
 #include <terry/point/operations.hpp>
+#include <terry/filter/recursiveGaussian.hpp>
+#include <terry/filter/boxBlur.hpp>
 
 #include <boost/gil/gil_all.hpp>
 
+#include <cmath>
+
 namespace tuttle {
 namespace plugin {
 namespace blur {
@@ -15,6 +19,8 @@ BlurPlugin::BlurPlugin( OfxImageEffectHandle handle )
 {
 	_paramSize   = fetchDouble2DParam( kParamSize );
 	_paramBorder = fetchChoiceParam( kParamBorder );
+	_paramAlgorithm = fetchChoiceParam( kParamAlgorithm );
+	_paramBoxPasses = fetchIntParam( kParamBoxPasses );
 	_paramNormalizedKernel = fetchBooleanParam( kParamNormalizedKernel );
 	_paramKernelEpsilon = fetchDoubleParam( kParamKernelEpsilon );
 }
@@ -26,12 +32,38 @@ BlurProcessParams<BlurPlugin::Scalar> BlurPlugin::getProcessParams( const OfxPoi
 	BlurProcessParams<Scalar> params;
 	params._size   = ofxToGil( _paramSize->getValue() ) * ofxToGil( renderScale  );
 	params._border = static_cast<EParamBorder>( _paramBorder->getValue() );
+	params._algorithm = static_cast<EParamAlgorithm>( _paramAlgorithm->getValue() );
+	params._nbBoxPasses = _paramBoxPasses->getValue();
+	// the size is the variance of the gaussian (see gaussianValueAt)
+	params._sigma.x = std::sqrt( params._size.x );
+	params._sigma.y = std::sqrt( params._size.y );
 
-	const bool normalizedKernel = _paramNormalizedKernel->getValue();
-	const double kernelEpsilon = _paramKernelEpsilon->getValue();
-
-	params._gilKernelX = buildGaussian1DKernel<Scalar>( params._size.x, normalizedKernel, kernelEpsilon );
-	params._gilKernelY = buildGaussian1DKernel<Scalar>( params._size.y, normalizedKernel, kernelEpsilon );
+	switch( params._algorithm )
+	{
+		case eParamAlgorithmConvolution:
+		{
+			const bool normalizedKernel = _paramNormalizedKernel->getValue();
+			const double kernelEpsilon = _paramKernelEpsilon->getValue();
+
+			params._gilKernelX = buildGaussian1DKernel<Scalar>( params._size.x, normalizedKernel, kernelEpsilon );
+			params._gilKernelY = buildGaussian1DKernel<Scalar>( params._size.y, normalizedKernel, kernelEpsilon );
+			params._margin.x = params._gilKernelX.left_size();
+			params._margin.y = params._gilKernelY.left_size();
+			break;
+		}
+		case eParamAlgorithmRecursiveGaussian:
+		{
+			params._margin.x = recursive_gaussian_filter( params._sigma.x ).margin();
+			params._margin.y = recursive_gaussian_filter( params._sigma.y ).margin();
+			break;
+		}
+		case eParamAlgorithmBox:
+		{
+			params._margin.x = box_blur_filter<Scalar>( params._sigma.x, params._nbBoxPasses ).margin();
+			params._margin.y = box_blur_filter<Scalar>( params._sigma.y, params._nbBoxPasses ).margin();
+			break;
+		}
+	}
 	
 	params._boundary_option = convolve_option_extend_mirror;
 	switch( params._border )
@@ -76,18 +108,18 @@ bool BlurPlugin::getRegionOfDefinition( const OFX::RegionOfDefinitionArguments&
 	switch( params._border )
 	{
 		case eParamBorderPadded:
-			rod.x1 = srcRod.x1 + params._gilKernelX.left_size();
-			rod.y1 = srcRod.y1 + params._gilKernelY.left_size();
-			rod.x2 = srcRod.x2 - params._gilKernelX.right_size();
-			rod.y2 = srcRod.y2 - params._gilKernelY.right_size();
+			rod.x1 = srcRod.x1 + params._margin.x;
+			rod.y1 = srcRod.y1 + params._margin.y;
+			rod.x2 = srcRod.x2 - params._margin.x;
+			rod.y2 = srcRod.y2 - params._margin.y;
 			return true;
 		case eParamBorderBlack:
 		case eParamBorderConstant:
 		case eParamBorderMirror:
-			rod.x1 = srcRod.x1 - params._gilKernelX.left_size();
-			rod.y1 = srcRod.y1 - params._gilKernelY.left_size();
-			rod.x2 = srcRod.x2 + params._gilKernelX.right_size();
-			rod.y2 = srcRod.y2 + params._gilKernelY.right_size();
+			rod.x1 = srcRod.x1 - params._margin.x;
+			rod.y1 = srcRod.y1 - params._margin.y;
+			rod.x2 = srcRod.x2 + params._margin.x;
+			rod.y2 = srcRod.y2 + params._margin.y;
 			return true;
 		case eParamBorderNo:
 			return false; // don't modify the source image RoD
@@ -102,10 +134,10 @@ void BlurPlugin::getRegionsOfInterest( const OFX::RegionsOfInterestArguments& ar
 	OfxRectD srcRod                  = _clipSrc->getCanonicalRod( args.time );
 
 	OfxRectD srcRoi;
-	srcRoi.x1 = srcRod.x1 - params._gilKernelX.left_size();
-	srcRoi.y1 = srcRod.y1 - params._gilKernelY.left_size();
-	srcRoi.x2 = srcRod.x2 + params._gilKernelX.right_size();
-	srcRoi.y2 = srcRod.y2 + params._gilKernelY.right_size();
+	srcRoi.x1 = srcRod.x1 - params._margin.x;
+	srcRoi.y1 = srcRod.y1 - params._margin.y;
+	srcRoi.x2 = srcRod.x2 + params._margin.x;
+	srcRoi.y2 = srcRod.y2 + params._margin.y;
 	rois.setRegionOfInterest( *_clipSrc, srcRoi );
 }
 
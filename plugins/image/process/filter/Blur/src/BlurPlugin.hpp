@@ -19,9 +19,14 @@ struct BlurProcessParams
 	terry::point2<double> _size;
 	EParamBorder _border;
 	terry::filter::convolve_boundary_option _boundary_option;
+	EParamAlgorithm _algorithm;
 
-	Kernel _gilKernelX;
+	Kernel _gilKernelX; ///< only used by the convolution algorithm
 	Kernel _gilKernelY;
+
+	terry::point2<double> _sigma; ///< standard deviation of the gaussian
+	std::size_t _nbBoxPasses;
+	terry::point2<std::ptrdiff_t> _margin; ///< number of source pixels needed on each side
 };
 
 /**
@@ -48,6 +53,8 @@ public:
 public:
 	OFX::Double2DParam* _paramSize;
 	OFX::ChoiceParam* _paramBorder;
+	OFX::ChoiceParam* _paramAlgorithm;
+	OFX::IntParam* _paramBoxPasses;
 	OFX::BooleanParam* _paramNormalizedKernel;
 	OFX::DoubleParam* _paramKernelEpsilon;
 };
@@ -97,6 +97,21 @@ void BlurPluginFactory::describeInContext( OFX::ImageEffectDescriptor& desc,
 	border->appendOption( kParamBorderPadded );
 	border->setDefault( eParamBorderMirror );
 
+	OFX::ChoiceParamDescriptor* algorithm = desc.defineChoiceParam( kParamAlgorithm );
+	algorithm->setLabel( "Algorithm" );
+	algorithm->appendOption( kParamAlgorithmConvolution, "Convolution: gaussian kernel, the cost grows with the size (reference)" );
+	algorithm->appendOption( kParamAlgorithmRecursiveGaussian, "Recursive gaussian: Young-van Vliet IIR filter, constant cost whatever the size" );
+	algorithm->appendOption( kParamAlgorithmBox, "Box: successive box filters, constant cost whatever the size" );
+	algorithm->setDefault( eParamAlgorithmConvolution );
+	algorithm->setHint( "The recursive gaussian and the box algorithms are approximations of the gaussian, for the large sizes." );
+
+	OFX::IntParamDescriptor* boxPasses = desc.defineIntParam( kParamBoxPasses );
+	boxPasses->setLabel( "Box passes" );
+	boxPasses->setHint( "Number of box filters used by the box algorithm. More passes are closer to a gaussian." );
+	boxPasses->setDefault( 3 );
+	boxPasses->setRange( 1, 10 );
+	boxPasses->setDisplayRange( 1, 6 );
+
 	OFX::GroupParamDescriptor* advanced = desc.defineGroupParam( kParamGroupAdvanced );
 	advanced->setLabel( "Advanced" );
 	advanced->setOpen( false );
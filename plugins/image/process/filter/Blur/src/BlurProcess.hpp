@@ -2,6 +2,11 @@
 #define _TUTTLE_PLUGIN_BLUR_PROCESS_HPP_
 
 #include <tuttle/plugin/ImageGilFilterProcessor.hpp>
+#include <tuttle/plugin/memory/OfxAllocator.hpp>
+
+#include <terry/globals.hpp>
+
+#include <vector>
 
 namespace tuttle {
 namespace plugin {
@@ -20,17 +25,25 @@ public:
 	typedef typename View::point_t Point;
 	typedef typename View::coord_t Coord;
 	typedef typename terry::image_from_view<View>::type Image;
+	typedef typename terry::floating_pixel_from_view<View>::type PixelAccum;
 
 protected:
 	BlurPlugin& _plugin; ///< Rendering plugin
 
 	BlurProcessParams<Scalar> _params; ///< user parameters
 
+	/// render window filtered by the line filters (with margin.y rows above and below), shared by the threads
+	std::vector<PixelAccum, OfxAllocator<PixelAccum> > _filtered;
+
 public:
 	BlurProcess( BlurPlugin& effect );
 
 	void setup( const OFX::RenderArguments& args );
 	void multiThreadProcessImages( const OfxRectI& procWindowRoW );
+
+private:
+	template<class LineFilterX, class LineFilterY>
+	void filterRenderWindow( const LineFilterX& filterX, const LineFilterY& filterY );
 };
 
 }
@@ -2,8 +2,11 @@
 
 #include <terry/filter/gaussianKernel.hpp>
 #include <terry/filter/convolve.hpp>
+#include <terry/filter/lineFilter.hpp>
+#include <terry/filter/recursiveGaussian.hpp>
+#include <terry/filter/boxBlur.hpp>
 
-#include <tuttle/plugin/memory/OfxAllocator.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
 
 namespace tuttle {
 namespace plugin {
@@ -29,6 +32,49 @@ void BlurProcess<View>::setup( const OFX::RenderArguments& args )
 	//	std::cout << "y [";
 	//	std::for_each(_params._gilKernelY.begin(), _params._gilKernelY.end(), std::cout << boost::lambda::_1 << ',');
 	//	std::cout << "]" << std::endl;
+
+	_filtered.clear();
+	switch( _params._algorithm )
+	{
+		case eParamAlgorithmConvolution:
+			break;
+		case eParamAlgorithmRecursiveGaussian:
+			filterRenderWindow( terry::filter::recursive_gaussian_filter( _params._sigma.x ), terry::filter::recursive_gaussian_filter( _params._sigma.y ) );
+			break;
+		case eParamAlgorithmBox:
+		{
+			typedef typename terry::channel_type<PixelAccum>::type ChannelAccum;
+			filterRenderWindow( terry::filter::box_blur_filter<ChannelAccum>( _params._sigma.x, _params._nbBoxPasses ),
+			                    terry::filter::box_blur_filter<ChannelAccum>( _params._sigma.y, _params._nbBoxPasses ) );
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Horizontal then vertical pass of the line filters on the whole render window, in float,
+ * on the threads of the host. The bands only convert their rows.
+ */
+template<class View>
+template<class LineFilterX, class LineFilterY>
+void BlurProcess<View>::filterRenderWindow( const LineFilterX& filterX, const LineFilterY& filterY )
+{
+	using namespace terry::filter;
+
+	const std::ptrdiff_t width = this->_renderWindowSize.x;
+	const std::ptrdiff_t nbRows = this->_renderWindowSize.y + 2 * _params._margin.y;
+	if( width == 0 || this->_renderWindowSize.y == 0 )
+		return;
+	const Point render_tl( this->_renderArgs.renderWindow.x1 - this->_srcPixelRod.x1, this->_renderArgs.renderWindow.y1 - this->_srcPixelRod.y1 );
+
+	_filtered.resize( nbRows * width );
+	terry::algorithm::parallel_for_rows( this->getLauncher(), nbRows,
+		line_filter_rows<PixelAccum, OfxAllocator, View, LineFilterX>(
+			this->_srcView, &_filtered.front(), width, render_tl, _params._margin, _params._boundary_option, filterX ) );
+
+	static const std::ptrdiff_t stripWidth = 64; // pixels of the columns filtered together
+	const line_filter_cols<PixelAccum, OfxAllocator, LineFilterY> cols( &_filtered.front(), width, nbRows, stripWidth, filterY );
+	terry::algorithm::parallel_for_rows( this->getLauncher(), cols.nbStrips(), cols, 1 );
 }
 
 /**
@@ -52,6 +98,28 @@ void BlurProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW
 
 	const Point proc_tl( procWindowRoW.x1 - this->_srcPixelRod.x1, procWindowRoW.y1 - this->_srcPixelRod.y1 );
 
+	switch( _params._algorithm )
+	{
+		case eParamAlgorithmConvolution:
+			break;
+		case eParamAlgorithmRecursiveGaussian:
+		case eParamAlgorithmBox:
+		{
+			// rows already filtered in setup
+			const std::ptrdiff_t width = this->_renderWindowSize.x;
+			const std::ptrdiff_t y0 = procWindowRoW.y1 - this->_renderArgs.renderWindow.y1 + _params._margin.y;
+			const std::ptrdiff_t x0 = procWindowRoW.x1 - this->_renderArgs.renderWindow.x1;
+			for( std::ptrdiff_t y = 0; y < procWindowSize.y; ++y )
+			{
+				const PixelAccum* filteredRow = &_filtered[( y0 + y ) * width + x0];
+				typename View::x_iterator dstIt = dst.row_begin( y );
+				for( std::ptrdiff_t x = 0; x < procWindowSize.x; ++x, ++dstIt )
+					color_convert( filteredRow[x], *dstIt );
+			}
+			return;
+		}
+	}
+
 	if( _params._size.x == 0 )
 	{
 		correlate_cols_auto<Pixel>( this->_srcView, _params._gilKernelY, dst, proc_tl, _params._boundary_option );
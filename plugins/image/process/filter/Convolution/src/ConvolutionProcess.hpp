@@ -18,6 +18,7 @@ class ConvolutionProcess : public ImageGilFilterProcessor<View>
 public:
 	typedef float Scalar;
 	typedef typename View::value_type Pixel;
+	typedef typename terry::floating_pixel_from_view<View>::type PixelAccum; ///< accumulate in float, to use the SIMD correlation
 	typedef typename View::point_t Point;
 	typedef typename View::coord_t Coord;
 	typedef typename terry::image_from_view<View>::type Image;
@@ -2,6 +2,10 @@
 #define _TUTTLE_PLUGIN_FLOODFILL_PROCESS_HPP_
 
 #include <tuttle/plugin/ImageGilFilterProcessor.hpp>
+#include <tuttle/plugin/memory/OfxAllocator.hpp>
+
+#include <terry/filter/floodFill.hpp>
+
 #include <boost/scoped_ptr.hpp>
 
 namespace tuttle {
@@ -26,6 +30,9 @@ protected :
 	bool _isConstantImage;
 	Scalar _lowerThres;
 	Scalar _upperThres;
+	OfxRectI _procWindowCrop; ///< render window without the border of the source
+	bool _serial; ///< flood_fill on one thread, instead of the labelling of the bands
+	terry::filter::floodFill::FloodFillLabels<OfxAllocator> _labels; ///< connected components of the render window
 
 public:
     FloodFillProcess( FloodFillPlugin& effect );
@@ -33,6 +40,15 @@ public:
 	void setup( const OFX::RenderArguments& args );
 
     void multiThreadProcessImages( const OfxRectI& procWindowRoW );
+
+	void postProcess();
+
+private:
+	template<class Connexity>
+	void processBand( const OfxRectI& procWindowRoW );
+
+	template<class Connexity>
+	void fillLabels();
 };
 
 }
@@ -6,7 +6,6 @@
 #include <tuttle/plugin/memory/OfxAllocator.hpp>
 
 #include <terry/globals.hpp>
-#include <terry/filter/floodFill.hpp>
 #include <terry/algorithm/transform_pixels_progress.hpp>
 #include <terry/draw/fill.hpp>
 
@@ -22,8 +21,8 @@ template<class View>
 FloodFillProcess<View>::FloodFillProcess( FloodFillPlugin &effect )
 : ImageGilFilterProcessor<View>( effect, eImageOrientationIndependant )
 , _plugin( effect )
+, _serial( true )
 {
-	this->setNoMultiThreading();
 }
 
 template<class View>
@@ -57,6 +56,26 @@ void FloodFillProcess<View>::setup( const OFX::RenderArguments& args )
 		_lowerThres = _params._lowerThres;
 		_upperThres = _params._upperThres;
 	}
+
+	if( _isConstantImage )
+		return;
+
+	using namespace terry::filter::floodFill;
+	static const unsigned int border = 1;
+	const OfxRectI srcRodCrop = rectangleReduce( this->_srcPixelRod, border );
+	_procWindowCrop = rectanglesIntersection( args.renderWindow, srcRodCrop );
+	// flood_fill can follow paths through the pixels around the render window,
+	// the bands are only labelled separately without soft pixels there.
+	_serial = OFX::MultiThread::getNumCPUs() == 1 ||
+	          soft_pixels_around( this->_srcView, ofxToGil(this->_srcPixelRod),
+	                              ofxToGil(rectanglesIntersection( this->_srcPixelRod, this->_dstPixelRod )),
+	                              ofxToGil(_procWindowCrop), IsUpper<Scalar>(_lowerThres) );
+	if( _serial )
+	{
+		this->setNoMultiThreading();
+		return;
+	}
+	_labels.init( ofxToGil(_procWindowCrop), ofxToGil(_procWindowCrop) );
 }
 
 /**
@@ -70,10 +89,6 @@ void FloodFillProcess<View>::multiThreadProcessImages( const OfxRectI& procWindo
 	using namespace terry;
 	OfxRectI procWindowOutput = this->translateRoWToOutputClipCoordinates( procWindowRoW );
 	
-	static const unsigned int border = 1;
-	const OfxRectI srcRodCrop = rectangleReduce( this->_srcPixelRod, border );
-	const OfxRectI procWindowRoWCrop = rectanglesIntersection( procWindowRoW, srcRodCrop );
-
 	terry::draw::fill_pixels( this->_dstView, ofxToGil(procWindowOutput), get_black<Pixel>() );
 
 	if( _isConstantImage )
@@ -85,24 +100,12 @@ void FloodFillProcess<View>::multiThreadProcessImages( const OfxRectI& procWindo
 	{
 		case eParamMethod4:
 		{
-			flood_fill<Connexity4, IsUpper<Scalar>, IsUpper<Scalar>, View, View, OfxAllocator>(
-				this->_srcView, ofxToGil(this->_srcPixelRod),
-				this->_dstView, ofxToGil(this->_dstPixelRod),
-				ofxToGil(procWindowRoWCrop),
-				IsUpper<Scalar>(_upperThres),
-				IsUpper<Scalar>(_lowerThres)
-				);
+			processBand<Connexity4>( procWindowRoW );
 			break;
 		}
 		case eParamMethod8:
 		{
-			flood_fill<Connexity8, IsUpper<Scalar>, IsUpper<Scalar>, View, View, OfxAllocator>(
-				this->_srcView, ofxToGil(this->_srcPixelRod),
-				this->_dstView, ofxToGil(this->_dstPixelRod),
-				ofxToGil(procWindowRoWCrop),
-				IsUpper<Scalar>(_upperThres),
-				IsUpper<Scalar>(_lowerThres)
-				);
+			processBand<Connexity8>( procWindowRoW );
 			break;
 		}
 		case eParamMethodBruteForce: // not in production
@@ -119,6 +122,73 @@ void FloodFillProcess<View>::multiThreadProcessImages( const OfxRectI& procWindo
 	}
 }
 
+/**
+ * @brief Connect the labels of the bands and fill the output, after the bands of all the threads.
+ */
+template<class View>
+void FloodFillProcess<View>::postProcess()
+{
+	if( ! _isConstantImage && ! _serial )
+	{
+		using namespace terry::filter::floodFill;
+		switch( _params._method )
+		{
+			case eParamMethod4:
+			{
+				fillLabels<Connexity4>();
+				break;
+			}
+			case eParamMethod8:
+			{
+				fillLabels<Connexity8>();
+				break;
+			}
+			case eParamMethodBruteForce: // not in production
+			{
+				break;
+			}
+		}
+	}
+	ImageGilFilterProcessor<View>::postProcess();
+}
+
+template<class View>
+template<class Connexity>
+void FloodFillProcess<View>::processBand( const OfxRectI& procWindowRoW )
+{
+	using namespace terry::filter::floodFill;
+	if( _serial )
+	{
+		static const unsigned int border = 1;
+		const OfxRectI srcRodCrop = rectangleReduce( this->_srcPixelRod, border );
+		const OfxRectI procWindowRoWCrop = rectanglesIntersection( procWindowRoW, srcRodCrop );
+		flood_fill<Connexity, IsUpper<Scalar>, IsUpper<Scalar>, View, View, OfxAllocator>(
+			this->_srcView, ofxToGil(this->_srcPixelRod),
+			this->_dstView, ofxToGil(this->_dstPixelRod),
+			ofxToGil(procWindowRoWCrop),
+			IsUpper<Scalar>(_upperThres),
+			IsUpper<Scalar>(_lowerThres)
+			);
+		return;
+	}
+	_labels.template labelRows<Connexity>( this->_srcView, ofxToGil(this->_srcPixelRod),
+		procWindowRoW.y1, procWindowRoW.y2,
+		IsUpper<Scalar>(_upperThres),
+		IsUpper<Scalar>(_lowerThres)
+		);
+}
+
+template<class View>
+template<class Connexity>
+void FloodFillProcess<View>::fillLabels()
+{
+	using namespace terry::filter::floodFill;
+	typedef FloodFillLabels<OfxAllocator> Labels;
+	_labels.template connectRows<Connexity>();
+	terry::algorithm::parallel_reduce_rows( this->getLauncher(), _procWindowCrop.y2 - _procWindowCrop.y1,
+		detail::flood_fill_rows_writer<Labels, View>( _labels, this->_dstView, ofxToGil(this->_dstPixelRod), ofxToGil(_procWindowCrop) ) );
+}
+
 }
 }
 }
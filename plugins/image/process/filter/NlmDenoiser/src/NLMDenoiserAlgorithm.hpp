@@ -0,0 +1,109 @@
+#ifndef _TUTTLE_PLUGIN_NLMDENOISER_ALGORITHM_HPP_
+#define _TUTTLE_PLUGIN_NLMDENOISER_ALGORITHM_HPP_
+
+#include <boost/gil/gil_all.hpp>
+
+#include <cstddef>
+
+#if ! defined(TERRY_DISABLE_SIMD) && ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+ #define TUTTLE_NLM_SIMD_X86 1
+ #include <emmintrin.h>
+#endif
+
+namespace tuttle {
+namespace plugin {
+namespace nlmDenoiser {
+
+/**
+ * @brief Number of channels used by the patch distances: the color channels (the alpha of RGBA is excluded).
+ */
+template<class Pixel>
+struct nlm_num_channels
+{
+	static const int value = boost::gil::num_channels<Pixel>::value < 3 ? int( boost::gil::num_channels<Pixel>::value ) : 3;
+};
+
+/**
+ * @brief Copy the channels used by the distances in a float view (with the values of the
+ * source channels, not normalized), the other floats of the pixels are 0.
+ */
+template<class View>
+void convertNlmFrame( const View& src, const boost::gil::rgba32f_view_t& dst )
+{
+	static const int nc = nlm_num_channels<typename View::value_type>::value;
+	for( std::ptrdiff_t y = 0; y < src.height(); ++y )
+	{
+		typename View::x_iterator src_it = src.row_begin( y );
+		float* d = reinterpret_cast<float*>( &dst.row_begin( y )[0] );
+		for( std::ptrdiff_t x = 0; x < src.width(); ++x, ++src_it, d += 4 )
+		{
+			int c = 0;
+			for( ; c < nc; ++c )
+				d[c] = float( ( *src_it )[c] );
+			for( ; c < 4; ++c )
+				d[c] = 0.0f;
+		}
+	}
+}
+
+/**
+ * @brief Squared differences of the pixels of two lines of 4 floats per pixel,
+ * summed over the channels.
+ */
+inline void nlmSquaredDifferencesGeneric( const float* a, const float* b, float* dst, const std::size_t n )
+{
+	for( std::size_t x = 0; x < n; ++x, a += 4, b += 4 )
+	{
+		float sum = 0.0f;
+		for( int c = 0; c < 4; ++c )
+		{
+			const float d = a[c] - b[c];
+			sum += d * d;
+		}
+		dst[x] = sum;
+	}
+}
+
+#ifdef TUTTLE_NLM_SIMD_X86
+
+/// nlmSquaredDifferencesGeneric with one pixel per register.
+__attribute__((target("sse2")))
+inline void nlmSquaredDifferencesSse2( const float* a, const float* b, float* dst, const std::size_t n )
+{
+	for( std::size_t x = 0; x < n; ++x, a += 4, b += 4 )
+	{
+		const __m128 d = _mm_sub_ps( _mm_loadu_ps( a ), _mm_loadu_ps( b ) );
+		const __m128 sq = _mm_mul_ps( d, d );
+		// horizontal sum of the 4 channels
+		const __m128 s = _mm_add_ps( sq, _mm_movehl_ps( sq, sq ) );
+		_mm_store_ss( dst + x, _mm_add_ss( s, _mm_shuffle_ps( s, s, 1 ) ) );
+	}
+}
+
+#endif
+
+typedef void (*NlmSquaredDifferencesFunction)( const float*, const float*, float*, const std::size_t );
+
+/// @return the best implementation for the current cpu
+inline NlmSquaredDifferencesFunction selectNlmSquaredDifferences()
+{
+#ifdef TUTTLE_NLM_SIMD_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "sse2" ) )
+		return &nlmSquaredDifferencesSse2;
+#endif
+	return &nlmSquaredDifferencesGeneric;
+}
+
+/// Squared differences with the best implementation for the current cpu.
+inline void nlmSquaredDifferences( const float* a, const float* b, float* dst, const std::size_t n )
+{
+	static const NlmSquaredDifferencesFunction squaredDifferences = selectNlmSquaredDifferences();
+	squaredDifferences( a, b, dst, n );
+}
+
+}
+}
+}
+
+#endif
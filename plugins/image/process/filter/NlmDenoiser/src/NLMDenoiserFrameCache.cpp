@@ -0,0 +1,69 @@
+#include "NLMDenoiserFrameCache.hpp"
+
+#include <boost/thread/locks.hpp>
+
+namespace tuttle {
+namespace plugin {
+namespace nlmDenoiser {
+
+bool NLMFrameKey::operator==( const NLMFrameKey& other ) const
+{
+	return _time == other._time &&
+	       _renderScale.x == other._renderScale.x &&
+	       _renderScale.y == other._renderScale.y &&
+	       _renderWindow.x1 == other._renderWindow.x1 &&
+	       _renderWindow.y1 == other._renderWindow.y1 &&
+	       _renderWindow.x2 == other._renderWindow.x2 &&
+	       _renderWindow.y2 == other._renderWindow.y2 &&
+	       _margin == other._margin &&
+	       _bitDepth == other._bitDepth &&
+	       _components == other._components;
+}
+
+NLMFrameCache::NLMFrameCache()
+: _memorySize( 0 )
+{}
+
+NLMFramePtr NLMFrameCache::get( const NLMFrameKey& key ) const
+{
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	for( Frames::const_iterator it = _frames.begin(); it != _frames.end(); ++it )
+	{
+		if( it->first == key )
+			return it->second;
+	}
+	return NLMFramePtr();
+}
+
+void NLMFrameCache::insert( const NLMFrameKey& key, const NLMFramePtr& frame, const std::size_t capacity )
+{
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	for( Frames::iterator it = _frames.begin(); it != _frames.end(); ++it )
+	{
+		if( it->first == key )
+		{
+			_memorySize -= it->second->memorySize();
+			_frames.erase( it );
+			break;
+		}
+	}
+	_frames.push_back( std::make_pair( key, frame ) );
+	_memorySize += frame->memorySize();
+	// the new frame is always kept
+	while( _frames.size() > 1 && ( _frames.size() > capacity || _memorySize > kMaxMemorySize ) )
+	{
+		_memorySize -= _frames.front().second->memorySize();
+		_frames.pop_front(); // the renders using it keep it alive
+	}
+}
+
+void NLMFrameCache::clear()
+{
+	boost::lock_guard<boost::mutex> lock( _mutex );
+	_frames.clear();
+	_memorySize = 0;
+}
+
+}
+}
+}
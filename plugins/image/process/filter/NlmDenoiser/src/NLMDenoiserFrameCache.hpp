@@ -0,0 +1,86 @@
+#ifndef _TUTTLE_PLUGIN_NLMDENOISER_FRAMECACHE_HPP_
+#define _TUTTLE_PLUGIN_NLMDENOISER_FRAMECACHE_HPP_
+
+#include <tuttle/plugin/memory/OfxAllocator.hpp>
+
+#include <ofxsImageEffect.h>
+
+#include <boost/gil/gil_all.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+namespace tuttle {
+namespace plugin {
+namespace nlmDenoiser {
+
+/**
+ * @brief A source frame converted for the patch distances (see convertNlmFrame).
+ */
+struct NLMFrame
+{
+	typedef boost::gil::image<boost::gil::rgba32f_pixel_t, false, OfxAllocator<unsigned char> > Image;
+
+	OfxRectI _bounds; ///< bounds of the source image
+	Image _image;
+
+	std::size_t memorySize() const { return _image.width() * _image.height() * sizeof( boost::gil::rgba32f_pixel_t ); }
+};
+
+typedef boost::shared_ptr<const NLMFrame> NLMFramePtr;
+
+/**
+ * @brief What the source image of a frame depends on in a sequence render.
+ */
+struct NLMFrameKey
+{
+	OfxTime _time;
+	OfxPointD _renderScale;
+	OfxRectI _renderWindow;
+	int _margin;
+	int _bitDepth;
+	int _components;
+
+	bool operator==( const NLMFrameKey& other ) const;
+};
+
+/**
+ * @brief Sliding window of the converted source frames.
+ *
+ * The consecutive renders of a sequence share most of their temporal
+ * window, so each source frame is fetched and converted only once.
+ * The source images are released just after their conversion.
+ * The frames are only valid during a sequence render: the input may
+ * change between two sequences, so the cache is cleared by the plugin at
+ * the beginning and at the end of each sequence.
+ * The frames are allocated by the host, and the cache keeps at most
+ * kMaxMemorySize bytes of them (the frames used by a render stay alive).
+ */
+class NLMFrameCache : boost::noncopyable
+{
+public:
+	static const std::size_t kMaxMemorySize = 512 * 1024 * 1024;
+
+	NLMFrameCache();
+
+	NLMFramePtr get( const NLMFrameKey& key ) const;
+	/// @brief Add a frame, the oldest ones are released to keep @p capacity frames and kMaxMemorySize bytes.
+	void insert( const NLMFrameKey& key, const NLMFramePtr& frame, const std::size_t capacity );
+	void clear();
+
+private:
+	typedef std::deque<std::pair<NLMFrameKey, NLMFramePtr> > Frames;
+	mutable boost::mutex _mutex;
+	Frames _frames; ///< oldest first
+	std::size_t _memorySize; ///< bytes of the frames
+};
+
+}
+}
+}
+
+#endif
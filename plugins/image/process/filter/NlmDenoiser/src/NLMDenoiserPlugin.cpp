@@ -72,6 +72,20 @@ void NLMDenoiserPlugin::getRegionsOfInterest( const OFX::RegionsOfInterestArgume
 	rois.setRegionOfInterest( *_clipSrc, roi );
 }
 
+void NLMDenoiserPlugin::beginSequenceRender( const OFX::BeginSequenceRenderArguments& args )
+{
+	_frameCache.clear();
+}
+
+void NLMDenoiserPlugin::endSequenceRender( const OFX::EndSequenceRenderArguments& args )
+{
+	_frameCache.clear();
+}
+
+void NLMDenoiserPlugin::purgeCaches()
+{
+	_frameCache.clear();
+}
 
 /**
  * @brief The overridden render function
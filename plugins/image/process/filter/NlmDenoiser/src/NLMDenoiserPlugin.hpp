@@ -1,6 +1,8 @@
 #ifndef _TUTTLE_PLUGIN_NLMDENOISER_PLUGIN_HPP_
 #define _TUTTLE_PLUGIN_NLMDENOISER_PLUGIN_HPP_
 
+#include "NLMDenoiserFrameCache.hpp"
+
 #include <ofxsImageEffect.h>
 
 namespace tuttle {
@@ -22,12 +24,18 @@ public:
 	OFX::IntParam* _paramDepth;
 	OFX::IntParam* _paramRegionRadius;
 	OFX::IntParam* _paramPatchRadius;
+
+	NLMFrameCache _frameCache; ///< converted source frames of the current sequence render
 	
 public:
 	NLMDenoiserPlugin( OfxImageEffectHandle handle );
 
 	void getFramesNeeded( const OFX::FramesNeededArguments &args, OFX::FramesNeededSetter &frames );
 	void getRegionsOfInterest( const OFX::RegionsOfInterestArguments& args, OFX::RegionOfInterestSetter& rois );
+
+	void beginSequenceRender( const OFX::BeginSequenceRenderArguments& args );
+	void endSequenceRender( const OFX::EndSequenceRenderArguments& args );
+	void purgeCaches();
 	
 	void render( const OFX::RenderArguments &args );
 };
@@ -2,6 +2,7 @@
 #define _TUTTLE_PLUGIN_NLMDENOISERPROCESS_HPP_
 
 #include "NLMDenoiserPlugin.hpp"
+#include "NLMDenoiserFrameCache.hpp"
 
 #include <tuttle/common/utils/global.hpp>
 #include <tuttle/plugin/ImageGilProcessor.hpp>
@@ -15,7 +16,6 @@
 
 #include <boost/gil/gil_all.hpp>
 
-#include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/array.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/scoped_array.hpp>
@@ -57,8 +57,9 @@ protected:
 	OFX::DoubleParam* _paramGreenGrainSize; ///< Green color effect bandwidth
 	OFX::DoubleParam* _paramBlueGrainSize; ///< Blue color effect bandwidth
 
-	std::vector< View > _srcViews; ///< Array of source image view (3D-NLMeans)
-	boost::ptr_vector< OFX::Image > _srcImgs;
+	boost::scoped_ptr<OFX::Image> _src; ///< Source image of the current frame
+	View _srcView; ///< Source view of the current frame
+	std::vector<NLMFramePtr> _frames; ///< Converted source frames (3D-NLMeans), the current frame first
 
 	NLMDenoiserPlugin & _plugin; ///< Rendering plugin
 
@@ -66,8 +67,7 @@ protected:
 	OfxRectI _upScaledBounds; ///< Upscaled source bounds (margin upscaling)
 
 protected:
-	void addFrame( const OfxRectI & dBounds, const int dstBitDepth,
-				 const int dstComponents, const double time, const int z );
+	NLMFramePtr getFrame( const NLMFrameKey& key, const std::size_t capacity );
 
 public:
 	NLMDenoiserProcess( NLMDenoiserPlugin & instance );
@@ -80,7 +80,8 @@ public:
 	double computeBandwidth( );
 	void nlMeans( View& dst, const OfxRectI& procWindow, const NlmParams& params );
 
-	void computeWeights( const std::vector< View > & srcViews,
+	void computeWeights( const View& src,
+						 const std::vector< boost::gil::rgba32f_view_t > & srcViews,
 						 const OfxRectI & procWindow,
 						 boost::gil::rgba32f_view_t & view_wc,
 						 boost::gil::rgba32f_view_t & view_norm,
@@ -1,5 +1,6 @@
 #include "NLMDenoiserDefinitions.hpp"
 #include "NLMDenoiserPlugin.hpp"
+#include "NLMDenoiserAlgorithm.hpp"
 #include "imageUtils/noiseAnalysis.hpp"
 
 #include <tuttle/common/utils/global.hpp>
@@ -17,6 +18,7 @@
 #include <boost/gil/gil_all.hpp>
 #include <boost/scoped_ptr.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <vector>
@@ -55,34 +57,43 @@ NLMDenoiserProcess<View>::~NLMDenoiserProcess()
 {
 }
 
+/**
+ * @brief The converted source frame of @p key, from the frames of the previous renders of the sequence if possible.
+ * The source image is released after its conversion, except the image of the current frame.
+ */
 template<class View>
-void NLMDenoiserProcess<View>::addFrame( const OfxRectI & dBounds, const int dstBitDepth, const int dstComponents, const double time, const int z )
+NLMFramePtr NLMDenoiserProcess<View>::getFrame( const NLMFrameKey& key, const std::size_t capacity )
 {
-	// Fetch main input image
-	TUTTLE_TLOG( TUTTLE_INFO, "NLMDenoiserProcess<View>::addFrame time:" << time );
-	OFX::Image *img = _plugin._clipSrc->fetchImage( time );
-	if( !img )
-		BOOST_THROW_EXCEPTION( exception::ImageNotReady() );
-	_srcImgs.push_back( img );
-	OfxRectI bounds = img->getBounds();
-	const int w = bounds.x2 - bounds.x1;
-	const int h = bounds.y2 - bounds.y1;
-
-	memcpy( &_upScaledBounds, &bounds, sizeof (OfxRectI ) );
-
-	// Build views
-	_srcViews.push_back(
-		bgil::interleaved_view( w, h, (Pixel *) img->getPixelData(), img->getRowDistanceBytes() ) );
-
-	// Make sure bit depths are same
-	OFX::EBitDepth srcBitDepth = img->getPixelDepth();
-	OFX::EPixelComponent srcComponents = img->getPixelComponents();
-
-	// See if they have the same bit depths
-	if( srcBitDepth != dstBitDepth || srcComponents != dstComponents )
+	NLMFramePtr frame = _plugin._frameCache.get( key );
+	if( frame )
+		return frame;
+
+	boost::scoped_ptr<OFX::Image> img;
+	View srcView = _srcView;
+	OfxRectI bounds = _upScaledBounds;
+	if( key._time != this->_renderArgs.time )
 	{
-		BOOST_THROW_EXCEPTION( exception::BitDepthMismatch() );
+		// Fetch a neighbour frame
+		TUTTLE_TLOG( TUTTLE_INFO, "NLMDenoiserProcess<View>::getFrame time:" << key._time );
+		img.reset( _plugin._clipSrc->fetchImage( key._time ) );
+		if( !img.get() )
+			BOOST_THROW_EXCEPTION( exception::ImageNotReady() );
+		// See if they have the same bit depths
+		if( img->getPixelDepth() != key._bitDepth || img->getPixelComponents() != key._components )
+		{
+			BOOST_THROW_EXCEPTION( exception::BitDepthMismatch() );
+		}
+		bounds = img->getBounds();
+		srcView = bgil::interleaved_view( bounds.x2 - bounds.x1, bounds.y2 - bounds.y1,
+		                                  (Pixel *) img->getPixelData(), img->getRowDistanceBytes() );
 	}
+
+	boost::shared_ptr<NLMFrame> newFrame( new NLMFrame() );
+	newFrame->_bounds = bounds;
+	newFrame->_image.recreate( srcView.dimensions() );
+	convertNlmFrame( srcView, bgil::view( newFrame->_image ) );
+	_plugin._frameCache.insert( key, newFrame, capacity );
+	return newFrame;
 }
 
 template<class View>
@@ -90,8 +101,7 @@ void NLMDenoiserProcess<View>::setup( const OFX::RenderArguments &args )
 {
 	const int depth = _paramDepth->getValue();
 
-	_srcViews.clear();
-	_srcImgs.clear();
+	_frames.clear();
 
 	this->_dst.reset( _plugin._clipDst->fetchImage( args.time ) );
 	// Fetch output image
@@ -106,6 +116,20 @@ void NLMDenoiserProcess<View>::setup( const OFX::RenderArguments &args )
 											 ( Pixel * ) this->_dst->getPixelData(),
 											 this->_dst->getRowDistanceBytes() );
 
+	// Fetch main input image
+	_src.reset( _plugin._clipSrc->fetchImage( args.time ) );
+	if( !_src.get() )
+		BOOST_THROW_EXCEPTION( exception::ImageNotReady() );
+	_upScaledBounds = _src->getBounds();
+	_srcView = bgil::interleaved_view( _upScaledBounds.x2 - _upScaledBounds.x1, _upScaledBounds.y2 - _upScaledBounds.y1,
+	                                   (Pixel *) _src->getPixelData(), _src->getRowDistanceBytes() );
+
+	// See if they have the same bit depths
+	if( _src->getPixelDepth() != dstBitDepth || _src->getPixelComponents() != dstComponents )
+	{
+		BOOST_THROW_EXCEPTION( exception::BitDepthMismatch() );
+	}
+
 	// Get render frame range
 	const OfxRangeD clipFullRange = _plugin._clipSrc->getFrameRange();
 	OfxRangeD requestedRange;
@@ -115,19 +139,34 @@ void NLMDenoiserProcess<View>::setup( const OFX::RenderArguments &args )
 	realRange.min = std::max( requestedRange.min, clipFullRange.min );
 	realRange.max = std::min( requestedRange.max, clipFullRange.max );
 
-	int i = 0;
-	addFrame( dBounds, dstBitDepth, dstComponents, (int) ( args.time ), i++ );
+	// The frames of the temporal window of the next render are kept
+	const std::size_t capacity = 2 * depth + 2;
+	NLMFrameKey key;
+	key._time = args.time;
+	key._renderScale = args.renderScale;
+	key._renderWindow = args.renderWindow;
+	key._margin = _paramRegionRadius->getValue() + _paramPatchRadius->getValue();
+	key._bitDepth = dstBitDepth;
+	key._components = dstComponents;
 
-	for( OfxTime t = args.time - 1; t >= realRange.min; --t )
-	{
-		TUTTLE_TLOG_VAR2( TUTTLE_INFO, args.time, t );
-		addFrame( dBounds, dstBitDepth, dstComponents, t, i++ );
-	}
+	_frames.push_back( getFrame( key, capacity ) );
 
+	std::vector<OfxTime> times;
+	for( OfxTime t = args.time - 1; t >= realRange.min; --t )
+		times.push_back( t );
 	for( OfxTime t = args.time + 1; t <= realRange.max; ++t )
+		times.push_back( t );
+
+	for( std::vector<OfxTime>::const_iterator t = times.begin(); t != times.end(); ++t )
 	{
-		TUTTLE_TLOG_VAR2( TUTTLE_INFO, args.time, t );
-		addFrame( dBounds, dstBitDepth, dstComponents, t, i++ );
+		TUTTLE_TLOG_VAR2( TUTTLE_INFO, args.time, *t );
+		key._time = *t;
+		const NLMFramePtr frame = getFrame( key, capacity );
+		const OfxRectI& bounds = frame->_bounds;
+		// the frames with other bounds (the source has another RoD at this time) are not used
+		if( bounds.x1 == _upScaledBounds.x1 && bounds.y1 == _upScaledBounds.y1 &&
+		    bounds.x2 == _upScaledBounds.x2 && bounds.y2 == _upScaledBounds.y2 )
+			_frames.push_back( frame );
 	}
 }
 
@@ -137,16 +176,16 @@ void NLMDenoiserProcess<View>::preProcess()
 	// Initialize progress bar
 	if( _paramOptimized->getValue() )
 	{
-		const int min_xpi = std::min( (int) _paramRegionRadius->getValue() * 2, (int) _srcViews[0].width() ),
-			min_ypi = std::min( (int) _paramRegionRadius->getValue() * 2, (int) _srcViews[0].height() );
+		const int min_xpi = std::min( (int) _paramRegionRadius->getValue() * 2, (int) _srcView.width() ),
+			min_ypi = std::min( (int) _paramRegionRadius->getValue() * 2, (int) _srcView.height() );
 		std::stringstream msg;
 		msg << "NL-Means algorithm in progress (automatic bandwidth = " << computeBandwidth() << ").";
 		this->progressBegin( _paramDepth->getValue() * min_xpi * min_ypi, msg.str() );
 	}
 	else
 	{
-		this->progressBegin( (int) ( ( _srcViews[0].width() * this->_renderArgs.renderScale.x ) *
-									 ( _srcViews[0].height() * this->_renderArgs.renderScale.y ) /
+		this->progressBegin( (int) ( ( _srcView.width() * this->_renderArgs.renderScale.x ) *
+									 ( _srcView.height() * this->_renderArgs.renderScale.y ) /
 									 _plugin._clipSrc->getPixelAspectRatio() ), "NL-Means algorithm in progress" );
 	}
 }
@@ -227,8 +266,7 @@ void NLMDenoiserProcess<View>::nlMeans( View &dst, const OfxRectI & procWindow,
 		mix[i] = params.mix[i] * channel_traits< Channel >::max_value();
 	}
 
-	std::vector<View> subSrcViews;
-	typename std::vector<View>::iterator it;
+	std::vector<rgba32f_view_t> subSrcViews;
 	const int margin = params.regionRadius + params.patchRadius;
 
 	// Upscale process window
@@ -246,9 +284,14 @@ void NLMDenoiserProcess<View>::nlMeans( View &dst, const OfxRectI & procWindow,
 	tUpscaledProcWindow.y2 = upscaledProcWindow.y2 - _upScaledBounds.y1;
 
 	// Create up-scaled-proc-windowed subviews sequence
-	for( it = _srcViews.begin(); it != _srcViews.end(); ++it )
+	const View subSrcView = subimage_view( _srcView, tUpscaledProcWindow.x1, tUpscaledProcWindow.y1,
+	                                       tUpscaledProcWindow.x2 - tUpscaledProcWindow.x1,
+	                                       tUpscaledProcWindow.y2 - tUpscaledProcWindow.y1 );
+	for( std::vector<NLMFramePtr>::const_iterator it = _frames.begin(); it != _frames.end(); ++it )
 	{
-		subSrcViews.push_back( subimage_view( *it, tUpscaledProcWindow.x1, tUpscaledProcWindow.y1,
+		// the frames are not modified, the views are only used to read them
+		const rgba32f_view_t frameView = view( const_cast<NLMFrame::Image&>( ( *it )->_image ) );
+		subSrcViews.push_back( subimage_view( frameView, tUpscaledProcWindow.x1, tUpscaledProcWindow.y1,
 											 tUpscaledProcWindow.x2 - tUpscaledProcWindow.x1,
 											 tUpscaledProcWindow.y2 - tUpscaledProcWindow.y1 ) );
 	}
@@ -270,11 +313,11 @@ void NLMDenoiserProcess<View>::nlMeans( View &dst, const OfxRectI & procWindow,
 	nProcWindow.x2 = nProcWindow.x1 + w;
 	nProcWindow.y2 = nProcWindow.y1 + h;
 
-	computeWeights( subSrcViews, nProcWindow, view_wc, view_norm, params );
+	computeWeights( subSrcView, subSrcViews, nProcWindow, view_wc, view_norm, params );
 
 	if( !_plugin.abort() )
 	{
-		View procView = subimage_view( subSrcViews[0], nProcWindow.x1, nProcWindow.y1, w, h );
+		View procView = subimage_view( subSrcView, nProcWindow.x1, nProcWindow.y1, w, h );
 		for( int yj = 0; yj < h; ++yj )
 		{
 			WeightIt wcIter = view_wc.row_begin( yj );
@@ -302,17 +345,26 @@ void NLMDenoiserProcess<View>::nlMeans( View &dst, const OfxRectI & procWindow,
 	}
 }
 
+/**
+ * @brief Accumulate the weights of the patches of each displacement.
+ *
+ * The distance between two patches is the sum of the squared differences of
+ * their pixels. For each displacement, the squared differences of the
+ * overlapping pixels are summed in an integral image, so the distance of
+ * each patch only costs 4 reads whatever the patch radius.
+ * The patches are cropped by the overlap of the two frames.
+ *
+ * @param[in] src  source view of the current frame, for the noise estimation
+ * @param[in] srcViews  converted frames, the current frame first
+ */
 template<class View>
-void NLMDenoiserProcess<View>::computeWeights( const std::vector<View> & srcViews,
+void NLMDenoiserProcess<View>::computeWeights( const View& src,
+											   const std::vector<bgil::rgba32f_view_t> & srcViews,
 											   const OfxRectI & procWindow,
 											   bgil::rgba32f_view_t & view_wc,
 											   bgil::rgba32f_view_t & view_norm,
 											   const NlmParams & params )
 {
-	typedef typename View::x_iterator sIterator;
-	typedef typename bgil::rgba32f_view_t::x_iterator wIterator;
-	typedef typename bgil::channel_type<View>::type dpix_t;
-	typedef typename View::locator Loc;
 	typedef typename bgil::rgba32f_view_t::locator WLoc;
 
 	const int patchRadius = params.patchRadius;
@@ -322,9 +374,8 @@ void NLMDenoiserProcess<View>::computeWeights( const std::vector<View> & srcView
 	const int hi = srcViews[0].height();
 	
 	// Noise variance estimation
-	const double nv = imageUtils::noise_variance( srcViews[0] );
+	const double nv = imageUtils::noise_variance( const_cast<View&>( src ) );
 	const double sigma = std::sqrt( nv < 0 ? 0 : nv );
-	Loc loc1, loc2;
 	WLoc wcLoc, wnLoc;
 
 	// Optimisation based on: AN IMPROVED NON-LOCAL DENOISING ALGORITHM, LNLA 2008
@@ -332,13 +383,12 @@ void NLMDenoiserProcess<View>::computeWeights( const std::vector<View> & srcView
 	const int min_xpi = std::min( params.regionRadius, wi / 2 );
 	const int min_ypi = std::min( params.regionRadius, hi / 2 );
 
-	static const int nc = boost::mpl::min< boost::mpl::int_<3>, typename bgil::num_channels<Pixel>::type >::type::value;
+	static const int nc = nlm_num_channels<Pixel>::value;
 	boost::array<float,nc> bws;
 	for( std::size_t i = 0; i < bws.size(); ++i )
 	{
 		bws[i] = params.bws[i];
 	}
-	int lbound, hbound;
 	// [Kervrann] notations
 	std::vector<double> h1( nc );
 	std::vector<double> h2( nc );
@@ -351,7 +401,11 @@ void NLMDenoiserProcess<View>::computeWeights( const std::vector<View> & srcView
 		h2[i] = 1.0 / ( h1[i] * h1[i] );
 	}
 
-	double abs_e, eucl_dist, weigth, e;
+	double abs_e, eucl_dist, weigth;
+
+	// Squared differences of a line, and their integral image (with a first line and column of 0)
+	std::vector<float> squaredDiffs( wi );
+	std::vector<double> integral( ( wi + 1 ) * ( hi + 1 ), 0.0 );
 
 	// For zi (displacment)
 	for( int zi = 0; zi < depth; ++zi )
@@ -362,101 +416,72 @@ void NLMDenoiserProcess<View>::computeWeights( const std::vector<View> & srcView
 			// For xi (displacment)
 			for( int xi = -min_xpi; xi <= min_xpi; ++xi )
 			{
+				// Overlap of the current frame and the displaced frame
+				const int xl = std::max( 0, -xi );
+				const int xh = std::min( wi, wi - xi );
+				const int yl = std::max( 0, -yi );
+				const int yh = std::min( hi, hi - yi );
+
 				// If not 0 displacment
-				if( xi != 0 || yi != 0 )
+				if( ( xi != 0 || yi != 0 ) && xl < xh && yl < yh )
 				{
-					const int xl = xi < 0 ? std::abs( xi ) : 0;
-					const int xh = wi + xi > wi ? wi - xi : wi;
-					const int yl = yi < 0 ? std::abs( yi ) : 0;
-					const int yh = hi + yi > hi ? hi - yi : hi;
+					const int ow = xh - xl;
+					const int oh = yh - yl;
+					const int stride = ow + 1;
 
-					// For yj
-					for( int yj = yl; yj < yh; ++yj )
+					// Integral image of the squared differences on the overlap
+					std::fill( integral.begin(), integral.begin() + stride, 0.0 );
+					for( int y = 0; y < oh; ++y )
 					{
-						// Initialize patch euclidian distance
-						eucl_dist = 0.0f;
-						int j = yj + yi;
-						// Horizontal & vertical averaging bounds
-						if( yi >= 0 )
-						{
-							lbound = -patchRadius + yj < 0 ? std::max( -yj, -patchRadius ) : -patchRadius;
-							hbound = lbound + ( patchRadius * 2 + 1 );
-							if( hbound + j > hi )
-								hbound = std::min( hi - j, patchRadius );
-						}
-						else
+						const float* a = reinterpret_cast<const float*>( &srcViews[zi].row_begin( y + yl + yi )[xl + xi] );
+						const float* b = reinterpret_cast<const float*>( &srcViews[0].row_begin( y + yl )[xl] );
+						nlmSquaredDifferences( a, b, &squaredDiffs[0], ow );
+						const double* prev = &integral[y * stride];
+						double* cur = &integral[( y + 1 ) * stride];
+						double lineSum = 0.0;
+						cur[0] = 0.0;
+						for( int x = 0; x < ow; ++x )
 						{
-							hbound = patchRadius + yj > hi ? std::min( patchRadius, ( hi - yj ) ) : patchRadius;
-							lbound = hbound - ( patchRadius * 2 + 1 );
-							if( lbound + j < 0 )
-								lbound = 0;
+							lineSum += squaredDiffs[x];
+							cur[x + 1] = prev[x + 1] + lineSum;
 						}
+					}
 
-						// Warmup: initial average accumulation
-						int xl_bound = std::max( xl - patchRadius, 0 );
-						int xr_bound = std::min( wi, xl_bound + patchRadius * 2 );
-						loc1 = srcViews[zi].xy_at( xi, j );
-						loc2 = srcViews[ 0].xy_at( 0, yj );
-						for( int xj = xl_bound; xj < xr_bound; ++xj )
-						{
-							// following "if" is bad but simplify the code
-							if( ( xj + xi ) >= 0 )
-							{
-								for( int k = lbound; k < hbound; ++k )
-								{
-									for( int v = 0; v < nc; ++v )
-									{
-										e = loc1( xj, k )[v] - loc2( xj, k )[v];
-										eucl_dist += e * e;
-									}
-								}
-							}
-						}
+					// For yj
+					for( int yj = yl; yj < yh; ++yj )
+					{
+						const int j = yj + yi;
+						const bool yPass = yj >= procWindow.y1 && yj < procWindow.y2;
+						const bool yPassSym = zi == 0 && j >= procWindow.y1 && j < procWindow.y2;
+						if( ! yPass && ! yPassSym )
+							continue;
+
+						// Vertical bounds of the patch in the integral image
+						const double* top = &integral[( std::max( yj - patchRadius, yl ) - yl ) * stride];
+						const double* bottom = &integral[( std::min( yj + patchRadius + 1, yh ) - yl ) * stride];
+
+						const bgil::rgba32f_view_t::x_iterator pix1 = srcViews[zi].row_begin( j );
+						const bgil::rgba32f_view_t::x_iterator pix2 = srcViews[0].row_begin( yj );
 
 						// For xj
 						for( int xj = xl; xj < xh; ++xj )
 						{
 							int i = xj + xi;
 
-							loc1 = srcViews[zi].xy_at( i, j );
-							loc2 = srcViews[0].xy_at( xj, yj );
-
-							// 2D centered patch sliding average
-							if( patchRadius + i < wi && patchRadius + xj < wi )
-							{
-								for( int k = lbound; k < hbound; ++k )
-								{
-									for( int v = 0; v < nc; ++v )
-									{
-										e = loc1( patchRadius, k )[v] - loc2( patchRadius, k )[v];
-										eucl_dist += e * e;
-									}
-								}
-							}
-
-							if( xj - patchRadius - 1 >= 0 && i - patchRadius - 1 >= 0 )
-							{
-								for( int k = lbound; k < hbound; ++k )
-								{
-									for( int v = 0; v < nc; ++v )
-									{
-										e = loc1( -patchRadius - 1, k )[v] - loc2( -patchRadius - 1, k )[v];
-										eucl_dist -= e * e;
-									}
-								}
-							}
-
 							// Symetric weigthening will be computed
-							bool w1Pass = ( zi == 0 && i >= procWindow.x1 && i < procWindow.x2 &&
-										 j >= procWindow.y1 && j < procWindow.y2 );
+							bool w1Pass = ( yPassSym && i >= procWindow.x1 && i < procWindow.x2 );
 
 							// Weigthening will be computed
-							bool w2Pass = ( xj >= procWindow.x1 && xj < procWindow.x2 &&
-										 yj >= procWindow.y1 && yj < procWindow.y2 );
+							bool w2Pass = ( yPass && xj >= procWindow.x1 && xj < procWindow.x2 );
 
 							// Weight computation (Modified Bisquare weightening function)
 							if( w1Pass || w2Pass )
 							{
+								// Patch euclidian distance
+								const int px1 = std::max( xj - patchRadius, xl ) - xl;
+								const int px2 = std::min( xj + patchRadius + 1, xh ) - xl;
+								eucl_dist = bottom[px2] - bottom[px1] - top[px2] + top[px1];
+
 								wcLoc = view_wc.xy_at( xj - procWindow.x1, yj - procWindow.y1 );
 								wnLoc = view_norm.xy_at( xj - procWindow.x1, yj - procWindow.y1 );
 
@@ -474,13 +499,13 @@ void NLMDenoiserProcess<View>::computeWeights( const std::vector<View> & srcView
 										// Weight accumulation
 										if( w1Pass )
 										{
-											wcLoc( xi, yi )[v] += weigth * loc2( 0, 0 )[v];
+											wcLoc( xi, yi )[v] += weigth * pix2[xj][v];
 											wnLoc( xi, yi )[v] += weigth;
 										}
 										if( w2Pass )
 										{
 											// Symmetry
-											wcLoc( 0, 0 )[v] += weigth * loc1( 0, 0 )[v];
+											wcLoc( 0, 0 )[v] += weigth * pix1[i][v];
 											wnLoc( 0, 0 )[v] += weigth;
 										}
 									}
@@ -1,14 +1,10 @@
 #include <tuttle/plugin/exceptions.hpp>
 #include <tuttle/plugin/numeric/rectOp.hpp>
 #include <tuttle/plugin/ofxToGil/rect.hpp>
-#include <tuttle/plugin/memory/OfxAllocator.hpp>
 
 #include <terry/globals.hpp>
-#include <terry/algorithm/transform_pixels_progress.hpp>
 #include <terry/filter/thinning.hpp>
 
-#include <boost/mpl/if.hpp>
-
 namespace tuttle {
 namespace plugin {
 namespace thinning {
@@ -34,50 +30,49 @@ void ThinningProcess<View>::setup( const OFX::RenderArguments& args )
 template<class View>
 void ThinningProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW )
 {
-	using namespace boost;
 	using namespace boost::gil;
-    typedef typename View::point_t Point;
-    typedef typename View::coord_t Coord;
-
-//	typedef typename mpl::if_c< num_channels<View>::value==1,
-//	                           View,
-//							   typename kth_channel_view_type<0,View>::type >::type CView;
-	typedef View CView;
-	typedef typename terry::image_from_view<CView, OfxAllocator<unsigned char> >::type CImage;
+	using namespace terry::filter::thinning;
 
 	static const std::size_t border = 1;
 	const OfxRectI srcRodCrop1 = rectangleReduce( this->_srcPixelRod, border );
 	const OfxRectI srcRodCrop2 = rectangleReduce( srcRodCrop1, border );
 	const OfxRectI procWindowRoWCrop1 = rectanglesIntersection( rectangleGrow( procWindowRoW, border ), srcRodCrop1 );
 	const OfxRectI procWindowRoWCrop2 = rectanglesIntersection( procWindowRoW, srcRodCrop2 );
+	if( procWindowRoWCrop2.x2 <= procWindowRoWCrop2.x1 || procWindowRoWCrop2.y2 <= procWindowRoWCrop2.y1 )
+		return;
+
+	// The rows around the render window of this thread are read again by
+	// the neighbour threads, so the two passes work on the bits of the
+	// source around the window of the first pass.
+	const OfxRectI bitsWindow = rectangleGrow( procWindowRoWCrop1, border );
+	const std::ptrdiff_t width = bitsWindow.x2 - bitsWindow.x1;
+	const std::ptrdiff_t height = bitsWindow.y2 - bitsWindow.y1;
+	const View src = subimage_view( this->_srcView,
+	                                bitsWindow.x1 - this->_srcPixelRod.x1, bitsWindow.y1 - this->_srcPixelRod.y1,
+	                                width, height );
+
+	BitImage srcBits( width, height );
+	BitImage tmpBits( width, height );
+	BitImage dstBits( width, height );
+	for( std::ptrdiff_t y = 0; y < height; ++y )
+		pack_white_row( src, srcBits, y );
 
-//	TUTTLE_LOG_WARNING("-----");
-//	TUTTLE_LOG_VAR( TUTTLE_INFO, this->_srcPixelRod );
-//	TUTTLE_LOG_VAR( TUTTLE_INFO, srcRodCrop1 );
-//	TUTTLE_LOG_INFO("");
-//	TUTTLE_LOG_VAR( TUTTLE_INFO, procWindowRoW );
-//	TUTTLE_LOG_VAR( TUTTLE_INFO, procWindowRoWCrop1 );
-//	TUTTLE_LOG_WARNING("-----");
-	
-	/// @todo use an allocator
-	OfxPointI tmpSize;
-	tmpSize.x = procWindowRoWCrop1.x2-procWindowRoWCrop1.x1;
-	tmpSize.y = procWindowRoWCrop1.y2-procWindowRoWCrop1.y1;
-	CImage image_tmp( tmpSize.x, tmpSize.y );
-	CView view_tmp = view( image_tmp );
+	const terry::Rect<std::ptrdiff_t> proc1( procWindowRoWCrop1.x1 - bitsWindow.x1, procWindowRoWCrop1.y1 - bitsWindow.y1,
+	                                         procWindowRoWCrop1.x2 - bitsWindow.x1, procWindowRoWCrop1.y2 - bitsWindow.y1 );
+	const terry::Rect<std::ptrdiff_t> proc2( procWindowRoWCrop2.x1 - bitsWindow.x1, procWindowRoWCrop2.y1 - bitsWindow.y1,
+	                                         procWindowRoWCrop2.x2 - bitsWindow.x1, procWindowRoWCrop2.y2 - bitsWindow.y1 );
+	for( std::ptrdiff_t y = proc1.y1; y < proc1.y2; ++y )
+		thinning_row( srcBits, tmpBits, thinningLut1(), proc1.x1, proc1.x2, y );
+	for( std::ptrdiff_t y = proc2.y1; y < proc2.y2; ++y )
+		thinning_row( tmpBits, dstBits, thinningLut2(), proc2.x1, proc2.x2, y );
 
-	terry::algorithm::transform_pixels_locator_progress(
-		this->_srcView, ofxToGil(this->_srcPixelRod),
-		view_tmp, ofxToGil(procWindowRoWCrop1),
-		ofxToGil(procWindowRoWCrop1),
-		terry::filter::thinning::pixel_locator_thinning_t<View,CView>(this->_srcView, terry::filter::thinning::lutthin1),
-		this->getOfxProgress() );
-	terry::algorithm::transform_pixels_locator_progress(
-		view_tmp, ofxToGil(procWindowRoWCrop1), //srcRodCrop1,
-		this->_dstView, ofxToGil(this->_dstPixelRod),
-		ofxToGil(procWindowRoWCrop2),
-		terry::filter::thinning::pixel_locator_thinning_t<CView,View>(view_tmp, terry::filter::thinning::lutthin2),
-		this->getOfxProgress() );
+	for( std::ptrdiff_t y = proc2.y1; y < proc2.y2; ++y )
+	{
+		unpack_row( dstBits, proc2.x1, proc2.x2, y,
+		            this->_dstView, procWindowRoWCrop2.x1 - this->_dstPixelRod.x1, y + bitsWindow.y1 - this->_dstPixelRod.y1 );
+		if( this->progressForward( proc2.x2 - proc2.x1 ) )
+			return;
+	}
 }
 
 }
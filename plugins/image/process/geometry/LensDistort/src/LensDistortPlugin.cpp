@@ -9,6 +9,11 @@
 #include <ofxsMultiThread.h>
 #include <ofxsParam.h>
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <ctime>
+
 namespace tuttle {
 namespace plugin {
 namespace lens {
@@ -36,6 +41,9 @@ LensDistortPlugin::LensDistortPlugin( OfxImageEffectHandle handle )
 	_postScale            = fetchDoubleParam        ( kParamPostScale );
 	_resizeRod            = fetchChoiceParam        ( kParamResizeRod );
 	_resizeRodManualScale = fetchDoubleParam        ( kParamResizeRodManualScale );
+	_distortionMapSource  = fetchChoiceParam        ( kParamDistortionMapSource );
+	_distortionMapStep    = fetchIntParam           ( kParamDistortionMapStep );
+	_stMapFilename        = fetchStringParam        ( kParamStMapFilename );
 	_groupDisplayParams   = fetchGroupParam         ( kParamDisplayOptions );
 	_gridOverlay          = fetchBooleanParam       ( kParamGridOverlay );
 	_gridCenter           = fetchDouble2DParam      ( kParamGridCenter );
@@ -119,6 +127,74 @@ void LensDistortPlugin::changedParam( const OFX::InstanceChangedArgs& args, cons
 	{
 		redrawOverlays();
 	}
+	else if( paramName == kParamStMapExport )
+	{
+		exportStMap( args );
+	}
+}
+
+void LensDistortPlugin::exportStMap( const OFX::InstanceChangedArgs& args )
+{
+	std::string filename;
+	_stMapFilename->getValue( filename );
+	if( filename.empty() )
+	{
+		BOOST_THROW_EXCEPTION( exception::Value()
+			<< exception::user( "LensDistort: Set the STMap file to export." ) );
+	}
+	// the map of a full resolution render, on each pixel
+	const OfxPointD fullScale = { 1.0, 1.0 };
+	const OfxRectD srcRod = rectIntToDouble( _clipSrc->getPixelRod( args.time, fullScale ) );
+	const OfxRectD dstRod = rectIntToDouble( _clipDst->getPixelRod( args.time, fullScale ) );
+	LensDistortProcessParams<Scalar> params;
+	if( _srcRefClip->isConnected() )
+	{
+		const OfxRectD srcRefRod = rectIntToDouble( _srcRefClip->getPixelRod( args.time, fullScale ) );
+		params = getProcessParams( srcRod, dstRod, srcRefRod, _clipDst->getPixelAspectRatio() );
+	}
+	else
+	{
+		params = getProcessParams( srcRod, dstRod, _clipDst->getPixelAspectRatio() );
+	}
+	const Point2 outputSize( dstRod.x2 - dstRod.x1, dstRod.y2 - dstRod.y1 );
+	const Point2 inputSize( srcRod.x2 - srcRod.x1, srcRod.y2 - srcRod.y1 );
+	writeStMap( *computeDistortionMap( getLensType(), params, outputSize, inputSize, 1 ), filename );
+}
+
+LensDistortPlugin::DistortionMapPtr LensDistortPlugin::getDistortionMap( const LensDistortProcessParams<Scalar>& params, const Point2& outputSize, const Point2& inputSize )
+{
+	const EParamDistortionMapSource source = getDistortionMapSource();
+	DistortionMapKey key;
+	std::string filename;
+	if( source == eParamDistortionMapSourceFile )
+	{
+		// the STMap doesn't depend on the image sizes, only on the file
+		_stMapFilename->getValue( filename );
+		boost::system::error_code error;
+		const std::time_t lastWriteTime = boost::filesystem::last_write_time( filename, error );
+		if( error )
+		{
+			BOOST_THROW_EXCEPTION( exception::FileNotExist()
+				<< exception::user( "LensDistort: Unable to open the STMap." )
+				<< exception::filename( filename ) );
+		}
+		key = DistortionMapKey( filename, lastWriteTime );
+	}
+	else
+	{
+		key = DistortionMapKey( getLensType(), params, outputSize, inputSize, _distortionMapStep->getValue() );
+	}
+
+	// the other threads wait for the map
+	boost::mutex::scoped_lock lock( _distortionMapMutex );
+	if( _distortionMap && key == _distortionMapKey )
+		return _distortionMap;
+	if( source == eParamDistortionMapSourceFile )
+		_distortionMap = readStMap( filename );
+	else
+		_distortionMap = computeDistortionMap( getLensType(), params, outputSize, inputSize, _distortionMapStep->getValue() );
+	_distortionMapKey = key;
+	return _distortionMap;
 }
 
 bool LensDistortPlugin::isIdentity( const OFX::RenderArguments& args, OFX::Clip*& identityClip, double& identityTime )
@@ -129,7 +205,8 @@ bool LensDistortPlugin::isIdentity( const OFX::RenderArguments& args, OFX::Clip*
 	{
 		isIdentity = true;
 	}
-	else if( _coef1->getValue() == 0 /*_coef1->getDefault( )*/ &&
+	else if( getDistortionMapSource() == eParamDistortionMapSourceLens &&
+	         _coef1->getValue() == 0 /*_coef1->getDefault( )*/ &&
 	         _preScale->getValue() == _preScale->getDefault() &&
 	         _postScale->getValue() == _postScale->getDefault() &&
 	         ( !_coef2->getIsEnable() || _coef2->getValue() == _coef2->getDefault() ) &&
@@ -313,6 +390,11 @@ void LensDistortPlugin::getRegionsOfInterest( const OFX::RegionsOfInterestArgume
 	//    srcRoi.x2 -= 2;
 	//    srcRoi.y2 -= 2;
 	OfxRectD srcRealRoi = rectanglesIntersection( srcRoi, srcRod );
+	if( getDistortionMapSource() == eParamDistortionMapSourceFile )
+	{
+		// the STMap can read anywhere in the source
+		srcRealRoi = srcRod;
+	}
 
 	rois.setRegionOfInterest( *_clipSrc, srcRealRoi );
 
@@ -3,11 +3,14 @@
 
 #include "lensDistortDefinitions.hpp"
 #include "lensDistortProcessParams.hpp"
+#include "lensDistortMap.hpp"
 
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 #include <tuttle/plugin/context/SamplerPlugin.hpp>
 
 #include <boost/gil/utilities.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <string>
 
 namespace tuttle {
@@ -30,6 +33,7 @@ class LensDistortPlugin : public SamplerPlugin
 public:
 	typedef double Scalar;
 	typedef boost::gil::point2<double> Point2;
+	typedef boost::shared_ptr<const DistortionMap> DistortionMapPtr;
 
 public:
 	///@{
@@ -52,6 +56,10 @@ public:
 	OFX::ChoiceParam*   _resizeRod;            ///< Choice how to resize the RoD (default 'no' resize)
 	OFX::DoubleParam*   _resizeRodManualScale; ///< scale the output RoD
 
+	OFX::ChoiceParam*   _distortionMapSource;  ///< lens model or STMap file
+	OFX::IntParam*      _distortionMapStep;    ///< step of the grid of the distortion map (in output pixels)
+	OFX::StringParam*   _stMapFilename;        ///< STMap file to import or export
+
 	OFX::GroupParam*    _groupDisplayParams;   ///< group of all overlay options (don't modify the output image)
 	OFX::BooleanParam*  _gridOverlay;          ///< grid overlay
 	OFX::Double2DParam* _gridCenter;           ///< grid center
@@ -96,9 +104,25 @@ public:
 	const EParamLensType                 getLensType  () const     { return static_cast<EParamLensType     >( _lensType->getValue()      ); }
 	const EParamCenterType               getCenterType() const    { return static_cast<EParamCenterType   >( _centerType->getValue()    ); }
 	const EParamResizeRod                getResizeRod () const    { return static_cast<EParamResizeRod    >( _resizeRod->getValue()     ); }
+	const EParamDistortionMapSource      getDistortionMapSource() const { return static_cast<EParamDistortionMapSource>( _distortionMapSource->getValue() ); }
+
+	/**
+	 * @brief The distortion map of a render.
+	 *
+	 * The map is computed (or read) once, and reused by the next renders
+	 * with the same parameters (the lens parameters are static across a shot).
+	 * @param outputSize, inputSize sizes of the output and source images, in pixels
+	 */
+	DistortionMapPtr getDistortionMap( const LensDistortProcessParams<Scalar>& params, const Point2& outputSize, const Point2& inputSize );
 
 private:
 	void initParamsProps();
+	void exportStMap( const OFX::InstanceChangedArgs& args );
+
+private:
+	boost::mutex     _distortionMapMutex;
+	DistortionMapKey _distortionMapKey;   ///< parameters of _distortionMap
+	DistortionMapPtr _distortionMap;      ///< map of the last render
 };
 
 }
@@ -206,6 +206,39 @@ void LensDistortPluginFactory::describeInContext( OFX::ImageEffectDescriptor& de
         scaleRod->setDisplayRange( 0, 2.5 );
         scaleRod->setHint( "Adjust the output RoD." );
 
+        OFX::GroupParamDescriptor* distortionMap = desc.defineGroupParam( kParamDistortionMap );
+        distortionMap->setLabel( "Distortion map" );
+        distortionMap->setHint( "The position in the source of each output pixel is computed once for all the frames with the same parameters." );
+
+        OFX::ChoiceParamDescriptor* distortionMapSource = desc.defineChoiceParam( kParamDistortionMapSource );
+        distortionMapSource->setLabel( "Source" );
+        distortionMapSource->setParent( *distortionMap );
+        distortionMapSource->appendOption( kParamDistortionMapSourceLens );
+        distortionMapSource->appendOption( kParamDistortionMapSourceFile );
+        distortionMapSource->setDefault( eParamDistortionMapSourceLens );
+        distortionMapSource->setHint( "Compute the distortion with the lens parameters, or read it from an STMap file." );
+
+        OFX::IntParamDescriptor* distortionMapStep = desc.defineIntParam( kParamDistortionMapStep );
+        distortionMapStep->setLabel( "Step" );
+        distortionMapStep->setParent( *distortionMap );
+        distortionMapStep->setDefault( 1 );
+        distortionMapStep->setRange( 1, 64 );
+        distortionMapStep->setDisplayRange( 1, 16 );
+        distortionMapStep->setHint( "Compute the lens model every N output pixels, and interpolate bilinearly between them.\n"
+                                    "1 computes the lens model on each pixel." );
+
+        OFX::StringParamDescriptor* stMapFilename = desc.defineStringParam( kParamStMapFilename );
+        stMapFilename->setLabel( "STMap file" );
+        stMapFilename->setParent( *distortionMap );
+        stMapFilename->setStringType( OFX::eStringTypeFilePath );
+        stMapFilename->setDefault( "" );
+        stMapFilename->setHint( "EXR file with the normalized source positions of the output pixels (s in R, t in G)." );
+
+        OFX::PushButtonParamDescriptor* stMapExport = desc.definePushButtonParam( kParamStMapExport );
+        stMapExport->setLabel( "Export STMap" );
+        stMapExport->setParent( *distortionMap );
+        stMapExport->setHint( "Write the distortion map of the lens parameters (at full resolution) in the STMap file." );
+
         OFX::GroupParamDescriptor* displayOptions = desc.defineGroupParam( kParamDisplayOptions );
         displayOptions->setLabel( "Display options" );
         displayOptions->setHint( "Display options (change nothing on the image)" );
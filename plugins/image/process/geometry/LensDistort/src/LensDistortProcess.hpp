@@ -2,6 +2,7 @@
 #define LENSDISTORTPROCESS_HPP
 
 #include "lensDistortAlgorithm.hpp"
+#include "lensDistortMap.hpp"
 #include <terry/sampler/sampler.hpp>
 
 #include <tuttle/plugin/global.hpp>
@@ -34,6 +35,10 @@ protected:
 
 	LensDistortParams                _params;
 
+	LensDistortPlugin::DistortionMapPtr _map; ///< source position of each output pixel
+	boost::gil::point2<double>       _outputSize;
+	boost::gil::point2<double>       _inputSize;
+
 public:
 	LensDistortProcess( LensDistortPlugin& instance );
 
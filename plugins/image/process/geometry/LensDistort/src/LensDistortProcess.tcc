@@ -34,6 +34,11 @@ void LensDistortProcess<View>::setup( const OFX::RenderArguments& args )
 	{
 		_p = _plugin.getProcessParams( srcRod, dstRod, this->_clipDst->getPixelAspectRatio() );
 	}
+
+	// the lens model is solved once for all the frames with the same parameters
+	_outputSize = boost::gil::point2<double>( dstRod.x2 - dstRod.x1, dstRod.y2 - dstRod.y1 );
+	_inputSize = boost::gil::point2<double>( srcRod.x2 - srcRod.x1, srcRod.y2 - srcRod.y1 );
+	_map = _plugin.getDistortionMap( _p, _outputSize, _inputSize );
 }
 
 /**
@@ -144,39 +149,8 @@ void LensDistortProcess<View>::lensDistort( View& srcView, View& dstView, const
 	using namespace terry::sampler;
 	EParamFilterOutOfImage outOfImageProcess = _params._samplerProcessParams._outOfImageProcess;
 	terry::Rect<std::ssize_t> procWin = ofxToGil(procWindow);
-	switch( _params._lensType )
-	{
-		case eParamLensTypeStandard:
-		{
-			if( _p._distort )
-			{
-				resample_pixels_progress( srcView, dstView, static_cast<NormalLensDistortParams<double>&>( _p ), procWin, outOfImageProcess, this->getOfxProgress(), sampler );
-			}
-			else
-			{
-				resample_pixels_progress( srcView, dstView, static_cast<NormalLensUndistortParams<double>&>( _p ), procWin, outOfImageProcess,  this->getOfxProgress(), sampler );
-			}
-			return;
-		}
-		case eParamLensTypeFisheye:
-		{
-			if( _p._distort )
-				resample_pixels_progress( srcView, dstView, static_cast<FisheyeLensDistortParams<double>&>( _p ), procWin, outOfImageProcess,  this->getOfxProgress(), sampler );
-			else
-				resample_pixels_progress( srcView, dstView, static_cast<FisheyeLensUndistortParams<double>&>( _p ), procWin, outOfImageProcess,  this->getOfxProgress(), sampler );
-			return;
-		}
-		case eParamLensTypeAdvanced:
-		{
-			if( _p._distort )
-				resample_pixels_progress( srcView, dstView, static_cast<AdvancedLensDistortParams<double>&>( _p ), procWin, outOfImageProcess,  this->getOfxProgress(), sampler );
-			else
-				resample_pixels_progress( srcView, dstView, static_cast<AdvancedLensUndistortParams<double>&>( _p ), procWin, outOfImageProcess,  this->getOfxProgress(), sampler );
-			return;
-		}
-	}
-	BOOST_THROW_EXCEPTION( exception::Bug()
-		<< exception::user( "Lens type not recognize." ) );
+	// a gather of the precomputed positions
+	resample_pixels_progress( srcView, dstView, DistortionMapTransform( *_map, _outputSize, _inputSize ), procWin, outOfImageProcess, this->getOfxProgress(), sampler );
 }
 
 }
@@ -47,6 +47,21 @@ enum EParamResizeRod
 };
 
 static const std::string kParamResizeRodManualScale    ( "scaleRod" );
+
+static const std::string kParamDistortionMap           ( "distortionMap" );
+static const std::string kParamDistortionMapSource     ( "distortionMapSource" );
+static const std::string kParamDistortionMapSourceLens ( "lens" );
+static const std::string kParamDistortionMapSourceFile ( "STMap file" );
+enum EParamDistortionMapSource
+{
+	eParamDistortionMapSourceLens = 0,
+	eParamDistortionMapSourceFile,
+};
+
+static const std::string kParamDistortionMapStep       ( "distortionMapStep" );
+static const std::string kParamStMapFilename           ( "stMapFilename" );
+static const std::string kParamStMapExport             ( "stMapExport" );
+
 static const std::string kParamDisplayOptions          ( "displayOptions" );
 static const std::string kParamGridOverlay             ( "gridOverlay" );
 static const std::string kParamGridCenter              ( "gridCenter" );
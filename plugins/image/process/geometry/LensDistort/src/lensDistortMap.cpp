@@ -0,0 +1,111 @@
+#include "lensDistortMap.hpp"
+
+#include <tuttle/plugin/exceptions.hpp>
+
+#include <ImfOutputFile.h>
+#include <ImfInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImathBox.h>
+
+#include <Iex.h>
+
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace lens {
+
+void writeStMap( const DistortionMap& map, const std::string& filename )
+{
+	const int width = static_cast<int>( map.width() );
+	const int height = static_cast<int>( map.height() );
+
+	// the lines of the map are from bottom to top, the lines of an EXR file are from top to bottom
+	std::vector<float> s( map.width() * map.height() );
+	std::vector<float> t( s.size() );
+	for( std::size_t y = 0; y < map.height(); ++y )
+	{
+		const DistortionMap::PointST* st = map.row( map.height() - 1 - y );
+		for( std::size_t x = 0; x < map.width(); ++x )
+		{
+			s[y * map.width() + x] = st[x].x;
+			t[y * map.width() + x] = st[x].y;
+		}
+	}
+
+	try
+	{
+		Imf::Header header( width, height );
+		header.compression() = Imf::ZIP_COMPRESSION;
+		header.channels().insert( "R", Imf::Channel( Imf::FLOAT ) );
+		header.channels().insert( "G", Imf::Channel( Imf::FLOAT ) );
+
+		Imf::FrameBuffer frameBuffer;
+		frameBuffer.insert( "R", Imf::Slice( Imf::FLOAT, reinterpret_cast<char*>( &s.front() ), sizeof( float ), sizeof( float ) * width ) );
+		frameBuffer.insert( "G", Imf::Slice( Imf::FLOAT, reinterpret_cast<char*>( &t.front() ), sizeof( float ), sizeof( float ) * width ) );
+
+		Imf::OutputFile file( filename.c_str(), header );
+		file.setFrameBuffer( frameBuffer );
+		file.writePixels( height );
+	}
+	catch( Iex::BaseExc& e )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "LensDistort: Unable to write the STMap." )
+			<< exception::dev( e.what() )
+			<< exception::filename( filename ) );
+	}
+}
+
+boost::shared_ptr<DistortionMap> readStMap( const std::string& filename )
+{
+	try
+	{
+		Imf::InputFile file( filename.c_str() );
+		const Imath::Box2i dataWindow = file.header().dataWindow();
+		const int width = dataWindow.max.x - dataWindow.min.x + 1;
+		const int height = dataWindow.max.y - dataWindow.min.y + 1;
+		if( width < 2 || height < 2 ||
+		    ! file.header().channels().findChannel( "R" ) || ! file.header().channels().findChannel( "G" ) )
+		{
+			BOOST_THROW_EXCEPTION( exception::File()
+				<< exception::user( "LensDistort: The STMap needs the channels R and G, and 2 pixels or more in each direction." )
+				<< exception::filename( filename ) );
+		}
+
+		std::vector<float> s( width * height );
+		std::vector<float> t( s.size() );
+		// the slices are addressed with the coordinates of the data window
+		const std::ptrdiff_t origin = -( std::ptrdiff_t( dataWindow.min.y ) * width + dataWindow.min.x );
+		Imf::FrameBuffer frameBuffer;
+		frameBuffer.insert( "R", Imf::Slice( Imf::FLOAT, reinterpret_cast<char*>( &s.front() + origin ), sizeof( float ), sizeof( float ) * width ) );
+		frameBuffer.insert( "G", Imf::Slice( Imf::FLOAT, reinterpret_cast<char*>( &t.front() + origin ), sizeof( float ), sizeof( float ) * width ) );
+		file.setFrameBuffer( frameBuffer );
+		file.readPixels( dataWindow.min.y, dataWindow.max.y );
+
+		boost::shared_ptr<DistortionMap> map( new DistortionMap( width, height ) );
+		for( int y = 0; y < height; ++y )
+		{
+			DistortionMap::PointST* st = map->row( height - 1 - y );
+			for( int x = 0; x < width; ++x )
+			{
+				st[x].x = s[y * width + x];
+				st[x].y = t[y * width + x];
+			}
+		}
+		return map;
+	}
+	catch( Iex::BaseExc& e )
+	{
+		BOOST_THROW_EXCEPTION( exception::File()
+			<< exception::user( "LensDistort: Unable to read the STMap." )
+			<< exception::dev( e.what() )
+			<< exception::filename( filename ) );
+	}
+}
+
+}
+}
+}
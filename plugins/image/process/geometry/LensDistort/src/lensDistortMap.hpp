@@ -0,0 +1,302 @@
+#ifndef _LENSDISTORTMAP_HPP_
+#define _LENSDISTORTMAP_HPP_
+
+#include "lensDistortDefinitions.hpp"
+#include "lensDistortAlgorithm.hpp"
+
+#include <tuttle/plugin/OfxMultiThreadLauncher.hpp>
+
+#include <terry/algorithm/parallel_reduce.hpp>
+
+#include <boost/gil/utilities.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace lens {
+
+/**
+ * @brief Positions in the source image of the pixels of the output image (an STMap).
+ *
+ * The positions are normalized by the size of the source image
+ * (s = (x + 0.5) / width, t = (y + 0.5) / height), so the map doesn't depend
+ * on the render scale.
+ * The grid can be coarser than the output image, it is then bilinearly
+ * interpolated: the node (i, j) is at the center of the output pixel
+ * ( (i + 0.5) * outputWidth / width - 0.5, (j + 0.5) * outputHeight / height - 0.5 ).
+ */
+class DistortionMap
+{
+public:
+	typedef boost::gil::point2<float> PointST;
+
+	DistortionMap( const std::size_t width, const std::size_t height )
+	: _width( width )
+	, _height( height )
+	, _st( width * height )
+	{}
+
+	std::size_t width() const { return _width; }
+	std::size_t height() const { return _height; }
+
+	PointST* row( const std::size_t y ) { return &_st[y * _width]; }
+	const PointST* row( const std::size_t y ) const { return &_st[y * _width]; }
+
+	/**
+	 * @brief Normalized source position of the point (x, y) of an output image of size @p outputSize.
+	 * Outside of the grid, the nearest cells are extrapolated.
+	 */
+	template<typename F>
+	PointST st( const F x, const F y, const boost::gil::point2<double>& outputSize ) const
+	{
+		if( outputSize.x == _width && outputSize.y == _height )
+		{
+			// the map of the output image
+			const std::ptrdiff_t ix = std::min( std::max( std::ptrdiff_t( x ), std::ptrdiff_t( 0 ) ), std::ptrdiff_t( _width - 1 ) );
+			const std::ptrdiff_t iy = std::min( std::max( std::ptrdiff_t( y ), std::ptrdiff_t( 0 ) ), std::ptrdiff_t( _height - 1 ) );
+			if( ix == x && iy == y )
+				return row( iy )[ix];
+		}
+		const double gx = ( x + 0.5 ) * _width / outputSize.x - 0.5;
+		const double gy = ( y + 0.5 ) * _height / outputSize.y - 0.5;
+		const std::ptrdiff_t x0 = cell( gx, _width );
+		const std::ptrdiff_t y0 = cell( gy, _height );
+		const float fx = float( gx - x0 );
+		const float fy = float( gy - y0 );
+		const std::ptrdiff_t x1 = std::min( x0 + 1, std::ptrdiff_t( _width - 1 ) );
+		const std::ptrdiff_t y1 = std::min( y0 + 1, std::ptrdiff_t( _height - 1 ) );
+		const PointST* r0 = row( y0 );
+		const PointST* r1 = row( y1 );
+		const float ax = r0[x0].x + ( r0[x1].x - r0[x0].x ) * fx;
+		const float ay = r0[x0].y + ( r0[x1].y - r0[x0].y ) * fx;
+		const float bx = r1[x0].x + ( r1[x1].x - r1[x0].x ) * fx;
+		const float by = r1[x0].y + ( r1[x1].y - r1[x0].y ) * fx;
+		return PointST( ax + ( bx - ax ) * fy, ay + ( by - ay ) * fy );
+	}
+
+private:
+	/// first node of the cell of the grid coordinate @p g (the 2 last nodes for the points after the grid)
+	static std::ptrdiff_t cell( const double g, const std::size_t size )
+	{
+		if( size < 2 || g < 0 )
+			return 0;
+		return std::min( std::ptrdiff_t( g ), std::ptrdiff_t( size - 2 ) );
+	}
+
+private:
+	std::size_t _width;
+	std::size_t _height;
+	std::vector<PointST> _st;
+};
+
+/**
+ * @brief The resampling transformation reading a DistortionMap.
+ */
+struct DistortionMapTransform
+{
+	typedef boost::gil::point2<double> Point2;
+
+	const DistortionMap& _map;
+	Point2 _outputSize; ///< size of the output image (in pixels)
+	Point2 _inputSize;  ///< size of the source image (in pixels)
+
+	DistortionMapTransform( const DistortionMap& map, const Point2& outputSize, const Point2& inputSize )
+	: _map( map )
+	, _outputSize( outputSize )
+	, _inputSize( inputSize )
+	{}
+
+	template<typename F>
+	Point2 operator()( const boost::gil::point2<F>& p ) const
+	{
+		const DistortionMap::PointST st = _map.st( p.x, p.y, _outputSize );
+		return Point2( st.x * _inputSize.x - 0.5, st.y * _inputSize.y - 0.5 );
+	}
+};
+
+/**
+ * @brief Computes rows of a DistortionMap with the lens model (a reducer of terry::algorithm::parallel_reduce_rows).
+ */
+template<class Params>
+struct DistortionMapRows
+{
+	typedef boost::gil::point2<double> Point2;
+
+	DistortionMap* _map;
+	const Params* _params;
+	Point2 _outputSize;
+	Point2 _inputSize;
+
+	DistortionMapRows( DistortionMap& map, const Params& params, const Point2& outputSize, const Point2& inputSize )
+	: _map( &map )
+	, _params( &params )
+	, _outputSize( outputSize )
+	, _inputSize( inputSize )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		const double scaleX = _outputSize.x / _map->width();
+		const double scaleY = _outputSize.y / _map->height();
+		DistortionMap::PointST* st = _map->row( y );
+		for( std::size_t x = 0; x < _map->width(); ++x )
+		{
+			const Point2 p( ( x + 0.5 ) * scaleX - 0.5, ( y + 0.5 ) * scaleY - 0.5 );
+			const Point2 src = terry::transform( *_params, p );
+			st[x].x = float( ( src.x + 0.5 ) / _inputSize.x );
+			st[x].y = float( ( src.y + 0.5 ) / _inputSize.y );
+		}
+	}
+
+	void merge( const DistortionMapRows& ) {}
+};
+
+/**
+ * @brief Compute the map of the lens model, with one node every @p step pixels of the output.
+ */
+template<class Params>
+boost::shared_ptr<DistortionMap> computeDistortionMap( const Params& params, const boost::gil::point2<double>& outputSize, const boost::gil::point2<double>& inputSize, const std::size_t step )
+{
+	const std::size_t width = std::max( std::size_t( 2 ), std::size_t( std::ceil( outputSize.x / step ) ) );
+	const std::size_t height = std::max( std::size_t( 2 ), std::size_t( std::ceil( outputSize.y / step ) ) );
+	boost::shared_ptr<DistortionMap> map( new DistortionMap( width, height ) );
+	terry::algorithm::parallel_reduce_rows( OfxMultiThreadLauncher(), std::ptrdiff_t( height ), DistortionMapRows<Params>( *map, params, outputSize, inputSize ) );
+	return map;
+}
+
+inline boost::shared_ptr<DistortionMap> computeDistortionMap( const EParamLensType lensType, const LensDistortProcessParams<double>& params,
+                                                              const boost::gil::point2<double>& outputSize, const boost::gil::point2<double>& inputSize, const std::size_t step )
+{
+	switch( lensType )
+	{
+		case eParamLensTypeStandard:
+		{
+			if( params._distort )
+				return computeDistortionMap( static_cast<const NormalLensDistortParams<double>&>( params ), outputSize, inputSize, step );
+			else
+				return computeDistortionMap( static_cast<const NormalLensUndistortParams<double>&>( params ), outputSize, inputSize, step );
+		}
+		case eParamLensTypeFisheye:
+		{
+			if( params._distort )
+				return computeDistortionMap( static_cast<const FisheyeLensDistortParams<double>&>( params ), outputSize, inputSize, step );
+			else
+				return computeDistortionMap( static_cast<const FisheyeLensUndistortParams<double>&>( params ), outputSize, inputSize, step );
+		}
+		case eParamLensTypeAdvanced:
+		{
+			if( params._distort )
+				return computeDistortionMap( static_cast<const AdvancedLensDistortParams<double>&>( params ), outputSize, inputSize, step );
+			else
+				return computeDistortionMap( static_cast<const AdvancedLensUndistortParams<double>&>( params ), outputSize, inputSize, step );
+		}
+	}
+	BOOST_THROW_EXCEPTION( exception::Unsupported()
+	    << exception::user( "Outside of the plugin fonctionnalities." ) );
+}
+
+/**
+ * @brief Everything a distortion map depends on, to reuse the map of the last render:
+ * the lens model with the sizes of the images and the step of the grid,
+ * or the STMap file with its last modification time.
+ */
+struct DistortionMapKey
+{
+	typedef boost::gil::point2<double> Point2;
+
+	EParamDistortionMapSource _source;
+	// lens model
+	EParamLensType _lensType;
+	LensDistortProcessParams<double> _params;
+	Point2 _outputSize;
+	Point2 _inputSize;
+	std::size_t _step;
+	// STMap file
+	std::string _filename;
+	std::time_t _lastWriteTime;
+
+	DistortionMapKey()
+	: _source( eParamDistortionMapSourceLens )
+	, _lensType( eParamLensTypeStandard )
+	, _step( 0 )
+	, _lastWriteTime( 0 )
+	{}
+
+	DistortionMapKey( const EParamLensType lensType, const LensDistortProcessParams<double>& params,
+	                  const Point2& outputSize, const Point2& inputSize, const std::size_t step )
+	: _source( eParamDistortionMapSourceLens )
+	, _lensType( lensType )
+	, _params( params )
+	, _outputSize( outputSize )
+	, _inputSize( inputSize )
+	, _step( step )
+	, _lastWriteTime( 0 )
+	{}
+
+	DistortionMapKey( const std::string& filename, const std::time_t lastWriteTime )
+	: _source( eParamDistortionMapSourceFile )
+	, _lensType( eParamLensTypeStandard )
+	, _step( 0 )
+	, _filename( filename )
+	, _lastWriteTime( lastWriteTime )
+	{}
+
+	bool operator==( const DistortionMapKey& other ) const
+	{
+		if( _source != other._source )
+			return false;
+		if( _source == eParamDistortionMapSourceFile )
+			return _lastWriteTime == other._lastWriteTime && _filename == other._filename;
+		return _lensType == other._lensType &&
+		       _step == other._step &&
+		       _outputSize == other._outputSize &&
+		       _inputSize == other._inputSize &&
+		       _params._distort == other._params._distort &&
+		       _params._coef1 == other._params._coef1 &&
+		       _params._coef2 == other._params._coef2 &&
+		       _params._squeeze == other._params._squeeze &&
+		       _params._asymmetric == other._params._asymmetric &&
+		       _params._lensCenterDst == other._params._lensCenterDst &&
+		       _params._lensCenterSrc == other._params._lensCenterSrc &&
+		       _params._postScale == other._params._postScale &&
+		       _params._preScale == other._params._preScale &&
+		       _params._imgSizeSrc == other._params._imgSizeSrc &&
+		       _params._imgCenterSrc == other._params._imgCenterSrc &&
+		       _params._imgCenterDst == other._params._imgCenterDst &&
+		       _params._imgHalfDiagonal == other._params._imgHalfDiagonal &&
+		       _params._pixelRatio == other._params._pixelRatio;
+	}
+};
+
+/**
+ * @brief Write the map in an EXR file, in the float channels R (s) and G (t).
+ * The first line of the file is the top of the image.
+ */
+void writeStMap( const DistortionMap& map, const std::string& filename );
+
+/**
+ * @brief Read an STMap from the R (s) and G (t) channels of an EXR file.
+ */
+boost::shared_ptr<DistortionMap> readStMap( const std::string& filename );
+
+}
+}
+}
+
+namespace terry {
+
+template <typename F2>
+inline point2<double> transform( const ::tuttle::plugin::lens::DistortionMapTransform& map, const point2<F2>& src )
+{
+	return map( src );
+}
+
+}
+
+#endif
@@ -8,6 +8,9 @@ namespace tuttle {
 namespace plugin {
 namespace pushPixel {
 
+/// Minimal number of lines of the bands of the motion vectors.
+static const int kMinBandHeight = 64;
+
 /**
  * @brief PushPixel process
  *
@@ -39,6 +42,10 @@ public:
 	void setup( const OFX::RenderArguments& args );
 
     void multiThreadProcessImages( const OfxRectI& procWindowRoW );
+
+private:
+	template<class MaskChannelView>
+	void processBands( const OfxRectI& procWindowRoW, const OfxRectI& imgGradientWin, const OfxRectI& maskPixelRod, MaskChannelView& maskView );
 };
 
 }
@@ -93,15 +93,6 @@ void PushPixelProcess<View>::multiThreadProcessImages( const OfxRectI& procWindo
 		procWindowRoW.y2 - procWindowRoW.y1
 		};
 
-	// use View channel type if floating point else use bit32f
-	typedef typename channel_mapping_type<View>::type Channel;
-	typedef typename boost::mpl::if_< boost::is_floating_point<Channel>,
-	                           Channel,
-							   bits32f>::type ChannelFloat;
-	typedef pixel<ChannelFloat, gray_layout_t> PixelGray;
-	typedef image<PixelGray, false> ImageGray;
-	typedef typename ImageGray::view_t ViewGray;
-
 	OfxRectI usedMaskPixelRod; // the mask RoD (depending on the clip mask used)
 	if( _clipMaskConnected )
 		usedMaskPixelRod = this->_maskPixelRod;
@@ -148,25 +139,6 @@ void PushPixelProcess<View>::multiThreadProcessImages( const OfxRectI& procWindo
 		}
 	}
 
-	const OfxPointI imgGradientSize = { imgGradientWin.x2 - imgGradientWin.x1,
-	                                    imgGradientWin.y2 - imgGradientWin.y1 };
-	ImageGray xGradientImage( imgGradientSize.x, imgGradientSize.y );
-	ImageGray yGradientImage( imgGradientSize.x, imgGradientSize.y );
-	ViewGray xGradientView = view(xGradientImage);
-	ViewGray yGradientView = view(yGradientImage);
-	Point proc_mask_tl( imgGradientWin.x1 - usedMaskPixelRod.x1, imgGradientWin.y1 - usedMaskPixelRod.y1 );
-	
-	/*
-	TUTTLE_LOG_VAR( TUTTLE_INFO, usedMaskPixelRod );
-	TUTTLE_LOG_VAR( TUTTLE_INFO, imgGradientWin );
-	TUTTLE_LOG_VAR( TUTTLE_INFO, procWindowRoW );
-	TUTTLE_LOG_VAR( TUTTLE_INFO, partialGradient );
-	TUTTLE_LOG_VAR( TUTTLE_INFO, procWindowOutput );
-	TUTTLE_LOG_VAR( TUTTLE_INFO, procWindowSize );
-	TUTTLE_LOG_VAR( TUTTLE_INFO, imgGradientSize );
-	TUTTLE_LOG_VAR( TUTTLE_INFO, proc_mask_tl );
-	*/
-
 	// compute motion vectors
 	if( _clipMaskConnected )
 	{
@@ -180,65 +152,126 @@ void PushPixelProcess<View>::multiThreadProcessImages( const OfxRectI& procWindo
 		typedef channel_view_type<MaskColorChannel, MaskView> KthChannelView;
 		typename KthChannelView::type channelMaskView = KthChannelView::make(this->_maskView); // gray or alpha channel
 
-		if( correlateMotionVectors<OfxAllocator, ViewGray, typename KthChannelView::type, Point, Scalar>( xGradientView, yGradientView, channelMaskView, proc_mask_tl, _params._kernelGaussianDerivative, _params._kernelGaussian, _params._boundary_option, this->getOfxProgress() ) )
-			return;
+		processBands( procWindowRoW, imgGradientWin, usedMaskPixelRod, channelMaskView );
 	}
 	else
 	{
 		typedef channel_view_type<alpha_t, View> KthChannelView;
 		typename KthChannelView::type channelMaskView = KthChannelView::make(this->_srcView); // alpha channel
 		
-		if( correlateMotionVectors<OfxAllocator, ViewGray, typename KthChannelView::type, Point, Scalar>( xGradientView, yGradientView, channelMaskView, proc_mask_tl, _params._kernelGaussianDerivative, _params._kernelGaussian, _params._boundary_option, this->getOfxProgress() ) )
-			return;
+		processBands( procWindowRoW, imgGradientWin, usedMaskPixelRod, channelMaskView );
 	}
+}
 
-	if( modifyVectors( xGradientView, yGradientView, this->_params._angle, _params._intensity, this->getOfxProgress() ) )
-			return;
+/**
+ * @brief Computes and applies the motion vectors band by band.
+ *
+ * The vectors of a band are computed with the mask lines around the band,
+ * so they are the same as the vectors of the whole window, but they only use
+ * buffers of the size of a band, which stay in the cache until they are applied.
+ * @param[in] procWindowRoW    Processing window
+ * @param[in] imgGradientWin   part of the processing window with a mask
+ * @param[in] maskPixelRod     RoD of the mask
+ * @param[in] maskView         channel of the mask
+ */
+template<class View>
+template<class MaskChannelView>
+void PushPixelProcess<View>::processBands( const OfxRectI& procWindowRoW, const OfxRectI& imgGradientWin, const OfxRectI& maskPixelRod, MaskChannelView& maskView )
+{
+	using namespace boost::gil;
+	using namespace terry;
+	using namespace terry::filter;
 
-	// apply motion vectors
-	switch( _params._output )
+	// use View channel type if floating point else use bit32f
+	typedef typename channel_mapping_type<View>::type Channel;
+	typedef typename boost::mpl::if_< boost::is_floating_point<Channel>,
+	                           Channel,
+							   bits32f>::type ChannelFloat;
+	typedef pixel<ChannelFloat, gray_layout_t> PixelGray;
+	typedef image<PixelGray, false> ImageGray;
+	typedef typename ImageGray::view_t ViewGray;
+
+	// the push pixel output covers the procWindow (without vectors the pixels are copied),
+	// the motion vectors output only the part with a mask (the rest is already black)
+	const OfxRectI bandsWin = _params._output == eParamOutputPushPixel ? procWindowRoW : imgGradientWin;
+	// the bands are high compared to the kernel, to compute few lines twice
+	const int bandHeight = std::min( bandsWin.y2 - bandsWin.y1,
+		std::max( kMinBandHeight, static_cast<int>( 4 * _params._kernelGaussianDerivative.size() ) ) );
+	const int gradientWidth = imgGradientWin.x2 - imgGradientWin.x1;
+
+	ImageGray xGradientImage( gradientWidth, bandHeight );
+	ImageGray yGradientImage( gradientWidth, bandHeight );
+
+	for( int y = bandsWin.y1; y < bandsWin.y2; y += bandHeight )
 	{
-		case eParamOutputMotionVectors:
+		OfxRectI bandWin = bandsWin;
+		bandWin.y1 = y;
+		bandWin.y2 = std::min( y + bandHeight, bandsWin.y2 );
+
+		// the vectors of the band
+		OfxRectI bandGradientWin = imgGradientWin;
+		bandGradientWin.y1 = std::max( bandWin.y1, imgGradientWin.y1 );
+		bandGradientWin.y2 = std::max( bandGradientWin.y1, std::min( bandWin.y2, imgGradientWin.y2 ) );
+		const OfxPointI bandGradientSize = { gradientWidth, bandGradientWin.y2 - bandGradientWin.y1 };
+		ViewGray xGradientView = subimage_view( view( xGradientImage ), 0, 0, bandGradientSize.x, bandGradientSize.y );
+		ViewGray yGradientView = subimage_view( view( yGradientImage ), 0, 0, bandGradientSize.x, bandGradientSize.y );
+
+		if( bandGradientSize.y > 0 )
 		{
-			const OfxRectI gradientRodInSrc = translateRegion( imgGradientWin, this->_srcPixelRod );
-			// subdst is the part of dst for which we have motion vectors information
-			View subdst = subimage_view( this->_dstView,
-					gradientRodInSrc.x1, gradientRodInSrc.y1,
-					imgGradientSize.x, imgGradientSize.y );
-			copy_and_convert_pixels( xGradientView, kth_channel_view<0>(subdst) ); // put x vectors
-			if( this->progressForward( procWindowSize.y * 0.5 ) )
+			const Point proc_mask_tl( bandGradientWin.x1 - maskPixelRod.x1, bandGradientWin.y1 - maskPixelRod.y1 );
+			if( correlateMotionVectors<OfxAllocator, ViewGray, MaskChannelView, Point, Scalar>( xGradientView, yGradientView, maskView, proc_mask_tl, _params._kernelGaussianDerivative, _params._kernelGaussian, _params._boundary_option, this->getOfxProgress() ) )
 				return;
-			copy_and_convert_pixels( yGradientView, kth_channel_view<1>(subdst) ); // put y vectors
-			if( this->progressForward( procWindowSize.y * 0.5 ) )
+			if( modifyVectors( xGradientView, yGradientView, this->_params._angle, _params._intensity, this->getOfxProgress() ) )
 				return;
-			return;
 		}
-		case eParamOutputPushPixel:
+
+		// apply motion vectors
+		switch( _params._output )
 		{
-			switch( _params._interpolation )
+			case eParamOutputMotionVectors:
 			{
-				/// @todo add all interpolation methods
-				case eParamInterpolationNearest:
-					motionvectors_resample_pixels<sampler::nearest_neighbor_sampler>(
-							this->_srcView, this->_srcPixelRod,
-							xGradientView, yGradientView, imgGradientWin,
-							this->_dstView, this->_dstPixelRod,
-							procWindowRoW,
-							sampler::eParamFilterOutBlack,
-							this->getOfxProgress() );
-					return;
-				case eParamInterpolationBilinear:
-					motionvectors_resample_pixels<sampler::bilinear_sampler>(
-							this->_srcView, this->_srcPixelRod,
-							xGradientView, yGradientView, imgGradientWin,
-							this->_dstView, this->_dstPixelRod,
-							procWindowRoW,
-							sampler::eParamFilterOutBlack,
-							this->getOfxProgress() );
+				const OfxRectI gradientRodInDst = translateRegion( bandGradientWin, this->_dstPixelRod );
+				// subdst is the part of dst for which we have motion vectors information
+				View subdst = subimage_view( this->_dstView,
+						gradientRodInDst.x1, gradientRodInDst.y1,
+						bandGradientSize.x, bandGradientSize.y );
+				copy_and_convert_pixels( xGradientView, kth_channel_view<0>(subdst) ); // put x vectors
+				copy_and_convert_pixels( yGradientView, kth_channel_view<1>(subdst) ); // put y vectors
+				if( this->progressForward( bandGradientSize.x * bandGradientSize.y ) )
 					return;
+				break;
+			}
+			case eParamOutputPushPixel:
+			{
+				switch( _params._interpolation )
+				{
+					/// @todo add all interpolation methods
+					case eParamInterpolationNearest:
+						if( motionvectors_resample_pixels<sampler::nearest_neighbor_sampler>(
+								this->_srcView, this->_srcPixelRod,
+								xGradientView, yGradientView, bandGradientWin,
+								this->_dstView, this->_dstPixelRod,
+								bandWin,
+								sampler::eParamFilterOutBlack,
+								this->getOfxProgress() ) )
+							return;
+						break;
+					case eParamInterpolationBilinear:
+						if( motionvectors_resample_pixels<sampler::bilinear_sampler>(
+								this->_srcView, this->_srcPixelRod,
+								xGradientView, yGradientView, bandGradientWin,
+								this->_dstView, this->_dstPixelRod,
+								bandWin,
+								sampler::eParamFilterOutBlack,
+								this->getOfxProgress() ) )
+							return;
+						break;
+					default:
+						TUTTLE_LOG_ERROR( "Interpolation method not recognize." );
+						return;
+				}
+				break;
 			}
-			TUTTLE_LOG_ERROR( "Interpolation method not recognize." );
-			return;
 		}
 	}
 }
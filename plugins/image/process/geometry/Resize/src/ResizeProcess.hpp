@@ -3,6 +3,9 @@
 
 #include <tuttle/plugin/ImageGilFilterProcessor.hpp>
 
+#include <terry/sampler/resample_separable.hpp>
+#include <terry/geometry/affine.hpp>
+
 namespace tuttle {
 namespace plugin {
 namespace resize {
@@ -23,12 +26,21 @@ protected:
 	ResizePlugin&			_plugin;	///< Rendering plugin
 	ResizeProcessParams<Scalar>	_params;	///< parameters
 
+	terry::sampler::separable_weights _xWeights; ///< filter weights of each column, shared by all the render threads
+	terry::sampler::separable_weights _yWeights; ///< filter weights of each row
+
 public:
 	ResizeProcess( ResizePlugin& effect );
 
 	void setup( const OFX::RenderArguments& args );
 
 	void multiThreadProcessImages( const OfxRectI& procWindowRoW );
+
+private:
+	terry::matrix3x2<double> getDstToSrcTransform() const;
+
+	template<class Sampler>
+	void computeWeights( const Sampler& sampler, const terry::matrix3x2<double>& mat );
 };
 
 }
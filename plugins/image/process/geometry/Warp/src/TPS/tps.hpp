@@ -9,6 +9,7 @@
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/gil/gil_all.hpp>
+#include <boost/shared_ptr.hpp>
 
 
 namespace tuttle {
@@ -18,16 +19,72 @@ namespace warp {
 using namespace boost::gil;
 using namespace boost::numeric::ublas;
 
+/**
+ * @brief Coefficients of a solved thin plate spline, in normalized coordinates.
+ *
+ * The solution only depends on the points, the regularization and the size of
+ * the image, so it can be shared by the renders of all the frames where the
+ * points are not animated.
+ */
+template<typename SCALAR>
+struct TPS_Solution
+{
+	typedef SCALAR Scalar;
+	typedef point2<Scalar> Point2;
+
+	std::vector<Point2> _centers; ///< centers of the radial basis functions
+	std::vector<Point2> _weights; ///< weights of the radial basis functions, for dx and dy
+	Point2 _a0; ///< affine part: constant
+	Point2 _ax; ///< affine part: coefficient of x
+	Point2 _ay; ///< affine part: coefficient of y
+};
+
+/**
+ * @brief Solve the spline moving the points @p pIn to @p pOut (LU factorization of the TPS system).
+ */
+template<typename SCALAR>
+boost::shared_ptr<TPS_Solution<SCALAR> > solveTPS( const std::vector< point2<SCALAR> >& pIn, const std::vector< point2<SCALAR> >& pOut, const double regularization, const std::size_t width, const std::size_t height );
+
+/**
+ * @brief Everything the solution of the spline depends on, to find an already solved spline.
+ */
+template<typename SCALAR>
+struct TPS_Key
+{
+	typedef point2<SCALAR> Point2;
+
+	std::vector<Point2> _pIn;
+	std::vector<Point2> _pOut;
+	double _regularization;
+	std::size_t _width;
+	std::size_t _height;
+
+	TPS_Key( const std::vector<Point2>& pIn, const std::vector<Point2>& pOut, const double regularization, const std::size_t width, const std::size_t height )
+	: _pIn( pIn )
+	, _pOut( pOut )
+	, _regularization( regularization )
+	, _width( width )
+	, _height( height )
+	{}
+
+	bool operator==( const TPS_Key& other ) const
+	{
+		return _regularization == other._regularization &&
+		       _width == other._width &&
+		       _height == other._height &&
+		       _pIn == other._pIn &&
+		       _pOut == other._pOut;
+	}
+};
+
 template<typename SCALAR>
 class TPS_Morpher
 {
 public:
 	typedef SCALAR Scalar;
 	typedef point2<Scalar> Point2;
-
-	typedef matrix<Scalar> Matrix;
-	typedef matrix_row<const Matrix> Const_Matrix_Row;
-	typedef matrix_column<const Matrix> Const_Matrix_Col;
+	typedef TPS_Solution<Scalar> Solution;
+	typedef boost::shared_ptr<const Solution> SolutionPtr;
 
 	bool _activateWarp;
 	std::size_t _nbPoints;
@@ -38,18 +95,20 @@ public:
 public:
 	TPS_Morpher();
 
-        void setup( const std::vector< Point2 > pIn, const std::vector< Point2 > pOut, const double regularization, const bool applyWarp, const std::size_t width, const std::size_t height , const double transition);
+	/// @brief Solve the spline and set it up.
+	void setup( const std::vector< Point2 > pIn, const std::vector< Point2 > pOut, const double regularization, const bool applyWarp, const std::size_t width, const std::size_t height, const double transition );
+
+	/// @brief Set up an already solved spline (see solveTPS).
+	void setup( const SolutionPtr& solution, const bool applyWarp, const std::size_t width, const std::size_t height, const double transition );
+
+	/// @brief The transformation doesn't move any point.
+	bool isIdentity() const { return !_activateWarp || _nbPoints <= 1; }
 
 	template<typename S2>
 	Point2 operator()( const point2<S2>& pt ) const;
 
 private:
-	std::vector<Point2> _pIn;
-	std::vector<Point2> _pOut;
-
-	Matrix _mat_L;
-	Matrix _mat_V;
-	Matrix _mat_K;
+	SolutionPtr _solution;
 };
 
 }
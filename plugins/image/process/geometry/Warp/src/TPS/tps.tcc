@@ -1,5 +1,3 @@
-#include "../WarpPlugin.hpp"
-#include "../WarpProcess.hpp"
 #include "../WarpDefinitions.hpp"
 #include "tps.hpp"
 
@@ -79,56 +77,46 @@ inline double base_func( const double r2 )
 //	return r2; // r^2
 }
 
-template<typename SCALAR>
-TPS_Morpher<SCALAR>::TPS_Morpher()
-{}
-
-
 /**
  *
  * @param pIn
  * @param pOut
  * @param regularization Amount of "relaxation", 0.0 = exact interpolation
- * @param applyWarp
- * @param nbPoints
+ * @param width, height size of the image, to normalize the coordinates
  */
 template<typename SCALAR>
-void TPS_Morpher<SCALAR>::setup( const std::vector< Point2 > pIn, const std::vector< Point2 > pOut, const double regularization, const bool applyWarp, const std::size_t width, const std::size_t height, const double transition )
+boost::shared_ptr<TPS_Solution<SCALAR> > solveTPS( const std::vector< point2<SCALAR> >& pIn, const std::vector< point2<SCALAR> >& pOut, const double regularization, const std::size_t width, const std::size_t height )
 {
 	using boost::math::pow;
+	typedef SCALAR Scalar;
+	typedef point2<Scalar> Point2;
+	typedef matrix<Scalar> Matrix;
 
-	_width = width;
-	_height = height;
-        _transition = transition;
-	
+	BOOST_ASSERT( pIn.size() == pOut.size() );
+
+	std::vector<Point2> nIn;
+	std::vector<Point2> nOut;
 #ifdef TPS_NORMALIZE_COORD
-	_pIn.reserve( pIn.size() );
-	_pOut.reserve( pOut.size() );
+	nIn.reserve( pIn.size() );
+	nOut.reserve( pOut.size() );
 	BOOST_FOREACH( const Point2& p, pIn )
 	{
-		Point2 np( p.x / _width, p.y / _height );
-		_pIn.push_back( np );
+		Point2 np( p.x / width, p.y / height );
+		nIn.push_back( np );
 	}
 	BOOST_FOREACH( const Point2& p, pOut )
 	{
-		Point2 np( p.x / _width, p.y / _height );
-		_pOut.push_back( np );
+		Point2 np( p.x / width, p.y / height );
+		nOut.push_back( np );
 	}
 #else
-	_pIn = pIn;
-	_pOut = pOut;
+	nIn = pIn;
+	nOut = pOut;
 #endif
-	
-	_nbPoints = _pIn.size();
-	_mat_L.resize( _nbPoints + 3, _nbPoints + 3 );
-	_mat_V.resize( _nbPoints + 3, 2 );
-	_mat_K.resize( _nbPoints, _nbPoints );
-	_activateWarp = applyWarp;
 
-        //TUTTLE_TCOUT_VAR( _pIn.size() );
-        //TUTTLE_TCOUT_VAR( _pOut.size() );
-
-	BOOST_ASSERT( _pIn.size() == _pOut.size() );
+	const std::size_t nbPoints = nIn.size();
+	Matrix mat_L( nbPoints + 3, nbPoints + 3 );
+	Matrix mat_V( nbPoints + 3, 2 );
 
 	// Fill K and directly copy values into L
 	// K = [ 0      U(r01) ...   U(r0n) ]
@@ -137,22 +125,21 @@ void TPS_Morpher<SCALAR>::setup( const std::vector< Point2 > pIn, const std::vec
 	//   = [ U(rn0) U(rn1) ...   0      ]
 	//
 	// K.size = n x n
-	for( std::size_t y = 0; y < _nbPoints; ++y )
+	for( std::size_t y = 0; y < nbPoints; ++y )
 	{
-		const Point2& point_i = _pIn[y];
-		for( std::size_t x = 0; x < _nbPoints; ++x )
+		const Point2& point_i = nIn[y];
+		for( std::size_t x = 0; x < nbPoints; ++x )
 		{
 			if( y == x )
 			{
-				_mat_L( y, x ) = _mat_K( y, x ) = regularization;
 				// diagonal: reqularization parameters (lambda * a^2)
-//				_mat_L( i, i ) = _mat_K( i, i ) = regularization /** (a*a)*/;
+				mat_L( y, x ) = regularization;
 			}
 			else
 			{
-				const Point2& point_j = _pIn[x];
+				const Point2& point_j = nIn[x];
 				const Scalar sum = pow<2>( point_i.x - point_j.x ) + pow<2>( point_i.y - point_j.y );
-				_mat_L( y, x ) = _mat_K( y, x ) = base_func( sum );
+				mat_L( y, x ) = base_func( sum );
 			}
 		}
 	}
@@ -165,16 +152,16 @@ void TPS_Morpher<SCALAR>::setup( const std::vector< Point2 > pIn, const std::vec
 	//     [ 1   xn   yn  ]
 	//
 	// P.size = n x 3
-	for( std::size_t i = 0; i < _nbPoints; ++i )
+	for( std::size_t i = 0; i < nbPoints; ++i )
 	{
-		const Point2& pt = _pIn[i];
-		_mat_L( i, _nbPoints + 0 ) = 1.0;
-		_mat_L( i, _nbPoints + 1 ) = pt.x;
-		_mat_L( i, _nbPoints + 2 ) = pt.y;
-
-		_mat_L( _nbPoints + 0, i ) = 1.0;
-		_mat_L( _nbPoints + 1, i ) = pt.x;
-		_mat_L( _nbPoints + 2, i ) = pt.y;
+		const Point2& pt = nIn[i];
+		mat_L( i, nbPoints + 0 ) = 1.0;
+		mat_L( i, nbPoints + 1 ) = pt.x;
+		mat_L( i, nbPoints + 2 ) = pt.y;
+
+		mat_L( nbPoints + 0, i ) = 1.0;
+		mat_L( nbPoints + 1, i ) = pt.x;
+		mat_L( nbPoints + 2, i ) = pt.y;
 	}
 
 	// L = [ K        |  P  ]
@@ -187,7 +174,7 @@ void TPS_Morpher<SCALAR>::setup( const std::vector< Point2 > pIn, const std::vec
 	{
 		for( std::size_t j = 0; j < 3; ++j )
 		{
-			_mat_L( _nbPoints+i, _nbPoints+j ) = 0.0;
+			mat_L( nbPoints+i, nbPoints+j ) = 0.0;
 		}
 	}
 
@@ -197,45 +184,58 @@ void TPS_Morpher<SCALAR>::setup( const std::vector< Point2 > pIn, const std::vec
 	//
 	// V.size = 2 x (n+3)
 	// here we manipulate trans(V)
-	for( std::size_t i = 0; i < _nbPoints; ++i )
+	for( std::size_t i = 0; i < nbPoints; ++i )
 	{
-		const Point2& pIn = _pIn[i];
-		const Point2& pOut = _pOut[i];
-		_mat_V( i, 0 ) = pOut.x - pIn.x;
-		_mat_V( i, 1 ) = pOut.y - pIn.y;
-                //TUTTLE_TCOUT_VAR2( pOut.x, pIn.x );
-                //TUTTLE_TCOUT_VAR2( pOut.y, pIn.y );
+		mat_V( i, 0 ) = nOut[i].x - nIn[i].x;
+		mat_V( i, 1 ) = nOut[i].y - nIn[i].y;
 	}
 
-	_mat_V( _nbPoints + 0, 0 ) = _mat_V( _nbPoints + 1, 0 ) = _mat_V( _nbPoints + 2, 0 ) = 0.0;
-	_mat_V( _nbPoints + 0, 1 ) = _mat_V( _nbPoints + 1, 1 ) = _mat_V( _nbPoints + 2, 1 ) = 0.0;
-
-        //TUTTLE_TCOUT("");
-        //TUTTLE_TCOUT( "mtx_v" );
-        //coutMat( std::cout, _mat_V );
-        //TUTTLE_TCOUT("");
-        //TUTTLE_TCOUT( "mtx_orig_k" );
-        //coutMat( std::cout, _mat_K );
-        //TUTTLE_TCOUT("");
-        //TUTTLE_TCOUT( "mtx_l" );
-        //coutMat( std::cout, _mat_L );
-        //TUTTLE_TCOUT("");
+	mat_V( nbPoints + 0, 0 ) = mat_V( nbPoints + 1, 0 ) = mat_V( nbPoints + 2, 0 ) = 0.0;
+	mat_V( nbPoints + 0, 1 ) = mat_V( nbPoints + 1, 1 ) = mat_V( nbPoints + 2, 1 ) = 0.0;
 
 	// Solve the linear system "inplace"
-	permutation_matrix<Scalar> P( _nbPoints + 3 );
-//	matrix<Scalar> x( _nbPoints + 3, 2 );
+	permutation_matrix<std::size_t> P( nbPoints + 3 );
+	lu_factorize( mat_L, P );
+	lu_substitute( mat_L, P, mat_V );
+
+	// the radial basis functions are evaluated around the output points
+	boost::shared_ptr<TPS_Solution<Scalar> > solution( new TPS_Solution<Scalar>() );
+	solution->_centers = nOut;
+	solution->_weights.reserve( nbPoints );
+	for( std::size_t i = 0; i < nbPoints; ++i )
+	{
+		solution->_weights.push_back( Point2( mat_V( i, 0 ), mat_V( i, 1 ) ) );
+	}
+	solution->_a0 = Point2( mat_V( nbPoints + 0, 0 ), mat_V( nbPoints + 0, 1 ) );
+	solution->_ax = Point2( mat_V( nbPoints + 1, 0 ), mat_V( nbPoints + 1, 1 ) );
+	solution->_ay = Point2( mat_V( nbPoints + 2, 0 ), mat_V( nbPoints + 2, 1 ) );
+	return solution;
+}
 
-	lu_factorize( _mat_L, P );
-	lu_substitute( _mat_L, P, _mat_V );
+template<typename SCALAR>
+TPS_Morpher<SCALAR>::TPS_Morpher()
+: _activateWarp( false )
+, _nbPoints( 0 )
+, _width( 1 )
+, _height( 1 )
+, _transition( 1 )
+{}
 
-        //TUTTLE_TCOUT_X( 10, "-");
-        //TUTTLE_TCOUT( "mtx_v" );
-        //coutMat( std::cout, _mat_V );
-        //TUTTLE_TCOUT("");
-        //TUTTLE_TCOUT( "mtx_l" );
-        //coutMat( std::cout, _mat_L );
-        //TUTTLE_TCOUT("");
-        //TUTTLE_TCOUT_X( 80, "_");
+template<typename SCALAR>
+void TPS_Morpher<SCALAR>::setup( const std::vector< Point2 > pIn, const std::vector< Point2 > pOut, const double regularization, const bool applyWarp, const std::size_t width, const std::size_t height, const double transition )
+{
+	setup( solveTPS( pIn, pOut, regularization, width, height ), applyWarp, width, height, transition );
+}
+
+template<typename SCALAR>
+void TPS_Morpher<SCALAR>::setup( const SolutionPtr& solution, const bool applyWarp, const std::size_t width, const std::size_t height, const double transition )
+{
+	_solution = solution;
+	_nbPoints = solution->_centers.size();
+	_activateWarp = applyWarp;
+	_width = width;
+	_height = height;
+	_transition = transition;
 }
 
 template<typename SCALAR>
@@ -243,7 +243,7 @@ template<typename S2>
 typename TPS_Morpher<SCALAR>::Point2 TPS_Morpher<SCALAR>::operator( )( const point2<S2>& pt ) const
 {
 	using boost::math::pow;
-	if( !_activateWarp || _nbPoints <= 1 )
+	if( isIdentity() )
 	{
 		return Point2( pt.x, pt.y );
 	}
@@ -252,32 +252,19 @@ typename TPS_Morpher<SCALAR>::Point2 TPS_Morpher<SCALAR>::operator( )( const poi
 #else
 	const Point2 npt( pt.x, pt.y );
 #endif
+	const Solution& s = *_solution;
 
-	// Nombre de colonnes de la matrice K
-	const std::size_t m = _mat_K.size2( );
-
-	double dx = _mat_V( m + 0, 0 ) + _mat_V( m + 1, 0 ) * npt.x + _mat_V( m + 2, 0 ) * npt.y;
-	double dy = _mat_V( m + 0, 1 ) + _mat_V( m + 1, 1 ) * npt.x + _mat_V( m + 2, 1 ) * npt.y;
-
-	Const_Matrix_Col mat_Vx( _mat_V, 0 );
-	Const_Matrix_Col mat_Vy( _mat_V, 1 );
+	double dx = s._a0.x + s._ax.x * npt.x + s._ay.x * npt.y;
+	double dy = s._a0.y + s._ax.y * npt.x + s._ay.y * npt.y;
 
-	std::vector< point2<double> >::const_iterator it_out = _pOut.begin();
-	typename Const_Matrix_Col::const_iterator it_Vx( mat_Vx.begin() );
-	typename Const_Matrix_Col::const_iterator it_Vy( mat_Vy.begin() );
-
-	//std::cout<<"DX fin "<<dx<<"  "<<dy<<std::endl;
-
-	for( std::size_t i = 0;
-	     i < m;
-	     ++i, ++it_out, ++it_Vx, ++it_Vy )
+	for( std::size_t i = 0; i < _nbPoints; ++i )
 	{
-		const double d = base_func( pow<2>( it_out->x - npt.x ) + pow<2>( it_out->y - npt.y ) );
-		dx += ( *it_Vx ) * d;
-		dy += ( *it_Vy ) * d;
-        }
-        dx *= _transition;
-        dy *= _transition;
+		const double d = base_func( pow<2>( s._centers[i].x - npt.x ) + pow<2>( s._centers[i].y - npt.y ) );
+		dx += s._weights[i].x * d;
+		dy += s._weights[i].y * d;
+	}
+	dx *= _transition;
+	dy *= _transition;
 #ifdef TPS_NORMALIZE_COORD
 	return Point2( (npt.x+dx)*_width, (npt.y+dy)*_height );
 #else
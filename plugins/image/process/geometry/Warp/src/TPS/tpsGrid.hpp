@@ -0,0 +1,203 @@
+#ifndef _TUTTLE_PLUGIN_TPS_GRID_HPP_
+#define _TUTTLE_PLUGIN_TPS_GRID_HPP_
+
+#include <ofxCore.h>
+
+#include <boost/gil/utilities.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace tuttle {
+namespace plugin {
+namespace warp {
+
+/**
+ * @brief Positions of a transformation (a TPS_Morpher) on a window of pixels,
+ * interpolated on an adaptive grid.
+ *
+ * The transformation is evaluated on the corners of cells of @p cellSize pixels
+ * and bilinearly interpolated inside the cells. The interpolation is compared
+ * to the transformation at the center and at the middle of the edges of each
+ * cell, and a cell with an error greater than @p precision pixels is split in
+ * 4, down to the pixel.
+ * With a null @p precision, the transformation is evaluated on each pixel.
+ */
+template<class Morpher>
+class TPS_Grid
+{
+public:
+	typedef typename Morpher::Point2 Point2;
+	typedef boost::gil::point2<float> StoredPoint2; ///< float positions, to halve the memory of the window
+
+	TPS_Grid( const Morpher& morpher, const OfxRectI& window, const double precision, const std::ptrdiff_t cellSize = 16 )
+	: _morpher( morpher )
+	, _window( window )
+	, _width( std::max( window.x2 - window.x1, 0 ) )
+	, _height( std::max( window.y2 - window.y1, 0 ) )
+	, _precision( precision )
+	, _positions( _width * _height )
+	{
+		if( _positions.empty() )
+			return;
+		const std::ptrdiff_t step = precision > 0 ? std::max( cellSize, std::ptrdiff_t( 1 ) ) : 1;
+
+		// nodes of the coarse grid, the last ones on the last pixels
+		std::vector<std::ptrdiff_t> xs;
+		std::vector<std::ptrdiff_t> ys;
+		for( std::ptrdiff_t x = 0; x < _width - 1; x += step )
+			xs.push_back( x );
+		xs.push_back( _width - 1 );
+		for( std::ptrdiff_t y = 0; y < _height - 1; y += step )
+			ys.push_back( y );
+		ys.push_back( _height - 1 );
+
+		std::vector<Point2> nodes;
+		nodes.reserve( xs.size() * ys.size() );
+		for( std::size_t j = 0; j < ys.size(); ++j )
+			for( std::size_t i = 0; i < xs.size(); ++i )
+				nodes.push_back( exact( xs[i], ys[j] ) );
+
+		const std::size_t nbCellsX = std::max( xs.size() - 1, std::size_t( 1 ) );
+		const std::size_t nbCellsY = std::max( ys.size() - 1, std::size_t( 1 ) );
+		for( std::size_t j = 0; j < nbCellsY; ++j )
+		{
+			const std::size_t j1 = std::min( j + 1, ys.size() - 1 );
+			for( std::size_t i = 0; i < nbCellsX; ++i )
+			{
+				const std::size_t i1 = std::min( i + 1, xs.size() - 1 );
+				fillCell( xs[i], ys[j], xs[i1], ys[j1],
+				          nodes[j * xs.size() + i], nodes[j * xs.size() + i1],
+				          nodes[j1 * xs.size() + i], nodes[j1 * xs.size() + i1] );
+			}
+		}
+	}
+
+	template<typename S2>
+	Point2 operator()( const boost::gil::point2<S2>& pt ) const
+	{
+		const std::ptrdiff_t x = std::ptrdiff_t( pt.x ) - _window.x1;
+		const std::ptrdiff_t y = std::ptrdiff_t( pt.y ) - _window.y1;
+		if( x >= 0 && x < _width && y >= 0 && y < _height &&
+		    x + _window.x1 == pt.x && y + _window.y1 == pt.y )
+		{
+			const StoredPoint2& p = _positions[y * _width + x];
+			return Point2( p.x, p.y );
+		}
+		return _morpher( pt );
+	}
+
+private:
+	/// @brief Position of the local pixel (x, y), with the transformation.
+	Point2 exact( const std::ptrdiff_t x, const std::ptrdiff_t y ) const
+	{
+		return _morpher( boost::gil::point2<std::ptrdiff_t>( x + _window.x1, y + _window.y1 ) );
+	}
+
+	void store( const std::ptrdiff_t x, const std::ptrdiff_t y, const Point2& p )
+	{
+		_positions[y * _width + x] = StoredPoint2( float( p.x ), float( p.y ) );
+	}
+
+	static Point2 lerp( const Point2& a, const Point2& b, const double t )
+	{
+		return Point2( a.x + ( b.x - a.x ) * t, a.y + ( b.y - a.y ) * t );
+	}
+
+	bool accurate( const Point2& interpolated, const Point2& exactValue ) const
+	{
+		return std::abs( interpolated.x - exactValue.x ) <= _precision &&
+		       std::abs( interpolated.y - exactValue.y ) <= _precision;
+	}
+
+	/**
+	 * @brief Fill the cell of corners (x0, y0) and (x1, y1) (included),
+	 * from the exact positions of its corners.
+	 */
+	void fillCell( const std::ptrdiff_t x0, const std::ptrdiff_t y0, const std::ptrdiff_t x1, const std::ptrdiff_t y1,
+	               const Point2& p00, const Point2& p10, const Point2& p01, const Point2& p11 )
+	{
+		const bool splitX = x1 - x0 > 1;
+		const bool splitY = y1 - y0 > 1;
+		if( ! splitX && ! splitY )
+		{
+			store( x0, y0, p00 );
+			store( x1, y0, p10 );
+			store( x0, y1, p01 );
+			store( x1, y1, p11 );
+			return;
+		}
+		const std::ptrdiff_t mx = splitX ? ( x0 + x1 ) / 2 : x0;
+		const std::ptrdiff_t my = splitY ? ( y0 + y1 ) / 2 : y0;
+		const double fx = splitX ? double( mx - x0 ) / ( x1 - x0 ) : 0.0;
+		const double fy = splitY ? double( my - y0 ) / ( y1 - y0 ) : 0.0;
+
+		const Point2 pm0 = splitX ? exact( mx, y0 ) : p00;
+		const Point2 pm1 = splitX ? exact( mx, y1 ) : p01;
+		const Point2 p0m = splitY ? exact( x0, my ) : p00;
+		const Point2 p1m = splitY ? exact( x1, my ) : p10;
+		const Point2 pmm = splitX && splitY ? exact( mx, my ) : ( splitX ? pm0 : p0m );
+
+		if( accurate( lerp( p00, p10, fx ), pm0 ) &&
+		    accurate( lerp( p01, p11, fx ), pm1 ) &&
+		    accurate( lerp( p00, p01, fy ), p0m ) &&
+		    accurate( lerp( p10, p11, fy ), p1m ) &&
+		    accurate( lerp( lerp( p00, p10, fx ), lerp( p01, p11, fx ), fy ), pmm ) )
+		{
+			interpolateCell( x0, y0, x1, y1, p00, p10, p01, p11 );
+			return;
+		}
+
+		if( splitX && splitY )
+		{
+			fillCell( x0, y0, mx, my, p00, pm0, p0m, pmm );
+			fillCell( mx, y0, x1, my, pm0, p10, pmm, p1m );
+			fillCell( x0, my, mx, y1, p0m, pmm, p01, pm1 );
+			fillCell( mx, my, x1, y1, pmm, p1m, pm1, p11 );
+		}
+		else if( splitX )
+		{
+			fillCell( x0, y0, mx, y1, p00, pm0, p01, pm1 );
+			fillCell( mx, y0, x1, y1, pm0, p10, pm1, p11 );
+		}
+		else
+		{
+			fillCell( x0, y0, x1, my, p00, p10, p0m, p1m );
+			fillCell( x0, my, x1, y1, p0m, p1m, p01, p11 );
+		}
+	}
+
+	/// @brief Bilinear interpolation of the corners on all the pixels of the cell.
+	void interpolateCell( const std::ptrdiff_t x0, const std::ptrdiff_t y0, const std::ptrdiff_t x1, const std::ptrdiff_t y1,
+	                      const Point2& p00, const Point2& p10, const Point2& p01, const Point2& p11 )
+	{
+		const double invW = x1 > x0 ? 1.0 / ( x1 - x0 ) : 0.0;
+		const double invH = y1 > y0 ? 1.0 / ( y1 - y0 ) : 0.0;
+		for( std::ptrdiff_t y = y0; y <= y1; ++y )
+		{
+			const double fy = ( y - y0 ) * invH;
+			const Point2 left = lerp( p00, p01, fy );
+			const Point2 right = lerp( p10, p11, fy );
+			for( std::ptrdiff_t x = x0; x <= x1; ++x )
+			{
+				store( x, y, lerp( left, right, ( x - x0 ) * invW ) );
+			}
+		}
+	}
+
+private:
+	const Morpher& _morpher;
+	OfxRectI _window;
+	std::ptrdiff_t _width;
+	std::ptrdiff_t _height;
+	double _precision;
+	std::vector<StoredPoint2> _positions; ///< positions of the pixels of the window, line by line
+};
+
+}
+}
+}
+
+#endif
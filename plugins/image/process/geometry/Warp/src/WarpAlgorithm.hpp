@@ -2,6 +2,7 @@
 #define _TUTTLE_PLUGIN_WARP_ALGORITHM_HPP_
 
 #include "TPS/tps.hpp"
+#include "TPS/tpsGrid.hpp"
 
 #include <terry/channel.hpp>
 #include <terry/numeric/operations.hpp>
@@ -17,6 +18,12 @@ inline boost::gil::point2<F> transform( const tuttle::plugin::warp::TPS_Morpher<
 	return op( src );
 }
 
+template <typename M, typename F2>
+inline typename tuttle::plugin::warp::TPS_Grid<M>::Point2 transform( const tuttle::plugin::warp::TPS_Grid<M>& grid, const boost::gil::point2<F2>& src )
+{
+	return grid( src );
+}
+
 }
 }
 
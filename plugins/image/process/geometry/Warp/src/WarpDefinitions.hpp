@@ -45,6 +45,7 @@ static const std::string kParamSetKey = "setKey";
 static const std::string kParamGroupSettings = "settings";
 static const std::string kParamNbPointsBezier = "Points Bezier";
 static const std::string kParamRigiditeTPS = "Rigidite TPS";
+static const std::string kParamPrecision = "precision";
 
 static const std::string kParamGroupIn = "groupIn";
 static const std::string kParamPointIn = "pIn";
@@ -27,7 +27,8 @@ namespace plugin {
 namespace warp {
 
 WarpPlugin::WarpPlugin( OfxImageEffectHandle handle ) :
-ImageEffect( handle )
+ImageEffect( handle ),
+_tpsSolutions( 4 ) // the 2 sources of the current frame and of the previous one
 {
 	_clipSrc = fetchClip( kOfxImageEffectSimpleSourceClipName );
 	_clipSrcB = fetchClip( kClipSourceB );
@@ -44,6 +45,7 @@ ImageEffect( handle )
 	_transition = fetchDoubleParam( kParamTransition );
 
 	_paramRigiditeTPS = fetchDoubleParam( kParamRigiditeTPS );
+	_paramPrecision = fetchDoubleParam( kParamPrecision );
 	_paramNbPointsBezier = fetchIntParam( kParamNbPointsBezier );
 
         //Multi curve
@@ -107,6 +109,7 @@ WarpProcessParams<WarpPlugin::Scalar> WarpPlugin::getProcessParams( const OfxPoi
         params._nbPoints = nbPoints;
 
 	params._rigiditeTPS = _paramRigiditeTPS->getValue( );
+	params._precision = _paramPrecision->getValue( ) * renderScale.x;
 	params._transition = _transition->getValue( );
         params._method = static_cast<EParamMethod> ( _paramMethod->getValue( ) );
 
@@ -297,6 +300,32 @@ bool WarpPlugin::isIdentity( const OFX::RenderArguments& args, OFX::Clip*& ident
 	return false;
 }
 
+namespace {
+
+struct TPSSolver
+{
+	const std::vector<WarpPlugin::Point2>& _pIn;
+	const std::vector<WarpPlugin::Point2>& _pOut;
+	double _regularization;
+	std::size_t _width;
+	std::size_t _height;
+
+	TPSSolver( const std::vector<WarpPlugin::Point2>& pIn, const std::vector<WarpPlugin::Point2>& pOut, const double regularization, const std::size_t width, const std::size_t height )
+	: _pIn( pIn ), _pOut( pOut ), _regularization( regularization ), _width( width ), _height( height )
+	{}
+
+	WarpPlugin::TPSSolutionPtr operator()() const { return solveTPS( _pIn, _pOut, _regularization, _width, _height ); }
+};
+
+}
+
+WarpPlugin::TPSSolutionPtr WarpPlugin::getTPSSolution( const std::vector<Point2>& pIn, const std::vector<Point2>& pOut, const double regularization, const std::size_t width, const std::size_t height )
+{
+	// solved under the lock, the other render threads wait for the solution
+	return _tpsSolutions.get( TPS_Key<Scalar>( pIn, pOut, regularization, width, height ),
+		TPSSolver( pIn, pOut, regularization, width, height ) );
+}
+
 /**
  * @brief The overridden render function
  * @param[in]   args     Rendering parameters
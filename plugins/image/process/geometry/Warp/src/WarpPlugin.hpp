@@ -2,14 +2,18 @@
 #define _TUTTLE_PLUGIN_WARP_PLUGIN_HPP_
 
 #include "WarpDefinitions.hpp"
+#include "TPS/tps.hpp"
 
 #include <tuttle/plugin/global.hpp>
 
+#include <terry/lru_cache.hpp>
+
 #include <ofxsImageEffect.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/gil/gil_all.hpp>
 #include <boost/array.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace tuttle {
 namespace plugin {
@@ -34,6 +38,7 @@ struct WarpProcessParams
 
         bool _activateWarp;
 	double _rigiditeTPS;
+	double _precision; ///< maximal error of the interpolation of the TPS (in pixels)
         std::size_t _nbPoints;
 	double _transition;
 
@@ -49,6 +54,7 @@ class WarpPlugin : public OFX::ImageEffect
 public:
 	typedef double Scalar;
 	typedef boost::gil::point2<Scalar> Point2;
+	typedef TPS_Morpher<Scalar>::SolutionPtr TPSSolutionPtr;
 public:
 	WarpPlugin( OfxImageEffectHandle handle );
 
@@ -63,6 +69,11 @@ public:
 
 	void render( const OFX::RenderArguments &args );
 
+	/**
+	 * @brief The solved TPS of these points, shared by the frames where the points don't move.
+	 */
+	TPSSolutionPtr getTPSSolution( const std::vector<Point2>& pIn, const std::vector<Point2>& pOut, const double regularization, const std::size_t width, const std::size_t height );
+
 public:
 	OFX::Clip* _clipSrc; ///< Source image clip
 	OFX::Clip* _clipSrcB; ///< Source image clip
@@ -80,6 +91,7 @@ public:
 
 	OFX::GroupParam* _paramGroupSettings;
 	OFX::DoubleParam* _paramRigiditeTPS;
+	OFX::DoubleParam* _paramPrecision;
 	OFX::IntParam* _paramNbPointsBezier;
 
 	//In
@@ -115,6 +127,8 @@ public:
 
 private:
 	OFX::InstanceChangedArgs _instanceChangedArgs;
+
+	terry::lru_cache<TPS_Key<Scalar>, TPSSolutionPtr> _tpsSolutions; ///< last solved TPS
 };
 
 }
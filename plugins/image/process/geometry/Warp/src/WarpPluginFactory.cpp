@@ -125,6 +125,15 @@ void WarpPluginFactory::describeInContext( OFX::ImageEffectDescriptor& desc,
 		rigidity->setDisplayRange( 0.0, 10.0 );
 		rigidity->setParent( groupSettings );
 
+		OFX::DoubleParamDescriptor* precision = desc.defineDoubleParam( kParamPrecision );
+		precision->setLabel( "Precision" );
+		precision->setHint( "Maximal error (in pixels) of the interpolation of the TPS between the nodes of its grid. "
+		                    "With 0, the TPS is evaluated on each pixel." );
+		precision->setDefault( 0.1 );
+		precision->setRange( 0.0, std::numeric_limits<double>::max( ) );
+		precision->setDisplayRange( 0.0, 1.0 );
+		precision->setParent( groupSettings );
+
 		OFX::IntParamDescriptor* nbPointsBezier = desc.defineIntParam( kParamNbPointsBezier );
 		nbPointsBezier->setLabel( "Bezier" );
 		nbPointsBezier->setHint( "Nombre de points dessinant la courbe de bezier" );
@@ -45,10 +45,16 @@ void WarpProcess<View>::setup( const OFX::RenderArguments& args )
 		// _srcBPixelRod = _srcB->getRegionOfDefinition(); // bug in nuke, returns bounds
 		_srcBPixelRod = _clipSrcB->getPixelRod( args.time, args.renderScale );
 		this->_srcBView = this->getView( this->_srcB.get( ), _srcBPixelRod );
-		_tpsB.setup( _params._bezierOut, _params._bezierIn, _params._rigiditeTPS, _params._activateWarp, this->_srcBPixelRod.x2 - this->_srcBPixelRod.x1, this->_srcBPixelRod.y2 - this->_srcBPixelRod.y1, ( 1.0 - _params._transition ) );
+		const std::size_t widthB = this->_srcBPixelRod.x2 - this->_srcBPixelRod.x1;
+		const std::size_t heightB = this->_srcBPixelRod.y2 - this->_srcBPixelRod.y1;
+		_tpsB.setup( _plugin.getTPSSolution( _params._bezierOut, _params._bezierIn, _params._rigiditeTPS, widthB, heightB ),
+		             _params._activateWarp, widthB, heightB, ( 1.0 - _params._transition ) );
 	}
 	//TPS_Morpher<Scalar> tps( _params._inPoints, _params._outPoints , _params._rigiditeTPS);
-	_tpsA.setup( _params._bezierIn, _params._bezierOut, _params._rigiditeTPS, _params._activateWarp, this->_srcPixelRod.x2 - this->_srcPixelRod.x1, this->_srcPixelRod.y2 - this->_srcPixelRod.y1, _params._transition );
+	const std::size_t widthA = this->_srcPixelRod.x2 - this->_srcPixelRod.x1;
+	const std::size_t heightA = this->_srcPixelRod.y2 - this->_srcPixelRod.y1;
+	_tpsA.setup( _plugin.getTPSSolution( _params._bezierIn, _params._bezierOut, _params._rigiditeTPS, widthA, heightA ),
+	             _params._activateWarp, widthA, heightA, _params._transition );
 	//TUTTLE_TCOUT_VAR( _params._rigiditeTPS );
 	//TUTTLE_TCOUT_VAR( _params._activateWarp );
 }
@@ -71,6 +77,9 @@ void WarpProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW
 								procWindowRoW.y2 - procWindowRoW.y1 };
 
 	const EParamFilterOutOfImage outOfImageProcess = eParamFilterOutBlack; /// @todo expose as parameter
+
+	// the TPS is interpolated on a grid over the window of this thread
+	const TPS_Grid<TPS_Morpher<Scalar> > gridA( _tpsA, procWindowSrcA, _params._precision );
 	
 	if( this->_clipSrcB->isConnected( ) )
 	{
@@ -85,8 +94,10 @@ void WarpProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW
 						this->_srcBPixelRod.x1-procWindowRoW.x1, this->_srcBPixelRod.y1-procWindowRoW.y1,
 						this->_srcBView.width(), this->_srcBView.height() );
 
-		resample_pixels_progress<terry::sampler::bilinear_sampler>( this->_srcView, viewA, _tpsA, procWindowSrcA, outOfImageProcess, this->getOfxProgress() );
-		resample_pixels_progress<terry::sampler::bilinear_sampler>( this->_srcBView, viewB, _tpsB, procWindowSrcB, outOfImageProcess, this->getOfxProgress() );
+		const TPS_Grid<TPS_Morpher<Scalar> > gridB( _tpsB, procWindowSrcB, _params._precision );
+
+		resample_pixels_progress<terry::sampler::bilinear_sampler>( this->_srcView, viewA, gridA, procWindowSrcA, outOfImageProcess, this->getOfxProgress() );
+		resample_pixels_progress<terry::sampler::bilinear_sampler>( this->_srcBView, viewB, gridB, procWindowSrcB, outOfImageProcess, this->getOfxProgress() );
 
 		//fondu entre imgA et imgB = this->_dstView FAITEALAMAIN
 		View dst = subimage_view( this->_dstView, procWindowOutput.x1, procWindowOutput.y1,
@@ -104,7 +115,7 @@ void WarpProcess<View>::multiThreadProcessImages( const OfxRectI& procWindowRoW
 						this->_dstView,
 						this->_srcPixelRod.x1-this->_dstPixelRod.x1, this->_srcPixelRod.y1-this->_dstPixelRod.y1,
 						this->_srcView.width(), this->_srcView.height() );
-		resample_pixels_progress<terry::sampler::bilinear_sampler > ( this->_srcView, dst, _tpsA, procWindowSrcA, outOfImageProcess, this->getOfxProgress() );
+		resample_pixels_progress<terry::sampler::bilinear_sampler > ( this->_srcView, dst, gridA, procWindowSrcA, outOfImageProcess, this->getOfxProgress() );
 	}
 }
 
@@ -1,6 +1,6 @@
 #include "MergePlugin.hpp"
 #include "MergeDefinitions.hpp"
-#include <terry/merge/ViewsMerging.hpp>
+#include <terry/merge/ViewsMergingBatch.hpp>
 
 #include <tuttle/plugin/numeric/rectOp.hpp>
 #include <tuttle/plugin/ImageGilProcessor.hpp>
@@ -303,7 +303,7 @@ void MergeProcess<View, Functor>::multiThreadProcessImages( const OfxRectI& proc
 						procIntersectSize.x,
 						procIntersectSize.y );
 
-	merge_views( srcViewA_inter, srcViewB_inter, dstView_inter, Functor() );
+	merge_views_batch( srcViewA_inter, srcViewB_inter, dstView_inter, Functor() );
 }
 
 }
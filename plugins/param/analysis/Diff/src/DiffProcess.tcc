@@ -5,11 +5,67 @@
 #include <tuttle/plugin/numeric/rectOp.hpp>
 #include <terry/globals.hpp>
 #include <terry/basic_colors.hpp>
+#include <terry/numeric/statistics.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
 
 namespace tuttle {
 namespace plugin {
 namespace quality {
 
+/**
+ * @brief Row reducer which writes the difference image and sums the squared differences.
+ */
+template<class SView, class Pixel64F>
+struct DiffRows
+{
+	typedef boost::gil::bits32f Value32F;
+
+	SView _v1, _v2, _dst;
+	bool _outputIsPsnr;
+	float _d2;
+	terry::numeric::pixel_squared_difference_sum_t<Pixel64F> _ssd;
+
+	DiffRows( const SView& v1, const SView& v2, const SView& dst, const bool outputIsPsnr, const float d2 )
+	: _v1( v1 ), _v2( v2 ), _dst( dst )
+	, _outputIsPsnr( outputIsPsnr )
+	, _d2( d2 )
+	{}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		typename SView::x_iterator itA = _v1.row_begin( y );
+		typename SView::x_iterator itB = _v2.row_begin( y );
+		typename SView::x_iterator itD = _dst.row_begin( y );
+
+		for( std::ptrdiff_t x = 0; x < _v1.width(); ++x, ++itA, ++itB, ++itD )
+		{
+			for( int i = 0; i < boost::gil::num_channels<typename SView::value_type>::type::value; ++i )
+			{
+				Value32F diff = ( Value32F ) std::abs( double( ( *itA )[i] - ( *itB )[i]) );
+
+				if( _outputIsPsnr )
+				{
+					float p = _d2 / diff;
+					if( p > std::numeric_limits<float>::epsilon( ) )
+						( *itD )[i] = Value32F( 10.0 * std::log10( p ) );
+					else
+						( *itD )[i] = 0;
+				}
+				else
+				{
+					( *itD )[i] = diff;
+				}
+			}
+			_ssd( *itA, *itB );
+		}
+	}
+
+	void merge( const DiffRows& other )
+	{
+		_ssd.merge( other._ssd );
+	}
+};
+
 template<class View>
 DiffProcess<View>::DiffProcess( DiffPlugin& instance )
 	: ImageGilProcessor<View>( instance, eImageOrientationIndependant )
@@ -162,49 +218,20 @@ DiffProcess<View>::mse( const SView& v1, const SView& v2, const SView& dst, bool
 	typedef typename boost::gil::channel_type<Pixel32F>::type Value32F;
 	typedef typename boost::gil::channel_type<typename SView::value_type>::type SValueType;
 
-	Pixel32F veqm = get_black<Pixel32F>();
-	int w         = v1.width();
-	int h         = v1.height();
+	typedef boost::gil::pixel<boost::gil::bits64f, boost::gil::layout<typename boost::gil::color_space_type<SView>::type> > Pixel64F;
 
 	size_t d      = (size_t)( std::pow( 2.0, sizeof( SValueType ) * 8.0 ) ) - 1;
 	size_t d2     = d * d;
 
-	for( typename SView::y_coord_t y = 0; y < h; ++y )
-	{
-		typename SView::x_iterator itA = v1.row_begin( y );
-		typename SView::x_iterator itB = v2.row_begin( y );
-		typename SView::x_iterator itD = dst.row_begin( y );
-
-		for( typename SView::x_coord_t x = 0; x < w; ++x )
-		{
-			for( int i = 0; i < boost::gil::num_channels<Pixel32F>::type::value; ++i )
-			{
-				Value32F diff = ( Value32F ) std::abs( double( ( *itA )[i] - ( *itB )[i]) );
-
-				if( outputIsPsnr )
-				{
-					float p = (float)d2 / diff;
-					if( p > std::numeric_limits<float>::epsilon( ) )
-						( *itD )[i] = Value32F( 10.0 * std::log10( p ) );
-					else
-						( *itD )[i] = 0;
-				}
-				else
-				{
-					( *itD )[i] = diff;
-				}
-				veqm[i]    += diff * diff;
-			}
-			++itA;
-			++itB;
-			++itD;
-		}
-		this->progressUpdate( (float)(y+1)/h );
-	}
+	// the squared differences are summed in double by each thread, then merged in the order of the rows
+	const DiffRows<SView, Pixel64F> rows = terry::algorithm::parallel_reduce_rows( this->getLauncher(), v1.height(),
+		DiffRows<SView, Pixel64F>( v1, v2, dst, outputIsPsnr, (float)d2 ), *this, v1.width() );
 
+	const Pixel64F eqm = rows._ssd.mean();
+	Pixel32F veqm;
 	for( int i = 0; i < boost::gil::num_channels<Pixel32F>::type::value; ++i )
 	{
-		veqm[i] /= ( w * h );
+		veqm[i] = Value32F( eqm[i] );
 	}
 	return veqm;
 }
@@ -0,0 +1,64 @@
+#ifndef _TUTTLE_PLUGIN_IMAGESTATISTICS_CACHE_HPP_
+#define _TUTTLE_PLUGIN_IMAGESTATISTICS_CACHE_HPP_
+
+#include <terry/lru_cache.hpp>
+
+#include <ofxCore.h>
+
+#include <cstddef>
+
+namespace tuttle {
+namespace plugin {
+namespace imageStatistics {
+
+/**
+ * @brief The statistics of a region of an image, in the RGBA and the HSL colorspaces:
+ * the channels of average, variance, channel min and max, luminosity min and max,
+ * kurtosis and skewness (in the order of OutputParams).
+ */
+struct ImageStatisticsValues
+{
+	static const std::size_t kNbStatistics = 8;
+	static const std::size_t kMaxNbChannels = 4;
+	double _rgba[kNbStatistics][kMaxNbChannels];
+	double _hsl[kNbStatistics][kMaxNbChannels];
+	std::size_t _nbPixels;
+};
+
+/**
+ * @brief Identification of the statistics of a region of an image.
+ * The host doesn't give any identifier of the content of the images,
+ * so the pixels are identified by a hash of their values (terry::numeric::view_content_hash_t).
+ */
+struct ImageStatisticsKey
+{
+	std::size_t _contentHash;
+	std::size_t _maskHash; ///< 0 without mask
+	OfxRectI _rect;        ///< the analysed region
+	bool _useMask;
+	std::size_t _pixelSize; ///< bytes per pixel
+
+	bool operator==( const ImageStatisticsKey& other ) const
+	{
+		return _contentHash == other._contentHash &&
+		       _maskHash == other._maskHash &&
+		       _rect.x1 == other._rect.x1 && _rect.y1 == other._rect.y1 &&
+		       _rect.x2 == other._rect.x2 && _rect.y2 == other._rect.y2 &&
+		       _useMask == other._useMask &&
+		       _pixelSize == other._pixelSize;
+	}
+};
+
+/**
+ * @brief The statistics of the last analysed regions.
+ *
+ * A new render of the same pixels (change of the output choice, host cache
+ * miss, same image at another frame) only computes the hash of the pixels.
+ */
+typedef terry::lru_cache<ImageStatisticsKey, ImageStatisticsValues> ImageStatisticsCache;
+
+}
+}
+}
+
+#endif
@@ -106,6 +106,11 @@ void ImageStatisticsPlugin::getRegionsOfInterest( const OFX::RegionsOfInterestAr
 	rois.setRegionOfInterest( *_clipMask, inputRoi_d );
 }
 
+void ImageStatisticsPlugin::purgeCaches()
+{
+	_statisticsCache.clear();
+}
+
 /**
  * @brief The overridden render function
  * @param[in]   args     Rendering parameters
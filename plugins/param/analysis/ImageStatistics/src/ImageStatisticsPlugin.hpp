@@ -2,6 +2,7 @@
 #define _TUTTLE_PLUGIN_IMAGESTATISTICS_PLUGIN_HPP_
 
 #include "ImageStatisticsDefinitions.hpp"
+#include "ImageStatisticsCache.hpp"
 #include <tuttle/plugin/ImageEffectGilPlugin.hpp>
 
 namespace tuttle {
@@ -28,6 +29,8 @@ public:
 
 	void getRegionsOfInterest( const OFX::RegionsOfInterestArguments& args, OFX::RegionOfInterestSetter& rois );
 
+	void purgeCaches();
+
 	ImageStatisticsProcessParams getProcessParams( const OfxTime time, const OfxPointD& renderScale ) const;
 
 public:
@@ -59,6 +62,8 @@ public:
 	OFX::Double3DParam* _paramOutputSkewnessHSL;
 
     OFX::Clip *_clipMask; ///< Source image clip
+
+	ImageStatisticsCache _statisticsCache; ///< statistics of the last analysed regions
 };
 
 }
@@ -14,12 +14,16 @@
 #include <terry/numeric/init.hpp>
 #include <terry/numeric/pow.hpp>
 #include <terry/numeric/sqrt.hpp>
+#include <terry/numeric/statistics.hpp>
+#include <terry/numeric/hash.hpp>
+#include <terry/algorithm/parallel_reduce.hpp>
 #include <boost/gil/extension/color/hsl.hpp>
 
 #include <boost/units/pow.hpp>
 #include <boost/mpl/vector.hpp>
 #include <boost/mpl/erase.hpp>
 #include <boost/mpl/find.hpp>
+#include <boost/static_assert.hpp>
 
 /*
 namespace boost {
@@ -195,140 +199,191 @@ struct OutputParams
 	Pixel _skewness;
 
 	std::size_t _nbPixels;
+
+	/// Copy the statistics in the values of the cache.
+	void store( double values[ImageStatisticsValues::kNbStatistics][ImageStatisticsValues::kMaxNbChannels] ) const
+	{
+		const Pixel* statistics[] = { &_average, &_variance, &_channelMin, &_channelMax, &_luminosityMin, &_luminosityMax, &_kurtosis, &_skewness };
+		for( std::size_t s = 0; s < ImageStatisticsValues::kNbStatistics; ++s )
+			for( int c = 0; c < boost::gil::num_channels<Pixel>::value; ++c )
+				values[s][c] = (*statistics[s])[c];
+	}
+
+	/// Copy the statistics from the values of the cache.
+	void load( const double values[ImageStatisticsValues::kNbStatistics][ImageStatisticsValues::kMaxNbChannels], const std::size_t nbPixels )
+	{
+		Pixel* statistics[] = { &_average, &_variance, &_channelMin, &_channelMax, &_luminosityMin, &_luminosityMax, &_kurtosis, &_skewness };
+		for( std::size_t s = 0; s < ImageStatisticsValues::kNbStatistics; ++s )
+			for( int c = 0; c < boost::gil::num_channels<Pixel>::value; ++c )
+				(*statistics[s])[c] = values[s][c];
+		_nbPixels = nbPixels;
+	}
 };
 
-template<class View, class MaskView, typename CType = boost::gil::bits64f>
-struct ComputeOutputParams
+/**
+ * @brief Statistics of the rows of an image, reducer of terry::algorithm::parallel_reduce_rows.
+ */
+template<class View, class MaskView, typename CPixel>
+struct StatisticsReducer
 {
 	typedef typename View::value_type Pixel;
-	typedef typename boost::gil::color_space_type<View>::type Colorspace;
 	typedef boost::gil::pixel<typename boost::gil::channel_type<View>::type, boost::gil::layout<boost::gil::gray_t> > PixelGray; // grayscale pixel type (using the input channel_type)
-	typedef boost::gil::pixel<CType, boost::gil::layout<Colorspace> > CPixel; // the pixel type use for computation (using input colorspace)
 
-	typedef OutputParams<CPixel> Output;
+	View _image;
+	MaskView _maskView;
+	bool _useMask;
 
-	static Output run( const View& image, const MaskView& maskView, const bool useMask, ImageStatisticsPlugin& plugin )
+	std::size_t _nbPixels;
+	Pixel _channelMin;
+	Pixel _channelMax;
+	Pixel _luminosityMin;
+	PixelGray _luminosityMinGray;
+	Pixel _luminosityMax;
+	PixelGray _luminosityMaxGray;
+
+	terry::numeric::pixel_mean_variance_t<CPixel> _meanVariance;
+	CPixel _sum;
+	CPixel _sum_p2;
+	CPixel _sum_p3;
+	CPixel _sum_p4;
+
+	StatisticsReducer( const View& image, const MaskView& maskView, const bool useMask )
+	: _image( image )
+	, _maskView( maskView )
+	, _useMask( useMask )
+	, _nbPixels( 0 )
 	{
 		using namespace terry::numeric;
-		OutputParams<CPixel> output;
+		pixel_zeros_t<CPixel>( )( _sum );
+		pixel_zeros_t<CPixel>( )( _sum_p2 );
+		pixel_zeros_t<CPixel>( )( _sum_p3 );
+		pixel_zeros_t<CPixel>( )( _sum_p4 );
+	}
+
+	void operator()( const std::ptrdiff_t y )
+	{
+		using namespace terry::numeric;
+		typename View::x_iterator src_it = _image.x_at( 0, y );
+		typename MaskView::x_iterator mask_it;
+		if( _useMask )
+			mask_it = _maskView.x_at( 0, y );
 
-		std::size_t nbProcPixels = 0;
-
-		Pixel channelMin;
-		Pixel channelMax;
-		Pixel luminosityMin;
-		PixelGray luminosityMinGray;
-		Pixel luminosityMax;
-		PixelGray luminosityMaxGray;
-
-		CPixel sum;
-		CPixel varianceSum;
-		CPixel sum_p2;
-		CPixel sum_p3;
-		CPixel sum_p4;
-		pixel_zeros_t<CPixel>( )( sum );
-		pixel_zeros_t<CPixel>( )( varianceSum );
-		pixel_zeros_t<CPixel>( )( sum_p2 );
-		pixel_zeros_t<CPixel>( )( sum_p3 );
-		pixel_zeros_t<CPixel>( )( sum_p4 );
-
-		for( int y = 0; y < image.height(); ++y )
+		for( std::ptrdiff_t x = 0; x < _image.width(); ++x, ++src_it )
 		{
-			typename View::x_iterator src_it = image.x_at( 0, y );
-			typename MaskView::x_iterator mask_it = maskView.x_at( 0, y );
+			if( _useMask && get_color( mask_it[x], gray_color_t() ) == 0.0 )
+				continue;
 
-			for( int x = 0; x < image.width(); ++x, ++src_it, ++mask_it )
+			const Pixel srcPixel = *src_it;
+			PixelGray grayCurrentPixel; // current pixel in gray colorspace
+			color_convert( srcPixel, grayCurrentPixel );
+
+			if( _nbPixels == 0 )
 			{
-				if( useMask && get_color( *mask_it, gray_color_t() ) == 0.0 )
-					continue;
-				
-				
-				PixelGray grayCurrentPixel; // current pixel in gray colorspace
-				color_convert( * src_it, grayCurrentPixel );
-
-				if( nbProcPixels == 0 )
-				{
-					// It's the first pixel we visit.
-					// So initialize statistics!
-					channelMin = *src_it;
-					channelMax = *src_it;
-					luminosityMin = *src_it;
-					luminosityMinGray = grayCurrentPixel;
-					luminosityMax = *src_it;
-					luminosityMaxGray = grayCurrentPixel;
-				}
-				// Count the number of pixels taken into account
-				++nbProcPixels;
-				
-				CPixel pix;
-				pixel_assigns_t<Pixel, CPixel>( )( * src_it, pix ); // pix = src_it;
-
-				CPixel pix_p2;
-				CPixel pix_p3;
-				CPixel pix_p4;
-
-				pixel_assigns_t<CPixel, CPixel>( )( pixel_pow_t<CPixel, 2>( )( pix ), pix_p2 ); // pix_p2 = pow<2>( pix );
-				pixel_assigns_t<CPixel, CPixel>( )( pixel_multiplies_t<CPixel, CPixel, CPixel>( )( pix, pix_p2 ), pix_p3 ); // pix_p3 = pix * pix_p2;
-				pixel_assigns_t<CPixel, CPixel>( )( pixel_multiplies_t<CPixel, CPixel, CPixel>( )( pix_p2, pix_p2 ), pix_p4 ); // pix_p4 = pix_p2 * pix_p2;
-
-				pixel_plus_assign_t<CPixel, CPixel>( )( pix, sum ); // sum += pix;
-				pixel_plus_assign_t<CPixel, CPixel>( )( pix_p2, sum_p2 ); // sum_p2 += pix_p2;
-				pixel_plus_assign_t<CPixel, CPixel>( )( pix_p3, sum_p3 ); // sum_p3 += pix_p3;
-				pixel_plus_assign_t<CPixel, CPixel>( )( pix_p4, sum_p4 ); // sum_p4 += pix_p4;
-
-				// search min for each channel
-				pixel_assign_min_t<Pixel, Pixel>( )( * src_it, channelMin );
-				// search max for each channel
-				pixel_assign_max_t<Pixel, Pixel>( )( * src_it, channelMax );
-
-				// search min luminosity
-				if( get_color( grayCurrentPixel, gray_color_t() ) < get_color( luminosityMinGray, gray_color_t() ) )
-				{
-					luminosityMin     = *src_it;
-					luminosityMinGray = grayCurrentPixel;
-				}
-				// search max luminosity
-				if( get_color( grayCurrentPixel, gray_color_t() ) > get_color( luminosityMaxGray, gray_color_t() ) )
-				{
-					luminosityMax     = *src_it;
-					luminosityMaxGray = grayCurrentPixel;
-				}
+				// It's the first pixel we visit.
+				// So initialize statistics!
+				_channelMin = srcPixel;
+				_channelMax = srcPixel;
+				_luminosityMin = srcPixel;
+				_luminosityMinGray = grayCurrentPixel;
+				_luminosityMax = srcPixel;
+				_luminosityMaxGray = grayCurrentPixel;
 			}
-		}
+			// Count the number of pixels taken into account
+			++_nbPixels;
 
-		output._nbPixels = nbProcPixels;
+			CPixel pix;
+			pixel_assigns_t<Pixel, CPixel>( )( srcPixel, pix ); // pix = src_it;
+			_meanVariance( pix );
 
-		output._channelMin    = channelMin;
-		output._channelMax    = channelMax;
-		output._luminosityMin = luminosityMin;
-		output._luminosityMax = luminosityMax;
+			const CPixel pix_p2 = pixel_pow_t<CPixel, 2>( )( pix ); // pix_p2 = pow<2>( pix );
+			const CPixel pix_p3 = pixel_multiplies_t<CPixel, CPixel, CPixel>( )( pix, pix_p2 ); // pix_p3 = pix * pix_p2;
+			const CPixel pix_p4 = pixel_multiplies_t<CPixel, CPixel, CPixel>( )( pix_p2, pix_p2 ); // pix_p4 = pix_p2 * pix_p2;
 
-		CPixel stdDeriv = pixel_standard_deviation( sum, sum_p2, nbProcPixels );
-		output._average  = pixel_divides_scalar_t<CPixel, double>() ( sum, nbProcPixels );
+			pixel_plus_assign_t<CPixel, CPixel>( )( pix, _sum ); // sum += pix;
+			pixel_plus_assign_t<CPixel, CPixel>( )( pix_p2, _sum_p2 ); // sum_p2 += pix_p2;
+			pixel_plus_assign_t<CPixel, CPixel>( )( pix_p3, _sum_p3 ); // sum_p3 += pix_p3;
+			pixel_plus_assign_t<CPixel, CPixel>( )( pix_p4, _sum_p4 ); // sum_p4 += pix_p4;
 
-		for( int y = 0; y < image.height(); ++y )
-		{
-			typename View::x_iterator src_it = image.x_at( 0, y );
-			
-			for( int x = 0; x < image.width(); ++x, ++src_it )
-			{
-				CPixel pix;
-				pixel_assigns_t<Pixel, CPixel>( )( * src_it, pix ); // pix = src_it;
+			// search min and max for each channel
+			pixel_assign_min_t<Pixel, Pixel>( )( srcPixel, _channelMin );
+			pixel_assign_max_t<Pixel, Pixel>( )( srcPixel, _channelMax );
 
-				CPixel pix_diff = pix;
-				CPixel pix_diff2;
+			// search min and max luminosity
+			updateLuminosity( srcPixel, grayCurrentPixel, srcPixel, grayCurrentPixel );
+		}
+	}
 
-				pix_diff = pixel_minus_t<CPixel, CPixel, CPixel>( )( pix, output._average ); // pix_diff = (pix - mean)
-				pix_diff2 = pixel_multiplies_t<CPixel, CPixel, CPixel>( )( pix_diff, pix_diff ); // pix_diff2 = (x - mean)*(x - mean)
-				
-				pixel_plus_assign_t<CPixel, CPixel>( )( pix_diff2, varianceSum ); // varianceSum += pix_diff2;
-			}
+	/// Accumulate the statistics of the next rows.
+	void merge( const StatisticsReducer& other )
+	{
+		using namespace terry::numeric;
+		if( other._nbPixels == 0 )
+			return;
+		if( _nbPixels == 0 )
+		{
+			*this = other;
+			return;
 		}
+		_nbPixels += other._nbPixels;
+		_meanVariance.merge( other._meanVariance );
+		pixel_plus_assign_t<CPixel, CPixel>( )( other._sum, _sum );
+		pixel_plus_assign_t<CPixel, CPixel>( )( other._sum_p2, _sum_p2 );
+		pixel_plus_assign_t<CPixel, CPixel>( )( other._sum_p3, _sum_p3 );
+		pixel_plus_assign_t<CPixel, CPixel>( )( other._sum_p4, _sum_p4 );
+		pixel_assign_min_t<Pixel, Pixel>( )( other._channelMin, _channelMin );
+		pixel_assign_max_t<Pixel, Pixel>( )( other._channelMax, _channelMax );
+		// strict comparisons: on equality, keep the first pixel like a sequential scan
+		updateLuminosity( other._luminosityMin, other._luminosityMinGray, other._luminosityMax, other._luminosityMaxGray );
+	}
+
+private:
+	void updateLuminosity( const Pixel& min, const PixelGray& minGray, const Pixel& max, const PixelGray& maxGray )
+	{
+		if( get_color( minGray, gray_color_t() ) < get_color( _luminosityMinGray, gray_color_t() ) )
+		{
+			_luminosityMin     = min;
+			_luminosityMinGray = minGray;
+		}
+		if( get_color( maxGray, gray_color_t() ) > get_color( _luminosityMaxGray, gray_color_t() ) )
+		{
+			_luminosityMax     = max;
+			_luminosityMaxGray = maxGray;
+		}
+	}
+};
+
+template<class View, class MaskView, typename CType = boost::gil::bits64f>
+struct ComputeOutputParams
+{
+	typedef typename View::value_type Pixel;
+	typedef typename boost::gil::color_space_type<View>::type Colorspace;
+	typedef boost::gil::pixel<CType, boost::gil::layout<Colorspace> > CPixel; // the pixel type use for computation (using input colorspace)
 
-		CPixel varianceSquare = pixel_divides_scalar_t<CPixel, double>() ( varianceSum, nbProcPixels );
-		output._variance = pixel_sqrt_t<CPixel, Pixel>()( varianceSquare );
-		output._kurtosis = pixel_kurtosis( output._average, stdDeriv, sum, sum_p2, sum_p3, sum_p4, nbProcPixels );
-		output._skewness = pixel_skewness( output._average, stdDeriv, sum, sum_p2, sum_p3, nbProcPixels );
+	typedef OutputParams<CPixel> Output;
+
+	static Output run( const OfxMultiThreadLauncher& launcher, const View& image, const MaskView& maskView, const bool useMask, ImageStatisticsPlugin& plugin )
+	{
+		using namespace terry::numeric;
+		typedef StatisticsReducer<View, MaskView, CPixel> Reducer;
+
+		// one pass on the threads of the host
+		const Reducer stats = terry::algorithm::parallel_reduce_rows( launcher, image.height(), Reducer( image, maskView, useMask ) );
+
+		OutputParams<CPixel> output;
+		output._nbPixels = stats._nbPixels;
+		if( stats._nbPixels == 0 )
+			return output;
+
+		output._channelMin    = stats._channelMin;
+		output._channelMax    = stats._channelMax;
+		output._luminosityMin = stats._luminosityMin;
+		output._luminosityMax = stats._luminosityMax;
+
+		CPixel stdDeriv = pixel_standard_deviation( stats._sum, stats._sum_p2, stats._nbPixels );
+		output._average  = stats._meanVariance.mean;
+		output._variance = stats._meanVariance.standard_deviation();
+		output._kurtosis = pixel_kurtosis( output._average, stdDeriv, stats._sum, stats._sum_p2, stats._sum_p3, stats._sum_p4, stats._nbPixels );
+		output._skewness = pixel_skewness( output._average, stdDeriv, stats._sum, stats._sum_p2, stats._sum_p3, stats._nbPixels );
 
 		return output;
 	}
@@ -367,8 +422,6 @@ ImageStatisticsProcess<View>::ImageStatisticsProcess( ImageStatisticsPlugin& ins
 	: ImageGilFilterProcessor<View>( instance, eImageOrientationIndependant )
 	, _plugin( instance )
 {
-	this->setNoMultiThreading();
-
 	_clipMask = instance.fetchClip( kClipMask );
 	_clipMaskConnected = _clipMask->isConnected();
 
@@ -431,12 +484,37 @@ void ImageStatisticsProcess<View>::setup( const OFX::RenderArguments& args )
 	typename KthChannelView::type channelMaskView = KthChannelView::make(maskView); // gray or alpha channel
 
 	typedef ComputeOutputParams<View, typename KthChannelView::type, boost::gil::bits64f> ComputeRGBA;
-	typename ComputeRGBA::Output outputRGBA = ComputeRGBA::run( image, channelMaskView, _clipMaskConnected, this->_plugin );
-
 	typedef pixel<typename channel_type<View>::type, layout<hsl_t> > HSLPixel;
 	typedef color_converted_view_type<View, HSLPixel> HSLConverter;
 	typedef ComputeOutputParams<typename HSLConverter::type, typename KthChannelView::type, boost::gil::bits64f> ComputeHSL;
-	typename ComputeHSL::Output outputHSL = ComputeHSL::run( color_converted_view<HSLPixel>( image ), channelMaskView, _clipMaskConnected, this->_plugin );
+	BOOST_STATIC_ASSERT( num_channels<Pixel>::value <= ImageStatisticsValues::kMaxNbChannels );
+
+	// the hash of the pixels is much cheaper than the statistics,
+	// a new render of the same region (other output choice...) doesn't compute them again
+	ImageStatisticsKey key;
+	key._contentHash = terry::algorithm::parallel_reduce_rows( this->getLauncher(), image.height(), terry::numeric::view_content_hash_t<View>( image ) )._hash;
+	key._maskHash = _clipMaskConnected ? terry::algorithm::parallel_reduce_rows( this->getLauncher(), maskView.height(), terry::numeric::view_content_hash_t<View>( maskView ) )._hash : 0;
+	key._rect = _processParams._rect;
+	key._useMask = _clipMaskConnected;
+	key._pixelSize = sizeof( Pixel );
+
+	typename ComputeRGBA::Output outputRGBA;
+	typename ComputeHSL::Output outputHSL;
+	ImageStatisticsValues values;
+	if( _plugin._statisticsCache.find( key, values ) )
+	{
+		outputRGBA.load( values._rgba, values._nbPixels );
+		outputHSL.load( values._hsl, values._nbPixels );
+	}
+	else
+	{
+		outputRGBA = ComputeRGBA::run( this->getLauncher(), image, channelMaskView, _clipMaskConnected, this->_plugin );
+		outputHSL = ComputeHSL::run( this->getLauncher(), color_converted_view<HSLPixel>( image ), channelMaskView, _clipMaskConnected, this->_plugin );
+		outputRGBA.store( values._rgba );
+		outputHSL.store( values._hsl );
+		values._nbPixels = outputRGBA._nbPixels;
+		_plugin._statisticsCache.insert( key, values );
+	}
 
 	setOutputParams( outputRGBA, outputHSL, args.time, this->_plugin );
 